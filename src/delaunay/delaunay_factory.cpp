@@ -6,12 +6,23 @@
 
 namespace delaunay
 {
+	DelaunayFactory::DelaunayFactory(int firstTriangleId) :
+			_triangleId(firstTriangleId)
+	{}
+
 	std::shared_ptr<Triangle> DelaunayFactory::createTriangle(
 			const std::shared_ptr<Vertex2D>& vertex1,
 			const std::shared_ptr<Vertex2D>& vertex2,
 			const std::shared_ptr<Vertex2D>& vertex3)
 	{
-		auto result = std::make_shared<Triangle>();
+		std::shared_ptr<Triangle> result;
+		if (_trianglePool && !_trianglePool->empty()) {
+			result = std::move(_trianglePool->back());
+			_trianglePool->pop_back();
+		}
+		else {
+			result = std::make_shared<Triangle>();
+		}
 		result->id = _triangleId;
 		result->vertex1 = vertex1;
 		result->vertex2 = vertex2;
@@ -20,4 +31,14 @@ namespace delaunay
 		return result;
 	}
 
+	int DelaunayFactory::nextTriangleId() const noexcept
+	{
+		return _triangleId;
+	}
+
+	void DelaunayFactory::setTrianglePool(std::vector<std::shared_ptr<Triangle> >* trianglePool) noexcept
+	{
+		_trianglePool = trianglePool;
+	}
+
 }
@@ -2,6 +2,7 @@
 #define DELAUNAY_DELAUNAY_FACTORY_H
 
 #include <memory>
+#include <vector>
 
 
 namespace delaunay
@@ -13,9 +14,15 @@ namespace delaunay
 	{
 	private:
 		int _triangleId = 1;
+		std::vector<std::shared_ptr<Triangle> >* _trianglePool = nullptr;
 
 	public:
 		DelaunayFactory() = default;
+		/**
+		 * @param firstTriangleId - id первого созданного треугольника, например
+		 * TriangulationCache::nextTriangleId() при продолжении триангуляции
+		 */
+		explicit DelaunayFactory(int firstTriangleId);
 		~DelaunayFactory() = default;
 		DelaunayFactory(const DelaunayFactory&) = delete;
 		DelaunayFactory(DelaunayFactory&&) = delete;
@@ -27,6 +34,15 @@ namespace delaunay
 				const std::shared_ptr<Vertex2D>& vertex2,
 				const std::shared_ptr<Vertex2D>& vertex3);
 
+		[[nodiscard]] int nextTriangleId() const noexcept;
+
+		/**
+		 * Пул пустых треугольников, из которого createTriangle берёт треугольники
+		 * прежде чем выделять память, например TriangulationCache::trianglePool()
+		 * @param trianglePool - может быть nullptr
+		 */
+		void setTrianglePool(std::vector<std::shared_ptr<Triangle> >* trianglePool) noexcept;
+
 	};
 }
 
@@ -5,7 +5,9 @@
 #include "triangulation_cache.h"
 #include "utils.h"
 #include "vertex_2d.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 
 
 namespace delaunay
@@ -92,39 +94,195 @@ namespace delaunay
 		return {};
 	}
 
+	DelaunayService::DelaunayService() = default;
+
+	DelaunayService::~DelaunayService() = default;
+
+	std::list<std::shared_ptr<Triangle> > DelaunayService::iterativeDynamicProcess(
+			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			bool* ok)
+	{
+		TriangulationCache cache;
+		return iterativeDynamicProcess(vertices, cache, ok);
+	}
+
 	std::list<std::shared_ptr<Triangle> > DelaunayService::iterativeDynamicProcess(
+			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			TriangulationCache& cache,
+			bool* ok)
+	{
+		if (!generalIterativeDynamicProcess(fakeSquareStep1, vertices, cache, ok)) {
+			return {};
+		}
+		return removeFakeTriangles(cache.triangles());
+	}
+
+	const std::list<std::shared_ptr<Triangle> >& DelaunayService::process(
 			const std::list<std::shared_ptr<Vertex2D> >& vertices,
 			bool* ok)
 	{
-		std::list<std::shared_ptr<Triangle> > result =
-				generalIterativeDynamicProcess(fakeSquareStep1, vertices, ok);
+		reset();
+		if (!_cache) {
+			_cache = std::make_unique<TriangulationCache>();
+		}
+		if (generalIterativeDynamicProcess(fakeSquareStep1, vertices, *_cache, ok)) {
+			_cache->collectTriangles([](const Triangle& triangle) {
+				return triangle.vertex1->id != FAKE_ID
+						&& triangle.vertex2->id != FAKE_ID
+						&& triangle.vertex3->id != FAKE_ID;
+			}, _triangles);
+		}
+		return _triangles;
+	}
+
+	const std::vector<SkippedVertex>& DelaunayService::skippedVertices() const noexcept
+	{
+		static const std::vector<SkippedVertex> empty;
+		return _cache ? _cache->skippedVertices() : empty;
+	}
 
+	void DelaunayService::reset()
+	{
+		if (!_cache) {
+			return;
+		}
+		// сначала возвращаются узлы результата, чтобы треугольники использовались
+		// только кэшем и вернулись в его пул
+		_cache->recycle(_triangles);
+		_cache->reset();
+	}
+
+	std::list<std::shared_ptr<Triangle> > DelaunayService::insertVertices(
+			TriangulationCache& cache,
+			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			bool* ok)
+	{
+		if (cache.triangles().empty()) {
+			if (ok) {
+				*ok = false;
+			}
+			return {};
+		}
+		DelaunayFactory delaunayFactory(cache.nextTriangleId());
+		delaunayFactory.setTrianglePool(&cache.trianglePool());
+		const bool thisOk = processVertices(cache, delaunayFactory, vertices, {});
+		cache.setNextTriangleId(delaunayFactory.nextTriangleId());
+		if (ok) {
+			*ok = thisOk;
+		}
+		if (!thisOk) {
+			return {};
+		}
+		return removeFakeTriangles(cache.triangles());
+	}
+
+	bool DelaunayService::insertFakeRectangle(
+			TriangulationCache& cache,
+			const std::list<std::shared_ptr<Vertex2D> >& vertices)
+	{
+		bool ok;
+		DelaunayFactory delaunayFactory;
+		delaunayFactory.setTrianglePool(&cache.trianglePool());
+		fakeSquareStep1(&cache, &delaunayFactory, vertices, &ok);
+		cache.setNextTriangleId(delaunayFactory.nextTriangleId());
+		return ok;
+	}
+
+	std::list<std::shared_ptr<Triangle> > DelaunayService::progressiveProcess(
+			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			const std::vector<double>& fractions,
+			const SnapshotHandler& handler,
+			TriangulationCache& cache,
+			bool* ok)
+	{
+		bool thisOk;
+		DelaunayFactory delaunayFactory;
+		delaunayFactory.setTrianglePool(&cache.trianglePool());
+		fakeSquareStep1(&cache, &delaunayFactory, vertices, &thisOk);
+		if (!thisOk) {
+			if (ok) {
+				*ok = false;
+			}
+			return {};
+		}
+
+		// Перемешивание Фишера-Йетса с собственным линейным конгруэнтным генератором,
+		// чтобы порядок (а значит и промежуточные сетки) не зависел от реализации
+		// стандартной библиотеки
+		std::vector<std::shared_ptr<Vertex2D> > order(vertices.cbegin(), vertices.cend());
+		uint64_t seed = 0x9e3779b97f4a7c15ULL;
+		for (size_t i = order.size(); i > 1; i--) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			std::swap(order[i - 1], order[(seed >> 33) % i]);
+		}
+
+		std::vector<double> stages;
+		for (double fraction : fractions) {
+			if (fraction > 0.0 && fraction < 1.0) {
+				stages.push_back(fraction);
+			}
+		}
+		std::sort(stages.begin(), stages.end());
+		stages.erase(std::unique(stages.begin(), stages.end()), stages.end());
+		// последний этап добавляет все оставшиеся вершины
+		stages.push_back(1.0);
+
+		size_t begin = 0;
+		for (double fraction : stages) {
+			const size_t end = fraction < 1.0
+					? std::max(begin, static_cast<size_t>(fraction * static_cast<double>(order.size())))
+					: order.size();
+			thisOk = processVertices(
+					cache, delaunayFactory, {order.cbegin() + begin, order.cbegin() + end}, {});
+			cache.setNextTriangleId(delaunayFactory.nextTriangleId());
+			if (!thisOk) {
+				if (ok) {
+					*ok = false;
+				}
+				return {};
+			}
+			begin = end;
+			if (fraction < 1.0 && handler) {
+				handler(fraction, removeFakeTriangles(cache.triangles()));
+			}
+		}
+
+		if (ok) {
+			*ok = true;
+		}
+		return removeFakeTriangles(cache.triangles());
+	}
+
+	std::list<std::shared_ptr<Triangle> > DelaunayService::removeFakeTriangles(
+			std::list<std::shared_ptr<Triangle> > triangles)
+	{
 		// TODO: не корректно просто удалять треугольники с FAKE_ID,
 		//  сначала по вершинам без FAKE_ID нужно построить выпуклое множество вершин
 		//  и перестроить некоторые треугольники так, чтобы после удаления треугольников
 		//  с FAKE_ID осталось только выпуклое множество
-		auto i = result.begin();
-		while (i != result.end()) {
+		auto i = triangles.begin();
+		while (i != triangles.end()) {
 			std::shared_ptr<Triangle>& triangle = *i;
 			if (triangle->vertex1->id == FAKE_ID
 					|| triangle->vertex2->id == FAKE_ID
 					|| triangle->vertex3->id == FAKE_ID) {
-				i = result.erase(i);
+				i = triangles.erase(i);
 			}
 			else {
 				++i;
 			}
 		}
-		return result;
+		return triangles;
 	}
 
-	std::list<std::shared_ptr<Triangle> > DelaunayService::generalIterativeDynamicProcess(
+	bool DelaunayService::generalIterativeDynamicProcess(
 			const std::function<std::list<std::shared_ptr<Vertex2D> >(
 					TriangulationCache*,
 					DelaunayFactory*,
 					const std::list<std::shared_ptr<Vertex2D> >&,
 					bool*) >& step1,
 			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			TriangulationCache& cache,
 			bool* ok)
 	{
 		if (ok) {
@@ -132,18 +290,44 @@ namespace delaunay
 		}
 
 		bool thisOk;
-		std::list<std::shared_ptr<Triangle> > createdTriangles;
 		DelaunayFactory delaunayFactory;
-		TriangulationCache cache;
+		delaunayFactory.setTrianglePool(&cache.trianglePool());
 
 		// Шаг 1. На первых трёх исходных точках строим один треугольник (предполагается, что
 		// точки не лежат на одной прямой, иначе надо выбрать другие точки).
 		std::list<std::shared_ptr<Vertex2D> > addedVertices = step1(
 				&cache, &delaunayFactory, vertices, &thisOk);
 		if (!thisOk) {
-			return {};
+			if (ok) {
+				*ok = false;
+			}
+			return false;
+		}
+
+		thisOk = processVertices(cache, delaunayFactory, vertices, addedVertices);
+		cache.setNextTriangleId(delaunayFactory.nextTriangleId());
+		if (!thisOk) {
+			if (ok) {
+				*ok = false;
+			}
+			return false;
 		}
 
+		// TODO: Для отладки хорошо бы сделать полную проверку всех полученных
+		//  треугольников на то что вообще нет ни одного пересечения рёбер
+
+		return true;
+	}
+
+	bool DelaunayService::processVertices(
+			TriangulationCache& cache,
+			DelaunayFactory& delaunayFactory,
+			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			const std::list<std::shared_ptr<Vertex2D> >& addedVertices)
+	{
+		bool thisOk;
+		std::list<std::shared_ptr<Triangle> > createdTriangles;
+
 		// Шаг 2. В цикле по n для всех остальных точек выполняем шаги 3–5
 		for(const auto& nextVertex : vertices) {
 			if (!nextVertex) {
@@ -159,6 +343,12 @@ namespace delaunay
 			if (found) {
 				continue;
 			}
+			if (!cache.contains(*nextVertex)) {
+				// Вне прямоугольника fake вершин, например, при добавлении вершин в
+				// загруженную триангуляцию
+				cache.skipVertex(nextVertex->id, SkipReason::OutOfTriangulationArea);
+				continue;
+			}
 
 			// Шаг 3. Очередная n-я точка добавляется в уже построенную структуру триангуляции
 			// следующим образом. Вначале производится локализация точки, т.е. находится
@@ -189,10 +379,7 @@ namespace delaunay
 					createdTriangles = cache.createNewSeveralTrianglesNearOuterVertex(
 							foundTriangle, nextVertex, &thisOk);
 					if(!thisOk) {
-						if (ok) {
-							*ok = false;
-						}
-						return {};
+						return false;
 					}
 					break;
 				case VertexRelation::VertexInTriangle:
@@ -236,12 +423,10 @@ namespace delaunay
 			// Шаг 5. Проводятся локальные проверки вновь полученных треугольников на
 			// соответствие условию Делоне и выполняются необходимые перестроения.
 			cache.checkDelaunayConditionAndRebuildIfNeed(createdTriangles);
+			cache.recycle(createdTriangles);
 		}
 
-		// TODO: Для отладки хорошо бы сделать полную проверку всех полученных
-		//  треугольников на то что вообще нет ни одного пересечения рёбер
-
-		return cache.triangles();
+		return true;
 	}
 
 	std::set<int> DelaunayService::vertexIds(
@@ -256,4 +441,19 @@ namespace delaunay
 		return result;
 	}
 
+	std::vector<bool> DelaunayService::usedVertices(
+			const std::list<std::shared_ptr<Triangle> >& triangles,
+			size_t vertexCount)
+	{
+		std::vector<bool> result(vertexCount, false);
+		for (const auto& triangle : triangles) {
+			assert(triangle);
+			for (int id : triangle->vertexIds()) {
+				assert(id >= 0 && static_cast<size_t>(id) < vertexCount);
+				result[static_cast<size_t>(id)] = true;
+			}
+		}
+		return result;
+	}
+
 }
@@ -5,20 +5,22 @@
 #include <list>
 #include <memory>
 #include <set>
+#include <vector>
 
 
 namespace delaunay
 {
 	struct Vertex2D;
 	struct Triangle;
+	struct SkippedVertex;
 	class TriangulationCache;
 	class DelaunayFactory;
 
 	class DelaunayService
 	{
 	public:
-		DelaunayService() = default;
-		~DelaunayService() = default;
+		DelaunayService();
+		~DelaunayService();
 		DelaunayService(const DelaunayService&) = delete;
 		DelaunayService(DelaunayService&&) = delete;
 		DelaunayService & operator=(const DelaunayService&) = delete;
@@ -27,6 +29,17 @@ namespace delaunay
 		static std::set<int> vertexIds(
 				const std::list<std::shared_ptr<Triangle> >& triangles);
 
+		/**
+		 * Битовая карта использованных вершин для случая, когда id вершин - плотные
+		 * индексы 0..vertexCount-1 (см. triangulation::projectVertex3D)
+		 * @param triangles
+		 * @param vertexCount
+		 * @return result[id] == true если вершина id входит хотя бы в один треугольник
+		 */
+		static std::vector<bool> usedVertices(
+				const std::list<std::shared_ptr<Triangle> >& triangles,
+				size_t vertexCount);
+
 		/**
 		 * В данной реализации сделано упрощение: сначала создаются fake вершины для двух
 		 * треугольников, которые образуют квадрат покрывающий всю область триангуляции.
@@ -43,23 +56,148 @@ namespace delaunay
 				const std::list<std::shared_ptr<Vertex2D> >& vertices,
 				bool* ok);
 
+		/**
+		 * То же, что iterativeDynamicProcess(vertices, ok), но триангуляционный кэш
+		 * (вместе с fake треугольниками) остаётся в cache, например, чтобы сохранить
+		 * его снимок, продолжить триангуляцию через insertVertices или узнать
+		 * пропущенные вершины.
+		 * @param vertices
+		 * @param cache - пустой кэш
+		 * @param ok
+		 * @return
+		 */
+		std::list<std::shared_ptr<Triangle> > iterativeDynamicProcess(
+				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				TriangulationCache& cache,
+				bool* ok);
+
+		/**
+		 * То же, что iterativeDynamicProcess(vertices, ok), но кэш, треугольники и
+		 * списки принадлежат сервису и используются повторно (см.
+		 * TriangulationCache::reset), поэтому для сервиса, который строит много
+		 * небольших триангуляций, повторный запуск на данных того же размера почти
+		 * не выделяет память.
+		 *
+		 * ВАЖНО!!! результат действителен до следующего вызова process или reset().
+		 * Если треугольники нужны дольше, их нужно скопировать.
+		 * @param vertices
+		 * @param ok
+		 * @return треугольники без fake треугольников
+		 */
+		const std::list<std::shared_ptr<Triangle> >& process(
+				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				bool* ok);
+
+		/**
+		 * Вершины, пропущенные последним вызовом process. Для остальных методов
+		 * пропущенные вершины остаются в кэше, см. TriangulationCache::skippedVertices.
+		 */
+		[[nodiscard]] const std::vector<SkippedVertex>& skippedVertices() const noexcept;
+
+		/**
+		 * Освобождает результат process, сохраняя выделенную память для следующего
+		 * вызова
+		 */
+		void reset();
+
+		/**
+		 * Добавляет вершины в существующую триангуляцию, построенную
+		 * iterativeDynamicProcess или загруженную из снимка TriangulationCache::load.
+		 *
+		 * ВАЖНО!!! id вершин не должны повторять id уже добавленных вершин. Вершины вне
+		 * прямоугольника fake вершин, построенного по исходным вершинам, пропускаются.
+		 * @param cache
+		 * @param vertices
+		 * @param ok
+		 * @return все треугольники триангуляции без fake треугольников
+		 */
+		std::list<std::shared_ptr<Triangle> > insertVertices(
+				TriangulationCache& cache,
+				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				bool* ok);
+
+		/**
+		 * Обработчик промежуточного результата прогрессивной триангуляции
+		 * @param fraction - доля уже добавленных вершин
+		 * @param triangles - треугольники текущей триангуляции без fake треугольников
+		 */
+		using SnapshotHandler = std::function<void(
+				double fraction,
+				const std::list<std::shared_ptr<Triangle> >& triangles)>;
+
+		/**
+		 * Прогрессивная триангуляция: вершины добавляются в псевдослучайном порядке
+		 * (одинаковом при каждом запуске), поэтому первые вершины равномерно
+		 * покрывают всю область и грубая сетка появляется задолго до окончания
+		 * работы. После добавления каждой доли вершин из fractions вызывается
+		 * handler, затем оставшиеся вершины добавляются в тот же кэш.
+		 *
+		 * fake прямоугольник строится по всем вершинам, как в iterativeDynamicProcess.
+		 * Доли вне интервала (0, 1) пропускаются.
+		 * @param vertices
+		 * @param fractions - доли вершин по возрастанию, например {0.01, 0.1}
+		 * @param handler
+		 * @param cache - пустой кэш
+		 * @param ok
+		 * @return все треугольники триангуляции без fake треугольников
+		 */
+		std::list<std::shared_ptr<Triangle> > progressiveProcess(
+				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				const std::vector<double>& fractions,
+				const SnapshotHandler& handler,
+				TriangulationCache& cache,
+				bool* ok);
+
+		/**
+		 * Заполняет пустой кэш двумя fake треугольниками, которые покрывают
+		 * прямоугольник вершин vertices с отступом FAKE_RECTANGLE_OFFSET
+		 * @param cache - пустой кэш
+		 * @param vertices - не меньше трёх вершин, например углы области триангуляции
+		 * @return
+		 */
+		static bool insertFakeRectangle(
+				TriangulationCache& cache,
+				const std::list<std::shared_ptr<Vertex2D> >& vertices);
+
+		/**
+		 * Шаги 2-5 алгоритма: последовательно добавляет вершины в кэш
+		 * @param cache
+		 * @param delaunayFactory
+		 * @param vertices
+		 * @param addedVertices - вершины, уже добавленные на первом шаге
+		 * @return false если вершину не удалось добавить
+		 */
+		static bool processVertices(
+				TriangulationCache& cache,
+				DelaunayFactory& delaunayFactory,
+				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				const std::list<std::shared_ptr<Vertex2D> >& addedVertices);
+
 	private:
 		/**
 		 * Запускает процесс триангуляции Делоне. Итеративный алгоритм с динамическим
-		 * кэшированием поиска
+		 * кэшированием поиска. Треугольники остаются в cache.
 		 * @param vertices
 		 * @param ok
-		 * @return
+		 * @return false если триангуляцию не удалось построить
 		 */
-		std::list<std::shared_ptr<Triangle> > generalIterativeDynamicProcess(
+		bool generalIterativeDynamicProcess(
 				const std::function<std::list<std::shared_ptr<Vertex2D> >(
 						TriangulationCache*,
 						DelaunayFactory*,
 						const std::list<std::shared_ptr<Vertex2D> >&,
 						bool*) >& step1,
 				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				TriangulationCache& cache,
 				bool* ok);
 
+		static std::list<std::shared_ptr<Triangle> > removeFakeTriangles(
+				std::list<std::shared_ptr<Triangle> > triangles);
+
+		// кэш и результат process, создаются при первом вызове
+		std::unique_ptr<TriangulationCache> _cache;
+		std::list<std::shared_ptr<Triangle> > _triangles;
+
 	};
 }
 
@@ -0,0 +1,24 @@
+#ifndef DELAUNAY_SKIPPED_VERTEX_H
+#define DELAUNAY_SKIPPED_VERTEX_H
+
+
+namespace delaunay
+{
+	enum class SkipReason
+	{
+		ValidationProblem = 0,	// преобразование треугольников нарушило бы их ориентацию
+		OutOfTriangulationArea,	// вне прямоугольника fake вершин
+		FinalizedArea			// в уже завершённой ячейке StreamingService
+	};
+
+	/**
+	 * Вершина, не добавленная в триангуляцию
+	 */
+	struct SkippedVertex
+	{
+		int id = 0;	// Vertex2D::id
+		SkipReason reason = SkipReason::ValidationProblem;
+	};
+}
+
+#endif //DELAUNAY_SKIPPED_VERTEX_H
@@ -0,0 +1,209 @@
+#include "streaming_service.h"
+
+#include "constants.h"
+#include "delaunay_factory.h"
+#include "delaunay_service.h"
+#include "triangle.h"
+#include "vertex_2d.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace delaunay
+{
+	// относительный запас радиуса описанной окружности на погрешность вычислений
+	static const double CIRCLE_TOLERANCE = 1e-6;
+
+	StreamingService::StreamingService(
+			float minX,
+			float minY,
+			float maxX,
+			float maxY,
+			int columns,
+			int rows)
+		: _minX(minX)
+		, _minY(minY)
+		, _maxX(maxX)
+		, _maxY(maxY)
+		, _columns(columns)
+		, _rows(rows)
+	{
+		if (columns <= 0 || rows <= 0 || !(maxX > minX) || !(maxY > minY)) {
+			return;
+		}
+		_cellWidth = (_maxX - _minX) / _columns;
+		_cellHeight = (_maxY - _minY) / _rows;
+		_finalized.assign(static_cast<size_t>(_columns) * static_cast<size_t>(_rows), false);
+
+		// fake прямоугольник строится по углам области, как по всем вершинам в
+		// DelaunayService::iterativeDynamicProcess
+		std::list<std::shared_ptr<Vertex2D> > corners;
+		for (float x : {minX, maxX}) {
+			for (float y : {minY, maxY}) {
+				auto corner = std::make_shared<Vertex2D>();
+				corner->id = FAKE_ID;
+				corner->x = x;
+				corner->y = y;
+				corners.push_back(corner);
+			}
+		}
+		// окончательность треугольника определяется по пустой описанной окружности,
+		// поэтому нужна настоящая триангуляция Делоне
+		_cache.setFlipPropagation(true);
+		_valid = DelaunayService::insertFakeRectangle(_cache, corners);
+	}
+
+	bool StreamingService::isValid() const noexcept
+	{
+		return _valid;
+	}
+
+	int StreamingService::columns() const noexcept
+	{
+		return _columns;
+	}
+
+	int StreamingService::rows() const noexcept
+	{
+		return _rows;
+	}
+
+	bool StreamingService::accepts(const Vertex2D& vertex) const noexcept
+	{
+		if (!contains(vertex)) {
+			return false;
+		}
+		const int column = std::min(static_cast<int>((vertex.x - _minX) / _cellWidth), _columns - 1);
+		const int row = std::min(static_cast<int>((vertex.y - _minY) / _cellHeight), _rows - 1);
+		return !isFinalized(column, row);
+	}
+
+	bool StreamingService::insertVertices(const std::list<std::shared_ptr<Vertex2D> >& vertices)
+	{
+		if (!_valid) {
+			return false;
+		}
+		_cache.clearSkippedVertices();
+		std::list<std::shared_ptr<Vertex2D> > accepted;
+		for (const auto& vertex : vertices) {
+			if (!vertex) {
+				continue;
+			}
+			if (!accepts(*vertex)) {
+				_cache.skipVertex(vertex->id, contains(*vertex)
+						? SkipReason::FinalizedArea
+						: SkipReason::OutOfTriangulationArea);
+				continue;
+			}
+			accepted.push_back(vertex);
+		}
+		DelaunayFactory delaunayFactory(_cache.nextTriangleId());
+		const bool ok = DelaunayService::processVertices(_cache, delaunayFactory, accepted, {});
+		_cache.setNextTriangleId(delaunayFactory.nextTriangleId());
+		return ok;
+	}
+
+	const std::vector<SkippedVertex>& StreamingService::skippedVertices() const noexcept
+	{
+		return _cache.skippedVertices();
+	}
+
+	bool StreamingService::finalizeCell(int column, int row)
+	{
+		if (column < 0 || column >= _columns || row < 0 || row >= _rows) {
+			return false;
+		}
+		_finalized[static_cast<size_t>(row) * _columns + column] = true;
+		return true;
+	}
+
+	std::list<std::shared_ptr<Triangle> > StreamingService::releaseFinalizedTriangles()
+	{
+		return withoutFakeTriangles(_cache.releaseTriangles([this](const Triangle& triangle) {
+			return isFinal(triangle);
+		}));
+	}
+
+	std::list<std::shared_ptr<Triangle> > StreamingService::releaseAllTriangles()
+	{
+		return withoutFakeTriangles(_cache.releaseTriangles([](const Triangle&) {
+			return true;
+		}));
+	}
+
+	size_t StreamingService::activeTriangleCount() const noexcept
+	{
+		return _cache.triangles().size();
+	}
+
+	bool StreamingService::contains(const Vertex2D& vertex) const noexcept
+	{
+		return _valid
+				&& vertex.x >= _minX && vertex.x <= _maxX
+				&& vertex.y >= _minY && vertex.y <= _maxY;
+	}
+
+	bool StreamingService::isFinalized(int column, int row) const noexcept
+	{
+		return _finalized[static_cast<size_t>(row) * _columns + column];
+	}
+
+	bool StreamingService::isFinal(const Triangle& triangle) const noexcept
+	{
+		const double ax = triangle.vertex1->x;
+		const double ay = triangle.vertex1->y;
+		const double bx = triangle.vertex2->x - ax;
+		const double by = triangle.vertex2->y - ay;
+		const double cx = triangle.vertex3->x - ax;
+		const double cy = triangle.vertex3->y - ay;
+		const double d = 2.0 * (bx * cy - by * cx);
+		if (d == 0.0) {
+			return false;
+		}
+		const double b2 = bx * bx + by * by;
+		const double c2 = cx * cx + cy * cy;
+		const double centerX = (cy * b2 - by * c2) / d;
+		const double centerY = (bx * c2 - cx * b2) / d;
+		const double radius = std::sqrt(centerX * centerX + centerY * centerY) * (1.0 + CIRCLE_TOLERANCE) + EPSILON;
+
+		const double firstColumn = std::floor((ax + centerX - radius - _minX) / _cellWidth);
+		const double lastColumn = std::floor((ax + centerX + radius - _minX) / _cellWidth);
+		const double firstRow = std::floor((ay + centerY - radius - _minY) / _cellHeight);
+		const double lastRow = std::floor((ay + centerY + radius - _minY) / _cellHeight);
+		if (lastColumn < 0.0 || firstColumn >= _columns || lastRow < 0.0 || firstRow >= _rows) {
+			// окружность вне области, вершин в ней не будет
+			return true;
+		}
+		const int beginColumn = static_cast<int>(std::max(firstColumn, 0.0));
+		const int endColumn = static_cast<int>(std::min(lastColumn, static_cast<double>(_columns - 1)));
+		const int beginRow = static_cast<int>(std::max(firstRow, 0.0));
+		const int endRow = static_cast<int>(std::min(lastRow, static_cast<double>(_rows - 1)));
+		for (int row = beginRow; row <= endRow; row++) {
+			for (int column = beginColumn; column <= endColumn; column++) {
+				if (!isFinalized(column, row)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	std::list<std::shared_ptr<Triangle> > StreamingService::withoutFakeTriangles(
+			std::list<std::shared_ptr<Triangle> > triangles)
+	{
+		auto i = triangles.begin();
+		while (i != triangles.end()) {
+			const Triangle& triangle = **i;
+			if (triangle.vertex1->id == FAKE_ID
+					|| triangle.vertex2->id == FAKE_ID
+					|| triangle.vertex3->id == FAKE_ID) {
+				i = triangles.erase(i);
+			}
+			else {
+				++i;
+			}
+		}
+		return triangles;
+	}
+}
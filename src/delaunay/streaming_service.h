@@ -0,0 +1,129 @@
+#ifndef DELAUNAY_STREAMING_SERVICE_H
+#define DELAUNAY_STREAMING_SERVICE_H
+
+#include "triangulation_cache.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <vector>
+
+
+namespace delaunay
+{
+	struct Vertex2D;
+	struct Triangle;
+
+	/**
+	 * Потоковая триангуляция для данных, которые не помещаются в память. Область
+	 * триангуляции делится на сетку ячеек columns x rows. Вершины поступают
+	 * упорядоченными по пространству, и после последней вершины ячейки она
+	 * объявляется завершённой (finalizeCell): в неё больше не попадёт ни одна
+	 * вершина.
+	 *
+	 * Треугольник, описанная окружность которого целиком лежит в завершённых
+	 * ячейках (или вне области), уже не изменится: новая вершина не может попасть
+	 * ни в него, ни в его окружность. Такие треугольники отдаются
+	 * releaseFinalizedTriangles() и освобождаются, поэтому в памяти остаётся только
+	 * фронт между завершёнными и незавершёнными ячейками.
+	 *
+	 * Вершины добавляются тем же алгоритмом, что и в DelaunayService, но с
+	 * TriangulationCache::setFlipPropagation(true): без этого у треугольников,
+	 * не удовлетворяющих условию Делоне, окружности большие, и они долго остаются
+	 * во фронте.
+	 */
+	class StreamingService
+	{
+	private:
+		TriangulationCache _cache;
+		bool _valid = false;
+		double _minX = 0.0;
+		double _minY = 0.0;
+		double _maxX = 0.0;
+		double _maxY = 0.0;
+		int _columns = 0;
+		int _rows = 0;
+		double _cellWidth = 0.0;
+		double _cellHeight = 0.0;
+		// _finalized[row * _columns + column]
+		std::vector<bool> _finalized;
+
+	public:
+		/**
+		 * @param minX, minY, maxX, maxY - область триангуляции, вершины вне неё
+		 * пропускаются
+		 * @param columns, rows - размер сетки завершения
+		 */
+		StreamingService(float minX, float minY, float maxX, float maxY, int columns, int rows);
+		~StreamingService() = default;
+		StreamingService(const StreamingService&) = delete;
+		StreamingService(StreamingService&&) = delete;
+		StreamingService & operator=(const StreamingService&) = delete;
+		StreamingService & operator=(StreamingService&&) = delete;
+
+		/**
+		 * @return false если область пуста или сетка не задана
+		 */
+		[[nodiscard]] bool isValid() const noexcept;
+		[[nodiscard]] int columns() const noexcept;
+		[[nodiscard]] int rows() const noexcept;
+
+		/**
+		 * Лежит ли вершина в области триангуляции и в незавершённой ячейке
+		 */
+		[[nodiscard]] bool accepts(const Vertex2D& vertex) const noexcept;
+
+		/**
+		 * Добавляет вершины в триангуляцию. Вершины, которые не принимает accepts(),
+		 * пропускаются, см. skippedVertices().
+		 *
+		 * ВАЖНО!!! id вершин не должны повторяться.
+		 * @param vertices
+		 * @return false если вершину не удалось добавить
+		 */
+		bool insertVertices(const std::list<std::shared_ptr<Vertex2D> >& vertices);
+
+		/**
+		 * Вершины, пропущенные последним вызовом insertVertices
+		 */
+		[[nodiscard]] const std::vector<SkippedVertex>& skippedVertices() const noexcept;
+
+		/**
+		 * Объявляет ячейку завершённой
+		 * @return false если ячейки нет в сетке
+		 */
+		bool finalizeCell(int column, int row);
+
+		/**
+		 * Убирает из триангуляции окончательные треугольники
+		 * @return окончательные треугольники без fake треугольников
+		 */
+		std::list<std::shared_ptr<Triangle> > releaseFinalizedTriangles();
+
+		/**
+		 * Убирает из триангуляции все треугольники, например, после последней вершины
+		 * @return треугольники без fake треугольников
+		 */
+		std::list<std::shared_ptr<Triangle> > releaseAllTriangles();
+
+		/**
+		 * Количество треугольников фронта, которые ещё хранятся в памяти
+		 */
+		[[nodiscard]] size_t activeTriangleCount() const noexcept;
+
+	private:
+		[[nodiscard]] bool contains(const Vertex2D& vertex) const noexcept;
+		[[nodiscard]] bool isFinalized(int column, int row) const noexcept;
+		/**
+		 * Лежит ли прямоугольник, описанный вокруг окружности треугольника, в
+		 * завершённых ячейках или вне области
+		 */
+		[[nodiscard]] bool isFinal(const Triangle& triangle) const noexcept;
+
+		static std::list<std::shared_ptr<Triangle> > withoutFakeTriangles(
+				std::list<std::shared_ptr<Triangle> > triangles);
+
+	};
+}
+
+#endif //DELAUNAY_STREAMING_SERVICE_H
@@ -0,0 +1,351 @@
+#include "tiling_service.h"
+
+#include "constants.h"
+#include "delaunay_factory.h"
+#include "delaunay_service.h"
+#include "triangle.h"
+#include "triangulation_cache.h"
+#include "vertex_2d.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+
+namespace delaunay
+{
+	const int TilingService::SEAM_MARGINS = 2;
+
+	// относительный запас радиуса описанной окружности на погрешность вычислений
+	static const double CIRCLE_TOLERANCE = 1e-6;
+	static const double INFINITE_COORDINATE = std::numeric_limits<double>::max();
+	// полосы вдоль левой, правой, нижней и верхней сторон прямоугольника вершин
+	static const int BORDER_COUNT = 4;
+
+	TilingService::TilingService(
+			float minX,
+			float minY,
+			float maxX,
+			float maxY,
+			int columns,
+			int rows,
+			double margin)
+		: _minX(minX)
+		, _minY(minY)
+		, _maxX(maxX)
+		, _maxY(maxY)
+		// так же, как в Utils::createVerticesAsRectangle
+		, _fakeMinX(minX - FAKE_RECTANGLE_OFFSET)
+		, _fakeMinY(minY - FAKE_RECTANGLE_OFFSET)
+		, _fakeMaxX(maxX + FAKE_RECTANGLE_OFFSET)
+		, _fakeMaxY(maxY + FAKE_RECTANGLE_OFFSET)
+		, _columns(columns)
+		, _rows(rows)
+		, _margin(margin)
+	{
+		if (columns <= 0 || rows <= 0 || !(maxX > minX) || !(maxY > minY) || !(margin >= 0.0)) {
+			return;
+		}
+		_tileWidth = (static_cast<double>(_maxX) - _minX) / _columns;
+		_tileHeight = (static_cast<double>(_maxY) - _minY) / _rows;
+		_valid = true;
+	}
+
+	bool TilingService::isValid() const noexcept
+	{
+		return _valid;
+	}
+
+	int TilingService::regionCount() const noexcept
+	{
+		if (!_valid) {
+			return 0;
+		}
+		return tileCount() + (_columns - 1) + (_rows - 1) + (tileCount() > 1 ? BORDER_COUNT : 0);
+	}
+
+	int TilingService::tileCount() const noexcept
+	{
+		return _valid ? _columns * _rows : 0;
+	}
+
+	void TilingService::regionsOf(const Vertex2D& vertex, std::vector<int>& regions) const
+	{
+		if (!_valid) {
+			return;
+		}
+		auto clamp = [](double value, int count) {
+			return static_cast<int>(std::min(std::max(value, 0.0), static_cast<double>(count - 1)));
+		};
+		const double x = vertex.x - static_cast<double>(_minX);
+		const double y = vertex.y - static_cast<double>(_minY);
+		const int firstColumn = clamp(std::floor((x - _margin) / _tileWidth) - 1.0, _columns);
+		const int lastColumn = clamp(std::floor((x + _margin) / _tileWidth) + 1.0, _columns);
+		const int firstRow = clamp(std::floor((y - _margin) / _tileHeight) - 1.0, _rows);
+		const int lastRow = clamp(std::floor((y + _margin) / _tileHeight) + 1.0, _rows);
+		for (int row = firstRow; row <= lastRow; row++) {
+			for (int column = firstColumn; column <= lastColumn; column++) {
+				const int region = row * _columns + column;
+				if (regionContains(region, vertex)) {
+					regions.push_back(region);
+				}
+			}
+		}
+		// швы проходят по границам тайлов 1.._columns-1 и 1.._rows-1
+		const int seamColumn = static_cast<int>(std::round(x / _tileWidth));
+		for (int column = std::max(seamColumn - 1, 1); column <= std::min(seamColumn + 1, _columns - 1); column++) {
+			const int region = tileCount() + column - 1;
+			if (regionContains(region, vertex)) {
+				regions.push_back(region);
+			}
+		}
+		const int seamRow = static_cast<int>(std::round(y / _tileHeight));
+		for (int row = std::max(seamRow - 1, 1); row <= std::min(seamRow + 1, _rows - 1); row++) {
+			const int region = tileCount() + _columns - 1 + row - 1;
+			if (regionContains(region, vertex)) {
+				regions.push_back(region);
+			}
+		}
+		for (int region = borderRegion(); region < regionCount(); region++) {
+			if (regionContains(region, vertex)) {
+				regions.push_back(region);
+			}
+		}
+	}
+
+	bool TilingService::regionContains(int region, const Vertex2D& vertex) const noexcept
+	{
+		if (region < 0 || region >= regionCount()) {
+			return false;
+		}
+		double minX, minY, maxX, maxY;
+		regionBox(region, minX, minY, maxX, maxY);
+		return vertex.x >= minX && vertex.x <= maxX && vertex.y >= minY && vertex.y <= maxY;
+	}
+
+	bool TilingService::triangulateRegion(
+			int region,
+			const std::list<std::shared_ptr<Vertex2D> >& vertices,
+			RegionTriangulation& result) const
+	{
+		result = RegionTriangulation();
+		if (region < 0 || region >= regionCount()) {
+			return false;
+		}
+		double minX, minY, maxX, maxY;
+		regionBox(region, minX, minY, maxX, maxY);
+		// Стороны fake прямоугольника области, выходящие за прямоугольник вершин,
+		// совпадают со сторонами fake прямоугольника всей триангуляции. Остальные
+		// fake вершины области лежат вне области, но внутри общего fake
+		// прямоугольника, поэтому в окружности записываемых треугольников не попадают.
+		const float left = minX <= _minX ? _minX : static_cast<float>(minX);
+		const float bottom = minY <= _minY ? _minY : static_cast<float>(minY);
+		const float right = maxX >= _maxX ? _maxX : static_cast<float>(maxX);
+		const float top = maxY >= _maxY ? _maxY : static_cast<float>(maxY);
+		std::list<std::shared_ptr<Vertex2D> > corners;
+		for (float x : {left, right}) {
+			for (float y : {bottom, top}) {
+				auto corner = std::make_shared<Vertex2D>();
+				corner->id = FAKE_ID;
+				corner->x = x;
+				corner->y = y;
+				corners.push_back(corner);
+			}
+		}
+
+		TriangulationCache cache;
+		cache.setFlipPropagation(true);
+		if (!DelaunayService::insertFakeRectangle(cache, corners)) {
+			return false;
+		}
+		DelaunayFactory delaunayFactory(cache.nextTriangleId());
+		if (!DelaunayService::processVertices(cache, delaunayFactory, vertices, {})) {
+			return false;
+		}
+
+		auto isGlobalCorner = [this](const Vertex2D& vertex) {
+			return (vertex.x == _fakeMinX || vertex.x == _fakeMaxX)
+					&& (vertex.y == _fakeMinY || vertex.y == _fakeMaxY);
+		};
+		std::unordered_set<int> tileVertexIds;
+		std::unordered_set<int> addedVertexIds;
+		for (const auto& triangle : cache.triangles()) {
+			const std::array<const Vertex2D*, 3> triangleVertices = {
+					triangle->vertex1.get(), triangle->vertex2.get(), triangle->vertex3.get()};
+			bool localFake = false;
+			bool fake = false;
+			for (const Vertex2D* vertex : triangleVertices) {
+				addedVertexIds.insert(vertex->id);
+				if (vertex->id == FAKE_ID) {
+					fake = true;
+					localFake = localFake || !isGlobalCorner(*vertex);
+				}
+				else if (region < tileCount() && tileOf(*vertex) == region) {
+					tileVertexIds.insert(vertex->id);
+				}
+			}
+			if (localFake || writerRegion(*triangle) != region) {
+				continue;
+			}
+			result.triangleCount++;
+			if (!fake) {
+				result.triangles.push_back(triangle);
+			}
+		}
+		result.vertexCount = tileVertexIds.size();
+		for (const auto& vertex : vertices) {
+			if (addedVertexIds.count(vertex->id) == 0) {
+				result.skippedVertexIds.push_back(vertex->id);
+			}
+		}
+		return true;
+	}
+
+	size_t TilingService::expectedTriangleCount(size_t vertexCount) noexcept
+	{
+		// по формуле Эйлера 2 * V - 2 - h треугольника для V = vertexCount + 4
+		// вершин, из которых h = 4 fake вершины на выпуклой оболочке
+		return 2 * vertexCount + 2;
+	}
+
+	void TilingService::regionBox(int region, double& minX, double& minY, double& maxX, double& maxY) const noexcept
+	{
+		const double seamMargin = SEAM_MARGINS * _margin;
+		if (region < tileCount()) {
+			const int column = region % _columns;
+			const int row = region / _columns;
+			// крайние тайлы не ограничены снаружи
+			minX = column == 0 ? -INFINITE_COORDINATE : _minX + column * _tileWidth - _margin;
+			maxX = column == _columns - 1 ? INFINITE_COORDINATE : _minX + (column + 1) * _tileWidth + _margin;
+			minY = row == 0 ? -INFINITE_COORDINATE : _minY + row * _tileHeight - _margin;
+			maxY = row == _rows - 1 ? INFINITE_COORDINATE : _minY + (row + 1) * _tileHeight + _margin;
+		}
+		else if (region < tileCount() + _columns - 1) {
+			const double x = _minX + (region - tileCount() + 1) * _tileWidth;
+			minX = x - seamMargin;
+			maxX = x + seamMargin;
+			minY = -INFINITE_COORDINATE;
+			maxY = INFINITE_COORDINATE;
+		}
+		else if (region < borderRegion()) {
+			const double y = _minY + (region - tileCount() - (_columns - 1) + 1) * _tileHeight;
+			minX = -INFINITE_COORDINATE;
+			maxX = INFINITE_COORDINATE;
+			minY = y - seamMargin;
+			maxY = y + seamMargin;
+		}
+		else {
+			minX = -INFINITE_COORDINATE;
+			maxX = INFINITE_COORDINATE;
+			minY = -INFINITE_COORDINATE;
+			maxY = INFINITE_COORDINATE;
+			switch (region - borderRegion()) {
+			case 0:
+				maxX = _minX + seamMargin;
+				break;
+			case 1:
+				minX = _maxX - seamMargin;
+				break;
+			case 2:
+				maxY = _minY + seamMargin;
+				break;
+			default:
+				minY = _maxY - seamMargin;
+				break;
+			}
+		}
+	}
+
+	int TilingService::borderRegion() const noexcept
+	{
+		return tileCount() + (_columns - 1) + (_rows - 1);
+	}
+
+	int TilingService::tileOf(const Vertex2D& vertex) const noexcept
+	{
+		const int column = std::min(std::max(static_cast<int>(std::floor((vertex.x - static_cast<double>(_minX)) / _tileWidth)), 0), _columns - 1);
+		const int row = std::min(std::max(static_cast<int>(std::floor((vertex.y - static_cast<double>(_minY)) / _tileHeight)), 0), _rows - 1);
+		return row * _columns + column;
+	}
+
+	int TilingService::writerRegion(const Triangle& triangle) const noexcept
+	{
+		// окружность считается по упорядоченным вершинам, чтобы во всех областях
+		// получались одни и те же числа
+		std::array<const Vertex2D*, 3> vertices = {
+				triangle.vertex1.get(), triangle.vertex2.get(), triangle.vertex3.get()};
+		std::sort(vertices.begin(), vertices.end(), [](const Vertex2D* first, const Vertex2D* second) {
+			return first->x < second->x || (first->x == second->x && first->y < second->y);
+		});
+		const double ax = vertices[0]->x;
+		const double ay = vertices[0]->y;
+		const double bx = vertices[1]->x - ax;
+		const double by = vertices[1]->y - ay;
+		const double cx = vertices[2]->x - ax;
+		const double cy = vertices[2]->y - ay;
+		const double d = 2.0 * (bx * cy - by * cx);
+		// вне fake прямоугольника вершин нет; вырожденный треугольник записывает
+		// только область, в которой лежит весь fake прямоугольник
+		double circleMinX = _fakeMinX;
+		double circleMaxX = _fakeMaxX;
+		double circleMinY = _fakeMinY;
+		double circleMaxY = _fakeMaxY;
+		if (d != 0.0) {
+			const double b2 = bx * bx + by * by;
+			const double c2 = cx * cx + cy * cy;
+			const double centerX = (cy * b2 - by * c2) / d;
+			const double centerY = (bx * c2 - cx * b2) / d;
+			const double radius = std::sqrt(centerX * centerX + centerY * centerY) * (1.0 + CIRCLE_TOLERANCE) + EPSILON;
+			circleMinX = std::max(ax + centerX - radius, circleMinX);
+			circleMaxX = std::min(ax + centerX + radius, circleMaxX);
+			circleMinY = std::max(ay + centerY - radius, circleMinY);
+			circleMaxY = std::min(ay + centerY + radius, circleMaxY);
+		}
+		auto inRegion = [&](int region) {
+			double minX, minY, maxX, maxY;
+			regionBox(region, minX, minY, maxX, maxY);
+			return minX <= circleMinX && circleMaxX <= maxX && minY <= circleMinY && circleMaxY <= maxY;
+		};
+		auto clamp = [](double value, int count) {
+			return static_cast<int>(std::min(std::max(value, 0.0), static_cast<double>(count - 1)));
+		};
+
+		const double x0 = circleMinX - _minX;
+		const double x1 = circleMaxX - _minX;
+		const double y0 = circleMinY - _minY;
+		const double y1 = circleMaxY - _minY;
+		const int firstColumn = clamp(std::floor((x1 - _margin) / _tileWidth) - 1.0, _columns);
+		const int lastColumn = clamp(std::floor((x0 + _margin) / _tileWidth) + 1.0, _columns);
+		const int firstRow = clamp(std::floor((y1 - _margin) / _tileHeight) - 1.0, _rows);
+		const int lastRow = clamp(std::floor((y0 + _margin) / _tileHeight) + 1.0, _rows);
+		for (int row = firstRow; row <= lastRow; row++) {
+			for (int column = firstColumn; column <= lastColumn; column++) {
+				if (inRegion(row * _columns + column)) {
+					return row * _columns + column;
+				}
+			}
+		}
+		const int seamColumn = static_cast<int>(std::round((x0 + x1) / 2.0 / _tileWidth));
+		for (int column = std::max(seamColumn - 1, 1); column <= std::min(seamColumn + 1, _columns - 1); column++) {
+			if (inRegion(tileCount() + column - 1)) {
+				return tileCount() + column - 1;
+			}
+		}
+		const int seamRow = static_cast<int>(std::round((y0 + y1) / 2.0 / _tileHeight));
+		for (int row = std::max(seamRow - 1, 1); row <= std::min(seamRow + 1, _rows - 1); row++) {
+			if (inRegion(tileCount() + _columns - 1 + row - 1)) {
+				return tileCount() + _columns - 1 + row - 1;
+			}
+		}
+		// окружности треугольников у выпуклой оболочки бывают очень большими, но
+		// внутри fake прямоугольника остаётся узкая полоса вдоль его стороны
+		for (int region = borderRegion(); region < regionCount(); region++) {
+			if (inRegion(region)) {
+				return region;
+			}
+		}
+		return -1;
+	}
+}
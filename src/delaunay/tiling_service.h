@@ -0,0 +1,147 @@
+#ifndef DELAUNAY_TILING_SERVICE_H
+#define DELAUNAY_TILING_SERVICE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <vector>
+
+
+namespace delaunay
+{
+	struct Vertex2D;
+	struct Triangle;
+
+	/**
+	 * Результат триангуляции одной области TilingService
+	 */
+	struct RegionTriangulation
+	{
+		// треугольники, которые записывает область, без fake треугольников
+		std::list<std::shared_ptr<Triangle> > triangles;
+		// количество треугольников области вместе с треугольниками с fake вершинами
+		// всей триангуляции
+		size_t triangleCount = 0;
+		// количество вершин в самом тайле (без полей), для полос шва 0
+		size_t vertexCount = 0;
+		// id вершин области, которые не удалось добавить (совпадающие вершины или
+		// вершины почти на ребре); зависят от соседних вершин, поэтому в разных
+		// областях могут отличаться
+		std::vector<int> skippedVertexIds;
+	};
+
+	/**
+	 * Разбиение триангуляции Делоне на области, которые строятся независимо
+	 * (например, параллельно) и записываются без пересечений.
+	 *
+	 * Прямоугольник вершин делится на columns x rows тайлов. Область тайла - тайл с
+	 * полями margin, области швов - полосы шириной 2 * SEAM_MARGINS * margin вдоль
+	 * внутренних границ тайлов на всю высоту или ширину, граничные области - полосы
+	 * шириной SEAM_MARGINS * margin вдоль сторон прямоугольника вершин для
+	 * треугольников у выпуклой оболочки. В каждой области строится
+	 * триангуляция Делоне всех попавших в неё вершин (TriangulationCache с
+	 * setFlipPropagation(true)). Стороны fake прямоугольника области, которые выходят
+	 * за прямоугольник вершин, совпадают со сторонами fake прямоугольника всей
+	 * триангуляции (DelaunayService::iterativeDynamicProcess).
+	 *
+	 * Треугольник, описанная окружность которого в пределах fake прямоугольника
+	 * лежит в области, есть и в триангуляции всех вершин: других вершин в окружности
+	 * нет. Такой треугольник записывает первая по номеру область (сначала тайлы,
+	 * затем вертикальные и горизонтальные швы, затем граничные области), в которой лежит окружность, поэтому
+	 * каждый треугольник записывается один раз. Полнота проверяется по количеству:
+	 * у триангуляции n вершин вместе с четырьмя fake вершинами 2 * n + 2
+	 * треугольника (expectedTriangleCount). Если треугольников меньше, поля малы для
+	 * пустых окружностей, и разбиение нужно повторить с большим margin. Если
+	 * какая-то область пропустила вершины, области согласованы, только когда эти
+	 * вершины убраны из всех областей.
+	 */
+	class TilingService
+	{
+	public:
+		// полуширина полосы шва в полях тайла
+		static const int SEAM_MARGINS;
+
+	private:
+		bool _valid = false;
+		// прямоугольник вершин
+		float _minX = 0.0f;
+		float _minY = 0.0f;
+		float _maxX = 0.0f;
+		float _maxY = 0.0f;
+		// fake прямоугольник всей триангуляции
+		float _fakeMinX = 0.0f;
+		float _fakeMinY = 0.0f;
+		float _fakeMaxX = 0.0f;
+		float _fakeMaxY = 0.0f;
+		int _columns = 0;
+		int _rows = 0;
+		double _tileWidth = 0.0;
+		double _tileHeight = 0.0;
+		double _margin = 0.0;
+
+	public:
+		/**
+		 * @param minX, minY, maxX, maxY - прямоугольник всех вершин
+		 * @param columns, rows - количество тайлов
+		 * @param margin - поле тайла
+		 */
+		TilingService(float minX, float minY, float maxX, float maxY, int columns, int rows, double margin);
+		~TilingService() = default;
+		TilingService(const TilingService&) = delete;
+		TilingService(TilingService&&) = delete;
+		TilingService & operator=(const TilingService&) = delete;
+		TilingService & operator=(TilingService&&) = delete;
+
+		[[nodiscard]] bool isValid() const noexcept;
+		/**
+		 * Области 0..tileCount()-1 - тайлы по строкам, затем швы и граничные области
+		 */
+		[[nodiscard]] int regionCount() const noexcept;
+		[[nodiscard]] int tileCount() const noexcept;
+
+		/**
+		 * Добавляет в regions номера областей, в которые попадает вершина, по
+		 * возрастанию
+		 */
+		void regionsOf(const Vertex2D& vertex, std::vector<int>& regions) const;
+		[[nodiscard]] bool regionContains(int region, const Vertex2D& vertex) const noexcept;
+
+		/**
+		 * Строит триангуляцию Делоне вершин области и выбирает треугольники, которые
+		 * записывает эта область.
+		 *
+		 * ВАЖНО!!! vertices - все вершины, для которых regionContains(region, ...),
+		 * в одном и том же порядке для всех областей; id не должны повторяться.
+		 * @param region
+		 * @param vertices
+		 * @param result
+		 * @return false если вершину не удалось добавить
+		 */
+		bool triangulateRegion(
+				int region,
+				const std::list<std::shared_ptr<Vertex2D> >& vertices,
+				RegionTriangulation& result) const;
+
+		/**
+		 * Количество треугольников триангуляции vertexCount вершин вместе с fake
+		 * треугольниками
+		 */
+		[[nodiscard]] static size_t expectedTriangleCount(size_t vertexCount) noexcept;
+
+	private:
+		void regionBox(int region, double& minX, double& minY, double& maxX, double& maxY) const noexcept;
+		/**
+		 * Номер первой граничной области
+		 */
+		[[nodiscard]] int borderRegion() const noexcept;
+		[[nodiscard]] int tileOf(const Vertex2D& vertex) const noexcept;
+		/**
+		 * Область, которая записывает треугольник, или -1, если описанная окружность
+		 * не помещается ни в одну область
+		 */
+		[[nodiscard]] int writerRegion(const Triangle& triangle) const noexcept;
+
+	};
+}
+
+#endif //DELAUNAY_TILING_SERVICE_H
@@ -3,6 +3,7 @@
 #include "constants.h"
 #include "utils.h"
 #include "vertex_2d.h"
+#include <cassert>
 
 
 namespace delaunay
@@ -63,35 +64,38 @@ namespace delaunay
 
 	int Triangle::commonRib(const std::shared_ptr<Triangle>& triangle) const noexcept
 	{
-		if (!isValid() || !triangle || !triangle->isValid()) {
+		if (!triangle || !vertex1 || !vertex2 || !vertex3) {
 			return 0;
 		}
 
-		bool ok11 = vertex1->equals(*(triangle->vertex1));
-		bool ok12 = vertex1->equals(*(triangle->vertex2));
-		bool ok13 = vertex1->equals(*(triangle->vertex3));
+		// Соседние треугольники разделяют одни и те же объекты вершин, поэтому
+		// достаточно сравнить указатели, а не координаты.
+		const Vertex2D* v1 = vertex1.get();
+		const Vertex2D* v2 = vertex2.get();
+		const Vertex2D* v3 = vertex3.get();
+		const Vertex2D* t1 = triangle->vertex1.get();
+		const Vertex2D* t2 = triangle->vertex2.get();
+		const Vertex2D* t3 = triangle->vertex3.get();
 
-		bool ok21 = vertex2->equals(*(triangle->vertex1));
-		bool ok22 = vertex2->equals(*(triangle->vertex2));
-		bool ok23 = vertex2->equals(*(triangle->vertex3));
+		// Битовая маска совпавших вершин triangle: бит 0 - vertex1, бит 1 - vertex2,
+		// бит 2 - vertex3
+		const unsigned int mask =
+				static_cast<unsigned int>(t1 && (t1 == v1 || t1 == v2 || t1 == v3))
+				| (static_cast<unsigned int>(t2 && (t2 == v1 || t2 == v2 || t2 == v3)) << 1u)
+				| (static_cast<unsigned int>(t3 && (t3 == v1 || t3 == v2 || t3 == v3)) << 2u);
 
-		bool ok31 = vertex3->equals(*(triangle->vertex1));
-		bool ok32 = vertex3->equals(*(triangle->vertex2));
-		bool ok33 = vertex3->equals(*(triangle->vertex3));
+		// Номер ребра напротив не совпавшей вершины:
+		// ребро 3 между вершинами 1 и 2, ребро 2 между 1 и 3, ребро 1 между 2 и 3
+		static const int RIB_BY_MASK[8] = {0, 0, 0, 3, 0, 2, 1, 3};
+		return RIB_BY_MASK[mask];
+	}
 
-		if ((ok11 || ok21 || ok31) && (ok12 || ok22 || ok32)) {
-			// ребро 3 между вершинами 1 и 2
-			return 3;
-		}
-		else if ((ok11 || ok21 || ok31) && (ok13 || ok23 || ok33)) {
-			// ребро 2 между вершинами 1 и 3
-			return 2;
-		}
-		else if ((ok12 || ok22 || ok32) && (ok13 || ok23 || ok33)) {
-			// ребро 1 между вершинами 2 и 3
-			return 1;
-		}
-		return 0;
+	std::shared_ptr<Triangle>& Triangle::neighbour(int ribNumber) noexcept
+	{
+		static std::shared_ptr<Triangle> Triangle::* const NEIGHBOURS[3] = {
+				&Triangle::triangle1, &Triangle::triangle2, &Triangle::triangle3};
+		assert(ribNumber >= 1 && ribNumber <= 3);
+		return this->*NEIGHBOURS[ribNumber - 1];
 	}
 
 	std::array<int, 3> Triangle::vertexIds() const noexcept
@@ -44,11 +44,21 @@ namespace delaunay
 		 * Ищет номер ребра именно в заданном треугольнике triangle, а НЕ у текущего,
 		 * которое общее с текущим каким-то ребром текущего треугольника.
 		 *
+		 * Вершины сравниваются по идентичности объектов (указателей), а не по
+		 * координатам, т.к. соседние треугольники разделяют одни и те же вершины.
+		 *
 		 * @param triangle
 		 * @return Возвращает 0 если общее ребро не найдено
 		 */
 		[[nodiscard]] int commonRib(const std::shared_ptr<Triangle>& triangle) const noexcept;
 
+		/**
+		 * Ссылка на соседний треугольник напротив ребра с номером ribNumber (1..3)
+		 * @param ribNumber
+		 * @return
+		 */
+		[[nodiscard]] std::shared_ptr<Triangle>& neighbour(int ribNumber) noexcept;
+
 		[[nodiscard]] std::array<int, 3> vertexIds() const noexcept;
 
 	};
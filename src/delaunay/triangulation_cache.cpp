@@ -6,9 +6,12 @@
 #include "utils.h"
 
 #include <algorithm>
-#include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <unordered_map>
 
 
 namespace delaunay
@@ -17,6 +20,20 @@ namespace delaunay
 	static const int R = 5;
 	// Начальный размер кэша - минимум 2
 	static const int M = 2;
+	// запас в долях ячейки, с которым треугольник считается пересекающим ячейку
+	static const float CELL_MARGIN = 0.01f;
+	// ограничение числа flip за одну вставку на случай зацикливания из-за
+	// погрешности вычислений
+	static const int MAX_PROPAGATED_FLIPS = 1000;
+	// число вызовов reset(), после которого запас памяти сокращается до
+	// наибольшего использования за эти вызовы
+	static const int TRIM_PERIOD = 16;
+
+	static const char SNAPSHOT_MAGIC[8] = {'D', 'T', 'C', 'A', 'C', 'H', 'E', 'S'};
+	static const uint32_t SNAPSHOT_VERSION = 1;
+	// записывается в порядке байтов платформы для проверки при загрузке
+	static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304u;
+	static const int32_t SNAPSHOT_NO_NEIGHBOUR = -1;
 
 	bool TriangulationCache::insertFirstTrianglesWithSameRectangle(
 			const std::list<std::shared_ptr<Triangle> >& triangles)
@@ -36,13 +53,13 @@ namespace delaunay
 		initCache(minX - EPSILON, minY - EPSILON, maxX + EPSILON, maxY + EPSILON, M);
 
 		for (const auto& triangle : triangles) {
-			_triangles.push_back(triangle);
+			pushBack(_triangles, triangle);
 		}
 		for(int i = 0; i < _m; i++) {
 			for(int j = 0; j < _m; j++) {
 				CacheInfo &cacheInfo = _cache.at(i).at(j);
 				for (const auto& triangle : triangles) {
-					cacheInfo.triangles.push_back(triangle);
+					pushBack(cacheInfo.triangles, triangle);
 				}
 			}
 		}
@@ -54,6 +71,350 @@ namespace delaunay
 		return _triangles;
 	}
 
+	int TriangulationCache::nextTriangleId() const noexcept
+	{
+		return _nextTriangleId;
+	}
+
+	void TriangulationCache::setNextTriangleId(int nextTriangleId) noexcept
+	{
+		_nextTriangleId = nextTriangleId;
+	}
+
+	void TriangulationCache::setFlipPropagation(bool propagate) noexcept
+	{
+		_flipPropagation = propagate;
+	}
+
+	const std::vector<SkippedVertex>& TriangulationCache::skippedVertices() const noexcept
+	{
+		return _skippedVertices;
+	}
+
+	void TriangulationCache::skipVertex(int id, SkipReason reason)
+	{
+		_skippedVertices.push_back({id, reason});
+	}
+
+	void TriangulationCache::clearSkippedVertices() noexcept
+	{
+		_skippedVertices.clear();
+	}
+
+	void TriangulationCache::reset()
+	{
+		for (int i = 0; i < _m; i++) {
+			for (int j = 0; j < _m; j++) {
+				recycle(_cache[i][j].triangles);
+			}
+		}
+		// связи с соседями образуют циклы shared_ptr, без их разрыва треугольники
+		// не освобождаются и не могут вернуться в пул
+		for (const auto& triangle : _triangles) {
+			triangle->vertex1.reset();
+			triangle->vertex2.reset();
+			triangle->vertex3.reset();
+			triangle->triangle1.reset();
+			triangle->triangle2.reset();
+			triangle->triangle3.reset();
+		}
+		const size_t usedTriangles = _triangles.size();
+		for (auto& triangle : _triangles) {
+			// треугольники, которые ещё используются снаружи, остаются их владельцам
+			if (triangle.use_count() == 1) {
+				triangle->id = 0;
+				_trianglePool.push_back(std::move(triangle));
+			}
+		}
+		recycle(_triangles);
+		_flipStack.clear();
+		_skippedVertices.clear();
+
+		_highWaterNodes = std::max(_highWaterNodes, _peakUsedNodes);
+		_highWaterTriangles = std::max(_highWaterTriangles, usedTriangles);
+		_highWaterCacheSize = std::max(_highWaterCacheSize, static_cast<size_t>(_m));
+		_usedNodes = 0;
+		_peakUsedNodes = 0;
+		_resetCount++;
+		if (_resetCount >= TRIM_PERIOD) {
+			trim();
+		}
+
+		_minX = _maxX = _aX = _bX = 0.0f;
+		_minY = _maxY = _aY = _bY = 0.0f;
+		_m = 0;
+		_nextTriangleId = 1;
+	}
+
+	void TriangulationCache::trim()
+	{
+		if (_spareNodes.size() > _highWaterNodes) {
+			_spareNodes.resize(_highWaterNodes);
+		}
+		if (_trianglePool.size() > _highWaterTriangles) {
+			_trianglePool.resize(_highWaterTriangles);
+			_trianglePool.shrink_to_fit();
+		}
+		if (_cache.size() > _highWaterCacheSize) {
+			_cache.resize(_highWaterCacheSize);
+			_cache.shrink_to_fit();
+			for (auto& row : _cache) {
+				row.resize(_highWaterCacheSize);
+				row.shrink_to_fit();
+			}
+		}
+		_highWaterNodes = 0;
+		_highWaterTriangles = 0;
+		_highWaterCacheSize = 0;
+		_resetCount = 0;
+	}
+
+	std::vector<std::shared_ptr<Triangle> >& TriangulationCache::trianglePool() noexcept
+	{
+		return _trianglePool;
+	}
+
+	void TriangulationCache::collectTriangles(
+			const std::function<bool(const Triangle&)>& selected,
+			std::list<std::shared_ptr<Triangle> >& result)
+	{
+		for (const auto& triangle : _triangles) {
+			if (selected(*triangle)) {
+				pushBack(result, triangle);
+			}
+		}
+	}
+
+	void TriangulationCache::recycle(std::list<std::shared_ptr<Triangle> >& triangles) noexcept
+	{
+		_usedNodes -= std::min(_usedNodes, triangles.size());
+		for (auto& triangle : triangles) {
+			triangle.reset();
+		}
+		_spareNodes.splice(_spareNodes.end(), triangles);
+	}
+
+	void TriangulationCache::pushBack(
+			std::list<std::shared_ptr<Triangle> >& triangles,
+			const std::shared_ptr<Triangle>& triangle)
+	{
+		if (_spareNodes.empty()) {
+			triangles.push_back(triangle);
+		}
+		else {
+			triangles.splice(triangles.end(), _spareNodes, _spareNodes.begin());
+			triangles.back() = triangle;
+		}
+		_usedNodes++;
+		_peakUsedNodes = std::max(_peakUsedNodes, _usedNodes);
+	}
+
+	std::list<std::shared_ptr<Triangle> >::iterator TriangulationCache::erase(
+			std::list<std::shared_ptr<Triangle> >& triangles,
+			std::list<std::shared_ptr<Triangle> >::iterator i) noexcept
+	{
+		auto next = std::next(i);
+		i->reset();
+		_spareNodes.splice(_spareNodes.end(), triangles, i);
+		if (_usedNodes > 0) {
+			_usedNodes--;
+		}
+		return next;
+	}
+
+	bool TriangulationCache::contains(const Vertex2D& vertex) const noexcept
+	{
+		return _m > 0
+				&& vertex.x >= _minX && vertex.x <= _maxX
+				&& vertex.y >= _minY && vertex.y <= _maxY;
+	}
+
+	bool TriangulationCache::save(std::ostream& output) const
+	{
+		std::unordered_map<const Vertex2D*, uint32_t> vertexIndices;
+		std::vector<SnapshotVertex> vertices;
+		std::unordered_map<const Triangle*, int32_t> triangleIndices;
+		triangleIndices.reserve(_triangles.size());
+		for (const auto& triangle : _triangles) {
+			triangleIndices.emplace(triangle.get(), static_cast<int32_t>(triangleIndices.size()));
+			for (const Vertex2D* vertex : {triangle->vertex1.get(), triangle->vertex2.get(), triangle->vertex3.get()}) {
+				if (vertexIndices.emplace(vertex, static_cast<uint32_t>(vertices.size())).second) {
+					vertices.push_back({vertex->id, vertex->x, vertex->y});
+				}
+			}
+		}
+		auto neighbourIndex = [&triangleIndices](const std::shared_ptr<Triangle>& triangle) {
+			if (!triangle) {
+				return SNAPSHOT_NO_NEIGHBOUR;
+			}
+			auto i = triangleIndices.find(triangle.get());
+			return i != triangleIndices.end() ? i->second : SNAPSHOT_NO_NEIGHBOUR;
+		};
+		std::vector<SnapshotTriangle> triangles;
+		triangles.reserve(_triangles.size());
+		for (const auto& triangle : _triangles) {
+			triangles.push_back({
+					triangle->id,
+					{
+							vertexIndices[triangle->vertex1.get()],
+							vertexIndices[triangle->vertex2.get()],
+							vertexIndices[triangle->vertex3.get()]},
+					{
+							neighbourIndex(triangle->triangle1),
+							neighbourIndex(triangle->triangle2),
+							neighbourIndex(triangle->triangle3)}});
+		}
+		std::vector<uint32_t> cellOffsets;
+		cellOffsets.reserve(static_cast<size_t>(_m) * _m + 1);
+		std::vector<uint32_t> cellEntries;
+		for (int i = 0; i < _m; i++) {
+			for (int j = 0; j < _m; j++) {
+				cellOffsets.push_back(static_cast<uint32_t>(cellEntries.size()));
+				for (const auto& triangle : _cache[i][j].triangles) {
+					auto i = triangleIndices.find(triangle.get());
+					assert(i != triangleIndices.end());
+					cellEntries.push_back(static_cast<uint32_t>(i->second));
+				}
+			}
+		}
+		cellOffsets.push_back(static_cast<uint32_t>(cellEntries.size()));
+
+		TriangulationSnapshotHeader header {};
+		std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+		header.version = SNAPSHOT_VERSION;
+		header.byteOrder = SNAPSHOT_BYTE_ORDER;
+		header.minX = _minX;
+		header.maxX = _maxX;
+		header.minY = _minY;
+		header.maxY = _maxY;
+		header.cacheSize = _m;
+		header.nextTriangleId = _nextTriangleId;
+		header.vertexCount = vertices.size();
+		header.triangleCount = triangles.size();
+		header.cellEntryCount = cellEntries.size();
+
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(vertices.data()),
+				static_cast<std::streamsize>(vertices.size() * sizeof(SnapshotVertex)));
+		output.write(reinterpret_cast<const char*>(triangles.data()),
+				static_cast<std::streamsize>(triangles.size() * sizeof(SnapshotTriangle)));
+		output.write(reinterpret_cast<const char*>(cellOffsets.data()),
+				static_cast<std::streamsize>(cellOffsets.size() * sizeof(uint32_t)));
+		output.write(reinterpret_cast<const char*>(cellEntries.data()),
+				static_cast<std::streamsize>(cellEntries.size() * sizeof(uint32_t)));
+		return !output.fail();
+	}
+
+	bool TriangulationCache::load(const char* data, size_t size)
+	{
+		reset();
+		if (!data || size < sizeof(TriangulationSnapshotHeader)) {
+			return false;
+		}
+		const auto* header = reinterpret_cast<const TriangulationSnapshotHeader*>(data);
+		if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+				|| header->version != SNAPSHOT_VERSION
+				|| header->byteOrder != SNAPSHOT_BYTE_ORDER
+				|| header->cacheSize < M
+				|| header->vertexCount > size
+				|| header->triangleCount > size
+				|| header->cellEntryCount > size) {
+			return false;
+		}
+		const size_t cellCount = static_cast<size_t>(header->cacheSize) * header->cacheSize;
+		const size_t vertexCount = static_cast<size_t>(header->vertexCount);
+		const size_t triangleCount = static_cast<size_t>(header->triangleCount);
+		const size_t cellEntryCount = static_cast<size_t>(header->cellEntryCount);
+		const size_t expectedSize = sizeof(TriangulationSnapshotHeader)
+				+ vertexCount * sizeof(SnapshotVertex)
+				+ triangleCount * sizeof(SnapshotTriangle)
+				+ (cellCount + 1) * sizeof(uint32_t)
+				+ cellEntryCount * sizeof(uint32_t);
+		if (cellCount > size || expectedSize != size) {
+			return false;
+		}
+		const auto* snapshotVertices = reinterpret_cast<const SnapshotVertex*>(header + 1);
+		const auto* snapshotTriangles = reinterpret_cast<const SnapshotTriangle*>(snapshotVertices + vertexCount);
+		const auto* cellOffsets = reinterpret_cast<const uint32_t*>(snapshotTriangles + triangleCount);
+		const uint32_t* cellEntries = cellOffsets + cellCount + 1;
+
+		// сначала проверяются все индексы, чтобы не создавать связанные треугольники
+		// из повреждённого снимка
+		for (size_t i = 0; i < triangleCount; i++) {
+			const SnapshotTriangle& snapshotTriangle = snapshotTriangles[i];
+			for (uint32_t vertex : snapshotTriangle.vertices) {
+				if (vertex >= vertexCount) {
+					return false;
+				}
+			}
+			for (int32_t neighbour : snapshotTriangle.neighbours) {
+				if (neighbour != SNAPSHOT_NO_NEIGHBOUR
+						&& (neighbour < 0 || static_cast<size_t>(neighbour) >= triangleCount)) {
+					return false;
+				}
+			}
+		}
+		if (cellOffsets[0] != 0 || cellOffsets[cellCount] != cellEntryCount) {
+			return false;
+		}
+		for (size_t i = 0; i < cellCount; i++) {
+			if (cellOffsets[i] > cellOffsets[i + 1]) {
+				return false;
+			}
+		}
+		for (size_t i = 0; i < cellEntryCount; i++) {
+			if (cellEntries[i] >= triangleCount) {
+				return false;
+			}
+		}
+		// сетка инициализируется до создания треугольников: связанные треугольники
+		// при ошибке не освободились бы
+		if (!(header->minX < header->maxX) || !(header->minY < header->maxY)
+				|| !initCache(header->minX, header->minY, header->maxX, header->maxY, header->cacheSize)) {
+			return false;
+		}
+
+		std::vector<std::shared_ptr<Vertex2D> > vertices(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++) {
+			vertices[i] = std::make_shared<Vertex2D>();
+			vertices[i]->id = snapshotVertices[i].id;
+			vertices[i]->x = snapshotVertices[i].x;
+			vertices[i]->y = snapshotVertices[i].y;
+		}
+		std::vector<std::shared_ptr<Triangle> > triangles(triangleCount);
+		for (auto& triangle : triangles) {
+			triangle = std::make_shared<Triangle>();
+		}
+		for (size_t i = 0; i < triangleCount; i++) {
+			const SnapshotTriangle& snapshotTriangle = snapshotTriangles[i];
+			Triangle& triangle = *triangles[i];
+			triangle.id = snapshotTriangle.id;
+			triangle.vertex1 = vertices[snapshotTriangle.vertices[0]];
+			triangle.vertex2 = vertices[snapshotTriangle.vertices[1]];
+			triangle.vertex3 = vertices[snapshotTriangle.vertices[2]];
+			for (int k = 0; k < 3; k++) {
+				if (snapshotTriangle.neighbours[k] != SNAPSHOT_NO_NEIGHBOUR) {
+					triangle.neighbour(k + 1) = triangles[snapshotTriangle.neighbours[k]];
+				}
+			}
+		}
+
+		_nextTriangleId = header->nextTriangleId;
+		for (const auto& triangle : triangles) {
+			pushBack(_triangles, triangle);
+		}
+		size_t cell = 0;
+		for (int i = 0; i < _m; i++) {
+			for (int j = 0; j < _m; j++, cell++) {
+				std::list<std::shared_ptr<Triangle> >& cellTriangles = _cache[i][j].triangles;
+				for (uint32_t k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++) {
+					pushBack(cellTriangles, triangles[cellEntries[k]]);
+				}
+			}
+		}
+		return true;
+	}
+
 	bool TriangulationCache::initCache(
 			float minX,
 			float minY,
@@ -78,10 +439,17 @@ namespace delaunay
 		_aY = static_cast<float>(_m - 1) / (_maxY - _minY);
 		_bY = -_minY * _aY;
 
-		_cache.clear();
-		_cache.resize(_m);
-		for(int i = 0; i < _m; i++) {
-			_cache[i].resize(_m);
+		// ячейки сетки освобождаются в _spareNodes, сама сетка только растёт
+		for (auto& row : _cache) {
+			for (CacheInfo& cacheInfo : row) {
+				recycle(cacheInfo.triangles);
+			}
+		}
+		if (_cache.size() < static_cast<size_t>(_m)) {
+			_cache.resize(_m);
+			for (auto& row : _cache) {
+				row.resize(_m);
+			}
 		}
 		return true;
 	}
@@ -103,12 +471,15 @@ namespace delaunay
 		}
 	}
 
-	void TriangulationCache::cacheTriangle(const std::shared_ptr<Triangle>& triangle)
+	template<typename Function>
+	void TriangulationCache::forEachTriangleCell(const Triangle& triangle, Function function) const
 	{
-		assert(triangle);
-		float minX, maxX, minY, maxY;
-		const bool ok = Utils::triangleRect(triangle, minX, minY, maxX, maxY);
-		assert(ok);
+		const float xs[3] = {triangle.vertex1->x, triangle.vertex2->x, triangle.vertex3->x};
+		const float ys[3] = {triangle.vertex1->y, triangle.vertex2->y, triangle.vertex3->y};
+		const float minX = std::min({xs[0], xs[1], xs[2]});
+		const float maxX = std::max({xs[0], xs[1], xs[2]});
+		const float minY = std::min({ys[0], ys[1], ys[2]});
+		const float maxY = std::max({ys[0], ys[1], ys[2]});
 		int minI, minJ, maxI, maxJ;
 		index(minX, minY, minI, minJ);
 		index(maxX, maxY, maxI, maxJ);
@@ -117,13 +488,47 @@ namespace delaunay
 		assert(maxI >= 0 && maxI < _m);
 		assert(maxJ >= 0 && maxJ < _m);
 		assert(minI <= maxI && minJ <= maxJ);
-		for(int i = minI; i <= maxI; i++) {
-			for(int j = minJ; j <= maxJ; j++) {
-				_cache.at(i).at(j).triangles.push_back(triangle);
+		for (int j = minJ; j <= maxJ; j++) {
+			// строка j - вершины, для которых index() даёт j, с запасом CELL_MARGIN
+			const float bandMinY = (static_cast<float>(j) - 0.5f - CELL_MARGIN - _bY) / _aY;
+			const float bandMaxY = (static_cast<float>(j) + 0.5f + CELL_MARGIN - _bY) / _aY;
+			// пересечение треугольника с полосой - выпуклый многоугольник из вершин
+			// внутри полосы и точек пересечения рёбер с её границами
+			float rowMinX = maxX;
+			float rowMaxX = minX;
+			for (int k = 0; k < 3; k++) {
+				if (ys[k] >= bandMinY && ys[k] <= bandMaxY) {
+					rowMinX = std::min(rowMinX, xs[k]);
+					rowMaxX = std::max(rowMaxX, xs[k]);
+				}
+				const int l = (k + 1) % 3;
+				for (float y : {bandMinY, bandMaxY}) {
+					if ((ys[k] - y) * (ys[l] - y) < 0.0f) {
+						const float x = xs[k] + (y - ys[k]) * (xs[l] - xs[k]) / (ys[l] - ys[k]);
+						rowMinX = std::min(rowMinX, x);
+						rowMaxX = std::max(rowMaxX, x);
+					}
+				}
+			}
+			if (rowMinX > rowMaxX) {
+				continue;
+			}
+			const int firstI = std::max(minI, static_cast<int>(std::floor(_aX * rowMinX + _bX + 0.5f - CELL_MARGIN)));
+			const int lastI = std::min(maxI, static_cast<int>(std::floor(_aX * rowMaxX + _bX + 0.5f + CELL_MARGIN)));
+			for (int i = firstI; i <= lastI; i++) {
+				function(i, j);
 			}
 		}
 	}
 
+	void TriangulationCache::cacheTriangle(const std::shared_ptr<Triangle>& triangle)
+	{
+		assert(triangle);
+		forEachTriangleCell(*triangle, [this, &triangle](int i, int j) {
+			pushBack(_cache[i][j].triangles, triangle);
+		});
+	}
+
 	void TriangulationCache::addToCache(const std::shared_ptr<Triangle>& triangle)
 	{
 		assert(triangle);
@@ -137,32 +542,20 @@ namespace delaunay
 
 	void TriangulationCache::removeFromCache(const std::shared_ptr<Triangle>& triangle)
 	{
-		float minX, maxX, minY, maxY;
-		const bool ok = Utils::triangleRect(triangle, minX, minY, maxX, maxY);
-		assert(ok);
-		int minI, minJ, maxI, maxJ;
-		index(minX, minY, minI, minJ);
-		index(maxX, maxY, maxI, maxJ);
-		assert(minI >= 0 && minI < _m);
-		assert(minJ >= 0 && minJ < _m);
-		assert(maxI >= 0 && maxI < _m);
-		assert(maxJ >= 0 && maxJ < _m);
-		assert(minI <= maxI && minJ <= maxJ);
-		for(int i = minI; i <= maxI; i++) {
-			for(int j = minJ; j <= maxJ; j++) {
-				auto& cachedTriangles = _cache.at(i).at(j).triangles;
-				auto k = cachedTriangles.begin();
-				while(k != cachedTriangles.end()) {
-					auto& cachedTriangle = *k;
-					if (cachedTriangle.get() == triangle.get()) {
-						k = cachedTriangles.erase(k);
-					}
-					else {
-						++k;
-					}
+		assert(triangle);
+		forEachTriangleCell(*triangle, [this, &triangle](int i, int j) {
+			auto& cachedTriangles = _cache[i][j].triangles;
+			auto k = cachedTriangles.begin();
+			while(k != cachedTriangles.end()) {
+				auto& cachedTriangle = *k;
+				if (cachedTriangle.get() == triangle.get()) {
+					k = erase(cachedTriangles, k);
+				}
+				else {
+					++k;
 				}
 			}
-		}
+		});
 	}
 
 	std::shared_ptr<Triangle> TriangulationCache::findAppropriateTriangle(
@@ -183,15 +576,6 @@ namespace delaunay
 		assert(i >= 0 && i < _m);
 		assert(j >= 0 && j < _m);
 		const CacheInfo& cacheInfo = _cache.at(i).at(j);
-		if (cacheInfo.triangles.size() == 1) {
-			const std::shared_ptr<Triangle>& triangle = cacheInfo.triangles.front();
-			if (triangle->vertex1->equals(*vertex)
-				|| triangle->vertex2->equals(*vertex)
-				|| triangle->vertex3->equals(*vertex)) {
-				return {};
-			}
-			return triangle;
-		}
 
 		// Найти самый близкий треугольник к vertex или вернуть пустой треугольник
 		// если vertex обнаружена как уже добавленная вершина
@@ -200,7 +584,7 @@ namespace delaunay
 		float distance;
 		float minDistance;
 		VertexRelation vertexRelation;
-		std::shared_ptr<Vertex2D> centerOfMass;
+		Vertex2D centerOfMass;
 		std::shared_ptr<Triangle> result;
 		for (const auto& triangle : cacheInfo.triangles) {
 			if (triangle->vertex1->equals(*vertex)
@@ -216,11 +600,13 @@ namespace delaunay
 				return triangle;
 			}
 
-			centerOfMass = Utils::centerOfMass(triangle);
-			distance = Utils::distance(centerOfMass, vertex, &ok);
-			if (!ok) {
+			// центр масс на стеке, как в Utils::centerOfMass, но без выделения памяти
+			if (!triangle->isValid()) {
 				continue;
 			}
+			centerOfMass.x = (triangle->vertex1->x + triangle->vertex2->x + triangle->vertex3->x) / 3.0f;
+			centerOfMass.y = (triangle->vertex1->y + triangle->vertex2->y + triangle->vertex3->y) / 3.0f;
+			distance = Utils::distance(centerOfMass, *vertex);
 			if (skipFirst) {
 				result = triangle;
 				minDistance = distance;
@@ -232,10 +618,93 @@ namespace delaunay
 				minDistance = distance;
 			}
 		}
-		// TODO: сюда попадаем только когда вместо FAKE треугольников, которые
-		//  закрывают всю область триангуляции, используется логика
-		//  createNewSeveralTrianglesNearOuterVertex
-		assert(false);
+		// Треугольник регистрируется в ячейках с запасом CELL_MARGIN, но на границе
+		// ячейки округление в index() может дать соседнюю ячейку, где нет
+		// треугольника с vertex. Тогда ищем его переходом по соседям.
+		if (!result) {
+			if (_triangles.empty()) {
+				return {};
+			}
+			result = _triangles.front();
+		}
+		result = walkToTriangle(result, *vertex);
+		if (result->vertex1->equals(*vertex)
+			|| result->vertex2->equals(*vertex)
+			|| result->vertex3->equals(*vertex)) {
+			return {};
+		}
+		return result;
+	}
+
+	std::shared_ptr<Triangle> TriangulationCache::walkToTriangle(
+			std::shared_ptr<Triangle> triangle,
+			const Vertex2D& vertex) const
+	{
+		// на триангуляции Делоне переход по рёбрам не зацикливается, ограничение -
+		// на случай ошибок округления
+		for (size_t step = 0; step < _triangles.size(); step++) {
+			const Vertex2D& vertex1 = *triangle->vertex1;
+			const Vertex2D& vertex2 = *triangle->vertex2;
+			const Vertex2D& vertex3 = *triangle->vertex3;
+			// те же произведения, что в Triangle::vertexRelation, и знак обхода
+			const float v12 = (vertex1.x - vertex.x) * (vertex2.y - vertex1.y)
+					- (vertex2.x - vertex1.x) * (vertex1.y - vertex.y);
+			const float v23 = (vertex2.x - vertex.x) * (vertex3.y - vertex2.y)
+					- (vertex3.x - vertex2.x) * (vertex2.y - vertex.y);
+			const float v13 = (vertex3.x - vertex.x) * (vertex1.y - vertex3.y)
+					- (vertex1.x - vertex3.x) * (vertex3.y - vertex.y);
+			const float orientation = (vertex1.x - vertex3.x) * (vertex2.y - vertex1.y)
+					- (vertex2.x - vertex1.x) * (vertex1.y - vertex3.y);
+			const std::shared_ptr<Triangle>* next = nullptr;
+			if (v12 * orientation < 0.0f) {
+				next = &triangle->triangle3;
+			}
+			else if (v23 * orientation < 0.0f) {
+				next = &triangle->triangle1;
+			}
+			else if (v13 * orientation < 0.0f) {
+				next = &triangle->triangle2;
+			}
+			if (!next || !*next) {
+				break;
+			}
+			triangle = *next;
+		}
+		return triangle;
+	}
+
+	std::list<std::shared_ptr<Triangle> > TriangulationCache::releaseTriangles(
+			const std::function<bool(const Triangle&)>& released)
+	{
+		std::list<std::shared_ptr<Triangle> > result;
+		auto i = _triangles.begin();
+		while (i != _triangles.end()) {
+			auto next = std::next(i);
+			if (released(**i)) {
+				result.splice(result.end(), _triangles, i);
+			}
+			i = next;
+		}
+		// узлы result переходят вызывающему и больше не учитываются в кэше, пока
+		// не вернутся через recycle
+		_usedNodes -= std::min(_usedNodes, result.size());
+		for (auto& triangle : result) {
+			removeFromCache(triangle);
+			for (int ribNumber = 1; ribNumber <= 3; ribNumber++) {
+				std::shared_ptr<Triangle>& neighbour = triangle->neighbour(ribNumber);
+				if (!neighbour) {
+					continue;
+				}
+				for (int neighbourRib = 1; neighbourRib <= 3; neighbourRib++) {
+					std::shared_ptr<Triangle>& back = neighbour->neighbour(neighbourRib);
+					if (back.get() == triangle.get()) {
+						back.reset();
+					}
+				}
+				// без ссылок на соседей освобождённые треугольники не удерживают друг друга
+				neighbour.reset();
+			}
+		}
 		return result;
 	}
 
@@ -281,17 +750,17 @@ namespace delaunay
 		// Проверяем, а возможно ли вообще делать преобразование
 		Direction newDirection = Utils::direction(innerVertex, outerVertex1, outerVertex2, &ok);
 		if (newDirection != Direction::Right) {
-			std::cout << "Skipped vertex: " << innerVertex->id << " (validation problem)." << std::endl;
+			skipVertex(innerVertex->id, SkipReason::ValidationProblem);
 			return {};
 		}
 		newDirection = Utils::direction(innerVertex, outerVertex2, outerVertex3, &ok);
 		if (newDirection != Direction::Right) {
-			std::cout << "Skipped vertex: " << innerVertex->id << " (validation problem)." << std::endl;
+			skipVertex(innerVertex->id, SkipReason::ValidationProblem);
 			return {};
 		}
 		newDirection = Utils::direction(innerVertex, outerVertex3, outerVertex1, &ok);
 		if (newDirection != Direction::Right) {
-			std::cout << "Skipped vertex: " << innerVertex->id << " (validation problem)." << std::endl;
+			skipVertex(innerVertex->id, SkipReason::ValidationProblem);
 			return {};
 		}
 
@@ -320,9 +789,9 @@ namespace delaunay
 		assert(ok);
 
 		std::list<std::shared_ptr<Triangle> > result;
-		result.push_back(newTriangle1);
-		result.push_back(newTriangle2);
-		result.push_back(newTriangle3);
+		pushBack(result, newTriangle1);
+		pushBack(result, newTriangle2);
+		pushBack(result, newTriangle3);
 		return result;
 	}
 
@@ -409,23 +878,23 @@ namespace delaunay
 		// Проверяем, а возможно ли вообще делать преобразование
 		Direction newDirection = Utils::direction(newVertex, adjacentVertex1, vertex, &ok);
 		if (newDirection != Direction::Right) {
-			std::cout << "Skipped vertex: " << vertex->id << " (validation problem)." << std::endl;
+			skipVertex(vertex->id, SkipReason::ValidationProblem);
 			return {};
 		}
 		newDirection = Utils::direction(newVertex, vertex, adjacentVertex2, &ok);
 		if (newDirection != Direction::Right) {
-			std::cout << "Skipped vertex: " << vertex->id << " (validation problem)." << std::endl;
+			skipVertex(vertex->id, SkipReason::ValidationProblem);
 			return {};
 		}
 		if (oppositeTriangle) {
 			newDirection = Utils::direction(adjacentNewVertex, adjacentOppositeVertex1, vertex, &ok);
 			if (newDirection != Direction::Right) {
-				std::cout << "Skipped vertex: " << vertex->id << " (validation problem)." << std::endl;
+				skipVertex(vertex->id, SkipReason::ValidationProblem);
 				return {};
 			}
 			newDirection = Utils::direction(adjacentNewVertex, vertex, adjacentOppositeVertex2, &ok);
 			if (newDirection != Direction::Right) {
-				std::cout << "Skipped vertex: " << vertex->id << " (validation problem)." << std::endl;
+				skipVertex(vertex->id, SkipReason::ValidationProblem);
 				return {};
 			}
 		}
@@ -471,11 +940,11 @@ namespace delaunay
 		}
 
 		std::list<std::shared_ptr<Triangle> > result;
-		result.push_back(triangle);
-		result.push_back(newTriangle);
+		pushBack(result, triangle);
+		pushBack(result, newTriangle);
 		if (oppositeTriangle) {
-			result.push_back(oppositeTriangle);
-			result.push_back(newOppositeTriangle);
+			pushBack(result, oppositeTriangle);
+			pushBack(result, newOppositeTriangle);
 		}
 		return result;
 	}
@@ -499,19 +968,57 @@ namespace delaunay
 		}
 		if (triangle->triangle1) {
 			if (!Utils::checkSumOppositeAngles(triangle, 1)) {
-				flipTriangles(triangle, 1);
+				if (flipTriangles(triangle, 1) && _flipPropagation) {
+					propagateFlips(triangle);
+				}
 			}
 		}
 		if (triangle->triangle2) {
 			if (!Utils::checkSumOppositeAngles(triangle, 2)) {
-				flipTriangles(triangle, 2);
+				if (flipTriangles(triangle, 2) && _flipPropagation) {
+					propagateFlips(triangle);
+				}
 			}
 		}
 		if (triangle->triangle3) {
 			if (!Utils::checkSumOppositeAngles(triangle, 3)) {
-				flipTriangles(triangle, 3);
+				if (flipTriangles(triangle, 3) && _flipPropagation) {
+					propagateFlips(triangle);
+				}
+			}
+		}
+	}
+
+	void TriangulationCache::propagateFlips(const std::shared_ptr<Triangle>& triangle)
+	{
+		// после flip вершина vertex1 лежит в обоих треугольниках: в triangle она
+		// противолежит ребру 1, в соседнем по ребру 3 треугольнике - ребру 2
+		std::vector<std::pair<std::shared_ptr<Triangle>, int> >& ribs = _flipStack;
+		ribs.clear();
+		ribs.emplace_back(triangle->triangle3, 2);
+		ribs.emplace_back(triangle, 1);
+		int flips = 0;
+		while (!ribs.empty() && flips < MAX_PROPAGATED_FLIPS) {
+			std::shared_ptr<Triangle> current = ribs.back().first;
+			const int vertexNumber = ribs.back().second;
+			ribs.pop_back();
+			if (!current) {
+				continue;
+			}
+			const std::shared_ptr<Triangle>& opposite = vertexNumber == 1
+					? current->triangle1
+					: (vertexNumber == 2 ? current->triangle2 : current->triangle3);
+			if (!opposite || Utils::checkSumOppositeAngles(current, vertexNumber)) {
+				continue;
+			}
+			if (flipTriangles(current, vertexNumber)) {
+				flips++;
+				ribs.emplace_back(current->triangle3, 2);
+				ribs.emplace_back(current, 1);
 			}
 		}
+		// не удерживать треугольники до следующего вызова
+		ribs.clear();
 	}
 
 	void TriangulationCache::index(float x, float y, int& i, int& j) const noexcept
@@ -526,12 +1033,12 @@ namespace delaunay
 		if (!triangle || !triangle->isValid()) {
 			return false;
 		}
-		_triangles.push_back(triangle);
+		pushBack(_triangles, triangle);
 		addToCache(triangle);
 		return true;
 	}
 
-	void TriangulationCache::flipTriangles(
+	bool TriangulationCache::flipTriangles(
 			std::shared_ptr<Triangle>& triangle,
 			int vertexNumber)
 	{
@@ -572,10 +1079,10 @@ namespace delaunay
 			vertex3 = triangle->vertex2;
 		}
 		else {
-			return;
+			return false;
 		}
 		if (!oppositeTriangle) {
-			return;
+			return false;
 		}
 		int oppositeVertexNumber = triangle->commonRib(oppositeTriangle);
 		if (oppositeVertexNumber == 1) {
@@ -600,7 +1107,7 @@ namespace delaunay
 			oppositeVertex3 = oppositeTriangle->vertex2;
 		}
 		else {
-			return;
+			return false;
 		}
 		assert(vertex2->equals(*oppositeVertex3));
 		assert(vertex3->equals(*oppositeVertex2));
@@ -609,12 +1116,12 @@ namespace delaunay
 		Direction newDirection = Utils::direction(vertex1, oppositeVertex1, vertex3, &ok);
 		if (newDirection != Direction::Right) {
 			// невозможно выполнить flip (с большой вероятностью треугольник с одной или двумя FAKE вершин)
-			return;
+			return false;
 		}
 		newDirection = Utils::direction(oppositeVertex1, vertex1, oppositeVertex3, &ok);
 		if (newDirection != Direction::Right) {
 			// невозможно выполнить flip (с большой вероятностью треугольник с одной или двумя FAKE вершин)
-			return;
+			return false;
 		}
 
 		removeFromCache(triangle);
@@ -636,6 +1143,7 @@ namespace delaunay
 
 		addToCache(triangle);
 		addToCache(oppositeTriangle);
+		return true;
 	}
 
 }
@@ -1,11 +1,17 @@
 #ifndef DELAUNAY_TRIANGULATION_CACHE_H
 #define DELAUNAY_TRIANGULATION_CACHE_H
 
+#include "skipped_vertex.h"
 #include "vertex_relation.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
 #include <list>
 #include <unordered_map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 
@@ -15,6 +21,47 @@ namespace delaunay
 	struct Triangle;
 	class DelaunayFactory;
 
+	/**
+	 * Заголовок снимка триангуляционного кэша. За заголовком следуют:
+	 * - SnapshotVertex[vertexCount] - все вершины треугольников, в том числе fake;
+	 * - SnapshotTriangle[triangleCount] - треугольники в порядке TriangulationCache::triangles();
+	 * - uint32_t[cacheSize * cacheSize + 1] - начала списков ячеек в cellEntries
+	 *   (ячейки по строкам i, затем по j);
+	 * - uint32_t[cellEntryCount] - индексы треугольников в ячейках.
+	 *
+	 * Все значения в порядке байтов платформы, записавшей снимок (см. byteOrder).
+	 */
+	struct TriangulationSnapshotHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		float minX;
+		float maxX;
+		float minY;
+		float maxY;
+		int32_t cacheSize;
+		int32_t nextTriangleId;
+		uint64_t vertexCount;
+		uint64_t triangleCount;
+		uint64_t cellEntryCount;
+	};
+	static_assert(sizeof(TriangulationSnapshotHeader) == 64, "Unexpected snapshot header size");
+
+	struct SnapshotVertex
+	{
+		int32_t id;
+		float x;
+		float y;
+	};
+
+	struct SnapshotTriangle
+	{
+		int32_t id;
+		uint32_t vertices[3];	// индексы в SnapshotVertex
+		int32_t neighbours[3];	// индексы в SnapshotTriangle или -1
+	};
+
 	struct CacheInfo
 	{
 		std::list<std::shared_ptr<Triangle> > triangles;
@@ -37,9 +84,115 @@ namespace delaunay
 				const std::list<std::shared_ptr<Triangle> >& triangles);
 
 		[[nodiscard]] const std::list<std::shared_ptr<Triangle> >& triangles() const noexcept;
+
+		/**
+		 * Id, который получит следующий созданный треугольник. Сохраняется в снимке,
+		 * чтобы продолжение триангуляции после загрузки выдавало те же id.
+		 */
+		[[nodiscard]] int nextTriangleId() const noexcept;
+		/**
+		 * Попадает ли вершина в область кэша [_minX, _maxX] x [_minY, _maxY]
+		 */
+		[[nodiscard]] bool contains(const Vertex2D& vertex) const noexcept;
+		void setNextTriangleId(int nextTriangleId) noexcept;
+		/**
+		 * По умолчанию после вставки вершины каждое ребро новых треугольников
+		 * проверяется один раз. С propagate = true после каждого flip проверяются и
+		 * рёбра, которые стали противолежать вершине (алгоритм Лоусона), и
+		 * триангуляция остаётся триангуляцией Делоне. Результат при этом отличается
+		 * от прежнего, поэтому режим включается явно (см. StreamingService).
+		 */
+		void setFlipPropagation(bool propagate) noexcept;
+
+		/**
+		 * Вершины, которые не удалось добавить с последнего reset(), load() или
+		 * clearSkippedVertices(), в порядке пропуска. Кэш ничего не выводит, сообщения
+		 * формирует вызывающий код (id - Vertex2D::id, см. triangulation::writeSkippedVertices).
+		 */
+		[[nodiscard]] const std::vector<SkippedVertex>& skippedVertices() const noexcept;
+		void skipVertex(int id, SkipReason reason);
+		void clearSkippedVertices() noexcept;
+
+		/**
+		 * Очищает кэш для новой триангуляции, но сохраняет выделенную память: узлы
+		 * списков, сетку ячеек и треугольники, которые больше нигде не используются.
+		 * Повторная триангуляция того же размера обходится без выделения памяти.
+		 *
+		 * Раз в TRIM_PERIOD вызовов запас сокращается до наибольшего использования
+		 * за этот период, чтобы одна большая триангуляция не удерживала память
+		 * навсегда.
+		 *
+		 * ВАЖНО!!! треугольники, полученные из кэша до reset, становятся
+		 * недействительными: их вершины и соседи сбрасываются.
+		 */
+		void reset();
+
+		/**
+		 * Треугольники, освобождённые reset(), для повторного использования в
+		 * DelaunayFactory::setTrianglePool
+		 */
+		[[nodiscard]] std::vector<std::shared_ptr<Triangle> >& trianglePool() noexcept;
+
+		/**
+		 * Добавляет в конец result треугольники кэша, для которых selected вернул
+		 * true, используя освобождённые узлы списков
+		 * @param selected
+		 * @param result
+		 */
+		void collectTriangles(
+				const std::function<bool(const Triangle&)>& selected,
+				std::list<std::shared_ptr<Triangle> >& result);
+
+		/**
+		 * Забирает узлы списка для повторного использования, например список,
+		 * который вернул createNewThreeTrianglesNearInnerVertex. Список становится
+		 * пустым.
+		 * @param triangles
+		 */
+		void recycle(std::list<std::shared_ptr<Triangle> >& triangles) noexcept;
+
+		/**
+		 * Записывает снимок кэша: вершины, треугольники с соседями, содержимое ячеек,
+		 * границы _minX.._maxY и размер сетки _m, до которого кэш вырос.
+		 * @param output - бинарный поток
+		 * @return
+		 */
+		bool save(std::ostream& output) const;
+
+		/**
+		 * Заменяет содержимое кэша снимком, записанным save(). Данные можно отобразить
+		 * в память, адрес должен быть выровнен хотя бы на 4 байта. Вершины и
+		 * треугольники создаются заново, поэтому после загрузки данные не нужны.
+		 * Прежнее содержимое сбрасывается как в reset().
+		 * @param data
+		 * @param size
+		 * @return false если снимок повреждён или записан на платформе с другим
+		 * порядком байтов; кэш при этом остаётся пустым
+		 */
+		bool load(const char* data, size_t size);
+		/**
+		 * Треугольник, в который или на ребро которого попадает vertex. Сначала
+		 * проверяются треугольники ячейки vertex, если ни один не подошёл (например,
+		 * из-за округления на границе ячейки), выполняется переход по соседям от
+		 * ближайшего из них.
+		 * @param vertex
+		 * @return пустой указатель если vertex совпадает с уже добавленной вершиной
+		 */
 		[[nodiscard]] std::shared_ptr<Triangle> findAppropriateTriangle(
 				const std::shared_ptr<Vertex2D>& vertex) const;
 
+		/**
+		 * Убирает из кэша треугольники, для которых released вернул true, и разрывает
+		 * их связи с соседями: оставшиеся соседи считают общее ребро границей. Нужно
+		 * для потоковой триангуляции, когда окончательные треугольники записываются
+		 * и освобождаются до окончания работы (см. StreamingService).
+		 * Узлы возвращённого списка можно вернуть кэшу через recycle.
+		 * @param released
+		 * @return убранные треугольники в порядке triangles()
+		 */
+		std::list<std::shared_ptr<Triangle> > releaseTriangles(
+				const std::function<bool(const Triangle&)>& released);
+
 		/**
 		 * НЕ РЕАЛИЗОВАНО!!!
 		 * Создаёт новые треугольники так, чтобы вся область триангуляции была выпуклой.
@@ -105,24 +258,80 @@ namespace delaunay
 				std::shared_ptr<Triangle>& triangle);
 
 	private:
+		/**
+		 * Освобождает запас сверх наибольшего использования за последние
+		 * TRIM_PERIOD вызовов reset()
+		 */
+		void trim();
+		/**
+		 * Добавляет triangle в конец списка, по возможности без выделения памяти
+		 */
+		void pushBack(
+				std::list<std::shared_ptr<Triangle> >& triangles,
+				const std::shared_ptr<Triangle>& triangle);
+		/**
+		 * Убирает элемент из списка, сохраняя его узел для pushBack
+		 * @return следующий элемент
+		 */
+		std::list<std::shared_ptr<Triangle> >::iterator erase(
+				std::list<std::shared_ptr<Triangle> >& triangles,
+				std::list<std::shared_ptr<Triangle> >::iterator i) noexcept;
 		bool initCache(float minX, float minY, float maxX, float maxY, int m);
 		bool needReInitCacheBySize() const noexcept;
 		void reInitCache();
 		void cacheTriangle(const std::shared_ptr<Triangle>& triangle);
 		void addToCache(const std::shared_ptr<Triangle>& triangle);
 		void removeFromCache(const std::shared_ptr<Triangle>& triangle);
+		/**
+		 * Вызывает function(i, j) для ячеек, которые пересекает треугольник. Для
+		 * длинных треугольников (например, с fake вершинами) это намного меньше
+		 * ячеек его габаритного прямоугольника.
+		 */
+		template<typename Function>
+		void forEachTriangleCell(const Triangle& triangle, Function function) const;
 		/**
 		 * По координатам x, y возвращает индекс в кэше
 		 */
 		void index(float x, float y, int& i, int& j) const noexcept;
+		/**
+		 * Переходит от triangle через рёбра, за которыми лежит vertex, пока vertex не
+		 * окажется внутри треугольника или на его ребре
+		 */
+		[[nodiscard]] std::shared_ptr<Triangle> walkToTriangle(
+				std::shared_ptr<Triangle> triangle,
+				const Vertex2D& vertex) const;
 		bool insertNewTriangleWithoutBoundaryRebuilding(
 				const std::shared_ptr<Triangle>& triangle);
-		void flipTriangles(
+		/**
+		 * @return false если flip невозможен
+		 */
+		bool flipTriangles(
 				std::shared_ptr<Triangle>& triangle,
 				int vertexNumber);
+		/**
+		 * Проверяет рёбра, противолежащие вершине vertex1 треугольника после flip,
+		 * и при необходимости продолжает flip дальше
+		 */
+		void propagateFlips(const std::shared_ptr<Triangle>& triangle);
 
+		// сетка не уменьшается при переходе к меньшему _m, используются ячейки
+		// [0, _m) x [0, _m)
 		std::vector<std::vector<CacheInfo> > _cache;
 		std::list<std::shared_ptr<Triangle> > _triangles;
+		// узлы списков с пустыми указателями, см. pushBack / erase
+		std::list<std::shared_ptr<Triangle> > _spareNodes;
+		std::vector<std::shared_ptr<Triangle> > _trianglePool;
+		// стек рёбер для propagateFlips
+		std::vector<std::pair<std::shared_ptr<Triangle>, int> > _flipStack;
+		std::vector<SkippedVertex> _skippedVertices;
+		// использование узлов списков с последнего reset()
+		size_t _usedNodes = 0;
+		size_t _peakUsedNodes = 0;
+		// наибольшее использование за текущий период TRIM_PERIOD
+		size_t _highWaterNodes = 0;
+		size_t _highWaterTriangles = 0;
+		size_t _highWaterCacheSize = 0;
+		int _resetCount = 0;
 //		std::unordered_map<int, std::shared_ptr<Vertex2D>> _vertices;
 		// минимум / максимум
 		float _minX = 0.0f;
@@ -139,6 +348,9 @@ namespace delaunay
 
 		int _m = 0;
 
+		int _nextTriangleId = 1;
+		bool _flipPropagation = false;
+
 	};
 }
 
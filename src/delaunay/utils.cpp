@@ -38,8 +38,8 @@ namespace delaunay
 		const float y2Difference = vertex1->y - vertex2->y;
 		const float x3Difference = vertex1->x - vertex3->x;
 		const float y3Difference = vertex1->y - vertex3->y;
-		const float sqrt1 = std::sqrtf(x2Difference * x2Difference + y2Difference * y2Difference);
-		const float sqrt2 = std::sqrtf(x3Difference * x3Difference + y3Difference * y3Difference);
+		const float sqrt1 = std::sqrt(x2Difference * x2Difference + y2Difference * y2Difference);
+		const float sqrt2 = std::sqrt(x3Difference * x3Difference + y3Difference * y3Difference);
 		const float top = (x2Difference * y3Difference) - (x3Difference * y2Difference);
 		// пытаемся вычислить углы внутри треугольника, поэтому принудительно возвращаем
 		// значения только положительные, где-то выше делаем проверку корректных значений
@@ -67,8 +67,8 @@ namespace delaunay
 		const float x2x1Difference = vertex2->x - vertex1->x;
 		const float y3y1Difference = vertex3->y - vertex1->y;
 		const float y2y1Difference = vertex2->y - vertex1->y;
-		const float sqrt1 = std::sqrtf(x3x1Difference * x3x1Difference + y3y1Difference * y3y1Difference);
-		const float sqrt2 = std::sqrtf(x2x1Difference * x2x1Difference + y2y1Difference * y2y1Difference);
+		const float sqrt1 = std::sqrt(x3x1Difference * x3x1Difference + y3y1Difference * y3y1Difference);
+		const float sqrt2 = std::sqrt(x2x1Difference * x2x1Difference + y2y1Difference * y2y1Difference);
 		const float top = (y3y1Difference * y2y1Difference) + (x3x1Difference * x2x1Difference);
 		// пытаемся вычислить углы внутри треугольника, поэтому принудительно возвращаем
 		// значения только положительные, где-то выше делаем проверку корректных значений
@@ -221,7 +221,9 @@ namespace delaunay
 		const float cAlfa = ((x0 - x1) * (y0 - y3)) - ((x0 - x3) * (y0 - y1));
 		const float cBetta = ((x2 - x3) * (y2 - y1)) - ((x2 - x1) * (y2 - y3));
 
-		return sAlfa * cBetta + cAlfa * sBetta >= 0;
+		// sin(alfa + betta) >= 0; знаки векторных произведений зависят от обхода
+		// треугольников, синусы углов - их модули
+		return sAlfa * std::fabs(cBetta) + std::fabs(cAlfa) * sBetta >= 0;
 	}
 
 	bool Utils::checkCircleEquation(
@@ -276,9 +278,13 @@ namespace delaunay
 		if (ok) {
 			*ok = true;
 		}
+		return distance(*vertex1, *vertex2);
+	}
 
-		const float xDifference = vertex2->x - vertex1->x;
-		const float yDifference = vertex2->y - vertex1->y;
+	float Utils::distance(const Vertex2D& vertex1, const Vertex2D& vertex2) noexcept
+	{
+		const float xDifference = vertex2.x - vertex1.x;
+		const float yDifference = vertex2.y - vertex1.y;
 		return std::sqrt((xDifference * xDifference) + (yDifference * yDifference));
 	}
 
@@ -310,32 +316,14 @@ namespace delaunay
 		innerTriangle->triangle1 = outerTriangle1;
 		innerTriangle->triangle2 = outerTriangle2;
 		innerTriangle->triangle3 = outerTriangle3;
-		if (commonRibNumber1 == 1) {
-			outerTriangle1->triangle1 = innerTriangle;
-		}
-		else if (commonRibNumber1 == 2) {
-			outerTriangle1->triangle2 = innerTriangle;
-		}
-		else if (commonRibNumber1 == 3) {
-			outerTriangle1->triangle3 = innerTriangle;
-		}
-		if (commonRibNumber2 == 1) {
-			outerTriangle2->triangle1 = innerTriangle;
-		}
-		else if (commonRibNumber2 == 2) {
-			outerTriangle2->triangle2 = innerTriangle;
-		}
-		else if (commonRibNumber2 == 3) {
-			outerTriangle2->triangle3 = innerTriangle;
-		}
-		if (commonRibNumber3 == 1) {
-			outerTriangle3->triangle1 = innerTriangle;
+		if (commonRibNumber1 > 0) {
+			outerTriangle1->neighbour(commonRibNumber1) = innerTriangle;
 		}
-		else if (commonRibNumber3 == 2) {
-			outerTriangle3->triangle2 = innerTriangle;
+		if (commonRibNumber2 > 0) {
+			outerTriangle2->neighbour(commonRibNumber2) = innerTriangle;
 		}
-		else if (commonRibNumber3 == 3) {
-			outerTriangle3->triangle3 = innerTriangle;
+		if (commonRibNumber3 > 0) {
+			outerTriangle3->neighbour(commonRibNumber3) = innerTriangle;
 		}
 		return true;
 	}
@@ -98,6 +98,8 @@ namespace delaunay
 				const std::shared_ptr<Vertex2D>& vertex2,
 				bool *ok) noexcept;
 
+		static float distance(const Vertex2D& vertex1, const Vertex2D& vertex2) noexcept;
+
 		/**
 		 * Связывает внутренний треугольник innerTriangle с внешними при этом
 		 * происходит проверка, что внутренний и внешний треугольник имеют общее ребро.
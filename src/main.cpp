@@ -1,18 +1,86 @@
 #include "delaunay/delaunay_service.h"
+#include "delaunay/triangulation_cache.h"
 #include "delaunay/vertex_2d.h"
+#include "tetrahedralization/tetrahedralization_service.h"
+#include "tetrahedralization/tetrahedron_writer.h"
+#include "triangulation/async_stream_buffer.h"
+#include "triangulation/batch_triangulation.h"
+#include "triangulation/binary_coordinates_file.h"
+#include "triangulation/binary_mesh_writer.h"
+#include "triangulation/compact_mesh_writer.h"
+#include "triangulation/convex_hull_service.h"
+#include "triangulation/coordinates_cache.h"
 #include "triangulation/coordinates_file_parser.h"
+#include "triangulation/cylindrical_projection.h"
+#include "triangulation/default_writer.h"
+#include "triangulation/legacy_projection.h"
+#include "triangulation/obj_writer.h"
+#include "triangulation/outlier_filter.h"
+#include "triangulation/parallel_writer.h"
+#include "triangulation/plane_projection.h"
+#include "triangulation/ply_writer.h"
+#include "triangulation/result_cache.h"
+#include "triangulation/spherical_projection.h"
+#include "triangulation/stl_writer.h"
+#include "triangulation/streaming_triangulation.h"
+#include "triangulation/tiled_triangulation.h"
 #include "triangulation/vertex_3d.h"
+#include "triangulation/voxel_thinning.h"
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 #include <algorithm>
 #include <string>
 #include <vector>
 #include <list>
-#include <set>
 
 
 static const std::string EMPTY_STRING;
 static const std::string DEFAULT_OUTPUT_FILENAME = "nodes_triangles.output";
+static const std::string BINARY_FILENAME_SUFFIX = ".bin";
+// имя файла для чтения из stdin / записи в stdout
+static const std::string STDIO_FILENAME = "-";
+static const std::string CONVERT_COMMAND = "convert";
+static const std::string BATCH_COMMAND = "batch";
+static const std::string TEXT_FORMAT = "text";
+static const std::string BINARY_FORMAT = "binary";
+static const std::string PLY_FORMAT = "ply";
+static const std::string OBJ_FORMAT = "obj";
+static const std::string STL_FORMAT = "stl";
+static const std::string COMPACT_FORMAT = "compact";
+static const std::string DELAUNAY_ENGINE = "delaunay";
+static const std::string HULL_ENGINE = "hull";
+static const std::string TETRAHEDRA_ENGINE = "tetra";
+static const std::string LEGACY_PROJECTION = "legacy";
+static const std::string PLANE_PROJECTION = "plane";
+static const std::string CYLINDRICAL_PROJECTION = "cylindrical";
+static const std::string SPHERICAL_PROJECTION = "spherical";
+static const size_t MAX_PRINTED_INVALID_LINES = 10;
+static const std::string CACHE_OPTION = "--cache";
+static const std::string SNAPSHOT_OPTION = "--snapshot";
+static const std::string RESULT_CACHE_OPTION = "--result-cache";
+static const std::string RESULT_CACHE_SIZE_OPTION = "--result-cache-size";
+static const std::string THIN_SPACING_OPTION = "--thin-spacing";
+static const std::string THIN_BUDGET_OPTION = "--thin-budget";
+static const std::string OUTLIERS_OPTION = "--remove-outliers";
+static const std::string OUTLIER_NEIGHBOURS_OPTION = "--outlier-neighbours";
+static const std::string OUTLIER_SIGMA_OPTION = "--outlier-sigma";
+static const std::string PROGRESSIVE_OPTION = "--progressive";
+static const std::string STREAMING_OPTION = "--streaming";
+static const std::string TILES_OPTION = "--tiles";
+static const std::string TILE_MARGIN_OPTION = "--tile-margin";
+static const size_t DEFAULT_OUTLIER_NEIGHBOURS = 8;
+static const double DEFAULT_OUTLIER_SIGMA = 2.0;
+static const unsigned long long DEFAULT_RESULT_CACHE_SIZE_MB = 1024;
+// параметры алгоритма, входящие в ключ кэша результатов; изменяется вместе
+// с алгоритмом триангуляции
+static const std::string RESULT_CACHE_ENGINE = "DelaunayService::iterativeDynamicProcess/2";
 
 class InputParser
 {
@@ -41,18 +109,520 @@ public:
 	{
 		return std::find(_tokens.begin(), _tokens.end(), option) != _tokens.end();
 	}
+
+	const std::string& command() const
+	{
+		if (!_tokens.empty() && _tokens.front().rfind('-', 0) != 0) {
+			return _tokens.front();
+		}
+		return EMPTY_STRING;
+	}
 };
 
 void usage()
 {
 	std::cout << "It creates bunch of triangles for input nodes (vertices)." << std::endl;
-	std::cout << "DelaunayTriangulation -i <input file name> [-o <output file name>]" << std::endl;
-	std::cout << "\t -i or --input \t Full path to input file" << std::endl;
-	std::cout << "\t -o or --output\t Full path to output file. Default name: " << DEFAULT_OUTPUT_FILENAME << std::endl;
+	std::cout << "DelaunayTriangulation -i <input file name> [-o <output file name>] [-f <output format>] [-e <engine>] [-p <projection>] [" << CACHE_OPTION << "]"
+			<< " [" << RESULT_CACHE_OPTION << " <directory> [" << RESULT_CACHE_SIZE_OPTION << " <megabytes>]]"
+			<< " [" << SNAPSHOT_OPTION << " <snapshot file name>]"
+			<< " [" << THIN_SPACING_OPTION << " <distance> | " << THIN_BUDGET_OPTION << " <number of vertices>]"
+			<< " [" << OUTLIERS_OPTION << " [" << OUTLIER_NEIGHBOURS_OPTION << " <k>] [" << OUTLIER_SIGMA_OPTION << " <sigma>]]"
+			<< " [" << PROGRESSIVE_OPTION << " <fraction>[,<fraction>...]] [" << STREAMING_OPTION << "]"
+			<< " [" << TILES_OPTION << " <columns>x<rows> [" << TILE_MARGIN_OPTION << " <distance>]]" << std::endl;
+	std::cout << "\t -i or --input \t Full path to input file or " << STDIO_FILENAME << " to read text from stdin" << std::endl;
+	std::cout << "\t -o or --output\t Full path to output file or " << STDIO_FILENAME << " to write to stdout. Default name: " << DEFAULT_OUTPUT_FILENAME << std::endl;
+	std::cout << "\t -f or --format\t Output file format: " << TEXT_FORMAT << " (default), " << BINARY_FORMAT
+			<< ", " << COMPACT_FORMAT << ", " << PLY_FORMAT << ", " << OBJ_FORMAT << " or " << STL_FORMAT << std::endl;
+	std::cout << "\t -e or --engine\t Triangulation engine: " << DELAUNAY_ENGINE << " (2D Delaunay triangulation of the projected vertices, default)"
+			<< ", " << HULL_ENGINE << " (3D convex hull for closed convex surfaces)"
+			<< " or " << TETRAHEDRA_ENGINE << " (3D Delaunay tetrahedralization, " << TEXT_FORMAT << " format only)" << std::endl;
+	std::cout << "\t -p or --projection Projection of the vertices onto the triangulation plane: " << LEGACY_PROJECTION
+			<< " (x * z, y * z, default), " << PLANE_PROJECTION << " (best-fit plane), "
+			<< CYLINDRICAL_PROJECTION << " or " << SPHERICAL_PROJECTION << " (unwrapping of a best-fit surface)" << std::endl;
+	std::cout << "\t " << CACHE_OPTION << "       \t Keep parsed text input in <input file name>"
+			<< triangulation::CoordinatesCache::FILE_SUFFIX << " and reuse it while the input is unchanged" << std::endl;
+	std::cout << "\t " << RESULT_CACHE_OPTION << "\t Reuse triangulations of identical vertex sets stored in the directory" << std::endl;
+	std::cout << "\t " << RESULT_CACHE_SIZE_OPTION << " Maximum size of the result cache directory. Default: "
+			<< DEFAULT_RESULT_CACHE_SIZE_MB << " MB" << std::endl;
+	std::cout << "\t " << SNAPSHOT_OPTION << "    \t Save the triangulation cache (topology and search grid) to reload it later."
+			<< " The result cache is not used with this option. The snapshot is loaded through the API only"
+			<< " (TriangulationCache::load, then DelaunayService::insertVertices)" << std::endl;
+	std::cout << "\t " << THIN_SPACING_OPTION << "\t Keep one vertex (the nearest to the center) per cube with the given side before triangulation" << std::endl;
+	std::cout << "\t " << THIN_BUDGET_OPTION << "\t Keep at most the given number of vertices choosing the cube side automatically" << std::endl;
+	std::cout << "\t " << OUTLIERS_OPTION << " Remove vertices whose mean distance to the k nearest neighbours exceeds"
+			<< " the average by more than sigma standard deviations. Defaults: k = " << DEFAULT_OUTLIER_NEIGHBOURS
+			<< ", sigma = " << DEFAULT_OUTLIER_SIGMA << std::endl;
+	std::cout << "\t " << PROGRESSIVE_OPTION << "  \t Insert vertices in random order and write intermediate meshes after the given"
+			<< " fractions of vertices, e.g. 0.01,0.1, to <output file name>.<percent>" << std::endl;
+	std::cout << "\t " << STREAMING_OPTION << "    \t Triangulate a text input sorted by grid cells with "
+			<< triangulation::StreamingTriangulation::GRID_TAG << " and " << triangulation::StreamingTriangulation::FINALIZE_TAG
+			<< " tags keeping only the active front in memory (" << TEXT_FORMAT << " format only)" << std::endl;
+	std::cout << "\t " << TILES_OPTION << "        \t Triangulate tiles with overlapping margins in parallel and stitch them into one mesh"
+			<< " keeping only the tiles in progress in memory (" << TEXT_FORMAT << " format only)" << std::endl;
+	std::cout << "\t " << TILE_MARGIN_OPTION << "  \t Margin of the tiles. Default: eight average distances between the vertices;"
+			<< " doubled automatically while the margins are too small" << std::endl;
+	std::cout << "Input file is either a text file or a binary file created by the convert command." << std::endl;
+	std::cout << std::endl;
+	std::cout << "It converts text input file to the binary format which is loaded without parsing." << std::endl;
+	std::cout << "DelaunayTriangulation " << CONVERT_COMMAND << " -i <input file name> [-o <output file name>] [--no-bbox]" << std::endl;
+	std::cout << "\t -o or --output\t Full path to output file. Default name: <input file name>" << BINARY_FILENAME_SUFFIX << std::endl;
+	std::cout << "\t --no-bbox     \t Do not store bounding box in the binary file header" << std::endl;
+	std::cout << std::endl;
+	std::cout << "It triangulates many small input files concurrently in one process." << std::endl;
+	std::cout << "DelaunayTriangulation " << BATCH_COMMAND << " -i <directory or list file> [-o <output directory>] [-f <output format>] [-p <projection>]" << std::endl;
+	std::cout << "\t -i or --input \t Directory with " << triangulation::BatchTriangulation::INPUT_FILE_EXTENSION
+			<< " files or a text file with one input file name per line" << std::endl;
+	std::cout << "\t -o or --output\t Directory for <input file name>" << triangulation::BatchTriangulation::OUTPUT_FILE_SUFFIX
+			<< " files and the " << triangulation::BatchTriangulation::SUMMARY_FILE_NAME
+			<< " summary with per-file timing. Default: next to the input files, summary in the current directory" << std::endl;
+}
+
+std::unique_ptr<triangulation::IFileWriter> createWriter(const std::string& format)
+{
+	if (format.empty() || format == TEXT_FORMAT) {
+		return std::make_unique<triangulation::ParallelWriter>();
+	}
+	else if (format == BINARY_FORMAT) {
+		return std::make_unique<triangulation::BinaryMeshWriter>();
+	}
+	else if (format == COMPACT_FORMAT) {
+		return std::make_unique<triangulation::CompactMeshWriter>();
+	}
+	else if (format == PLY_FORMAT) {
+		return std::make_unique<triangulation::PlyWriter>();
+	}
+	else if (format == OBJ_FORMAT) {
+		return std::make_unique<triangulation::ObjWriter>();
+	}
+	else if (format == STL_FORMAT) {
+		return std::make_unique<triangulation::StlWriter>();
+	}
+	return {};
+}
+
+std::unique_ptr<triangulation::IProjection> createProjection(const std::string& projection)
+{
+	if (projection.empty() || projection == LEGACY_PROJECTION) {
+		return std::make_unique<triangulation::LegacyProjection>();
+	}
+	else if (projection == PLANE_PROJECTION) {
+		return std::make_unique<triangulation::PlaneProjection>();
+	}
+	else if (projection == CYLINDRICAL_PROJECTION) {
+		return std::make_unique<triangulation::CylindricalProjection>();
+	}
+	else if (projection == SPHERICAL_PROJECTION) {
+		return std::make_unique<triangulation::SphericalProjection>();
+	}
+	return {};
+}
+
+/**
+ * Разбирает список долей через запятую, например "0.01,0.1,0.5"
+ * @return false, если есть доля вне интервала (0, 1)
+ */
+bool parseFractions(const std::string& text, std::vector<double>& fractions)
+{
+	std::istringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		try {
+			const double fraction = std::stod(item);
+			if (!(fraction > 0.0 && fraction < 1.0)) {
+				return false;
+			}
+			fractions.push_back(fraction);
+		}
+		catch (const std::exception&) {
+			return false;
+		}
+	}
+	return !fractions.empty();
+}
+
+bool loadCoordinates(
+		triangulation::CoordinatesFileParser& coordinatesParser,
+		const std::string& inputFileName)
+{
+	if (inputFileName == STDIO_FILENAME) {
+		if (!coordinatesParser.loadStream(std::cin)) {
+			return false;
+		}
+	}
+	else if (triangulation::BinaryCoordinatesFile::isBinaryFile(inputFileName)) {
+		return coordinatesParser.loadBinaryFile(inputFileName);
+	}
+	else if (!coordinatesParser.loadFile(inputFileName)) {
+		return false;
+	}
+	const std::vector<size_t>& invalidLines = coordinatesParser.invalidLines();
+	if (!invalidLines.empty()) {
+		std::cout << "Can not load lines: " << invalidLines.size() << " (line numbers:";
+		const size_t printedCount = std::min<size_t>(invalidLines.size(), MAX_PRINTED_INVALID_LINES);
+		for (size_t i = 0; i < printedCount; i++) {
+			std::cout << ' ' << invalidLines[i];
+		}
+		if (printedCount < invalidLines.size()) {
+			std::cout << " ...";
+		}
+		std::cout << ")" << std::endl;
+	}
+	return true;
+}
+
+/**
+ * Записывает сетку в файл или в standardOutput, если имя файла STDIO_FILENAME.
+ * Вывод идёт через AsyncStreamBuffer: пока writer форматирует следующую часть,
+ * фоновый поток записывает предыдущую.
+ */
+bool writeOutput(
+		triangulation::IFileWriter& writer,
+		const std::string& outputFileName,
+		std::ostream& standardOutput,
+		const std::vector<triangulation::Vertex3D>& coordinates,
+		const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+		const std::vector<bool>& usedVertices)
+{
+	std::fstream file;
+	if (outputFileName != STDIO_FILENAME) {
+		file.open(outputFileName, writer.isBinary()
+				? std::ios::out | std::ios::binary | std::ios::trunc
+				: std::ios::out);
+		if (!file.is_open()) {
+			return false;
+		}
+	}
+	std::ostream& target = outputFileName != STDIO_FILENAME ? file : standardOutput;
+	bool ok;
+	{
+		triangulation::AsyncStreamBuffer buffer(target);
+		std::ostream output(&buffer);
+		ok = writer.writeStream(output, coordinates, triangles, usedVertices);
+		ok = output.flush() && ok;
+	}
+	if (file.is_open()) {
+		file.close();
+	}
+	return ok && !target.fail();
+}
+
+/**
+ * Записывает тетраэдры в файл или в standardOutput, если имя файла STDIO_FILENAME
+ */
+bool writeTetrahedra(
+		const std::string& outputFileName,
+		std::ostream& standardOutput,
+		const std::vector<triangulation::Vertex3D>& coordinates,
+		const std::vector<tetrahedralization::Tetrahedron>& tetrahedra)
+{
+	std::fstream file;
+	if (outputFileName != STDIO_FILENAME) {
+		file.open(outputFileName, std::ios::out);
+		if (!file.is_open()) {
+			return false;
+		}
+	}
+	std::ostream& target = outputFileName != STDIO_FILENAME ? file : standardOutput;
+	bool ok;
+	{
+		triangulation::AsyncStreamBuffer buffer(target);
+		std::ostream output(&buffer);
+		tetrahedralization::TetrahedronWriter writer;
+		ok = writer.writeStream(output, coordinates, tetrahedra);
+		ok = output.flush() && ok;
+	}
+	if (file.is_open()) {
+		file.close();
+	}
+	return ok && !target.fail();
+}
+
+int convert(const InputParser& input, const std::string& inputFileName)
+{
+	std::string outputFileName = input.getCmdOption("-o");
+	if (outputFileName.empty()) {
+		outputFileName = input.getCmdOption("--output");
+		if (outputFileName.empty()) {
+			outputFileName = inputFileName + BINARY_FILENAME_SUFFIX;
+		}
+	}
+
+	std::cout << "Loading the input file..." << std::endl;
+	triangulation::CoordinatesFileParser coordinatesParser;
+	if (!loadCoordinates(coordinatesParser, inputFileName)) {
+		std::cout << "There is an error when loading input file. File can not be processed." << std::endl;
+		return -2;
+	}
+	std::cout << "Loaded number of coordinates: " << coordinatesParser.coordinates().size() << std::endl;
+
+	std::cout << "Writing binary file..." << std::endl;
+	if (!triangulation::BinaryCoordinatesFile::write(
+			outputFileName, coordinatesParser.coordinates(), !input.cmdOptionExists("--no-bbox"))) {
+		std::cout << "There is an error when writing binary file." << std::endl;
+		return -3;
+	}
+	std::cout << "Saved the binary file." << std::endl;
+	return 0;
+}
+
+/**
+ * Пакетная триангуляция (см. triangulation::BatchTriangulation)
+ */
+int batch(const InputParser& input, const std::string& inputFileName)
+{
+	std::string outputDirectory = input.getCmdOption("-o");
+	if (outputDirectory.empty()) {
+		outputDirectory = input.getCmdOption("--output");
+	}
+	std::string format = input.getCmdOption("-f");
+	if (format.empty()) {
+		format = input.getCmdOption("--format");
+	}
+	if (!createWriter(format)) {
+		std::cout << "Unknown output format: " << format << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	std::string projectionName = input.getCmdOption("-p");
+	if (projectionName.empty()) {
+		projectionName = input.getCmdOption("--projection");
+	}
+	if (!createProjection(projectionName)) {
+		std::cout << "Unknown projection: " << projectionName << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	for (const std::string& option : {std::string("-e"), std::string("--engine"), CACHE_OPTION, RESULT_CACHE_OPTION,
+			SNAPSHOT_OPTION, THIN_SPACING_OPTION, THIN_BUDGET_OPTION, OUTLIERS_OPTION, PROGRESSIVE_OPTION,
+			STREAMING_OPTION, TILES_OPTION}) {
+		if (input.cmdOptionExists(option)) {
+			std::cout << "Option " << option << " is not supported with the " << BATCH_COMMAND << " command." << std::endl << std::endl;
+			usage();
+			return -1;
+		}
+	}
+
+	std::vector<std::string> inputFileNames;
+	if (!triangulation::BatchTriangulation::listInputs(inputFileName, inputFileNames)) {
+		std::cout << "There is an error when reading the input directory or list file." << std::endl;
+		return -2;
+	}
+	std::cout << "Found number of input files: " << inputFileNames.size() << std::endl;
+	std::error_code error;
+	if (!outputDirectory.empty()) {
+		std::filesystem::create_directories(outputDirectory, error);
+	}
+	std::vector<triangulation::BatchJob> jobs(inputFileNames.size());
+	std::vector<std::string> outputFileNames;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		jobs[i].inputFileName = inputFileNames[i];
+		const std::string outputName = inputFileNames[i] + triangulation::BatchTriangulation::OUTPUT_FILE_SUFFIX;
+		jobs[i].outputFileName = outputDirectory.empty()
+				? outputName
+				: (std::filesystem::path(outputDirectory) / std::filesystem::path(outputName).filename()).string();
+		outputFileNames.push_back(jobs[i].outputFileName);
+	}
+	std::sort(outputFileNames.begin(), outputFileNames.end());
+	const auto duplicate = std::adjacent_find(outputFileNames.begin(), outputFileNames.end());
+	if (duplicate != outputFileNames.end()) {
+		std::cout << "Several input files have the same output file: " << *duplicate << std::endl;
+		return -1;
+	}
+
+	std::cout << "Building triangulations..." << std::endl;
+	triangulation::BatchTriangulation batchTriangulation(
+			[&format]() -> std::unique_ptr<triangulation::IFileWriter> {
+				// файлы и так записываются параллельно, поэтому без пула потоков ParallelWriter
+				if (format.empty() || format == TEXT_FORMAT) {
+					return std::make_unique<triangulation::DefaultWriter>();
+				}
+				return createWriter(format);
+			},
+			[&projectionName]() { return createProjection(projectionName); });
+	const size_t failedCount = batchTriangulation.process(jobs);
+	// сообщения выводятся после обработки в порядке заданий, а не потоков
+	for (const auto& job : jobs) {
+		if (!job.skippedVertices.empty()) {
+			std::cout << "File " << job.inputFileName << ":" << std::endl;
+			triangulation::writeSkippedVertices(std::cout, job.skippedVertices);
+		}
+		if (!job.ok) {
+			std::cout << "Failed file: " << job.inputFileName << " (" << job.error << ")." << std::endl;
+		}
+	}
+	std::cout << "Built number of triangulations: " << jobs.size() - failedCount << " of " << jobs.size() << std::endl;
+
+	const std::string summaryFileName = (std::filesystem::path(outputDirectory)
+			/ triangulation::BatchTriangulation::SUMMARY_FILE_NAME).string();
+	std::ofstream summary(summaryFileName, std::ios::out | std::ios::trunc);
+	if (!summary.is_open() || !triangulation::BatchTriangulation::writeSummary(summary, jobs)) {
+		std::cout << "There is an error when writing summary file." << std::endl;
+		return -3;
+	}
+	std::cout << "Saved the summary file " << summaryFileName << std::endl;
+	return failedCount == 0 ? 0 : -3;
+}
+
+/**
+ * Потоковая триангуляция (см. triangulation::StreamingTriangulation). Все вершины
+ * в памяти не хранятся, поэтому фильтры, кэши и проекции с fit() не поддерживаются.
+ */
+int streaming(
+		const InputParser& input,
+		const std::string& inputFileName,
+		const std::string& outputFileName,
+		const std::string& format,
+		const std::string& engine,
+		const triangulation::IProjection& projection)
+{
+	if ((!engine.empty() && engine != DELAUNAY_ENGINE) || (!format.empty() && format != TEXT_FORMAT)
+			|| projection.needsFit() || outputFileName == STDIO_FILENAME) {
+		std::cout << "Option " << STREAMING_OPTION << " supports only the " << DELAUNAY_ENGINE << " engine, the "
+				<< TEXT_FORMAT << " output format, projections without fitting and an output file name." << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	for (const std::string& option : {CACHE_OPTION, RESULT_CACHE_OPTION, SNAPSHOT_OPTION, THIN_SPACING_OPTION,
+			THIN_BUDGET_OPTION, OUTLIERS_OPTION, PROGRESSIVE_OPTION, TILES_OPTION}) {
+		if (input.cmdOptionExists(option)) {
+			std::cout << "Option " << option << " is not supported with " << STREAMING_OPTION << "." << std::endl << std::endl;
+			usage();
+			return -1;
+		}
+	}
+
+	std::ifstream file;
+	if (inputFileName != STDIO_FILENAME) {
+		file.open(inputFileName, std::ios::in);
+		if (!file.is_open()) {
+			std::cout << "There is an error when loading input file. File can not be processed." << std::endl;
+			return -2;
+		}
+	}
+	std::cout << "Building triangulation from the stream..." << std::endl;
+	triangulation::StreamingTriangulation triangulation(projection);
+	if (!triangulation.process(inputFileName != STDIO_FILENAME ? file : std::cin, outputFileName)) {
+		std::cout << "There is an error when triangulating the stream or writing output file." << std::endl;
+		return -3;
+	}
+	if (triangulation.invalidLineCount() > 0) {
+		std::cout << "Can not load lines: " << triangulation.invalidLineCount() << std::endl;
+	}
+	std::cout << "Loaded number of coordinates: " << triangulation.vertexCount() << std::endl;
+	std::cout << "Built number of triangles: " << triangulation.triangleCount()
+			<< " (at most " << triangulation.maxActiveTriangleCount() << " in memory)" << std::endl;
+	std::cout << "Saved the output file." << std::endl;
+	return 0;
+}
+
+/**
+ * Разбирает "<columns>x<rows>" или "<count>" для квадратной сетки тайлов
+ */
+bool parseTiles(const std::string& text, int& columns, int& rows)
+{
+	try {
+		size_t position = 0;
+		columns = std::stoi(text, &position);
+		rows = columns;
+		if (position < text.size()) {
+			if (text[position] != 'x') {
+				return false;
+			}
+			const std::string rowsText = text.substr(position + 1);
+			rows = std::stoi(rowsText, &position);
+			if (position != rowsText.size()) {
+				return false;
+			}
+		}
+	}
+	catch (const std::exception&) {
+		return false;
+	}
+	return columns > 0 && rows > 0;
+}
+
+/**
+ * Триангуляция по тайлам (см. triangulation::TiledTriangulation). Вершины
+ * раскладываются по временным файлам, поэтому, как и при потоковой
+ * триангуляции, фильтры, кэши и проекции с fit() не поддерживаются.
+ */
+int tiled(
+		const InputParser& input,
+		const std::string& inputFileName,
+		const std::string& outputFileName,
+		const std::string& format,
+		const std::string& engine,
+		const triangulation::IProjection& projection)
+{
+	if ((!engine.empty() && engine != DELAUNAY_ENGINE) || (!format.empty() && format != TEXT_FORMAT)
+			|| projection.needsFit() || outputFileName == STDIO_FILENAME) {
+		std::cout << "Option " << TILES_OPTION << " supports only the " << DELAUNAY_ENGINE << " engine, the "
+				<< TEXT_FORMAT << " output format, projections without fitting and an output file name." << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	for (const std::string& option : {CACHE_OPTION, RESULT_CACHE_OPTION, SNAPSHOT_OPTION, THIN_SPACING_OPTION,
+			THIN_BUDGET_OPTION, OUTLIERS_OPTION, PROGRESSIVE_OPTION, STREAMING_OPTION}) {
+		if (input.cmdOptionExists(option)) {
+			std::cout << "Option " << option << " is not supported with " << TILES_OPTION << "." << std::endl << std::endl;
+			usage();
+			return -1;
+		}
+	}
+	int columns = 0;
+	int rows = 0;
+	const std::string& tilesOption = input.getCmdOption(TILES_OPTION);
+	if (!parseTiles(tilesOption, columns, rows)) {
+		std::cout << "Invalid tiles for " << TILES_OPTION << ": " << tilesOption << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	double margin = 0.0;
+	const std::string& marginOption = input.getCmdOption(TILE_MARGIN_OPTION);
+	try {
+		if (!marginOption.empty()) {
+			margin = std::stod(marginOption);
+		}
+	}
+	catch (const std::exception&) {
+		margin = -1.0;
+	}
+	if (margin < 0.0 || (input.cmdOptionExists(TILE_MARGIN_OPTION) && !(margin > 0.0))) {
+		std::cout << "Invalid margin for " << TILE_MARGIN_OPTION << ": " << marginOption << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+
+	std::ifstream file;
+	if (inputFileName != STDIO_FILENAME) {
+		file.open(inputFileName, std::ios::in);
+		if (!file.is_open()) {
+			std::cout << "There is an error when loading input file. File can not be processed." << std::endl;
+			return -2;
+		}
+	}
+	std::cout << "Building triangulation by " << columns << "x" << rows << " tiles..." << std::endl;
+	triangulation::TiledTriangulation triangulation(projection, columns, rows, margin);
+	if (!triangulation.process(inputFileName != STDIO_FILENAME ? file : std::cin, outputFileName)) {
+		std::cout << "There is an error when triangulating the tiles or writing output file." << std::endl;
+		return -3;
+	}
+	if (triangulation.invalidLineCount() > 0) {
+		std::cout << "Can not load lines: " << triangulation.invalidLineCount() << std::endl;
+	}
+	std::cout << "Loaded number of coordinates: " << triangulation.vertexCount() << std::endl;
+	std::cout << "Built number of triangles: " << triangulation.triangleCount()
+			<< " (tile margin " << triangulation.usedMargin() << ")" << std::endl;
+	std::cout << "Saved the output file." << std::endl;
+	return 0;
 }
 
 int main(int argc, char* argv[])
 {
+	// stdin и stdout используются только через iostream, поэтому синхронизация
+	// с stdio не нужна и лишь замедляет чтение и запись
+	std::ios::sync_with_stdio(false);
+
 	InputParser input(argc, argv);
 	if (input.cmdOptionExists("-h") || input.cmdOptionExists("--help")) {
 		usage();
@@ -68,6 +638,18 @@ int main(int argc, char* argv[])
 		usage();
 		return -1;
 	}
+	const std::string& command = input.command();
+	if (command == CONVERT_COMMAND) {
+		return convert(input, inputFileName);
+	}
+	else if (command == BATCH_COMMAND) {
+		return batch(input, inputFileName);
+	}
+	else if (!command.empty()) {
+		std::cout << "Unknown command: " << command << std::endl << std::endl;
+		usage();
+		return -1;
+	}
 	std::string outputFileName = input.getCmdOption("-o");
 	if (outputFileName.empty()) {
 		outputFileName = input.getCmdOption("--output");
@@ -75,31 +657,305 @@ int main(int argc, char* argv[])
 			outputFileName = DEFAULT_OUTPUT_FILENAME;
 		}
 	}
+	std::string format = input.getCmdOption("-f");
+	if (format.empty()) {
+		format = input.getCmdOption("--format");
+	}
+	std::unique_ptr<triangulation::IFileWriter> writer = createWriter(format);
+	if (!writer) {
+		std::cout << "Unknown output format: " << format << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	std::string projectionName = input.getCmdOption("-p");
+	if (projectionName.empty()) {
+		projectionName = input.getCmdOption("--projection");
+	}
+	std::unique_ptr<triangulation::IProjection> projection = createProjection(projectionName);
+	if (!projection) {
+		std::cout << "Unknown projection: " << projectionName << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	std::string engine = input.getCmdOption("-e");
+	if (engine.empty()) {
+		engine = input.getCmdOption("--engine");
+	}
+	if (!engine.empty() && engine != DELAUNAY_ENGINE && engine != HULL_ENGINE && engine != TETRAHEDRA_ENGINE) {
+		std::cout << "Unknown engine: " << engine << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	const bool hullEngine = engine == HULL_ENGINE;
+	const bool tetrahedraEngine = engine == TETRAHEDRA_ENGINE;
+	if ((hullEngine || tetrahedraEngine)
+			&& (input.cmdOptionExists(RESULT_CACHE_OPTION) || input.cmdOptionExists(SNAPSHOT_OPTION)
+				|| input.cmdOptionExists(PROGRESSIVE_OPTION))) {
+		std::cout << "Options " << RESULT_CACHE_OPTION << ", " << SNAPSHOT_OPTION << " and " << PROGRESSIVE_OPTION
+				<< " are supported only by the " << DELAUNAY_ENGINE << " engine." << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	if (tetrahedraEngine && !format.empty() && format != TEXT_FORMAT) {
+		std::cout << "The " << TETRAHEDRA_ENGINE << " engine supports only the " << TEXT_FORMAT
+				<< " output format." << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	std::vector<double> progressiveFractions;
+	const bool progressive = input.cmdOptionExists(PROGRESSIVE_OPTION);
+	if (progressive) {
+		const std::string& fractionsOption = input.getCmdOption(PROGRESSIVE_OPTION);
+		if (!parseFractions(fractionsOption, progressiveFractions)) {
+			std::cout << "Invalid fractions for " << PROGRESSIVE_OPTION << ": " << fractionsOption << std::endl << std::endl;
+			usage();
+			return -1;
+		}
+		if (outputFileName == STDIO_FILENAME) {
+			std::cout << "Option " << PROGRESSIVE_OPTION << " needs an output file name." << std::endl << std::endl;
+			usage();
+			return -1;
+		}
+	}
+	// При записи результата в stdout все сообщения (в том числе сообщения
+	// библиотеки триангуляции) перенаправляются в stderr
+	std::ostream standardOutput(std::cout.rdbuf());
+	if (outputFileName == STDIO_FILENAME) {
+		std::cout.rdbuf(std::cerr.rdbuf());
+#ifdef _WIN32
+		if (writer->isBinary()) {
+			_setmode(_fileno(stdout), _O_BINARY);
+		}
+#endif
+	}
+
+	double thinSpacing = 0.0;
+	size_t thinBudget = 0;
+	const std::string& thinSpacingOption = input.getCmdOption(THIN_SPACING_OPTION);
+	const std::string& thinBudgetOption = input.getCmdOption(THIN_BUDGET_OPTION);
+	try {
+		if (!thinSpacingOption.empty()) {
+			thinSpacing = std::stod(thinSpacingOption);
+		}
+		if (!thinBudgetOption.empty()) {
+			thinBudget = std::stoull(thinBudgetOption);
+		}
+	}
+	catch (const std::exception&) {
+		std::cout << "Invalid thinning parameter: " << thinSpacingOption << thinBudgetOption << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	if (thinSpacing < 0.0 || (!thinSpacingOption.empty() && !thinBudgetOption.empty())) {
+		std::cout << "Use either " << THIN_SPACING_OPTION << " with a positive distance or "
+				<< THIN_BUDGET_OPTION << "." << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	const bool thinning = thinSpacing > 0.0 || thinBudget > 0;
+	const bool removeOutliers = input.cmdOptionExists(OUTLIERS_OPTION);
+	size_t outlierNeighbours = DEFAULT_OUTLIER_NEIGHBOURS;
+	double outlierSigma = DEFAULT_OUTLIER_SIGMA;
+	const std::string& outlierNeighboursOption = input.getCmdOption(OUTLIER_NEIGHBOURS_OPTION);
+	const std::string& outlierSigmaOption = input.getCmdOption(OUTLIER_SIGMA_OPTION);
+	try {
+		if (!outlierNeighboursOption.empty()) {
+			outlierNeighbours = std::stoull(outlierNeighboursOption);
+		}
+		if (!outlierSigmaOption.empty()) {
+			outlierSigma = std::stod(outlierSigmaOption);
+		}
+	}
+	catch (const std::exception&) {
+		std::cout << "Invalid outlier filter parameter: " << outlierNeighboursOption << outlierSigmaOption << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+	if (outlierNeighbours == 0) {
+		std::cout << "Number of neighbours for the outlier filter must be positive." << std::endl << std::endl;
+		usage();
+		return -1;
+	}
+
+	if (input.cmdOptionExists(STREAMING_OPTION)) {
+		return streaming(input, inputFileName, outputFileName, format, engine, *projection);
+	}
+	if (input.cmdOptionExists(TILES_OPTION)) {
+		return tiled(input, inputFileName, outputFileName, format, engine, *projection);
+	}
 
 	std::cout << "Loading the input file..." << std::endl;
 	triangulation::CoordinatesFileParser coordinatesParser;
-	if (!coordinatesParser.loadFile(inputFileName)) {
+	// Вершины проецируются по мере загрузки частей файла, пока следующие части
+	// разбираются в пуле потоков. Проекциям, параметры которых зависят от всех
+	// вершин, удалению выбросов и прореживанию нужен весь файл.
+	std::list<std::shared_ptr<delaunay::Vertex2D> > vertices;
+	// выпуклой оболочке и тетраэдризации проекция не нужна
+	const bool projected = !hullEngine && !tetrahedraEngine;
+	if (projected && !projection->needsFit() && !thinning && !removeOutliers) {
+		coordinatesParser.setChunkHandler([&vertices, &projection](const triangulation::Vertex3D* coordinates, size_t count) {
+			triangulation::projectVertex3D(*projection, coordinates, count, vertices);
+		});
+	}
+	coordinatesParser.setUseCache(input.cmdOptionExists(CACHE_OPTION));
+	if (!loadCoordinates(coordinatesParser, inputFileName)) {
 		std::cout << "There is an error when loading input file. File can not be processed." << std::endl;
 		return -2;
 	}
-	std::list<triangulation::Vertex3D> coordinates = coordinatesParser.coordinates();
-	std::cout << "Loaded number of coordinates: " << coordinates.size() << std::endl << std::flush;
+	if (coordinatesParser.isLoadedFromCache()) {
+		std::cout << "Loaded from the cache file." << std::endl;
+	}
+	std::cout << "Loaded number of coordinates: " << coordinatesParser.coordinates().size() << std::endl << std::flush;
 
-	std::cout << "Building triangulation..." << std::endl;
-	bool ok;
-	std::list<std::shared_ptr<delaunay::Vertex2D> > vertices = projectVertex3D(coordinates);
-	::delaunay::DelaunayService service;
-	std::list<std::shared_ptr<delaunay::Triangle> > triangles =
-			service.iterativeDynamicProcess(vertices, &ok);
-	std::set<int> usedVertexIds = ::delaunay::DelaunayService::vertexIds(triangles);
+	// оставшиеся после фильтров вершины сохраняют свои id, поэтому выходной файл
+	// ссылается на номера вершин исходного файла
+	std::vector<triangulation::Vertex3D> filteredCoordinates;
+	if (removeOutliers) {
+		triangulation::OutlierFilter filter(outlierNeighbours, outlierSigma, 0);
+		std::vector<int> removedIds;
+		filteredCoordinates = filter.filter(coordinatesParser.coordinates(), removedIds);
+		for (int id : removedIds) {
+			std::cout << "Removed vertex: " << id << " (outlier)." << std::endl;
+		}
+		std::cout << "Removed number of outliers: " << removedIds.size() << std::endl << std::flush;
+	}
+	if (thinning) {
+		triangulation::VoxelThinning thinner(0);
+		const std::vector<triangulation::Vertex3D>& source = removeOutliers ? filteredCoordinates : coordinatesParser.coordinates();
+		if (thinBudget > 0) {
+			thinSpacing = thinner.spacingForBudget(source, thinBudget);
+		}
+		filteredCoordinates = thinner.thin(source, thinSpacing);
+		std::cout << "Thinned number of coordinates: " << filteredCoordinates.size()
+				<< " (cube side " << thinSpacing << ")" << std::endl << std::flush;
+	}
+	const bool filtered = removeOutliers || thinning;
+	const std::vector<triangulation::Vertex3D>& coordinates = filtered ? filteredCoordinates : coordinatesParser.coordinates();
+	if (projected && (projection->needsFit() || filtered)) {
+		if (projection->needsFit()) {
+			projection->fit(coordinates.data(), coordinates.size());
+		}
+		triangulation::projectVertex3D(*projection, coordinates.data(), coordinates.size(), vertices);
+	}
+
+	if (tetrahedraEngine) {
+		std::cout << "Building tetrahedralization..." << std::endl;
+		bool ok;
+		tetrahedralization::TetrahedralizationService service;
+		const std::vector<tetrahedralization::Tetrahedron> tetrahedra = service.process(coordinates, &ok);
+		if (!ok) {
+			std::cout << "There is no tetrahedralization: all vertices lie in one plane." << std::endl;
+			return -4;
+		}
+		std::cout << "Built number of tetrahedra: " << tetrahedra.size() << std::endl << std::flush;
+
+		std::cout << "Writing output file..." << std::endl;
+		if (!writeTetrahedra(outputFileName, standardOutput, coordinates, tetrahedra)) {
+			std::cout << "There is an error when writing output file." << std::endl;
+			return -3;
+		}
+		std::cout << "Saved the output file." << std::endl;
+		return 0;
+	}
+
+	std::unique_ptr<triangulation::ResultCache> resultCache;
+	triangulation::ResultCache::Key resultKey;
+	const std::string& resultCacheDirectory = input.getCmdOption(RESULT_CACHE_OPTION);
+	if (!resultCacheDirectory.empty() && progressive) {
+		// промежуточные сетки нельзя взять из кэша, а итоговая зависит от порядка
+		// добавления вершин, поэтому прогрессивный режим кэш не использует
+		std::cout << "Option " << RESULT_CACHE_OPTION << " is ignored with " << PROGRESSIVE_OPTION << "." << std::endl;
+	}
+	else if (!resultCacheDirectory.empty()) {
+		unsigned long long maxSize = DEFAULT_RESULT_CACHE_SIZE_MB;
+		const std::string& maxSizeOption = input.getCmdOption(RESULT_CACHE_SIZE_OPTION);
+		if (!maxSizeOption.empty()) {
+			try {
+				maxSize = std::stoull(maxSizeOption);
+			}
+			catch (const std::exception&) {
+				std::cout << "Invalid result cache size: " << maxSizeOption << std::endl << std::endl;
+				usage();
+				return -1;
+			}
+		}
+		resultCache = std::make_unique<triangulation::ResultCache>(resultCacheDirectory, maxSize * 1024 * 1024);
+		resultKey = triangulation::ResultCache::key(vertices, RESULT_CACHE_ENGINE);
+	}
+
+	const std::string& snapshotFileName = input.getCmdOption(SNAPSHOT_OPTION);
+	std::list<std::shared_ptr<delaunay::Triangle> > triangles;
+	if (hullEngine) {
+		std::cout << "Building convex hull..." << std::endl;
+		bool ok;
+		// пул потоков используется только для больших файлов
+		triangulation::ConvexHullService service(0);
+		triangles = service.process(coordinates, &ok);
+		if (!ok) {
+			std::cout << "There is no convex hull: all vertices lie in one plane." << std::endl;
+			return -4;
+		}
+	}
+	else if (resultCache && snapshotFileName.empty() && resultCache->load(resultKey, vertices, triangles)) {
+		std::cout << "Loaded triangulation from the result cache." << std::endl;
+	}
+	else {
+		std::cout << "Building triangulation..." << std::endl;
+		bool ok;
+		::delaunay::DelaunayService service;
+		::delaunay::TriangulationCache cache;
+		if (progressive) {
+			// промежуточные сетки записываются тем же writer в <output>.<процент>
+			bool snapshotsOk = true;
+			triangles = service.progressiveProcess(vertices, progressiveFractions,
+					[&](double fraction, const std::list<std::shared_ptr<delaunay::Triangle> >& current) {
+						std::ostringstream fileName;
+						fileName << outputFileName << '.' << fraction * 100.0;
+						const std::vector<bool> used =
+								::delaunay::DelaunayService::usedVertices(current, coordinates.size());
+						if (!writeOutput(*writer, fileName.str(), standardOutput, coordinates, current, used)) {
+							snapshotsOk = false;
+							std::cout << "There is an error when writing intermediate file " << fileName.str() << std::endl;
+							return;
+						}
+						std::cout << "Saved intermediate file " << fileName.str() << " (" << current.size()
+								<< " triangles)." << std::endl << std::flush;
+					},
+					cache, &ok);
+			if (!snapshotsOk) {
+				return -3;
+			}
+		}
+		else {
+			triangles = service.iterativeDynamicProcess(vertices, cache, &ok);
+		}
+		triangulation::writeSkippedVertices(std::cout, cache.skippedVertices(), coordinates);
+		if (resultCache && ok && !resultCache->store(resultKey, triangles)) {
+			std::cout << "Can not save triangulation to the result cache." << std::endl;
+		}
+		if (!snapshotFileName.empty()) {
+			std::ofstream snapshot(snapshotFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!snapshot.is_open() || !cache.save(snapshot) || !snapshot.flush()) {
+				std::cout << "There is an error when writing snapshot file." << std::endl;
+				return -3;
+			}
+			std::cout << "Saved the snapshot file." << std::endl;
+		}
+	}
+	const std::vector<bool> usedVertices =
+			::delaunay::DelaunayService::usedVertices(triangles, coordinates.size());
 	std::cout << "Built number of triangles: " << triangles.size() << std::endl << std::flush;
 
 	std::cout << "Writing output file..." << std::endl;
-	if (!coordinatesParser.writeFile(outputFileName, coordinates, triangles, usedVertexIds)) {
+	if (!writeOutput(*writer, outputFileName, standardOutput, coordinates, triangles, usedVertices)) {
 		std::cout << "There is an error when writing output file." << std::endl;
 		return -3;
 	}
 	std::cout << "Saved the output file." << std::endl;
+	if (resultCache) {
+		std::cout << "Result cache: hits " << resultCache->hits()
+				<< ", misses " << resultCache->misses() << std::endl;
+	}
 
 	return 0;
 }
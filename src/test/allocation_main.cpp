@@ -0,0 +1,10 @@
+#include "allocation_test.h"
+
+
+int main()
+{
+	test::delaunay::AllocationTest allocationTest;
+	allocationTest.testProcess();
+
+	return 0;
+}
@@ -0,0 +1,223 @@
+#include "allocation_test.h"
+
+#include "delaunay/delaunay_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <new>
+#include <vector>
+
+
+namespace
+{
+	// число выделений памяти во всей программе
+	std::atomic<size_t> allocationCount(0);
+
+	// fakeSquareStep1 при каждом запуске создаёт вектор и четыре fake вершины
+	// (Utils::createVerticesAsRectangle), список из четырёх узлов для
+	// Utils::createFirstTriangle и список из двух узлов для
+	// insertFirstTrianglesWithSameRectangle
+	const size_t STEADY_STATE_ALLOCATIONS = 11;
+
+	void* allocate(size_t size) noexcept
+	{
+		allocationCount++;
+		return std::malloc(size > 0 ? size : 1);
+	}
+
+	void* allocate(size_t size, std::align_val_t alignment) noexcept
+	{
+		allocationCount++;
+		const auto align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+		return _aligned_malloc(size > 0 ? size : 1, align);
+#else
+		// размер для aligned_alloc должен быть кратен выравниванию
+		const size_t alignedSize = (std::max<size_t>(size, 1) + align - 1) / align * align;
+		return std::aligned_alloc(align, alignedSize);
+#endif
+	}
+
+	void deallocate(void* pointer) noexcept
+	{
+		std::free(pointer);
+	}
+
+	void deallocate(void* pointer, std::align_val_t) noexcept
+	{
+#ifdef _MSC_VER
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+
+	void* allocateOrThrow(size_t size)
+	{
+		void* result = allocate(size);
+		if (!result) {
+			throw std::bad_alloc();
+		}
+		return result;
+	}
+
+	void* allocateOrThrow(size_t size, std::align_val_t alignment)
+	{
+		void* result = allocate(size, alignment);
+		if (!result) {
+			throw std::bad_alloc();
+		}
+		return result;
+	}
+}
+
+// заменяются все формы, чтобы выделение и освобождение всегда шли через одну
+// пару функций
+
+void* operator new(size_t size)
+{
+	return allocateOrThrow(size);
+}
+
+void* operator new[](size_t size)
+{
+	return allocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocate(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept
+{
+	deallocate(pointer, alignment);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+	deallocate(pointer, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer, alignment);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer, alignment);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(pointer, alignment);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(pointer, alignment);
+}
+
+namespace test::delaunay
+{
+	void AllocationTest::testProcess()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const int vertexCount = 2000;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint64_t seed = 54321;
+			for (int i = 0; i < vertexCount; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->x = static_cast<double>(seed >> 40) / (1 << 24) * 100.0;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->y = static_cast<double>(seed >> 40) / (1 << 24) * 100.0;
+				vertices.push_back(vertex);
+			}
+
+			bool ok;
+			::delaunay::DelaunayService delaunayService;
+			// запусков больше периода сокращения запаса в TriangulationCache::reset
+			std::vector<size_t> allocations;
+			for (int run = 0; run < 20; run++) {
+				const size_t before = allocationCount;
+				delaunayService.process(vertices, &ok);
+				allocations.push_back(allocationCount - before);
+				DELAUNAY_TEST(ok);
+			}
+			// первый запуск заполняет пул, при втором растёт вектор пула в reset(),
+			// дальше выделяется только память под fake прямоугольник
+			DELAUNAY_TEST(allocations[0] > static_cast<size_t>(vertexCount));
+			DELAUNAY_TEST(allocations[1] < static_cast<size_t>(vertexCount));
+			for (size_t run = 2; run < allocations.size(); run++) {
+				DELAUNAY_TEST(allocations[run] == STEADY_STATE_ALLOCATIONS);
+			}
+		DELAUNAY_TEST_END();
+	}
+
+}
@@ -0,0 +1,26 @@
+#ifndef TEST_ALLOCATION_TEST_H
+#define TEST_ALLOCATION_TEST_H
+
+
+namespace test::delaunay
+{
+	/**
+	 * Проверки числа выделений памяти. Собираются в отдельную программу
+	 * DelaunayAllocationTest, так как заменяют глобальные operator new / delete.
+	 */
+	class AllocationTest
+	{
+	public:
+		AllocationTest() = default;
+		~AllocationTest() = default;
+		AllocationTest(const AllocationTest&) = delete;
+		AllocationTest(AllocationTest&&) = delete;
+		AllocationTest & operator=(const AllocationTest&) = delete;
+		AllocationTest & operator=(AllocationTest&&) = delete;
+
+		void testProcess();
+
+	};
+}
+
+#endif //TEST_ALLOCATION_TEST_H
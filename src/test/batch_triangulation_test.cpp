@@ -0,0 +1,207 @@
+#include "batch_triangulation_test.h"
+
+#include "delaunay/delaunay_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/batch_triangulation.h"
+#include "triangulation/default_writer.h"
+#include "triangulation/legacy_projection.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		const char* const DIRECTORY = "batch_triangulation_test";
+		const int FILE_COUNT = 5;
+
+		/**
+		 * Записывает файл из count псевдослучайных вершин
+		 */
+		std::vector<::triangulation::Vertex3D> writeInput(const std::string& fileName, int count, uint32_t seed)
+		{
+			std::vector<::triangulation::Vertex3D> coordinates;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 10000) / 100.0f;
+			};
+			std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+			for (int i = 0; i < count; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = i + 1;
+				vertex.x = random();
+				vertex.y = random();
+				vertex.z = 1.0f;
+				coordinates.push_back(vertex);
+				file << vertex.id << ", " << vertex.x << ", " << vertex.y << ", " << vertex.z << '\n';
+			}
+			return coordinates;
+		}
+
+		std::string readFile(const std::string& fileName)
+		{
+			std::ifstream file(fileName, std::ios::in | std::ios::binary);
+			return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		std::unique_ptr<::triangulation::IFileWriter> createWriter()
+		{
+			return std::make_unique<::triangulation::DefaultWriter>();
+		}
+
+		std::unique_ptr<::triangulation::IProjection> createProjection()
+		{
+			return std::make_unique<::triangulation::LegacyProjection>();
+		}
+	}
+
+	void BatchTriangulationTest::testDirectory()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::filesystem::remove_all(DIRECTORY);
+			std::filesystem::create_directories(DIRECTORY);
+			std::vector<std::string> expected;
+			for (int i = 0; i < FILE_COUNT; i++) {
+				const std::string fileName = (std::filesystem::path(DIRECTORY) / ("part" + std::to_string(i) + ".xyz")).string();
+				// файлы разного размера, чтобы потоки брали их не по порядку
+				const std::vector<::triangulation::Vertex3D> coordinates = writeInput(fileName, 50 + 100 * (i % 3), 100 + i);
+				::triangulation::LegacyProjection projection;
+				std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+				::triangulation::projectVertex3D(projection, coordinates.data(), coordinates.size(), vertices);
+				::delaunay::DelaunayService service;
+				bool ok;
+				const auto triangles = service.iterativeDynamicProcess(vertices, &ok);
+				DELAUNAY_TEST(ok);
+				std::ostringstream output;
+				::triangulation::DefaultWriter writer;
+				DELAUNAY_TEST(writer.writeStream(output, coordinates, triangles,
+						::delaunay::DelaunayService::usedVertices(triangles, coordinates.size())));
+				expected.push_back(output.str());
+			}
+			std::ofstream(std::filesystem::path(DIRECTORY) / "notes.txt") << "not an input\n";
+
+			std::vector<std::string> inputFileNames;
+			DELAUNAY_TEST(::triangulation::BatchTriangulation::listInputs(DIRECTORY, inputFileNames));
+			DELAUNAY_TEST(inputFileNames.size() == FILE_COUNT);
+			DELAUNAY_TEST(std::is_sorted(inputFileNames.begin(), inputFileNames.end()));
+
+			std::vector<::triangulation::BatchJob> jobs(inputFileNames.size());
+			for (size_t i = 0; i < jobs.size(); i++) {
+				jobs[i].inputFileName = inputFileNames[i];
+				jobs[i].outputFileName = inputFileNames[i] + ::triangulation::BatchTriangulation::OUTPUT_FILE_SUFFIX;
+			}
+			::triangulation::BatchTriangulation batch(createWriter, createProjection, 2);
+			DELAUNAY_TEST(batch.process(jobs) == 0);
+			// результат совпадает с триангуляцией каждого файла отдельно
+			for (size_t i = 0; i < jobs.size(); i++) {
+				DELAUNAY_TEST(jobs[i].ok);
+				DELAUNAY_TEST(jobs[i].vertexCount == static_cast<size_t>(50 + 100 * (i % 3)));
+				DELAUNAY_TEST(jobs[i].triangleCount > 0);
+				DELAUNAY_TEST(readFile(jobs[i].outputFileName) == expected[i]);
+			}
+
+			std::ostringstream summary;
+			DELAUNAY_TEST(::triangulation::BatchTriangulation::writeSummary(summary, jobs));
+			const std::string text = summary.str();
+			DELAUNAY_TEST(std::count(text.begin(), text.end(), '\n') == FILE_COUNT + 1);
+			std::filesystem::remove_all(DIRECTORY);
+		DELAUNAY_TEST_END();
+	}
+
+	void BatchTriangulationTest::testManifest()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::filesystem::remove_all(DIRECTORY);
+			std::filesystem::create_directories(DIRECTORY);
+			writeInput((std::filesystem::path(DIRECTORY) / "first.xyz").string(), 100, 1);
+			const std::string manifestFileName = (std::filesystem::path(DIRECTORY) / "manifest.txt").string();
+			std::ofstream(manifestFileName) << "# inputs\n\nfirst.xyz\n  missing.xyz  \n";
+
+			std::vector<std::string> inputFileNames;
+			DELAUNAY_TEST(::triangulation::BatchTriangulation::listInputs(manifestFileName, inputFileNames));
+			DELAUNAY_TEST(inputFileNames.size() == 2);
+			// относительные пути отсчитываются от каталога списка
+			DELAUNAY_TEST(inputFileNames[0] == (std::filesystem::path(DIRECTORY) / "first.xyz").string());
+
+			std::vector<::triangulation::BatchJob> jobs(inputFileNames.size());
+			for (size_t i = 0; i < jobs.size(); i++) {
+				jobs[i].inputFileName = inputFileNames[i];
+				jobs[i].outputFileName = inputFileNames[i] + ::triangulation::BatchTriangulation::OUTPUT_FILE_SUFFIX;
+			}
+			::triangulation::BatchTriangulation batch(createWriter, createProjection, 2);
+			DELAUNAY_TEST(batch.process(jobs) == 1);
+			DELAUNAY_TEST(jobs[0].ok);
+			DELAUNAY_TEST(!jobs[1].ok);
+			DELAUNAY_TEST(!std::filesystem::exists(jobs[1].outputFileName));
+
+			std::vector<std::string> none;
+			DELAUNAY_TEST(!::triangulation::BatchTriangulation::listInputs(
+					(std::filesystem::path(DIRECTORY) / "missing.txt").string(), none));
+			std::filesystem::remove_all(DIRECTORY);
+		DELAUNAY_TEST_END();
+	}
+
+	void BatchTriangulationTest::testDegenerateInput()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::filesystem::remove_all(DIRECTORY);
+			std::filesystem::create_directories(DIRECTORY);
+			// запятая в имени файла не должна разбивать строку сводки
+			const std::string commaFileName = (std::filesystem::path(DIRECTORY) / "first,part.xyz").string();
+			writeInput(commaFileName, 100, 7);
+			// из двух вершин треугольник не построить
+			const std::string degenerateFileName = (std::filesystem::path(DIRECTORY) / "two.xyz").string();
+			writeInput(degenerateFileName, 2, 8);
+
+			std::vector<std::string> inputFileNames;
+			DELAUNAY_TEST(::triangulation::BatchTriangulation::listInputs(DIRECTORY, inputFileNames));
+			DELAUNAY_TEST(inputFileNames.size() == 2);
+			std::vector<::triangulation::BatchJob> jobs(inputFileNames.size());
+			for (size_t i = 0; i < jobs.size(); i++) {
+				jobs[i].inputFileName = inputFileNames[i];
+				jobs[i].outputFileName = inputFileNames[i] + ::triangulation::BatchTriangulation::OUTPUT_FILE_SUFFIX;
+			}
+			::triangulation::BatchTriangulation batch(createWriter, createProjection, 2);
+			DELAUNAY_TEST(batch.process(jobs) == 1);
+			DELAUNAY_TEST(jobs[0].inputFileName == commaFileName);
+			DELAUNAY_TEST(jobs[0].ok);
+			DELAUNAY_TEST(jobs[0].error.empty());
+			DELAUNAY_TEST(jobs[0].skippedVertices.empty());
+			DELAUNAY_TEST(jobs[1].inputFileName == degenerateFileName);
+			DELAUNAY_TEST(!jobs[1].ok);
+			DELAUNAY_TEST(jobs[1].error == "fewer than 3 vertices");
+			DELAUNAY_TEST(jobs[1].vertexCount == 2);
+			DELAUNAY_TEST(jobs[1].triangleCount == 0);
+			DELAUNAY_TEST(!std::filesystem::exists(jobs[1].outputFileName));
+
+			jobs[1].inputFileName = "say \"two\".xyz";
+			std::ostringstream summary;
+			DELAUNAY_TEST(::triangulation::BatchTriangulation::writeSummary(summary, jobs));
+			std::istringstream input(summary.str());
+			std::vector<std::string> lines;
+			for (std::string line; std::getline(input, line);) {
+				lines.push_back(line);
+			}
+			DELAUNAY_TEST(lines.size() == 3);
+			DELAUNAY_TEST(lines[0] == "input,output,status,error,vertices,invalid lines,skipped vertices,triangles,milliseconds");
+			DELAUNAY_TEST(lines[1].rfind("\"" + commaFileName + "\",\"" + commaFileName + ".output\",ok,,100,0,0,", 0) == 0);
+			DELAUNAY_TEST(lines[2].rfind("\"say \"\"two\"\".xyz\"," + degenerateFileName + ".output,failed,fewer than 3 vertices,2,0,0,0,", 0) == 0);
+			std::filesystem::remove_all(DIRECTORY);
+		DELAUNAY_TEST_END();
+	}
+
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_BATCH_TRIANGULATION_TEST_H
+#define TEST_BATCH_TRIANGULATION_TEST_H
+
+
+namespace test::triangulation
+{
+	class BatchTriangulationTest
+	{
+	public:
+		BatchTriangulationTest() = default;
+		~BatchTriangulationTest() = default;
+		BatchTriangulationTest(const BatchTriangulationTest&) = delete;
+		BatchTriangulationTest(BatchTriangulationTest&&) = delete;
+		BatchTriangulationTest & operator=(const BatchTriangulationTest&) = delete;
+		BatchTriangulationTest & operator=(BatchTriangulationTest&&) = delete;
+
+		void testDirectory();
+		void testManifest();
+		void testDegenerateInput();
+
+	};
+}
+
+#endif //TEST_BATCH_TRIANGULATION_TEST_H
@@ -0,0 +1,187 @@
+#include "binary_mesh_test.h"
+
+#include "delaunay/delaunay_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/binary_mesh_file.h"
+#include "triangulation/binary_mesh_writer.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		const char* const FILE_NAME = "binary_mesh_test.mesh";
+
+		struct Mesh
+		{
+			std::vector<::triangulation::Vertex3D> coordinates;
+			std::list<std::shared_ptr<::delaunay::Triangle> > triangles;
+			std::vector<bool> usedVertices;
+		};
+
+		/**
+		 * Триангуляция псевдослучайных точек, чтобы результат не зависел от платформы
+		 */
+		bool triangulate(int count, Mesh& mesh)
+		{
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint32_t seed = 54321;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 10000) / 100.0f;
+			};
+			for (int i = 0; i < count; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = 500 + i;
+				vertex.x = random();
+				vertex.y = random();
+				vertex.z = random();
+				mesh.coordinates.push_back(vertex);
+
+				auto vertex2D = std::make_shared<::delaunay::Vertex2D>();
+				vertex2D->id = i;
+				vertex2D->x = vertex.x;
+				vertex2D->y = vertex.y;
+				vertices.push_back(vertex2D);
+			}
+			::delaunay::DelaunayService delaunayService;
+			bool ok;
+			mesh.triangles = delaunayService.iterativeDynamicProcess(vertices, &ok);
+			mesh.usedVertices = ::delaunay::DelaunayService::usedVertices(mesh.triangles, mesh.coordinates.size());
+			return ok && !mesh.triangles.empty();
+		}
+
+		/**
+		 * Записывает значение поверх заголовка файла
+		 */
+		void patchHeader(size_t offset, uint64_t value)
+		{
+			std::fstream file(FILE_NAME, std::ios::in | std::ios::out | std::ios::binary);
+			file.seekp(static_cast<std::streamoff>(offset));
+			file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+	}
+
+	void BinaryMeshTest::testRoundTrip()
+	{
+		DELAUNAY_TEST_BEGIN();
+			Mesh mesh;
+			DELAUNAY_TEST(triangulate(300, mesh));
+			std::unordered_map<const ::delaunay::Triangle*, int32_t> triangleIndices;
+			for (const auto& triangle : mesh.triangles) {
+				triangleIndices.emplace(triangle.get(), static_cast<int32_t>(triangleIndices.size()));
+			}
+			// соседи, не вошедшие в результат, записываются как NO_NEIGHBOUR
+			auto neighbourIndex = [&triangleIndices](const std::shared_ptr<::delaunay::Triangle>& triangle) {
+				if (!triangle) {
+					return ::triangulation::BinaryMeshFile::NO_NEIGHBOUR;
+				}
+				auto i = triangleIndices.find(triangle.get());
+				return i != triangleIndices.end() ? i->second : ::triangulation::BinaryMeshFile::NO_NEIGHBOUR;
+			};
+
+			for (bool withNeighbours : {true, false}) {
+				::triangulation::BinaryMeshWriter writer(withNeighbours);
+				DELAUNAY_TEST(writer.writeFile(FILE_NAME, mesh.coordinates, mesh.triangles, mesh.usedVertices));
+
+				::triangulation::BinaryMeshFile file;
+				const bool opened = file.open(FILE_NAME);
+				DELAUNAY_TEST(opened);
+				DELAUNAY_TEST(file.triangleCount() == mesh.triangles.size());
+				DELAUNAY_TEST((file.neighbours() != nullptr) == withNeighbours);
+
+				// вершины записываются в порядке исходного файла, только использованные
+				size_t vertexIndex = 0;
+				std::map<size_t, int32_t> fileIndices;
+				const ::triangulation::BinaryMeshVertex* vertices = file.vertices();
+				for (size_t i = 0; i < mesh.coordinates.size(); i++) {
+					if (!mesh.usedVertices[i]) {
+						continue;
+					}
+					DELAUNAY_TEST(vertexIndex < file.vertexCount());
+					DELAUNAY_TEST(vertices[vertexIndex].id == mesh.coordinates[i].id);
+					DELAUNAY_TEST(vertices[vertexIndex].x == mesh.coordinates[i].x);
+					DELAUNAY_TEST(vertices[vertexIndex].y == mesh.coordinates[i].y);
+					DELAUNAY_TEST(vertices[vertexIndex].z == mesh.coordinates[i].z);
+					fileIndices[i] = static_cast<int32_t>(vertexIndex++);
+				}
+				DELAUNAY_TEST(vertexIndex == file.vertexCount());
+
+				size_t i = 0;
+				for (const auto& triangle : mesh.triangles) {
+					const int32_t* vertexIndices = file.triangles() + 3 * i;
+					DELAUNAY_TEST(vertexIndices[0] == fileIndices[static_cast<size_t>(triangle->vertex1->id)]);
+					DELAUNAY_TEST(vertexIndices[1] == fileIndices[static_cast<size_t>(triangle->vertex2->id)]);
+					DELAUNAY_TEST(vertexIndices[2] == fileIndices[static_cast<size_t>(triangle->vertex3->id)]);
+					if (withNeighbours) {
+						const int32_t* neighbours = file.neighbours() + 3 * i;
+						DELAUNAY_TEST(neighbours[0] == neighbourIndex(triangle->triangle1));
+						DELAUNAY_TEST(neighbours[1] == neighbourIndex(triangle->triangle2));
+						DELAUNAY_TEST(neighbours[2] == neighbourIndex(triangle->triangle3));
+					}
+					i++;
+				}
+			}
+			std::remove(FILE_NAME);
+		DELAUNAY_TEST_END();
+	}
+
+	void BinaryMeshTest::testCorruptHeader()
+	{
+		DELAUNAY_TEST_BEGIN();
+			Mesh mesh;
+			DELAUNAY_TEST(triangulate(50, mesh));
+			::triangulation::BinaryMeshWriter writer;
+			DELAUNAY_TEST(writer.writeFile(FILE_NAME, mesh.coordinates, mesh.triangles, mesh.usedVertices));
+			uint64_t vertexCount = 0;
+			uint64_t triangleCount = 0;
+			{
+				::triangulation::BinaryMeshFile valid;
+				DELAUNAY_TEST(valid.open(FILE_NAME));
+				vertexCount = valid.header()->vertexCount;
+				triangleCount = valid.header()->triangleCount;
+			}
+
+			// количество, при котором размер блока переполняется до исходного значения
+			patchHeader(offsetof(::triangulation::BinaryMeshHeader, triangleCount),
+					triangleCount + (uint64_t(1) << 62));
+			::triangulation::BinaryMeshFile overflowedTriangles;
+			DELAUNAY_TEST(!overflowedTriangles.open(FILE_NAME));
+			DELAUNAY_TEST(overflowedTriangles.header() == nullptr);
+			DELAUNAY_TEST(overflowedTriangles.triangles() == nullptr);
+			patchHeader(offsetof(::triangulation::BinaryMeshHeader, triangleCount), triangleCount);
+
+			patchHeader(offsetof(::triangulation::BinaryMeshHeader, vertexCount),
+					vertexCount + (uint64_t(1) << 60));
+			::triangulation::BinaryMeshFile overflowedVertices;
+			DELAUNAY_TEST(!overflowedVertices.open(FILE_NAME));
+			patchHeader(offsetof(::triangulation::BinaryMeshHeader, vertexCount), vertexCount);
+
+			// на один треугольник больше, чем помещается в файл
+			patchHeader(offsetof(::triangulation::BinaryMeshHeader, triangleCount), triangleCount + 1);
+			::triangulation::BinaryMeshFile truncated;
+			DELAUNAY_TEST(!truncated.open(FILE_NAME));
+			patchHeader(offsetof(::triangulation::BinaryMeshHeader, triangleCount), triangleCount);
+
+			::triangulation::BinaryMeshFile restored;
+			DELAUNAY_TEST(restored.open(FILE_NAME));
+			DELAUNAY_TEST(restored.triangleCount() == mesh.triangles.size());
+			std::remove(FILE_NAME);
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_BINARY_MESH_TEST_H
+#define TEST_BINARY_MESH_TEST_H
+
+
+namespace test::triangulation
+{
+	class BinaryMeshTest
+	{
+	public:
+		BinaryMeshTest() = default;
+		~BinaryMeshTest() = default;
+		BinaryMeshTest(const BinaryMeshTest&) = delete;
+		BinaryMeshTest(BinaryMeshTest&&) = delete;
+		BinaryMeshTest & operator=(const BinaryMeshTest&) = delete;
+		BinaryMeshTest & operator=(BinaryMeshTest&&) = delete;
+
+		void testRoundTrip();
+		void testCorruptHeader();
+
+	};
+}
+
+#endif //TEST_BINARY_MESH_TEST_H
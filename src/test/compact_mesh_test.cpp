@@ -0,0 +1,121 @@
+#include "compact_mesh_test.h"
+
+#include "delaunay/delaunay_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/compact_mesh_file.h"
+#include "triangulation/compact_mesh_writer.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		// вершины треугольника, циклически сдвинутые к наименьшему id
+		std::array<int, 3> canonicalVertexIds(int id1, int id2, int id3)
+		{
+			std::array<int, 3> ids = {id1, id2, id3};
+			std::rotate(ids.begin(), std::min_element(ids.begin(), ids.end()), ids.end());
+			return ids;
+		}
+	}
+
+	void CompactMeshTest::testRoundTrip()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const std::string fileName = "compact_mesh_test.mesh";
+			const int count = 400;
+			std::vector<::triangulation::Vertex3D> coordinates;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			// псевдослучайные точки, чтобы результат не зависел от платформы
+			uint32_t seed = 12345;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 10000) / 100.0f;
+			};
+			for (int i = 0; i < count; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = 1000 + i;
+				vertex.x = random();
+				vertex.y = random();
+				vertex.z = random();
+				coordinates.push_back(vertex);
+
+				std::shared_ptr<::delaunay::Vertex2D> vertex2D = std::make_shared<::delaunay::Vertex2D>();
+				vertex2D->id = i;
+				vertex2D->x = vertex.x;
+				vertex2D->y = vertex.y;
+				vertices.push_back(vertex2D);
+			}
+
+			::delaunay::DelaunayService delaunayService;
+			bool ok;
+			std::list<std::shared_ptr<::delaunay::Triangle> > triangles =
+					delaunayService.iterativeDynamicProcess(vertices, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(!triangles.empty());
+			const std::vector<bool> usedVertices =
+					::delaunay::DelaunayService::usedVertices(triangles, coordinates.size());
+			std::set<int> usedVertexIds;
+			for (size_t i = 0; i < coordinates.size(); i++) {
+				if (usedVertices[i]) {
+					usedVertexIds.insert(coordinates[i].id);
+				}
+			}
+
+			::triangulation::CompactMeshWriter writer;
+			DELAUNAY_TEST(writer.writeFile(fileName, coordinates, triangles, usedVertices));
+
+			::triangulation::CompactMeshFile file;
+			const bool opened = file.open(fileName);
+			DELAUNAY_TEST(opened);
+			DELAUNAY_TEST(file.vertexCount() == usedVertexIds.size());
+			DELAUNAY_TEST(file.triangleCount() == triangles.size());
+
+			std::map<int, const ::triangulation::Vertex3D*> coordinatesById;
+			for (const auto& vertex : coordinates) {
+				coordinatesById[vertex.id] = &vertex;
+			}
+			const ::triangulation::BinaryMeshVertex* fileVertices = file.vertices();
+			for (size_t i = 0; i < file.vertexCount(); i++) {
+				DELAUNAY_TEST(usedVertexIds.count(fileVertices[i].id) == 1);
+				const ::triangulation::Vertex3D* vertex = coordinatesById[fileVertices[i].id];
+				DELAUNAY_TEST(fileVertices[i].x == vertex->x);
+				DELAUNAY_TEST(fileVertices[i].y == vertex->y);
+				DELAUNAY_TEST(fileVertices[i].z == vertex->z);
+			}
+
+			std::map<int, std::array<int, 3> > expected;
+			for (const auto& triangle : triangles) {
+				expected[triangle->id] = canonicalVertexIds(
+						coordinates[triangle->vertex1->id].id,
+						coordinates[triangle->vertex2->id].id,
+						coordinates[triangle->vertex3->id].id);
+			}
+			std::map<int, std::array<int, 3> > actual;
+			const int32_t* fileTriangles = file.triangles();
+			for (size_t i = 0; i < file.triangleCount(); i++) {
+				actual[file.triangleIds()[i]] = canonicalVertexIds(
+						fileVertices[fileTriangles[3 * i]].id,
+						fileVertices[fileTriangles[3 * i + 1]].id,
+						fileVertices[fileTriangles[3 * i + 2]].id);
+			}
+			DELAUNAY_TEST(actual == expected);
+			std::remove(fileName.c_str());
+
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_COMPACT_MESH_TEST_H
+#define TEST_COMPACT_MESH_TEST_H
+
+
+namespace test::triangulation
+{
+	class CompactMeshTest
+	{
+	public:
+		CompactMeshTest() = default;
+		~CompactMeshTest() = default;
+		CompactMeshTest(const CompactMeshTest&) = delete;
+		CompactMeshTest(CompactMeshTest&&) = delete;
+		CompactMeshTest & operator=(const CompactMeshTest&) = delete;
+		CompactMeshTest & operator=(CompactMeshTest&&) = delete;
+
+		void testRoundTrip();
+
+	};
+}
+
+#endif //TEST_COMPACT_MESH_TEST_H
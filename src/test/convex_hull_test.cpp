@@ -0,0 +1,142 @@
+#include "convex_hull_test.h"
+
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/convex_hull_service.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <set>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		/**
+		 * Псевдослучайные точки на сфере радиуса 100 и внутри неё, чтобы результат
+		 * не зависел от платформы
+		 */
+		std::vector<::triangulation::Vertex3D> spherePoints(int surfaceCount, int innerCount)
+		{
+			std::vector<::triangulation::Vertex3D> result;
+			uint32_t seed = 777;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 20001) / 10000.0f - 1.0f;
+			};
+			while (static_cast<int>(result.size()) < surfaceCount + innerCount) {
+				const float x = random();
+				const float y = random();
+				const float z = random();
+				const float length = std::sqrt(x * x + y * y + z * z);
+				if (length < 0.1f || length > 1.0f) {
+					continue;
+				}
+				const bool surface = static_cast<int>(result.size()) < surfaceCount;
+				const float scale = surface ? 100.0f / length : 90.0f;
+				::triangulation::Vertex3D vertex;
+				vertex.id = static_cast<int>(result.size()) + 1;
+				vertex.x = x * scale;
+				vertex.y = y * scale;
+				vertex.z = z * scale;
+				result.push_back(vertex);
+			}
+			return result;
+		}
+
+		// вершины и соседи треугольников по id треугольника
+		std::vector<int> describe(const std::list<std::shared_ptr<::delaunay::Triangle> >& triangles)
+		{
+			std::vector<int> result;
+			for (const auto& triangle : triangles) {
+				result.push_back(triangle->id);
+				for (int id : triangle->vertexIds()) {
+					result.push_back(id);
+				}
+				result.push_back(triangle->triangle1->id);
+				result.push_back(triangle->triangle2->id);
+				result.push_back(triangle->triangle3->id);
+			}
+			return result;
+		}
+	}
+
+	void ConvexHullTest::testConvexity()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const std::vector<::triangulation::Vertex3D> coordinates = spherePoints(1500, 500);
+			::triangulation::ConvexHullService service;
+			bool ok;
+			const std::list<std::shared_ptr<::delaunay::Triangle> > triangles =
+					service.process(coordinates, &ok);
+			DELAUNAY_TEST(ok);
+
+			std::set<int> hullVertices;
+			for (const auto& triangle : triangles) {
+				for (int id : triangle->vertexIds()) {
+					hullVertices.insert(id);
+				}
+			}
+			// внутренние вершины в оболочку не входят
+			DELAUNAY_TEST(*hullVertices.rbegin() < 1500);
+			// замкнутая поверхность из треугольников: F = 2 * V - 4
+			DELAUNAY_TEST(triangles.size() == 2 * hullVertices.size() - 4);
+
+			for (const auto& triangle : triangles) {
+				// соседи ссылаются на треугольник через общее ребро
+				for (int rib = 1; rib <= 3; rib++) {
+					const std::shared_ptr<::delaunay::Triangle>& neighbour = triangle->neighbour(rib);
+					DELAUNAY_TEST(neighbour);
+					DELAUNAY_TEST(neighbour->commonRib(triangle) != 0);
+				}
+
+				// порядок vertex1, vertex3, vertex2 - против часовой стрелки снаружи,
+				// поэтому все вершины лежат не выше плоскости треугольника
+				const ::triangulation::Vertex3D& a = coordinates[static_cast<size_t>(triangle->vertex1->id)];
+				const ::triangulation::Vertex3D& b = coordinates[static_cast<size_t>(triangle->vertex3->id)];
+				const ::triangulation::Vertex3D& c = coordinates[static_cast<size_t>(triangle->vertex2->id)];
+				const std::array<double, 3> ab = {b.x - a.x, b.y - a.y, b.z - a.z};
+				const std::array<double, 3> ac = {c.x - a.x, c.y - a.y, c.z - a.z};
+				const std::array<double, 3> normal = {
+						ab[1] * ac[2] - ab[2] * ac[1],
+						ab[2] * ac[0] - ab[0] * ac[2],
+						ab[0] * ac[1] - ab[1] * ac[0]};
+				const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				double maxDistance = -1.0;
+				for (const auto& vertex : coordinates) {
+					const double distance = (normal[0] * (vertex.x - a.x)
+							+ normal[1] * (vertex.y - a.y)
+							+ normal[2] * (vertex.z - a.z)) / length;
+					maxDistance = std::max(maxDistance, distance);
+				}
+				DELAUNAY_TEST(maxDistance < 1e-3);
+			}
+		DELAUNAY_TEST_END();
+	}
+
+	void ConvexHullTest::testParallel()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const std::vector<::triangulation::Vertex3D> coordinates =
+					spherePoints(static_cast<int>(::triangulation::ConvexHullService::PARALLEL_THRESHOLD) * 2, 1000);
+			bool ok;
+			::triangulation::ConvexHullService service;
+			const std::list<std::shared_ptr<::delaunay::Triangle> > triangles =
+					service.process(coordinates, &ok);
+			DELAUNAY_TEST(ok);
+			::triangulation::ConvexHullService parallelService(4);
+			const std::list<std::shared_ptr<::delaunay::Triangle> > parallelTriangles =
+					parallelService.process(coordinates, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(describe(parallelTriangles) == describe(triangles));
+		DELAUNAY_TEST_END();
+	}
+}
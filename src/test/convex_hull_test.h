@@ -0,0 +1,23 @@
+#ifndef TEST_CONVEX_HULL_TEST_H
+#define TEST_CONVEX_HULL_TEST_H
+
+
+namespace test::triangulation
+{
+	class ConvexHullTest
+	{
+	public:
+		ConvexHullTest() = default;
+		~ConvexHullTest() = default;
+		ConvexHullTest(const ConvexHullTest&) = delete;
+		ConvexHullTest(ConvexHullTest&&) = delete;
+		ConvexHullTest & operator=(const ConvexHullTest&) = delete;
+		ConvexHullTest & operator=(ConvexHullTest&&) = delete;
+
+		void testConvexity();
+		void testParallel();
+
+	};
+}
+
+#endif //TEST_CONVEX_HULL_TEST_H
@@ -0,0 +1,112 @@
+#include "coordinates_cache_test.h"
+
+#include "triangulation/coordinates_cache.h"
+#include "triangulation/coordinates_file_parser.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		const char* const FILE_NAME = "coordinates_cache_test.xyz";
+
+		void writeFile(const std::string& text)
+		{
+			std::ofstream file(FILE_NAME, std::ios::out | std::ios::binary | std::ios::trunc);
+			file << text;
+		}
+
+		/**
+		 * Сдвигает время модификации файла, чтобы изменение не потерялось
+		 * из-за грубой точности времени файловой системы
+		 */
+		void shiftModificationTime(int seconds)
+		{
+			std::error_code error;
+			const auto time = std::filesystem::last_write_time(FILE_NAME, error);
+			std::filesystem::last_write_time(FILE_NAME, time + std::chrono::seconds(seconds), error);
+		}
+
+		/**
+		 * Время модификации исходного файла, записанное в заголовке кэша
+		 */
+		int64_t cachedModificationTime()
+		{
+			::triangulation::CoordinatesCacheHeader header{};
+			std::ifstream file(
+					::triangulation::CoordinatesCache::cacheFileName(FILE_NAME),
+					std::ios::in | std::ios::binary);
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			return header.sourceModificationTime;
+		}
+
+		bool load(::triangulation::CoordinatesFileParser& parser)
+		{
+			parser.clear();
+			parser.setUseCache(true);
+			return parser.loadFile(FILE_NAME, 2);
+		}
+	}
+
+	void CoordinatesCacheTest::testInvalidation()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::error_code error;
+			std::filesystem::remove(::triangulation::CoordinatesCache::cacheFileName(FILE_NAME), error);
+			writeFile("1, 1.5, 2.5, 3.5\n2, 4.5, 5.5, 6.5\n* comment\n3, 7.5, 8.5, 9.5\n");
+
+			::triangulation::CoordinatesFileParser parser;
+			DELAUNAY_TEST(load(parser));
+			DELAUNAY_TEST(!parser.isLoadedFromCache());
+			DELAUNAY_TEST(parser.coordinates().size() == 3);
+
+			DELAUNAY_TEST(load(parser));
+			DELAUNAY_TEST(parser.isLoadedFromCache());
+			DELAUNAY_TEST(parser.coordinates().size() == 3);
+			DELAUNAY_TEST(parser.coordinates()[1].x == 4.5f);
+			DELAUNAY_TEST(parser.invalidLines().empty());
+
+			// то же содержимое с новым временем модификации: кэш проверяется по хэшу,
+			// а новое время сохраняется в нём
+			shiftModificationTime(10);
+			DELAUNAY_TEST(load(parser));
+			DELAUNAY_TEST(parser.isLoadedFromCache());
+			DELAUNAY_TEST(parser.coordinates().size() == 3);
+			DELAUNAY_TEST(cachedModificationTime()
+					== static_cast<int64_t>(std::filesystem::last_write_time(FILE_NAME).time_since_epoch().count()));
+
+			// другое содержимое того же размера
+			writeFile("1, 1.5, 2.5, 3.5\n2, 0.5, 5.5, 6.5\n* comment\n3, 7.5, 8.5, 9.5\n");
+			shiftModificationTime(20);
+			DELAUNAY_TEST(load(parser));
+			DELAUNAY_TEST(!parser.isLoadedFromCache());
+			DELAUNAY_TEST(parser.coordinates().size() == 3);
+			DELAUNAY_TEST(parser.coordinates()[1].x == 0.5f);
+
+			DELAUNAY_TEST(load(parser));
+			DELAUNAY_TEST(parser.isLoadedFromCache());
+			DELAUNAY_TEST(parser.coordinates()[1].x == 0.5f);
+
+			// другой размер
+			writeFile("1, 1.5, 2.5, 3.5\n2, 0.5, 5.5, 6.5\n* comment\n3, 7.5, 8.5, 9.5\nbad\n4, 1, 2, 3\n");
+			DELAUNAY_TEST(load(parser));
+			DELAUNAY_TEST(!parser.isLoadedFromCache());
+			DELAUNAY_TEST(parser.coordinates().size() == 4);
+			DELAUNAY_TEST(parser.invalidLines().size() == 1);
+
+			std::filesystem::remove(::triangulation::CoordinatesCache::cacheFileName(FILE_NAME), error);
+			std::filesystem::remove(FILE_NAME, error);
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_COORDINATES_CACHE_TEST_H
+#define TEST_COORDINATES_CACHE_TEST_H
+
+
+namespace test::triangulation
+{
+	class CoordinatesCacheTest
+	{
+	public:
+		CoordinatesCacheTest() = default;
+		~CoordinatesCacheTest() = default;
+		CoordinatesCacheTest(const CoordinatesCacheTest&) = delete;
+		CoordinatesCacheTest(CoordinatesCacheTest&&) = delete;
+		CoordinatesCacheTest & operator=(const CoordinatesCacheTest&) = delete;
+		CoordinatesCacheTest & operator=(CoordinatesCacheTest&&) = delete;
+
+		void testInvalidation();
+
+	};
+}
+
+#endif //TEST_COORDINATES_CACHE_TEST_H
@@ -0,0 +1,186 @@
+#include "coordinates_file_parser_test.h"
+
+#include "triangulation/coordinates_file_parser.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <cstddef>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		/**
+		 * Разбор строки регулярными выражениями, как до перехода на std::from_chars
+		 * @return false для комментария и строки, которую не удалось разобрать
+		 */
+		bool parseVertexWithRegex(const std::string& line, ::triangulation::Vertex3D& vertex)
+		{
+			static const std::regex COMMENT_REGEX("^\\s*\\*.*");
+			static const std::regex NUMBERS_LINE_REGEX(R"(^\s*([0-9]+),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?).*)");
+			if (std::regex_match(line, COMMENT_REGEX)) {
+				return false;
+			}
+			std::smatch matches;
+			if (!std::regex_search(line, matches, NUMBERS_LINE_REGEX) || matches.size() != 5) {
+				return false;
+			}
+			vertex.id = std::stoi(matches[1].str());
+			vertex.x = std::stof(matches[2].str());
+			vertex.y = std::stof(matches[3].str());
+			vertex.z = std::stof(matches[4].str());
+			return true;
+		}
+
+		bool parseVertex(const std::string& line, ::triangulation::Vertex3D& vertex)
+		{
+			return ::triangulation::CoordinatesFileParser::parseVertex(
+					line.data(), line.data() + line.size(), vertex);
+		}
+
+		bool sameCoordinates(
+				const std::vector<::triangulation::Vertex3D>& coordinates1,
+				const std::vector<::triangulation::Vertex3D>& coordinates2)
+		{
+			if (coordinates1.size() != coordinates2.size()) {
+				return false;
+			}
+			for (size_t i = 0; i < coordinates1.size(); i++) {
+				if (coordinates1[i].id != coordinates2[i].id
+						|| coordinates1[i].x != coordinates2[i].x
+						|| coordinates1[i].y != coordinates2[i].y
+						|| coordinates1[i].z != coordinates2[i].z) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	void CoordinatesFileParserTest::testParseVertex()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// строки с '\r' - как их видел std::getline в файле с CRLF
+			const std::vector<std::string> lines = {
+					"1, 2.5, -3.25, 4e2",
+					"  7,\t1.,2,3",
+					"1,2,3,4",
+					"12, +1.5, -0.5, +2E-3",
+					"3, 1.5e+3, 2, 3 trailing junk",
+					"3, 1, 2, 3abc",
+					"3, 1, 2, 4e",
+					"3, 1, 2, 3\r",
+					"4, 1, 2, 3, 5",
+					"123456, 0.000001, 1234567.0, -0",
+					"* comment",
+					"   *comment 1, 2, 3, 4",
+					"* comment\r",
+					"",
+					"   ",
+					"\r",
+					"1, 2, 3",
+					"1, 2",
+					"1",
+					"1 , 2, 3, 4",
+					"1, 2 , 3, 4",
+					"1,, 2, 3, 4",
+					"-1, 2, 3, 4",
+					"+1, 2, 3, 4",
+					"a, 1, 2, 3",
+					"1, .5, 2, 3",
+					"1, 2e, 3, 4",
+					"1, 1.5.5, 2, 3",
+					"1, +-2, 3, 4",
+					"1, -+2, 3, 4",
+					"1, inf, 2, 3",
+					"1, nan, 2, 3",
+					"1, 0x10, 2, 3",
+					"1, 2, 3, -"};
+			for (const std::string& line : lines) {
+				::triangulation::Vertex3D expected;
+				::triangulation::Vertex3D vertex;
+				const bool expectedOk = parseVertexWithRegex(line, expected);
+				DELAUNAY_TEST(parseVertex(line, vertex) == expectedOk);
+				if (expectedOk) {
+					DELAUNAY_TEST(vertex.id == expected.id);
+					DELAUNAY_TEST(vertex.x == expected.x);
+					DELAUNAY_TEST(vertex.y == expected.y);
+					DELAUNAY_TEST(vertex.z == expected.z);
+				}
+			}
+
+			// раньше std::stoi / std::stof бросали исключение, теперь строка
+			// считается ошибочной
+			::triangulation::Vertex3D vertex;
+			DELAUNAY_TEST(!parseVertex("99999999999, 1, 2, 3", vertex));
+			DELAUNAY_TEST(!parseVertex("1, 1e400, 2, 3", vertex));
+		DELAUNAY_TEST_END();
+	}
+
+	void CoordinatesFileParserTest::testChunks()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// длинные числа, комментарии, ошибочные и пустые строки, CRLF и последняя
+			// строка без перевода строки
+			std::string text;
+			std::vector<::triangulation::Vertex3D> expectedCoordinates;
+			std::vector<size_t> expectedInvalidLines;
+			const size_t lineCount = 60;
+			for (size_t line = 1; line <= lineCount; line++) {
+				if (line % 11 == 0) {
+					text += "* comment " + std::to_string(line);
+				}
+				else if (line % 7 == 0) {
+					text += line % 2 == 0 ? "" : "bad line " + std::to_string(line);
+					expectedInvalidLines.push_back(line);
+				}
+				else {
+					const std::string vertexLine = std::to_string(line) + ", "
+							+ std::to_string(line) + ".123456789, -"
+							+ std::to_string(line * 1000) + ".5e-2, 1.25E+"
+							+ std::to_string(line % 5);
+					::triangulation::Vertex3D vertex;
+					DELAUNAY_TEST(parseVertex(vertexLine, vertex));
+					expectedCoordinates.push_back(vertex);
+					text += vertexLine;
+				}
+				if (line < lineCount) {
+					text += line % 3 == 0 ? "\r\n" : "\n";
+				}
+			}
+
+			::triangulation::CoordinatesFileParser wholeParser;
+			wholeParser.parseBuffer(text.data(), text.size(), 1);
+			DELAUNAY_TEST(sameCoordinates(wholeParser.coordinates(), expectedCoordinates));
+			DELAUNAY_TEST(wholeParser.invalidLines() == expectedInvalidLines);
+
+			// части буфера делятся по границам строк
+			::triangulation::CoordinatesFileParser bufferParser;
+			bufferParser.setChunkSize(1);
+			bufferParser.parseBuffer(text.data(), text.size(), 4);
+			DELAUNAY_TEST(sameCoordinates(bufferParser.coordinates(), expectedCoordinates));
+			DELAUNAY_TEST(bufferParser.invalidLines() == expectedInvalidLines);
+
+			// блоки потока делят строки и числа в любом месте
+			for (size_t chunkSize : {1, 3, 7, 16, 100}) {
+				::triangulation::CoordinatesFileParser streamParser;
+				streamParser.setChunkSize(chunkSize);
+				std::vector<::triangulation::Vertex3D> handledCoordinates;
+				streamParser.setChunkHandler([&handledCoordinates](const ::triangulation::Vertex3D* coordinates, size_t count) {
+					handledCoordinates.insert(handledCoordinates.end(), coordinates, coordinates + count);
+				});
+				std::istringstream stream(text);
+				DELAUNAY_TEST(streamParser.loadStream(stream, 2));
+				DELAUNAY_TEST(sameCoordinates(streamParser.coordinates(), expectedCoordinates));
+				DELAUNAY_TEST(sameCoordinates(handledCoordinates, expectedCoordinates));
+				DELAUNAY_TEST(streamParser.invalidLines() == expectedInvalidLines);
+			}
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_COORDINATES_FILE_PARSER_TEST_H
+#define TEST_COORDINATES_FILE_PARSER_TEST_H
+
+
+namespace test::triangulation
+{
+	class CoordinatesFileParserTest
+	{
+	public:
+		CoordinatesFileParserTest() = default;
+		~CoordinatesFileParserTest() = default;
+		CoordinatesFileParserTest(const CoordinatesFileParserTest&) = delete;
+		CoordinatesFileParserTest(CoordinatesFileParserTest&&) = delete;
+		CoordinatesFileParserTest & operator=(const CoordinatesFileParserTest&) = delete;
+		CoordinatesFileParserTest & operator=(CoordinatesFileParserTest&&) = delete;
+
+		void testParseVertex();
+		void testChunks();
+
+	};
+}
+
+#endif //TEST_COORDINATES_FILE_PARSER_TEST_H
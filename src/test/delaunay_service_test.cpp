@@ -2,12 +2,15 @@
 
 #include "delaunay/delaunay_service.h"
 #include "delaunay/triangle.h"
+#include "delaunay/triangulation_cache.h"
 #include "delaunay/vertex_2d.h"
 
 #include "test.h"
 
+#include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 
 namespace test::delaunay
@@ -50,4 +53,128 @@ namespace test::delaunay
 		DELAUNAY_TEST_END();
 	}
 
+	void DelaunayServiceTest::testProgressiveProcess()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const int vertexCount = 2000;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint64_t seed = 12345;
+			for (int i = 0; i < vertexCount; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->x = static_cast<double>(seed >> 40) / (1 << 24) * 100.0;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->y = static_cast<double>(seed >> 40) / (1 << 24) * 100.0;
+				vertices.push_back(vertex);
+			}
+
+			// доли заданы не по порядку и с недопустимыми значениями
+			std::vector<double> calledFractions;
+			std::vector<size_t> usedCounts;
+			bool ok;
+			::delaunay::DelaunayService delaunayService;
+			::delaunay::TriangulationCache cache;
+			std::list<std::shared_ptr<::delaunay::Triangle> > triangles = delaunayService.progressiveProcess(
+					vertices, {0.5, 0.1, 0.0, 1.5},
+					[&](double fraction, const std::list<std::shared_ptr<::delaunay::Triangle> >& current) {
+						calledFractions.push_back(fraction);
+						usedCounts.push_back(::delaunay::DelaunayService::vertexIds(current).size());
+					},
+					cache, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(calledFractions == std::vector<double>({0.1, 0.5}));
+			DELAUNAY_TEST(usedCounts[0] <= vertexCount / 10);
+			DELAUNAY_TEST(usedCounts[0] > vertexCount / 20);
+			DELAUNAY_TEST(usedCounts[1] <= vertexCount / 2);
+			DELAUNAY_TEST(usedCounts[1] > usedCounts[0]);
+
+			// результат не зависит от запуска
+			::delaunay::TriangulationCache secondCache;
+			std::list<std::shared_ptr<::delaunay::Triangle> > second = delaunayService.progressiveProcess(
+					vertices, {0.1, 0.5}, nullptr, secondCache, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(second.size() == triangles.size());
+			auto secondTriangle = second.cbegin();
+			for (const auto& triangle : triangles) {
+				DELAUNAY_TEST(triangle->vertexIds() == (*secondTriangle)->vertexIds());
+				++secondTriangle;
+			}
+
+			// в итоговую сетку попадают те же вершины, что и при обычном порядке
+			std::list<std::shared_ptr<::delaunay::Triangle> > expected =
+					delaunayService.iterativeDynamicProcess(vertices, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(::delaunay::DelaunayService::vertexIds(triangles)
+					== ::delaunay::DelaunayService::vertexIds(expected));
+			const size_t triangleCount = triangles.size();
+
+			// продолжение триангуляции в том же кэше
+			auto vertex = std::make_shared<::delaunay::Vertex2D>();
+			vertex->id = vertexCount;
+			vertex->x = 50.5;
+			vertex->y = 50.5;
+			triangles = delaunayService.insertVertices(cache, {vertex}, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(triangles.size() == triangleCount + 2);
+		DELAUNAY_TEST_END();
+	}
+
+	void DelaunayServiceTest::testProcess()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const int vertexCount = 2000;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint64_t seed = 54321;
+			for (int i = 0; i < vertexCount; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->x = static_cast<double>(seed >> 40) / (1 << 24) * 100.0;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->y = static_cast<double>(seed >> 40) / (1 << 24) * 100.0;
+				vertices.push_back(vertex);
+			}
+
+			bool ok;
+			::delaunay::DelaunayService delaunayService;
+			const std::list<std::shared_ptr<::delaunay::Triangle> > expected =
+					delaunayService.iterativeDynamicProcess(vertices, &ok);
+			DELAUNAY_TEST(ok);
+
+			// повторные запуски дают тот же результат, число выделений памяти
+			// проверяется в AllocationTest
+			for (int run = 0; run < 3; run++) {
+				const std::list<std::shared_ptr<::delaunay::Triangle> >& triangles =
+						delaunayService.process(vertices, &ok);
+				DELAUNAY_TEST(ok);
+				DELAUNAY_TEST(triangles.size() == expected.size());
+				auto expectedTriangle = expected.cbegin();
+				for (const auto& triangle : triangles) {
+					DELAUNAY_TEST(triangle->id == (*expectedTriangle)->id);
+					DELAUNAY_TEST(triangle->vertexIds() == (*expectedTriangle)->vertexIds());
+					++expectedTriangle;
+				}
+			}
+
+			// после большой триангуляции в пуле остаются лишние треугольники
+			vertices.resize(vertexCount / 4);
+			const std::list<std::shared_ptr<::delaunay::Triangle> > smaller =
+					delaunayService.iterativeDynamicProcess(vertices, &ok);
+			DELAUNAY_TEST(ok);
+			const std::list<std::shared_ptr<::delaunay::Triangle> >& triangles =
+					delaunayService.process(vertices, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(triangles.size() == smaller.size());
+			auto smallerTriangle = smaller.cbegin();
+			for (const auto& triangle : triangles) {
+				DELAUNAY_TEST(triangle->vertexIds() == (*smallerTriangle)->vertexIds());
+				++smallerTriangle;
+			}
+			delaunayService.reset();
+			DELAUNAY_TEST(delaunayService.process({}, &ok).empty());
+			DELAUNAY_TEST(!ok);
+		DELAUNAY_TEST_END();
+	}
+
 }
@@ -15,6 +15,8 @@ namespace test::delaunay
 		DelaunayServiceTest & operator=(DelaunayServiceTest&&) = delete;
 
 		void testIterativeDynamicProcess1();
+		void testProgressiveProcess();
+		void testProcess();
 
 	};
 }
@@ -0,0 +1,169 @@
+#include "format_test.h"
+
+#include "triangulation/utils.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		// длины выравнивания, которые используют писатели, и граничные случаи
+		const size_t MIN_LENGTHS[] = {0, 1, 5, 8, 10, 11, 12, 16, 40};
+
+		/**
+		 * Запись целого числа до перехода на std::to_chars
+		 */
+		std::string previousIntToString(int i, size_t minLength)
+		{
+			std::string result = std::to_string(i);
+			if (result.size() < minLength) {
+				for (size_t j = result.size(); j <= minLength; j++) {
+					result = ' ' + result;
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Запись числа через std::ostream до перехода на std::to_chars
+		 */
+		std::string previousFloatToString(float f, size_t minLength)
+		{
+			std::ostringstream ss;
+			ss << f;
+			std::string result(ss.str());
+			if (result.size() < minLength) {
+				for (size_t j = result.size(); j <= minLength; j++) {
+					result = ' ' + result;
+				}
+			}
+			return result;
+		}
+
+		std::string formatInt(int i, size_t minLength)
+		{
+			std::vector<char> buffer(std::max(::triangulation::Utils::MAX_NUMBER_LENGTH, minLength + 1));
+			return std::string(buffer.data(), ::triangulation::Utils::formatInt(buffer.data(), i, minLength));
+		}
+
+		std::string formatFloat(float f, size_t minLength)
+		{
+			std::vector<char> buffer(std::max(::triangulation::Utils::MAX_NUMBER_LENGTH, minLength + 1));
+			return std::string(buffer.data(), ::triangulation::Utils::formatFloat(buffer.data(), f, minLength));
+		}
+
+		bool sameAsPreviousInt(int i)
+		{
+			for (size_t minLength : MIN_LENGTHS) {
+				const std::string expected = previousIntToString(i, minLength);
+				if (formatInt(i, minLength) != expected
+						|| ::triangulation::Utils::intToString(i, minLength) != expected) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool sameAsPreviousFloat(float f)
+		{
+			for (size_t minLength : MIN_LENGTHS) {
+				const std::string expected = previousFloatToString(f, minLength);
+				if (formatFloat(f, minLength) != expected
+						|| ::triangulation::Utils::floatToString(f, minLength) != expected) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	void FormatTest::testFormatInt()
+	{
+		DELAUNAY_TEST_BEGIN();
+			DELAUNAY_TEST(formatInt(0, 0) == "0");
+			DELAUNAY_TEST(formatInt(-7, 0) == "-7");
+			DELAUNAY_TEST(formatInt(42, 5) == "    42");
+			DELAUNAY_TEST(formatInt(-42, 5) == "   -42");
+			// запись длиной ровно minLength не выравнивается
+			DELAUNAY_TEST(formatInt(12345, 5) == "12345");
+			DELAUNAY_TEST(formatInt(123456, 5) == "123456");
+			DELAUNAY_TEST(formatInt(INT_MAX, 8) == "2147483647");
+			DELAUNAY_TEST(formatInt(INT_MIN, 8) == "-2147483648");
+
+			const int values[] = {0, 1, -1, 9, 10, -10, 99999, 100000, -100000, 12345678, INT_MAX, INT_MIN};
+			for (int i : values) {
+				DELAUNAY_TEST(sameAsPreviousInt(i));
+			}
+			uint32_t seed = 777;
+			for (int n = 0; n < 20000; n++) {
+				seed = seed * 1103515245u + 12345u;
+				const int i = static_cast<int>(seed) >> (n % 31);
+				DELAUNAY_TEST(sameAsPreviousInt(i));
+			}
+		DELAUNAY_TEST_END();
+	}
+
+	void FormatTest::testFormatFloat()
+	{
+		DELAUNAY_TEST_BEGIN();
+			DELAUNAY_TEST(formatFloat(0.0f, 0) == "0");
+			DELAUNAY_TEST(formatFloat(-0.0f, 0) == "-0");
+			DELAUNAY_TEST(formatFloat(1.5f, 0) == "1.5");
+			DELAUNAY_TEST(formatFloat(-2.25f, 8) == "    -2.25");
+			// 6 значащих цифр с округлением
+			DELAUNAY_TEST(formatFloat(3.14159265f, 0) == "3.14159");
+			DELAUNAY_TEST(formatFloat(2.7182818f, 0) == "2.71828");
+			DELAUNAY_TEST(formatFloat(0.1f, 0) == "0.1");
+			DELAUNAY_TEST(formatFloat(123456.0f, 0) == "123456");
+			DELAUNAY_TEST(formatFloat(1234567.0f, 0) == "1.23457e+06");
+			DELAUNAY_TEST(formatFloat(999999.5f, 0) == "1e+06");
+			DELAUNAY_TEST(formatFloat(-1.0e20f, 0) == "-1e+20");
+			DELAUNAY_TEST(formatFloat(0.0001f, 0) == "0.0001");
+			DELAUNAY_TEST(formatFloat(0.00001f, 0) == "1e-05");
+			DELAUNAY_TEST(formatFloat(std::numeric_limits<float>::max(), 0) == "3.40282e+38");
+
+			const float values[] = {
+					0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 1.0f / 3.0f, -2.0f / 3.0f,
+					9.999995f, 99999.95f, 999999.4f, 999999.6f, 1.0e6f, 1.0e-4f, 9.99999e-5f,
+					123.456789f, -98765.4321f, 3.0e15f, -7.0e-30f,
+					std::numeric_limits<float>::max(),
+					std::numeric_limits<float>::lowest(),
+					std::numeric_limits<float>::min(),
+					std::numeric_limits<float>::denorm_min(),
+					std::numeric_limits<float>::infinity(),
+					-std::numeric_limits<float>::infinity()};
+			for (float f : values) {
+				DELAUNAY_TEST(sameAsPreviousFloat(f));
+			}
+			// произвольные битовые представления, кроме NaN
+			uint32_t seed = 2024;
+			for (int n = 0; n < 20000; n++) {
+				seed = seed * 1103515245u + 12345u;
+				const uint32_t bits = seed ^ (seed << 13);
+				float f;
+				std::memcpy(&f, &bits, sizeof(f));
+				if (f != f) {
+					continue;
+				}
+				DELAUNAY_TEST(sameAsPreviousFloat(f));
+			}
+			// координаты в обычном для входных файлов диапазоне
+			for (int n = 0; n < 20000; n++) {
+				seed = seed * 1103515245u + 12345u;
+				const float f = static_cast<float>(static_cast<int32_t>(seed) % 100000000) / 1000.0f;
+				DELAUNAY_TEST(sameAsPreviousFloat(f));
+			}
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_FORMAT_TEST_H
+#define TEST_FORMAT_TEST_H
+
+
+namespace test::triangulation
+{
+	class FormatTest
+	{
+	public:
+		FormatTest() = default;
+		~FormatTest() = default;
+		FormatTest(const FormatTest&) = delete;
+		FormatTest(FormatTest&&) = delete;
+		FormatTest & operator=(const FormatTest&) = delete;
+		FormatTest & operator=(FormatTest&&) = delete;
+
+		void testFormatInt();
+		void testFormatFloat();
+
+	};
+}
+
+#endif //TEST_FORMAT_TEST_H
@@ -1,7 +1,22 @@
+#include "batch_triangulation_test.h"
+#include "binary_mesh_test.h"
+#include "compact_mesh_test.h"
+#include "convex_hull_test.h"
+#include "coordinates_cache_test.h"
+#include "coordinates_file_parser_test.h"
 #include "delaunay_service_test.h"
+#include "format_test.h"
+#include "outlier_filter_test.h"
+#include "projection_test.h"
+#include "result_cache_test.h"
+#include "streaming_service_test.h"
+#include "tetrahedralization_test.h"
+#include "tiling_service_test.h"
 #include "utils_test.h"
 #include "triangulation_cache_test.h"
 #include "triangle_test.h"
+#include "voxel_thinning_test.h"
+#include "writer_test.h"
 
 
 int main()
@@ -21,15 +36,86 @@ int main()
 
 	test::delaunay::TriangleTest triangleTest;
 	triangleTest.testVertexRelation();
+	triangleTest.testCommonRib();
 
 	test::delaunay::TriangulationCacheTest triangulationCacheTest;
 	triangulationCacheTest.testFindAppropriateTriangle();
 	triangulationCacheTest.testCreateNewThreeTrianglesNearInnerVertex();
 	triangulationCacheTest.testCreateNewTwoOrFourTrianglesNearVertexOnRib();
 	triangulationCacheTest.testCheckDelaunayConditionAndRebuildIfNeed();
+	triangulationCacheTest.testSnapshot();
+	triangulationCacheTest.testReset();
+	triangulationCacheTest.testCellBorders();
 
 	test::delaunay::DelaunayServiceTest delaunayServiceTest;
 	delaunayServiceTest.testIterativeDynamicProcess1();
+	delaunayServiceTest.testProgressiveProcess();
+	delaunayServiceTest.testProcess();
+
+	test::delaunay::StreamingServiceTest streamingServiceTest;
+	streamingServiceTest.testSameAsInMemory();
+	streamingServiceTest.testFinalizedArea();
+
+	test::delaunay::TilingServiceTest tilingServiceTest;
+	tilingServiceTest.testSameAsInMemory();
+	tilingServiceTest.testSmallMargin();
+
+	test::triangulation::FormatTest formatTest;
+	formatTest.testFormatInt();
+	formatTest.testFormatFloat();
+
+	test::triangulation::CoordinatesFileParserTest coordinatesFileParserTest;
+	coordinatesFileParserTest.testParseVertex();
+	coordinatesFileParserTest.testChunks();
+
+	test::triangulation::CoordinatesCacheTest coordinatesCacheTest;
+	coordinatesCacheTest.testInvalidation();
+
+	test::triangulation::WriterTest writerTest;
+	writerTest.testParallelWriter();
+	writerTest.testObjWriter();
+	writerTest.testPlyWriter();
+	writerTest.testStlWriter();
+	writerTest.testMissingVertexIndex();
+
+	test::triangulation::BinaryMeshTest binaryMeshTest;
+	binaryMeshTest.testRoundTrip();
+	binaryMeshTest.testCorruptHeader();
+
+	test::triangulation::CompactMeshTest compactMeshTest;
+	compactMeshTest.testRoundTrip();
+
+	test::triangulation::ProjectionTest projectionTest;
+	projectionTest.testLegacy();
+	projectionTest.testPlane();
+	projectionTest.testCylindrical();
+	projectionTest.testSpherical();
+	projectionTest.testSkippedVertices();
+
+	test::triangulation::ConvexHullTest convexHullTest;
+	convexHullTest.testConvexity();
+	convexHullTest.testParallel();
+
+	test::tetrahedralization::TetrahedralizationTest tetrahedralizationTest;
+	tetrahedralizationTest.testEmptySphere();
+	tetrahedralizationTest.testGrid();
+
+	test::triangulation::VoxelThinningTest voxelThinningTest;
+	voxelThinningTest.testThin();
+	voxelThinningTest.testBudget();
+
+	test::triangulation::OutlierFilterTest outlierFilterTest;
+	outlierFilterTest.testMeanDistances();
+	outlierFilterTest.testFilter();
+
+	test::triangulation::BatchTriangulationTest batchTriangulationTest;
+	batchTriangulationTest.testDirectory();
+	batchTriangulationTest.testManifest();
+	batchTriangulationTest.testDegenerateInput();
+
+	test::triangulation::ResultCacheTest resultCacheTest;
+	resultCacheTest.testKey();
+	resultCacheTest.testEviction();
 
 	return 0;
 }
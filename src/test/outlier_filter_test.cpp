@@ -0,0 +1,72 @@
+#include "outlier_filter_test.h"
+
+#include "triangulation/outlier_filter.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		// узлы решётки size x size x size с шагом 1, id с 1
+		std::vector<::triangulation::Vertex3D> grid(int size)
+		{
+			std::vector<::triangulation::Vertex3D> result;
+			for (int i = 0; i < size * size * size; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = i + 1;
+				vertex.x = static_cast<float>(i % size);
+				vertex.y = static_cast<float>(i / size % size);
+				vertex.z = static_cast<float>(i / size / size);
+				result.push_back(vertex);
+			}
+			return result;
+		}
+	}
+
+	void OutlierFilterTest::testMeanDistances()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const int size = 30;
+			const std::vector<::triangulation::Vertex3D> coordinates = grid(size);
+			::triangulation::OutlierFilter filter(6, 2.0);
+			const std::vector<double> distances = filter.meanDistances(coordinates);
+			DELAUNAY_TEST(distances.size() == coordinates.size());
+			// у внутреннего узла 6 соседей на расстоянии 1
+			const size_t inner = static_cast<size_t>((size / 2 * size + size / 2) * size + size / 2);
+			DELAUNAY_TEST(std::fabs(distances[inner] - 1.0) < 1e-9);
+			// у угла 3 соседа на расстоянии 1 и 3 на расстоянии sqrt(2)
+			DELAUNAY_TEST(std::fabs(distances[0] - (3.0 + 3.0 * std::sqrt(2.0)) / 6.0) < 1e-9);
+
+			::triangulation::OutlierFilter parallelFilter(6, 2.0, 4);
+			DELAUNAY_TEST(parallelFilter.meanDistances(coordinates) == distances);
+		DELAUNAY_TEST_END();
+	}
+
+	void OutlierFilterTest::testFilter()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::vector<::triangulation::Vertex3D> coordinates = grid(20);
+			const float far[3][3] = {{500.0f, 0.0f, 0.0f}, {-300.0f, 10.0f, 5.0f}, {10.0f, 10.0f, 40.0f}};
+			for (const auto& position : far) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = static_cast<int>(coordinates.size()) + 1;
+				vertex.x = position[0];
+				vertex.y = position[1];
+				vertex.z = position[2];
+				coordinates.push_back(vertex);
+			}
+			::triangulation::OutlierFilter filter(8, 3.0);
+			std::vector<int> removedIds;
+			const std::vector<::triangulation::Vertex3D> result = filter.filter(coordinates, removedIds);
+			DELAUNAY_TEST(removedIds == std::vector<int>({8001, 8002, 8003}));
+			DELAUNAY_TEST(result.size() == 8000);
+			DELAUNAY_TEST(result.back().id == 8000);
+		DELAUNAY_TEST_END();
+	}
+}
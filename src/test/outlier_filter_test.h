@@ -0,0 +1,23 @@
+#ifndef TEST_OUTLIER_FILTER_TEST_H
+#define TEST_OUTLIER_FILTER_TEST_H
+
+
+namespace test::triangulation
+{
+	class OutlierFilterTest
+	{
+	public:
+		OutlierFilterTest() = default;
+		~OutlierFilterTest() = default;
+		OutlierFilterTest(const OutlierFilterTest&) = delete;
+		OutlierFilterTest(OutlierFilterTest&&) = delete;
+		OutlierFilterTest & operator=(const OutlierFilterTest&) = delete;
+		OutlierFilterTest & operator=(OutlierFilterTest&&) = delete;
+
+		void testMeanDistances();
+		void testFilter();
+
+	};
+}
+
+#endif //TEST_OUTLIER_FILTER_TEST_H
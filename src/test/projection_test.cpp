@@ -0,0 +1,269 @@
+#include "projection_test.h"
+
+#include "delaunay/delaunay_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/triangulation_cache.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/cylindrical_projection.h"
+#include "triangulation/default_writer.h"
+#include "triangulation/legacy_projection.h"
+#include "triangulation/plane_projection.h"
+#include "triangulation/spherical_projection.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		const double PI = 3.14159265358979323846;
+		const float TOLERANCE = 1e-3f;
+
+		::triangulation::Vertex3D vertex3D(int id, double x, double y, double z)
+		{
+			::triangulation::Vertex3D vertex;
+			vertex.id = id;
+			vertex.x = static_cast<float>(x);
+			vertex.y = static_cast<float>(y);
+			vertex.z = static_cast<float>(z);
+			return vertex;
+		}
+
+		/**
+		 * Проекция одной вершины после fit() по всем вершинам
+		 */
+		::delaunay::Vertex2D project(
+				const ::triangulation::IProjection& projection,
+				const ::triangulation::Vertex3D& vertex)
+		{
+			::delaunay::Vertex2D result;
+			projection.project(&vertex, 1, &result);
+			return result;
+		}
+
+		bool near(float actual, double expected)
+		{
+			return std::fabs(actual - static_cast<float>(expected)) < TOLERANCE;
+		}
+
+		std::string triangulate(
+				const std::vector<::triangulation::Vertex3D>& coordinates,
+				std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices)
+		{
+			::delaunay::DelaunayService service;
+			bool ok;
+			const auto triangles = service.iterativeDynamicProcess(vertices, &ok);
+			if (!ok) {
+				return std::string();
+			}
+			std::ostringstream stream;
+			::triangulation::DefaultWriter writer;
+			writer.writeStream(
+					stream,
+					coordinates,
+					triangles,
+					::delaunay::DelaunayService::usedVertices(triangles, coordinates.size()));
+			return stream.str();
+		}
+	}
+
+	void ProjectionTest::testLegacy()
+	{
+		DELAUNAY_TEST_BEGIN();
+			::triangulation::LegacyProjection projection;
+			DELAUNAY_TEST(!projection.needsFit());
+			const ::delaunay::Vertex2D known = project(projection, vertex3D(7, 2.0, -3.0, 4.0));
+			DELAUNAY_TEST(known.x == 8.0f);
+			DELAUNAY_TEST(known.y == -12.0f);
+
+			std::vector<::triangulation::Vertex3D> coordinates;
+			uint32_t seed = 4242;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<double>((seed >> 8) % 10000) / 100.0;
+			};
+			for (int i = 0; i < 500; i++) {
+				coordinates.push_back(vertex3D(100 + i, random(), random(), 0.5 + random() / 50.0));
+			}
+
+			// проекция до введения IProjection: x * z, y * z по одной вершине
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > baseline;
+			for (size_t i = 0; i < coordinates.size(); i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = static_cast<int>(i);
+				vertex->x = coordinates[i].x * coordinates[i].z;
+				vertex->y = coordinates[i].y * coordinates[i].z;
+				baseline.push_back(vertex);
+			}
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > projected;
+			::triangulation::projectVertex3D(projection, coordinates.data(), coordinates.size(), projected);
+			DELAUNAY_TEST(projected.size() == baseline.size());
+			auto expected = baseline.begin();
+			for (const auto& vertex : projected) {
+				DELAUNAY_TEST(vertex->id == (*expected)->id);
+				DELAUNAY_TEST(vertex->x == (*expected)->x);
+				DELAUNAY_TEST(vertex->y == (*expected)->y);
+				++expected;
+			}
+
+			// вывод совпадает с выводом до введения IProjection
+			const std::string baselineOutput = triangulate(coordinates, baseline);
+			DELAUNAY_TEST(!baselineOutput.empty());
+			DELAUNAY_TEST(triangulate(coordinates, projected) == baselineOutput);
+			DELAUNAY_TEST(triangulate(coordinates, ::triangulation::projectVertex3D(coordinates)) == baselineOutput);
+		DELAUNAY_TEST_END();
+	}
+
+	void ProjectionTest::testPlane()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// прямоугольник в плоскости z = 2, наибольший разброс вдоль x
+			std::vector<::triangulation::Vertex3D> coordinates;
+			for (int i = -10; i <= 10; i++) {
+				for (int j = -2; j <= 2; j++) {
+					coordinates.push_back(vertex3D(static_cast<int>(coordinates.size()), i + 1.0, j - 3.0, 2.0));
+				}
+			}
+			::triangulation::PlaneProjection projection;
+			DELAUNAY_TEST(projection.needsFit());
+			projection.fit(coordinates.data(), coordinates.size());
+
+			// центр масс переходит в начало координат, оси - в главные оси
+			const ::delaunay::Vertex2D center = project(projection, vertex3D(0, 1.0, -3.0, 2.0));
+			DELAUNAY_TEST(near(center.x, 0.0) && near(center.y, 0.0));
+			const ::delaunay::Vertex2D known = project(projection, vertex3D(0, 6.0, -2.0, 2.0));
+			DELAUNAY_TEST(near(std::fabs(known.x), 5.0));
+			DELAUNAY_TEST(near(std::fabs(known.y), 1.0));
+
+			// проекция на плоскость вершин сохраняет расстояния
+			std::vector<::delaunay::Vertex2D> projected(coordinates.size());
+			projection.project(coordinates.data(), coordinates.size(), projected.data());
+			for (size_t i = 1; i < coordinates.size(); i++) {
+				const double distance = std::hypot(
+						coordinates[i].x - coordinates[0].x,
+						coordinates[i].y - coordinates[0].y);
+				DELAUNAY_TEST(near(std::hypot(projected[i].x - projected[0].x, projected[i].y - projected[0].y), distance));
+			}
+		DELAUNAY_TEST_END();
+	}
+
+	void ProjectionTest::testCylindrical()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// дуга цилиндра радиуса 2 с осью, параллельной z, от -120 до 120 градусов;
+			// высота больше диаметра, чтобы ось была главной осью
+			const double radius = 2.0;
+			const double centerX = 1.0;
+			const double centerY = -1.0;
+			auto point = [&](int id, double angle, double height) {
+				return vertex3D(id, centerX + radius * std::cos(angle), centerY + radius * std::sin(angle), height);
+			};
+			std::vector<::triangulation::Vertex3D> coordinates;
+			for (int i = -12; i <= 12; i++) {
+				for (int h = 0; h <= 20; h++) {
+					coordinates.push_back(point(static_cast<int>(coordinates.size()), i * PI / 18.0, h));
+				}
+			}
+			::triangulation::CylindricalProjection projection;
+			DELAUNAY_TEST(projection.needsFit());
+			projection.fit(coordinates.data(), coordinates.size());
+
+			// середина дуги на средней высоте - начало координат
+			const ::delaunay::Vertex2D origin = project(projection, point(0, 0.0, 10.0));
+			DELAUNAY_TEST(near(origin.x, 0.0) && near(origin.y, 0.0));
+			// x - длина дуги от середины, y - высота от средней
+			const ::delaunay::Vertex2D known = project(projection, point(0, PI / 3.0, 14.0));
+			DELAUNAY_TEST(near(std::fabs(known.x), radius * PI / 3.0));
+			DELAUNAY_TEST(near(std::fabs(known.y), 4.0));
+			const ::delaunay::Vertex2D mirrored = project(projection, point(0, -PI / 3.0, 6.0));
+			DELAUNAY_TEST(near(mirrored.x, -known.x));
+			DELAUNAY_TEST(near(mirrored.y, -known.y));
+		DELAUNAY_TEST_END();
+	}
+
+	void ProjectionTest::testSpherical()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// часть сферы радиуса 3 вокруг направления +x: долгота от -70 до 70 градусов,
+			// широта от -30 до 30, поэтому восток - ось y
+			const double radius = 3.0;
+			const double center[3] = {2.0, 3.0, 4.0};
+			auto point = [&](int id, double longitude, double latitude) {
+				return vertex3D(
+						id,
+						center[0] + radius * std::cos(latitude) * std::cos(longitude),
+						center[1] + radius * std::cos(latitude) * std::sin(longitude),
+						center[2] + radius * std::sin(latitude));
+			};
+			std::vector<::triangulation::Vertex3D> coordinates;
+			for (int i = -7; i <= 7; i++) {
+				for (int j = -3; j <= 3; j++) {
+					coordinates.push_back(point(static_cast<int>(coordinates.size()), i * PI / 18.0, j * PI / 18.0));
+				}
+			}
+			::triangulation::SphericalProjection projection;
+			DELAUNAY_TEST(projection.needsFit());
+			projection.fit(coordinates.data(), coordinates.size());
+
+			const ::delaunay::Vertex2D origin = project(projection, point(0, 0.0, 0.0));
+			DELAUNAY_TEST(near(origin.x, 0.0) && near(origin.y, 0.0));
+			// x - длина дуги по экватору, y - по меридиану
+			const ::delaunay::Vertex2D east = project(projection, point(0, PI / 6.0, 0.0));
+			DELAUNAY_TEST(near(std::fabs(east.x), radius * PI / 6.0));
+			DELAUNAY_TEST(near(east.y, 0.0));
+			const ::delaunay::Vertex2D north = project(projection, point(0, 0.0, PI / 6.0));
+			DELAUNAY_TEST(near(north.x, 0.0));
+			DELAUNAY_TEST(near(std::fabs(north.y), radius * PI / 6.0));
+			// точка вне сферы проецируется по направлению из центра
+			const ::delaunay::Vertex2D outside = project(projection, vertex3D(0, center[0] + 10.0, center[1], center[2] + 10.0));
+			DELAUNAY_TEST(near(outside.x, 0.0));
+			DELAUNAY_TEST(near(std::fabs(outside.y), radius * PI / 4.0));
+		DELAUNAY_TEST_END();
+	}
+
+	void ProjectionTest::testSkippedVertices()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// последняя вершина далеко от остальных и не попадает в область,
+			// построенную по первым четырём
+			std::vector<::triangulation::Vertex3D> coordinates = {
+					vertex3D(501, 0.0, 0.0, 1.0),
+					vertex3D(502, 10.0, 0.0, 1.0),
+					vertex3D(503, 0.0, 10.0, 1.0),
+					vertex3D(504, 10.0, 10.0, 1.0),
+					vertex3D(777, 1000.0, 1000.0, 1.0)};
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices =
+					::triangulation::projectVertex3D(coordinates);
+			const std::shared_ptr<::delaunay::Vertex2D> outside = vertices.back();
+			vertices.pop_back();
+
+			bool ok;
+			::delaunay::DelaunayService service;
+			::delaunay::TriangulationCache cache;
+			service.iterativeDynamicProcess(vertices, cache, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(cache.skippedVertices().empty());
+			service.insertVertices(cache, {outside}, &ok);
+			DELAUNAY_TEST(ok);
+
+			// кэш сообщает плотный индекс, в сообщении - номер из файла
+			DELAUNAY_TEST(cache.skippedVertices().size() == 1);
+			DELAUNAY_TEST(cache.skippedVertices().front().id == 4);
+			DELAUNAY_TEST(cache.skippedVertices().front().reason
+					== ::delaunay::SkipReason::OutOfTriangulationArea);
+			std::ostringstream output;
+			::triangulation::writeSkippedVertices(output, cache.skippedVertices(), coordinates);
+			DELAUNAY_TEST(output.str() == "Skipped vertex: 777 (out of triangulation area).\n");
+		DELAUNAY_TEST_END();
+	}
+}
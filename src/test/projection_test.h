@@ -0,0 +1,26 @@
+#ifndef TEST_PROJECTION_TEST_H
+#define TEST_PROJECTION_TEST_H
+
+
+namespace test::triangulation
+{
+	class ProjectionTest
+	{
+	public:
+		ProjectionTest() = default;
+		~ProjectionTest() = default;
+		ProjectionTest(const ProjectionTest&) = delete;
+		ProjectionTest(ProjectionTest&&) = delete;
+		ProjectionTest & operator=(const ProjectionTest&) = delete;
+		ProjectionTest & operator=(ProjectionTest&&) = delete;
+
+		void testLegacy();
+		void testPlane();
+		void testCylindrical();
+		void testSpherical();
+		void testSkippedVertices();
+
+	};
+}
+
+#endif //TEST_PROJECTION_TEST_H
@@ -0,0 +1,202 @@
+#include "result_cache_test.h"
+
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/result_cache.h"
+
+#include "test.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <system_error>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		const char* const DIRECTORY = "result_cache_test";
+
+		using Vertices = std::list<std::shared_ptr<::delaunay::Vertex2D> >;
+		using Triangles = std::list<std::shared_ptr<::delaunay::Triangle> >;
+
+		/**
+		 * Квадрат из четырёх вершин с id - плотными индексами
+		 */
+		Vertices createVertices()
+		{
+			Vertices vertices;
+			const float coordinates[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+			for (int i = 0; i < 4; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				vertex->x = coordinates[i][0];
+				vertex->y = coordinates[i][1];
+				vertices.push_back(vertex);
+			}
+			return vertices;
+		}
+
+		/**
+		 * Два треугольника квадрата, соседи друг друга
+		 */
+		Triangles createTriangles(const Vertices& vertices)
+		{
+			auto v = vertices.begin();
+			const auto v0 = *v++;
+			const auto v1 = *v++;
+			const auto v2 = *v++;
+			const auto v3 = *v;
+			auto first = std::make_shared<::delaunay::Triangle>();
+			first->id = 1;
+			first->vertex1 = v2;
+			first->vertex2 = v1;
+			first->vertex3 = v0;
+			auto second = std::make_shared<::delaunay::Triangle>();
+			second->id = 2;
+			second->vertex1 = v3;
+			second->vertex2 = v2;
+			second->vertex3 = v0;
+			first->triangle2 = second;
+			second->triangle1 = first;
+			return {first, second};
+		}
+
+		bool sameTriangles(const Triangles& expected, const Triangles& actual)
+		{
+			if (expected.size() != actual.size()) {
+				return false;
+			}
+			auto a = actual.begin();
+			for (const auto& e : expected) {
+				const auto& t = *a++;
+				if (e->id != t->id
+						|| e->vertex1 != t->vertex1 || e->vertex2 != t->vertex2 || e->vertex3 != t->vertex3
+						|| !e->triangle1 != !t->triangle1
+						|| !e->triangle2 != !t->triangle2
+						|| !e->triangle3 != !t->triangle3) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * Время последнего использования для LRU задаётся явно, чтобы не зависеть
+		 * от точности времени файловой системы
+		 */
+		void setLastUse(
+				const ::triangulation::ResultCache::Key& key,
+				std::filesystem::file_time_type time)
+		{
+			char name[17];
+			std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key.hash));
+			std::error_code error;
+			std::filesystem::last_write_time(
+					std::filesystem::path(DIRECTORY) / (name + std::string(::triangulation::ResultCache::FILE_SUFFIX)),
+					time,
+					error);
+		}
+	}
+
+	void ResultCacheTest::testKey()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::error_code error;
+			std::filesystem::remove_all(DIRECTORY, error);
+			const Vertices vertices = createVertices();
+			const auto key = ::triangulation::ResultCache::key(vertices, "engine");
+
+			const auto same = ::triangulation::ResultCache::key(createVertices(), "engine");
+			DELAUNAY_TEST(same.hash == key.hash && same.check == key.check && same.vertexCount == 4);
+
+			// другие параметры алгоритма
+			const auto otherEngine = ::triangulation::ResultCache::key(vertices, "engine/2");
+			DELAUNAY_TEST(otherEngine.hash != key.hash && otherEngine.check != key.check);
+
+			// сдвинутая вершина
+			Vertices moved = createVertices();
+			moved.back()->x = 0.5f;
+			const auto otherVertices = ::triangulation::ResultCache::key(moved, "engine");
+			DELAUNAY_TEST(otherVertices.hash != key.hash && otherVertices.check != key.check);
+
+			// другой порядок обработки
+			Vertices reordered = createVertices();
+			reordered.splice(reordered.end(), reordered, reordered.begin());
+			const auto otherOrder = ::triangulation::ResultCache::key(reordered, "engine");
+			DELAUNAY_TEST(otherOrder.hash != key.hash);
+
+			::triangulation::ResultCache cache(DIRECTORY, 1 << 20);
+			Triangles loaded;
+			DELAUNAY_TEST(!cache.load(key, vertices, loaded));
+			DELAUNAY_TEST(loaded.empty());
+			const Triangles triangles = createTriangles(vertices);
+			DELAUNAY_TEST(cache.store(key, triangles));
+
+			DELAUNAY_TEST(cache.load(key, vertices, loaded));
+			DELAUNAY_TEST(sameTriangles(triangles, loaded));
+			DELAUNAY_TEST(loaded.front()->triangle2 == loaded.back());
+			DELAUNAY_TEST(loaded.back()->triangle1 == loaded.front());
+
+			Triangles missed;
+			DELAUNAY_TEST(!cache.load(otherEngine, vertices, missed));
+			DELAUNAY_TEST(!cache.load(otherVertices, moved, missed));
+			// тот же хэш с другим проверочным хэшем не считается попаданием
+			auto collision = key;
+			collision.check++;
+			DELAUNAY_TEST(!cache.load(collision, vertices, missed));
+			DELAUNAY_TEST(missed.empty());
+
+			DELAUNAY_TEST(cache.hits() == 1);
+			DELAUNAY_TEST(cache.misses() == 4);
+			std::filesystem::remove_all(DIRECTORY, error);
+		DELAUNAY_TEST_END();
+	}
+
+	void ResultCacheTest::testEviction()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::error_code error;
+			std::filesystem::remove_all(DIRECTORY, error);
+			const Vertices vertices = createVertices();
+			const Triangles triangles = createTriangles(vertices);
+			const auto first = ::triangulation::ResultCache::key(vertices, "first");
+			const auto second = ::triangulation::ResultCache::key(vertices, "second");
+			const auto third = ::triangulation::ResultCache::key(vertices, "third");
+			const uint64_t resultSize = sizeof(::triangulation::ResultCacheHeader)
+					+ triangles.size() * sizeof(::triangulation::CachedTriangle);
+
+			// помещаются ровно два результата
+			::triangulation::ResultCache cache(DIRECTORY, 2 * resultSize);
+			DELAUNAY_TEST(cache.store(first, triangles));
+			DELAUNAY_TEST(cache.store(second, triangles));
+			const auto now = std::filesystem::file_time_type::clock::now();
+			setLastUse(first, now - std::chrono::hours(2));
+			setLastUse(second, now - std::chrono::hours(1));
+
+			// попадание обновляет время использования первого результата
+			Triangles loaded;
+			DELAUNAY_TEST(cache.load(first, vertices, loaded));
+
+			// третий результат вытесняет давно не использованный второй
+			DELAUNAY_TEST(cache.store(third, triangles));
+			DELAUNAY_TEST(!cache.load(second, vertices, loaded));
+			DELAUNAY_TEST(cache.load(first, vertices, loaded));
+			DELAUNAY_TEST(cache.load(third, vertices, loaded));
+			DELAUNAY_TEST(sameTriangles(triangles, loaded));
+
+			// кэш меньше одного результата: новый результат сразу удаляется
+			::triangulation::ResultCache tiny(DIRECTORY, resultSize - 1);
+			DELAUNAY_TEST(tiny.store(second, triangles));
+			DELAUNAY_TEST(!tiny.load(second, vertices, loaded));
+			DELAUNAY_TEST(!tiny.load(first, vertices, loaded));
+
+			std::filesystem::remove_all(DIRECTORY, error);
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_RESULT_CACHE_TEST_H
+#define TEST_RESULT_CACHE_TEST_H
+
+
+namespace test::triangulation
+{
+	class ResultCacheTest
+	{
+	public:
+		ResultCacheTest() = default;
+		~ResultCacheTest() = default;
+		ResultCacheTest(const ResultCacheTest&) = delete;
+		ResultCacheTest(ResultCacheTest&&) = delete;
+		ResultCacheTest & operator=(const ResultCacheTest&) = delete;
+		ResultCacheTest & operator=(ResultCacheTest&&) = delete;
+
+		void testKey();
+		void testEviction();
+
+	};
+}
+
+#endif //TEST_RESULT_CACHE_TEST_H
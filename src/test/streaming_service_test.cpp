@@ -0,0 +1,192 @@
+#include "streaming_service_test.h"
+
+#include "delaunay/constants.h"
+#include "delaunay/delaunay_factory.h"
+#include "delaunay/delaunay_service.h"
+#include "delaunay/streaming_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/triangulation_cache.h"
+#include "delaunay/vertex_2d.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+namespace test::delaunay
+{
+	namespace
+	{
+		const int GRID_SIZE = 4;
+		const int CELL_VERTEX_COUNT = 100;
+		const float AREA_SIZE = 100.0f;
+
+		double area(const std::list<std::shared_ptr<::delaunay::Triangle> >& triangles)
+		{
+			double result = 0.0;
+			for (const auto& triangle : triangles) {
+				const double bx = triangle->vertex2->x - triangle->vertex1->x;
+				const double by = triangle->vertex2->y - triangle->vertex1->y;
+				const double cx = triangle->vertex3->x - triangle->vertex1->x;
+				const double cy = triangle->vertex3->y - triangle->vertex1->y;
+				result += std::fabs(bx * cy - by * cx) / 2.0;
+			}
+			return result;
+		}
+
+		std::set<std::array<int, 3> > triangleSet(const std::list<std::shared_ptr<::delaunay::Triangle> >& triangles)
+		{
+			std::set<std::array<int, 3> > result;
+			for (const auto& triangle : triangles) {
+				std::array<int, 3> ids = triangle->vertexIds();
+				std::sort(ids.begin(), ids.end());
+				result.insert(ids);
+			}
+			return result;
+		}
+
+		/**
+		 * Случайные вершины, упорядоченные по ячейкам сетки GRID_SIZE x GRID_SIZE:
+		 * cells[row * GRID_SIZE + column]
+		 */
+		std::vector<std::list<std::shared_ptr<::delaunay::Vertex2D> > > cellVertices()
+		{
+			std::vector<std::list<std::shared_ptr<::delaunay::Vertex2D> > > cells(GRID_SIZE * GRID_SIZE);
+			const float cellSize = AREA_SIZE / GRID_SIZE;
+			uint64_t seed = 7;
+			int id = 0;
+			for (int row = 0; row < GRID_SIZE; row++) {
+				for (int column = 0; column < GRID_SIZE; column++) {
+					for (int i = 0; i < CELL_VERTEX_COUNT; i++) {
+						auto vertex = std::make_shared<::delaunay::Vertex2D>();
+						vertex->id = id++;
+						seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+						vertex->x = cellSize * (column + static_cast<float>(seed >> 40) / (1 << 24));
+						seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+						vertex->y = cellSize * (row + static_cast<float>(seed >> 40) / (1 << 24));
+						cells[row * GRID_SIZE + column].push_back(vertex);
+					}
+				}
+			}
+			return cells;
+		}
+	}
+
+	void StreamingServiceTest::testSameAsInMemory()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const auto cells = cellVertices();
+
+			::delaunay::StreamingService service(0.0f, 0.0f, AREA_SIZE, AREA_SIZE, GRID_SIZE, GRID_SIZE);
+			DELAUNAY_TEST(service.isValid());
+			std::list<std::shared_ptr<::delaunay::Triangle> > streamed;
+			size_t releasedBeforeEnd = 0;
+			size_t maxActiveCount = 0;
+			for (int row = 0; row < GRID_SIZE; row++) {
+				for (int column = 0; column < GRID_SIZE; column++) {
+					DELAUNAY_TEST(service.insertVertices(cells[row * GRID_SIZE + column]));
+					maxActiveCount = std::max(maxActiveCount, service.activeTriangleCount());
+					DELAUNAY_TEST(service.finalizeCell(column, row));
+					streamed.splice(streamed.end(), service.releaseFinalizedTriangles());
+				}
+				releasedBeforeEnd = streamed.size();
+			}
+			streamed.splice(streamed.end(), service.releaseAllTriangles());
+			DELAUNAY_TEST(service.activeTriangleCount() == 0);
+
+			// те же вершины в том же порядке без освобождения треугольников
+			::delaunay::TriangulationCache cache;
+			cache.setFlipPropagation(true);
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > corners;
+			for (float x : {0.0f, AREA_SIZE}) {
+				for (float y : {0.0f, AREA_SIZE}) {
+					auto corner = std::make_shared<::delaunay::Vertex2D>();
+					corner->id = ::delaunay::FAKE_ID;
+					corner->x = x;
+					corner->y = y;
+					corners.push_back(corner);
+				}
+			}
+			DELAUNAY_TEST(::delaunay::DelaunayService::insertFakeRectangle(cache, corners));
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			for (const auto& cell : cells) {
+				vertices.insert(vertices.end(), cell.begin(), cell.end());
+			}
+			::delaunay::DelaunayFactory delaunayFactory(cache.nextTriangleId());
+			DELAUNAY_TEST(::delaunay::DelaunayService::processVertices(cache, delaunayFactory, vertices, {}));
+			std::list<std::shared_ptr<::delaunay::Triangle> > expected;
+			for (const auto& triangle : cache.triangles()) {
+				if (triangle->vertex1->id != ::delaunay::FAKE_ID
+						&& triangle->vertex2->id != ::delaunay::FAKE_ID
+						&& triangle->vertex3->id != ::delaunay::FAKE_ID) {
+					expected.push_back(triangle);
+				}
+			}
+
+			// триангуляция Делоне единственна, поэтому сетки совпадают по треугольникам
+			DELAUNAY_TEST(streamed.size() == expected.size());
+			DELAUNAY_TEST(triangleSet(streamed) == triangleSet(expected));
+			DELAUNAY_TEST(std::fabs(area(streamed) - area(expected)) < 1e-3 * area(expected));
+			// каждое ребро разделяют не больше двух треугольников
+			std::map<std::pair<int, int>, int> ribs;
+			for (const auto& triangle : streamed) {
+				const std::array<int, 3> ids = triangle->vertexIds();
+				for (int i = 0; i < 3; i++) {
+					ribs[std::minmax(ids[i], ids[(i + 1) % 3])]++;
+				}
+			}
+			for (const auto& rib : ribs) {
+				DELAUNAY_TEST(rib.second <= 2);
+			}
+			// до конца потока записана большая часть сетки, а в памяти хранится
+			// только фронт
+			DELAUNAY_TEST(releasedBeforeEnd > streamed.size() / 2);
+			DELAUNAY_TEST(maxActiveCount < streamed.size() / 2);
+		DELAUNAY_TEST_END();
+	}
+
+	void StreamingServiceTest::testFinalizedArea()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const auto cells = cellVertices();
+			::delaunay::StreamingService service(0.0f, 0.0f, AREA_SIZE, AREA_SIZE, GRID_SIZE, GRID_SIZE);
+			DELAUNAY_TEST(service.insertVertices(cells[0]));
+			DELAUNAY_TEST(service.finalizeCell(0, 0));
+			DELAUNAY_TEST(!service.finalizeCell(GRID_SIZE, 0));
+			DELAUNAY_TEST(!service.accepts(*cells[0].front()));
+			DELAUNAY_TEST(service.accepts(*cells[1].front()));
+
+			::delaunay::Vertex2D outside;
+			outside.x = AREA_SIZE + 1.0f;
+			outside.y = 1.0f;
+			DELAUNAY_TEST(!service.accepts(outside));
+
+			// вершины завершённой ячейки пропускаются
+			const size_t activeCount = service.activeTriangleCount();
+			auto late = std::make_shared<::delaunay::Vertex2D>();
+			late->id = GRID_SIZE * GRID_SIZE * CELL_VERTEX_COUNT;
+			late->x = 1.0f;
+			late->y = 1.0f;
+			DELAUNAY_TEST(service.insertVertices({late}));
+			DELAUNAY_TEST(service.activeTriangleCount() == activeCount);
+			DELAUNAY_TEST(service.skippedVertices().size() == 1);
+			DELAUNAY_TEST(service.skippedVertices().front().id == late->id);
+			DELAUNAY_TEST(service.skippedVertices().front().reason == ::delaunay::SkipReason::FinalizedArea);
+			DELAUNAY_TEST(service.insertVertices({}));
+			DELAUNAY_TEST(service.skippedVertices().empty());
+
+			::delaunay::StreamingService empty(0.0f, 0.0f, 0.0f, AREA_SIZE, GRID_SIZE, GRID_SIZE);
+			DELAUNAY_TEST(!empty.isValid());
+		DELAUNAY_TEST_END();
+	}
+
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_STREAMING_SERVICE_TEST_H
+#define TEST_STREAMING_SERVICE_TEST_H
+
+
+namespace test::delaunay
+{
+	class StreamingServiceTest
+	{
+	public:
+		StreamingServiceTest() = default;
+		~StreamingServiceTest() = default;
+		StreamingServiceTest(const StreamingServiceTest&) = delete;
+		StreamingServiceTest(StreamingServiceTest&&) = delete;
+		StreamingServiceTest & operator=(const StreamingServiceTest&) = delete;
+		StreamingServiceTest & operator=(StreamingServiceTest&&) = delete;
+
+		void testSameAsInMemory();
+		void testFinalizedArea();
+
+	};
+}
+
+#endif //TEST_STREAMING_SERVICE_TEST_H
@@ -0,0 +1,172 @@
+#include "tetrahedralization_test.h"
+
+#include "tetrahedralization/predicates.h"
+#include "tetrahedralization/tetrahedralization_service.h"
+#include "tetrahedralization/tetrahedron.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+
+namespace test::tetrahedralization
+{
+	namespace
+	{
+		std::array<double, 3> point(const ::triangulation::Vertex3D& vertex)
+		{
+			return {vertex.x, vertex.y, vertex.z};
+		}
+
+		/**
+		 * Проверяет ориентацию тетраэдров, взаимность соседей и формулу Эйлера
+		 * V - E + F - T = 1 для разбиения выпуклой оболочки
+		 */
+		bool isValid(
+				const std::vector<::triangulation::Vertex3D>& coordinates,
+				const std::vector<::tetrahedralization::Tetrahedron>& tetrahedra,
+				size_t vertexCount)
+		{
+			std::set<std::array<int, 2> > edges;
+			std::set<std::array<int, 3> > faces;
+			std::set<int> vertices;
+			for (size_t i = 0; i < tetrahedra.size(); i++) {
+				const ::tetrahedralization::Tetrahedron& tetrahedron = tetrahedra[i];
+				const std::array<double, 3> a = point(coordinates[tetrahedron.vertices[0]]);
+				const std::array<double, 3> b = point(coordinates[tetrahedron.vertices[1]]);
+				const std::array<double, 3> c = point(coordinates[tetrahedron.vertices[2]]);
+				const std::array<double, 3> d = point(coordinates[tetrahedron.vertices[3]]);
+				if (::tetrahedralization::Predicates::orient3d(a.data(), b.data(), c.data(), d.data()) <= 0.0) {
+					return false;
+				}
+				for (int k = 0; k < 4; k++) {
+					vertices.insert(tetrahedron.vertices[k]);
+					for (int l = k + 1; l < 4; l++) {
+						edges.insert({std::min(tetrahedron.vertices[k], tetrahedron.vertices[l]),
+								std::max(tetrahedron.vertices[k], tetrahedron.vertices[l])});
+					}
+					std::array<int, 3> face {};
+					int count = 0;
+					for (int l = 0; l < 4; l++) {
+						if (l != k) {
+							face[count++] = tetrahedron.vertices[l];
+						}
+					}
+					std::sort(face.begin(), face.end());
+					faces.insert(face);
+
+					// сосед напротив вершины k содержит все остальные вершины и ссылается обратно
+					const int neighbour = tetrahedron.neighbours[k];
+					if (neighbour == ::tetrahedralization::Tetrahedron::NO_NEIGHBOUR) {
+						continue;
+					}
+					const ::tetrahedralization::Tetrahedron& other = tetrahedra[static_cast<size_t>(neighbour)];
+					for (int vertex : face) {
+						if (std::find(other.vertices, other.vertices + 4, vertex) == other.vertices + 4) {
+							return false;
+						}
+					}
+					if (std::find(other.neighbours, other.neighbours + 4, static_cast<int>(i)) == other.neighbours + 4) {
+						return false;
+					}
+				}
+			}
+			return vertices.size() == vertexCount
+					&& static_cast<long long>(vertices.size()) - static_cast<long long>(edges.size())
+					+ static_cast<long long>(faces.size()) - static_cast<long long>(tetrahedra.size()) == 1;
+		}
+	}
+
+	void TetrahedralizationTest::testEmptySphere()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// псевдослучайные точки в кубе, чтобы результат не зависел от платформы
+			std::vector<::triangulation::Vertex3D> coordinates;
+			uint32_t seed = 12345;
+			for (int i = 0; i < 400; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = i + 1;
+				seed = seed * 1103515245u + 12345u;
+				vertex.x = static_cast<float>((seed >> 8) % 10000) / 100.0f;
+				seed = seed * 1103515245u + 12345u;
+				vertex.y = static_cast<float>((seed >> 8) % 10000) / 100.0f;
+				seed = seed * 1103515245u + 12345u;
+				vertex.z = static_cast<float>((seed >> 8) % 10000) / 100.0f;
+				coordinates.push_back(vertex);
+			}
+			// повторная вершина пропускается
+			coordinates.push_back(coordinates[10]);
+			coordinates.back().id = 401;
+
+			::tetrahedralization::TetrahedralizationService service;
+			bool ok;
+			const std::vector<::tetrahedralization::Tetrahedron> tetrahedra = service.process(coordinates, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(service.skippedVertices() == 1);
+			DELAUNAY_TEST(isValid(coordinates, tetrahedra, 400));
+
+			// ни одна вершина не лежит внутри описанной сферы тетраэдра
+			bool empty = true;
+			for (const ::tetrahedralization::Tetrahedron& tetrahedron : tetrahedra) {
+				const std::array<double, 3> a = point(coordinates[tetrahedron.vertices[0]]);
+				const std::array<double, 3> b = point(coordinates[tetrahedron.vertices[1]]);
+				const std::array<double, 3> c = point(coordinates[tetrahedron.vertices[2]]);
+				const std::array<double, 3> d = point(coordinates[tetrahedron.vertices[3]]);
+				for (const ::triangulation::Vertex3D& vertex : coordinates) {
+					const std::array<double, 3> e = point(vertex);
+					if (::tetrahedralization::Predicates::insphere(a.data(), b.data(), c.data(), d.data(), e.data()) > 0.0) {
+						empty = false;
+					}
+				}
+			}
+			DELAUNAY_TEST(empty);
+		DELAUNAY_TEST_END();
+	}
+
+	void TetrahedralizationTest::testGrid()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// узлы решётки: по 8 вершин на одной сфере, 4 в одной плоскости на каждой
+			// грани - вырожденный случай, который решают только точные предикаты
+			const int size = 6;
+			std::vector<::triangulation::Vertex3D> coordinates;
+			for (int i = 0; i < size * size * size; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = i + 1;
+				vertex.x = static_cast<float>(i % size);
+				vertex.y = static_cast<float>(i / size % size);
+				vertex.z = static_cast<float>(i / size / size);
+				coordinates.push_back(vertex);
+			}
+			::tetrahedralization::TetrahedralizationService service;
+			bool ok;
+			const std::vector<::tetrahedralization::Tetrahedron> tetrahedra = service.process(coordinates, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(isValid(coordinates, tetrahedra, coordinates.size()));
+
+			// тетраэдры заполняют куб без наложений
+			double volume = 0.0;
+			for (const ::tetrahedralization::Tetrahedron& tetrahedron : tetrahedra) {
+				const std::array<double, 3> a = point(coordinates[tetrahedron.vertices[0]]);
+				const std::array<double, 3> b = point(coordinates[tetrahedron.vertices[1]]);
+				const std::array<double, 3> c = point(coordinates[tetrahedron.vertices[2]]);
+				const std::array<double, 3> d = point(coordinates[tetrahedron.vertices[3]]);
+				volume += ::tetrahedralization::Predicates::orient3d(a.data(), b.data(), c.data(), d.data()) / 6.0;
+			}
+			const double expected = std::pow(static_cast<double>(size - 1), 3.0);
+			DELAUNAY_TEST(std::fabs(volume - expected) < 1e-9);
+
+			// все вершины в одной плоскости
+			std::vector<::triangulation::Vertex3D> plane(coordinates.begin(), coordinates.begin() + size * size);
+			const std::vector<::tetrahedralization::Tetrahedron> flat = service.process(plane, &ok);
+			DELAUNAY_TEST(!ok);
+			DELAUNAY_TEST(flat.empty());
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_TETRAHEDRALIZATION_TEST_H
+#define TEST_TETRAHEDRALIZATION_TEST_H
+
+
+namespace test::tetrahedralization
+{
+	class TetrahedralizationTest
+	{
+	public:
+		TetrahedralizationTest() = default;
+		~TetrahedralizationTest() = default;
+		TetrahedralizationTest(const TetrahedralizationTest&) = delete;
+		TetrahedralizationTest(TetrahedralizationTest&&) = delete;
+		TetrahedralizationTest & operator=(const TetrahedralizationTest&) = delete;
+		TetrahedralizationTest & operator=(TetrahedralizationTest&&) = delete;
+
+		void testEmptySphere();
+		void testGrid();
+
+	};
+}
+
+#endif //TEST_TETRAHEDRALIZATION_TEST_H
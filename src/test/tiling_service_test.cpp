@@ -0,0 +1,184 @@
+#include "tiling_service_test.h"
+
+#include "delaunay/constants.h"
+#include "delaunay/delaunay_factory.h"
+#include "delaunay/delaunay_service.h"
+#include "delaunay/tiling_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/triangulation_cache.h"
+#include "delaunay/vertex_2d.h"
+
+#include "test.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <set>
+#include <vector>
+
+
+namespace test::delaunay
+{
+	namespace
+	{
+		const int VERTEX_COUNT = 1500;
+		const float AREA_SIZE = 100.0f;
+		const int TILES = 3;
+
+		std::list<std::shared_ptr<::delaunay::Vertex2D> > randomVertices()
+		{
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint64_t seed = 11;
+			for (int id = 0; id < VERTEX_COUNT; id++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = id;
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->x = AREA_SIZE * static_cast<float>(seed >> 40) / (1 << 24);
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				vertex->y = AREA_SIZE * static_cast<float>(seed >> 40) / (1 << 24);
+				vertices.push_back(vertex);
+			}
+			return vertices;
+		}
+
+		std::array<int, 3> sortedIds(const ::delaunay::Triangle& triangle)
+		{
+			std::array<int, 3> ids = triangle.vertexIds();
+			std::sort(ids.begin(), ids.end());
+			return ids;
+		}
+
+		/**
+		 * Триангуляция Делоне всех вершин без fake треугольников
+		 */
+		std::set<std::array<int, 3> > inMemoryTriangles(
+				const std::list<std::shared_ptr<::delaunay::Vertex2D> >& vertices)
+		{
+			std::set<std::array<int, 3> > result;
+			::delaunay::TriangulationCache cache;
+			cache.setFlipPropagation(true);
+			if (!::delaunay::DelaunayService::insertFakeRectangle(cache, vertices)) {
+				return result;
+			}
+			::delaunay::DelaunayFactory delaunayFactory(cache.nextTriangleId());
+			if (!::delaunay::DelaunayService::processVertices(cache, delaunayFactory, vertices, {})) {
+				return result;
+			}
+			for (const auto& triangle : cache.triangles()) {
+				if (triangle->vertex1->id != ::delaunay::FAKE_ID
+						&& triangle->vertex2->id != ::delaunay::FAKE_ID
+						&& triangle->vertex3->id != ::delaunay::FAKE_ID) {
+					result.insert(sortedIds(*triangle));
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Строит все области разбиения и собирает записанные треугольники
+		 * @param tiling
+		 * @param vertices
+		 * @param written - треугольники без повторов
+		 * @param triangleCount - треугольники областей вместе с fake треугольниками
+		 * @param vertexCount - вершины тайлов
+		 * @return false если треугольник записан дважды или область не построена
+		 */
+		bool triangulateRegions(
+				const ::delaunay::TilingService& tiling,
+				const std::list<std::shared_ptr<::delaunay::Vertex2D> >& vertices,
+				std::set<std::array<int, 3> >& written,
+				size_t& triangleCount,
+				size_t& vertexCount)
+		{
+			triangleCount = 0;
+			vertexCount = 0;
+			for (int region = 0; region < tiling.regionCount(); region++) {
+				std::list<std::shared_ptr<::delaunay::Vertex2D> > regionVertices;
+				for (const auto& vertex : vertices) {
+					if (tiling.regionContains(region, *vertex)) {
+						regionVertices.push_back(vertex);
+					}
+				}
+				::delaunay::RegionTriangulation result;
+				if (!tiling.triangulateRegion(region, regionVertices, result)) {
+					return false;
+				}
+				for (const auto& triangle : result.triangles) {
+					if (!written.insert(sortedIds(*triangle)).second) {
+						return false;
+					}
+				}
+				triangleCount += result.triangleCount;
+				vertexCount += result.vertexCount;
+			}
+			return true;
+		}
+	}
+
+	void TilingServiceTest::testSameAsInMemory()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const auto vertices = randomVertices();
+			float minX = AREA_SIZE, minY = AREA_SIZE, maxX = 0.0f, maxY = 0.0f;
+			for (const auto& vertex : vertices) {
+				minX = std::min(minX, vertex->x);
+				minY = std::min(minY, vertex->y);
+				maxX = std::max(maxX, vertex->x);
+				maxY = std::max(maxY, vertex->y);
+			}
+			::delaunay::TilingService tiling(minX, minY, maxX, maxY, TILES, TILES, 10.0);
+			DELAUNAY_TEST(tiling.isValid());
+			DELAUNAY_TEST(tiling.tileCount() == TILES * TILES);
+			DELAUNAY_TEST(tiling.regionCount() == TILES * TILES + 2 * (TILES - 1) + 4);
+
+			// regionsOf и regionContains согласованы
+			for (const auto& vertex : vertices) {
+				std::vector<int> regions;
+				tiling.regionsOf(*vertex, regions);
+				DELAUNAY_TEST(std::is_sorted(regions.begin(), regions.end()));
+				size_t containing = 0;
+				for (int region = 0; region < tiling.regionCount(); region++) {
+					containing += tiling.regionContains(region, *vertex) ? 1 : 0;
+				}
+				DELAUNAY_TEST(regions.size() == containing);
+			}
+
+			std::set<std::array<int, 3> > written;
+			size_t triangleCount = 0;
+			size_t vertexCount = 0;
+			DELAUNAY_TEST(triangulateRegions(tiling, vertices, written, triangleCount, vertexCount));
+			DELAUNAY_TEST(vertexCount == vertices.size());
+			DELAUNAY_TEST(triangleCount == ::delaunay::TilingService::expectedTriangleCount(vertexCount));
+			// триангуляция Делоне единственна, поэтому сшитая сетка совпадает с
+			// построенной в памяти
+			DELAUNAY_TEST(written == inMemoryTriangles(vertices));
+		DELAUNAY_TEST_END();
+	}
+
+	void TilingServiceTest::testSmallMargin()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const auto vertices = randomVertices();
+			::delaunay::TilingService tiling(0.0f, 0.0f, AREA_SIZE, AREA_SIZE, TILES, TILES, 0.1);
+			DELAUNAY_TEST(tiling.isValid());
+
+			// окружности части треугольников не помещаются в области: сетка неполная,
+			// но записанные треугольники верны и не повторяются
+			std::set<std::array<int, 3> > written;
+			size_t triangleCount = 0;
+			size_t vertexCount = 0;
+			DELAUNAY_TEST(triangulateRegions(tiling, vertices, written, triangleCount, vertexCount));
+			DELAUNAY_TEST(vertexCount == vertices.size());
+			DELAUNAY_TEST(triangleCount < ::delaunay::TilingService::expectedTriangleCount(vertexCount));
+			const auto expected = inMemoryTriangles(vertices);
+			DELAUNAY_TEST(std::includes(expected.begin(), expected.end(), written.begin(), written.end()));
+
+			::delaunay::TilingService empty(0.0f, 0.0f, AREA_SIZE, 0.0f, TILES, TILES, 1.0);
+			DELAUNAY_TEST(!empty.isValid());
+			DELAUNAY_TEST(empty.regionCount() == 0);
+		DELAUNAY_TEST_END();
+	}
+
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_TILING_SERVICE_TEST_H
+#define TEST_TILING_SERVICE_TEST_H
+
+
+namespace test::delaunay
+{
+	class TilingServiceTest
+	{
+	public:
+		TilingServiceTest() = default;
+		~TilingServiceTest() = default;
+		TilingServiceTest(const TilingServiceTest&) = delete;
+		TilingServiceTest(TilingServiceTest&&) = delete;
+		TilingServiceTest & operator=(const TilingServiceTest&) = delete;
+		TilingServiceTest & operator=(TilingServiceTest&&) = delete;
+
+		void testSameAsInMemory();
+		void testSmallMargin();
+
+	};
+}
+
+#endif //TEST_TILING_SERVICE_TEST_H
@@ -63,4 +63,61 @@ namespace test::delaunay
 
 		DELAUNAY_TEST_END();
 	}
+
+	void TriangleTest::testCommonRib()
+	{
+		DELAUNAY_TEST_BEGIN();
+			std::shared_ptr<::delaunay::Vertex2D> vertex1 = std::make_shared<::delaunay::Vertex2D>();
+			std::shared_ptr<::delaunay::Vertex2D> vertex2 = std::make_shared<::delaunay::Vertex2D>();
+			std::shared_ptr<::delaunay::Vertex2D> vertex3 = std::make_shared<::delaunay::Vertex2D>();
+			std::shared_ptr<::delaunay::Vertex2D> vertex4 = std::make_shared<::delaunay::Vertex2D>();
+			std::shared_ptr<::delaunay::Vertex2D> sameAsVertex4 = std::make_shared<::delaunay::Vertex2D>();
+			vertex1->x = 0.0f;
+			vertex1->y = 0.0f;
+			vertex2->x = 0.0f;
+			vertex2->y = 2.0f;
+			vertex3->x = 2.0f;
+			vertex3->y = 0.0f;
+			vertex4->x = 2.0f;
+			vertex4->y = 2.0f;
+			sameAsVertex4->x = 2.0f;
+			sameAsVertex4->y = 2.0f;
+
+			std::shared_ptr<::delaunay::Triangle> triangle = std::make_shared<::delaunay::Triangle>();
+			triangle->vertex1 = vertex1;
+			triangle->vertex2 = vertex2;
+			triangle->vertex3 = vertex3;
+
+			std::shared_ptr<::delaunay::Triangle> adjacentTriangle = std::make_shared<::delaunay::Triangle>();
+			adjacentTriangle->vertex1 = vertex4;
+			adjacentTriangle->vertex2 = vertex3;
+			adjacentTriangle->vertex3 = vertex2;
+			DELAUNAY_TEST(triangle->commonRib(adjacentTriangle) == 1);
+			DELAUNAY_TEST(adjacentTriangle->commonRib(triangle) == 1);
+
+			adjacentTriangle->vertex1 = vertex3;
+			adjacentTriangle->vertex2 = vertex4;
+			adjacentTriangle->vertex3 = vertex2;
+			DELAUNAY_TEST(triangle->commonRib(adjacentTriangle) == 2);
+
+			adjacentTriangle->vertex1 = vertex3;
+			adjacentTriangle->vertex2 = vertex2;
+			adjacentTriangle->vertex3 = vertex4;
+			DELAUNAY_TEST(triangle->commonRib(adjacentTriangle) == 3);
+
+			// Общей считается только та же самая вершина, а не вершина с теми же координатами
+			adjacentTriangle->vertex1 = sameAsVertex4;
+			adjacentTriangle->vertex2 = vertex3;
+			adjacentTriangle->vertex3 = vertex4;
+			DELAUNAY_TEST(triangle->commonRib(adjacentTriangle) == 0);
+
+			std::shared_ptr<::delaunay::Triangle> emptyTriangle;
+			DELAUNAY_TEST(triangle->commonRib(emptyTriangle) == 0);
+
+			triangle->neighbour(2) = adjacentTriangle;
+			DELAUNAY_TEST(triangle->triangle2 == adjacentTriangle);
+			DELAUNAY_TEST(!triangle->triangle1 && !triangle->triangle3);
+
+		DELAUNAY_TEST_END();
+	}
 }
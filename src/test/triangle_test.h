@@ -15,6 +15,7 @@ namespace test::delaunay
 		TriangleTest & operator=(TriangleTest&&) = delete;
 
 		void testVertexRelation();
+		void testCommonRib();
 
 	};
 
@@ -1,6 +1,7 @@
 #include "triangulation_cache_test.h"
 
 #include "delaunay/delaunay_factory.h"
+#include "delaunay/delaunay_service.h"
 #include "delaunay/triangulation_cache.h"
 #include "delaunay/triangle.h"
 #include "delaunay/utils.h"
@@ -8,13 +9,48 @@
 
 #include "test.h"
 
+#include <algorithm>
+#include <array>
 #include <list>
 #include <memory>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
 
 
 namespace test::delaunay
 {
+	namespace
+	{
+		// id треугольника, id его вершин и id соседних треугольников
+		std::vector<int> describe(const std::list<std::shared_ptr<::delaunay::Triangle> >& triangles)
+		{
+			std::vector<int> result;
+			for (const auto& triangle : triangles) {
+				result.push_back(triangle->id);
+				for (int id : triangle->vertexIds()) {
+					result.push_back(id);
+				}
+				for (const auto* neighbour : {&triangle->triangle1, &triangle->triangle2, &triangle->triangle3}) {
+					result.push_back(*neighbour ? (*neighbour)->id : 0);
+				}
+			}
+			return result;
+		}
+
+		bool loadSnapshot(::delaunay::TriangulationCache& cache, const std::string& snapshot)
+		{
+			// копия с выравниванием, как у отображённого в память файла
+			std::vector<uint32_t> data((snapshot.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+			std::memcpy(data.data(), snapshot.data(), snapshot.size());
+			return cache.load(reinterpret_cast<const char*>(data.data()), snapshot.size());
+		}
+	}
+
 	void TriangulationCacheTest::testFindAppropriateTriangle()
 	{
 		DELAUNAY_TEST_BEGIN();
@@ -328,4 +364,265 @@ namespace test::delaunay
 		DELAUNAY_TEST_END();
 		*/
 	}
+
+	void TriangulationCacheTest::testSnapshot()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// первая часть вершин задаёт область триангуляции, вторая добавляется
+			// после сохранения и загрузки снимка
+			const int count = 600;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > firstVertices;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > secondVertices;
+			uint32_t seed = 2024;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 10000) / 100.0f;
+			};
+			for (int i = 0; i < count; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				vertex->x = random();
+				vertex->y = random();
+				(i < count / 2 ? firstVertices : secondVertices).push_back(vertex);
+			}
+
+			bool ok;
+			::delaunay::DelaunayService service;
+			::delaunay::TriangulationCache cache;
+			const std::list<std::shared_ptr<::delaunay::Triangle> > firstTriangles =
+					service.iterativeDynamicProcess(firstVertices, cache, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(!firstTriangles.empty());
+
+			std::ostringstream output;
+			DELAUNAY_TEST(cache.save(output));
+			const std::string snapshot = output.str();
+
+			::delaunay::TriangulationCache loadedCache;
+			DELAUNAY_TEST(loadSnapshot(loadedCache, snapshot));
+			DELAUNAY_TEST(loadedCache.nextTriangleId() == cache.nextTriangleId());
+			DELAUNAY_TEST(describe(loadedCache.triangles()) == describe(cache.triangles()));
+
+			// сетка и её границы восстановлены без изменений
+			std::ostringstream loadedOutput;
+			DELAUNAY_TEST(loadedCache.save(loadedOutput));
+			DELAUNAY_TEST(loadedOutput.str() == snapshot);
+
+			// продолжение триангуляции даёт тот же результат, что и без снимка
+			const std::list<std::shared_ptr<::delaunay::Triangle> > triangles =
+					service.insertVertices(cache, secondVertices, &ok);
+			DELAUNAY_TEST(ok);
+			const std::list<std::shared_ptr<::delaunay::Triangle> > loadedTriangles =
+					service.insertVertices(loadedCache, secondVertices, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(triangles.size() > firstTriangles.size());
+			DELAUNAY_TEST(describe(loadedTriangles) == describe(triangles));
+
+			// повторная загрузка в заполненный кэш разрывает связи прежних треугольников,
+			// и их вершины освобождаются
+			const std::weak_ptr<::delaunay::Vertex2D> oldVertex =
+					loadedCache.triangles().front()->vertex1;
+			DELAUNAY_TEST(loadSnapshot(loadedCache, snapshot));
+			DELAUNAY_TEST(oldVertex.expired());
+			std::ostringstream reloadedOutput;
+			DELAUNAY_TEST(loadedCache.save(reloadedOutput));
+			DELAUNAY_TEST(reloadedOutput.str() == snapshot);
+
+			// повреждённый снимок не загружается
+			std::string damagedSnapshot = snapshot;
+			damagedSnapshot.resize(damagedSnapshot.size() - 1);
+			::delaunay::TriangulationCache damagedCache;
+			DELAUNAY_TEST(!loadSnapshot(damagedCache, damagedSnapshot));
+			DELAUNAY_TEST(damagedCache.triangles().empty());
+
+			// как и снимок с вырожденными границами сетки
+			::delaunay::TriangulationSnapshotHeader header;
+			std::memcpy(&header, snapshot.data(), sizeof(header));
+			header.maxX = header.minX;
+			damagedSnapshot = snapshot;
+			damagedSnapshot.replace(0, sizeof(header), reinterpret_cast<const char*>(&header), sizeof(header));
+			DELAUNAY_TEST(!loadSnapshot(damagedCache, damagedSnapshot));
+			DELAUNAY_TEST(damagedCache.triangles().empty());
+		DELAUNAY_TEST_END();
+	}
+
+	void TriangulationCacheTest::testReset()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const int count = 400;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint32_t seed = 2025;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 10000) / 100.0f;
+			};
+			for (int i = 0; i < count; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				vertex->x = random();
+				vertex->y = random();
+				vertices.push_back(vertex);
+			}
+
+			bool ok;
+			::delaunay::DelaunayService service;
+			::delaunay::TriangulationCache cache;
+			service.iterativeDynamicProcess(vertices, cache, &ok);
+			DELAUNAY_TEST(ok);
+			const std::vector<int> expected = describe(cache.triangles());
+			std::ostringstream expectedSnapshot;
+			DELAUNAY_TEST(cache.save(expectedSnapshot));
+			const size_t triangleCount = cache.triangles().size();
+
+			// треугольник, который ещё используется, не попадает в пул
+			std::shared_ptr<::delaunay::Triangle> held = cache.triangles().back();
+			cache.reset();
+			DELAUNAY_TEST(cache.triangles().empty());
+			DELAUNAY_TEST(cache.trianglePool().size() == triangleCount - 1);
+			DELAUNAY_TEST(!held->vertex1 && !held->triangle1);
+			held.reset();
+
+			// повторная триангуляция из пула даёт тот же результат и тот же снимок
+			service.iterativeDynamicProcess(vertices, cache, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(describe(cache.triangles()) == expected);
+			std::ostringstream snapshot;
+			DELAUNAY_TEST(cache.save(snapshot));
+			DELAUNAY_TEST(snapshot.str() == expectedSnapshot.str());
+
+			// после периода маленьких триангуляций пул сокращается до их размера
+			vertices.resize(count / 10);
+			for (int i = 0; i < 32; i++) {
+				cache.reset();
+				service.iterativeDynamicProcess(vertices, cache, &ok);
+				DELAUNAY_TEST(ok);
+			}
+			const size_t smallTriangleCount = cache.triangles().size();
+			cache.reset();
+			DELAUNAY_TEST(cache.trianglePool().size() == smallTriangleCount);
+		DELAUNAY_TEST_END();
+	}
+
+	void TriangulationCacheTest::testCellBorders()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const int count = 300;
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			uint32_t seed = 4711;
+			auto random = [&seed]() {
+				seed = seed * 1103515245u + 12345u;
+				return static_cast<float>((seed >> 8) % 10000) / 100.0f;
+			};
+			for (int i = 0; i < count; i++) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>();
+				vertex->id = i;
+				vertex->x = random();
+				vertex->y = random();
+				vertices.push_back(vertex);
+			}
+			bool ok;
+			::delaunay::DelaunayService service;
+			::delaunay::TriangulationCache cache;
+			service.iterativeDynamicProcess(vertices, cache, &ok);
+			DELAUNAY_TEST(ok);
+
+			// сетка кэша по заголовку снимка, как в TriangulationCache::initCache
+			std::ostringstream output;
+			DELAUNAY_TEST(cache.save(output));
+			::delaunay::TriangulationSnapshotHeader header;
+			std::memcpy(&header, output.str().data(), sizeof(header));
+			const float aX = static_cast<float>(header.cacheSize - 1) / (header.maxX - header.minX);
+			const float bX = -header.minX * aX;
+			const float aY = static_cast<float>(header.cacheSize - 1) / (header.maxY - header.minY);
+			const float bY = -header.minY * aY;
+
+			// точки на границах ячеек и рядом с ними, а также на рёбрах длинных
+			// треугольников с fake вершинами
+			std::vector<::delaunay::Vertex2D> points;
+			auto addPoint = [&points](float x, float y) {
+				::delaunay::Vertex2D point;
+				point.x = x;
+				point.y = y;
+				points.push_back(point);
+			};
+			for (int k = 0; k + 1 < header.cacheSize; k++) {
+				const float borderX = (static_cast<float>(k) + 0.5f - bX) / aX;
+				const float borderY = (static_cast<float>(k) + 0.5f - bY) / aY;
+				for (int l = 0; l <= 8; l++) {
+					const float x = header.minX + (header.maxX - header.minX) * (static_cast<float>(l) + 0.3f) / 9.0f;
+					const float y = header.minY + (header.maxY - header.minY) * (static_cast<float>(l) + 0.3f) / 9.0f;
+					for (float delta : {-1.0f, 0.0f, 1.0f}) {
+						addPoint(std::nextafter(borderX, borderX + delta), y);
+						addPoint(x, std::nextafter(borderY, borderY + delta));
+					}
+				}
+			}
+			for (const auto& triangle : cache.triangles()) {
+				const std::array<int, 3> ids = triangle->vertexIds();
+				if (std::find(ids.begin(), ids.end(), ::delaunay::FAKE_ID) == ids.end()) {
+					continue;
+				}
+				const ::delaunay::Vertex2D* corners[3] = {
+						triangle->vertex1.get(), triangle->vertex2.get(), triangle->vertex3.get()};
+				// рёбра 12, 23, 31 и треугольники за ними
+				const ::delaunay::Triangle* opposite[3] = {
+						triangle->triangle3.get(), triangle->triangle1.get(), triangle->triangle2.get()};
+				for (int k = 0; k < 3; k++) {
+					// на внешнюю границу fake прямоугольника вершины не попадают
+					if (!opposite[k]) {
+						continue;
+					}
+					const ::delaunay::Vertex2D& first = *corners[k];
+					const ::delaunay::Vertex2D& second = *corners[(k + 1) % 3];
+					for (float t : {0.25f, 0.5f, 0.75f}) {
+						addPoint(first.x + (second.x - first.x) * t, first.y + (second.y - first.y) * t);
+					}
+				}
+			}
+
+			// для каждой точки находится треугольник, в который она попадает
+			for (const auto& point : points) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>(point);
+				const std::shared_ptr<::delaunay::Triangle> triangle = cache.findAppropriateTriangle(vertex);
+				DELAUNAY_TEST(triangle);
+				DELAUNAY_TEST(triangle->vertexRelation(vertex, &ok) != ::delaunay::VertexRelation::VertexOutOfTriangle);
+				DELAUNAY_TEST(ok);
+			}
+
+			// если в ячейке точки нет подходящего треугольника, он находится переходом
+			// по соседям: в снимке все треугольники оставлены только в первой ячейке
+			const std::string snapshot = output.str();
+			const size_t cellCount = static_cast<size_t>(header.cacheSize) * header.cacheSize;
+			const size_t cellsOffset = sizeof(header)
+					+ header.vertexCount * sizeof(::delaunay::SnapshotVertex)
+					+ header.triangleCount * sizeof(::delaunay::SnapshotTriangle);
+			::delaunay::TriangulationSnapshotHeader sparseHeader = header;
+			sparseHeader.cellEntryCount = 1;
+			std::string sparseSnapshot(reinterpret_cast<const char*>(&sparseHeader), sizeof(sparseHeader));
+			sparseSnapshot.append(snapshot, sizeof(header), cellsOffset - sizeof(header));
+			std::vector<uint32_t> cells(cellCount + 2, 1);
+			cells[0] = 0;
+			cells[cellCount + 1] = 0;
+			sparseSnapshot.append(reinterpret_cast<const char*>(cells.data()), cells.size() * sizeof(uint32_t));
+			::delaunay::TriangulationCache sparseCache;
+			DELAUNAY_TEST(loadSnapshot(sparseCache, sparseSnapshot));
+			for (const auto& point : points) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>(point);
+				const std::shared_ptr<::delaunay::Triangle> triangle = sparseCache.findAppropriateTriangle(vertex);
+				DELAUNAY_TEST(triangle);
+				DELAUNAY_TEST(triangle->vertexRelation(vertex, &ok) != ::delaunay::VertexRelation::VertexOutOfTriangle);
+			}
+
+			// и точки добавляются в триангуляцию
+			std::list<std::shared_ptr<::delaunay::Vertex2D> > inserted;
+			for (const auto& point : points) {
+				auto vertex = std::make_shared<::delaunay::Vertex2D>(point);
+				vertex->id = count + static_cast<int>(inserted.size());
+				inserted.push_back(vertex);
+			}
+			service.insertVertices(cache, inserted, &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(cache.triangles().size() > 2 * static_cast<size_t>(count));
+		DELAUNAY_TEST_END();
+	}
 }
@@ -18,6 +18,9 @@ namespace test::delaunay
 		void testCreateNewThreeTrianglesNearInnerVertex();
 		void testCreateNewTwoOrFourTrianglesNearVertexOnRib();
 		void testCheckDelaunayConditionAndRebuildIfNeed();
+		void testSnapshot();
+		void testReset();
+		void testCellBorders();
 
 	};
 }
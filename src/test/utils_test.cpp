@@ -230,16 +230,13 @@ namespace test::delaunay
 			triangle1->vertex2 = vertex12;
 			triangle1->vertex3 = vertex13;
 
+			// Смежные треугольники разделяют одни и те же объекты вершин общего ребра
 			std::shared_ptr<::delaunay::Vertex2D> vertex21 = std::make_shared<::delaunay::Vertex2D>();
-			std::shared_ptr<::delaunay::Vertex2D> vertex22 = std::make_shared<::delaunay::Vertex2D>();
-			std::shared_ptr<::delaunay::Vertex2D> vertex23 = std::make_shared<::delaunay::Vertex2D>();
+			std::shared_ptr<::delaunay::Vertex2D> vertex22 = vertex13;
+			std::shared_ptr<::delaunay::Vertex2D> vertex23 = vertex12;
 			std::shared_ptr<::delaunay::Triangle> triangle2 = std::make_shared<::delaunay::Triangle>();
 			vertex21->x = 3.0f;
 			vertex21->y = 0.0f;
-			vertex22->x = 2.0f;
-			vertex22->y = -1.0f;
-			vertex23->x = 2.0f;
-			vertex23->y = 2.0f;
 			triangle2->vertex1 = vertex21;
 			triangle2->vertex2 = vertex22;
 			triangle2->vertex3 = vertex23;
@@ -251,6 +248,23 @@ namespace test::delaunay
 			DELAUNAY_TEST(!result1);
 			DELAUNAY_TEST(!result2);
 
+			// Один угол тупой, другой острый; треугольники по часовой стрелке, как в
+			// триангуляции
+			vertex11->x = 0.0f;
+			vertex11->y = 1.0f;
+			vertex12->x = 1.0f;
+			vertex12->y = 0.0f;
+			vertex13->x = -1.0f;
+			vertex13->y = 0.0f;
+			vertex21->x = 0.0f;
+			vertex21->y = -0.2f;
+			// vertex21 внутри описанной окружности triangle1
+			DELAUNAY_TEST(!::delaunay::Utils::checkSumOppositeAngles(triangle1, 1));
+			vertex11->y = 0.5f;
+			vertex21->y = -3.0f;
+			// vertex21 вне описанной окружности triangle1
+			DELAUNAY_TEST(::delaunay::Utils::checkSumOppositeAngles(triangle1, 1));
+
 		DELAUNAY_TEST_END();
 	}
 
@@ -271,16 +285,13 @@ namespace test::delaunay
 			triangle1->vertex2 = vertex12;
 			triangle1->vertex3 = vertex13;
 
+			// Смежные треугольники разделяют одни и те же объекты вершин общего ребра
 			std::shared_ptr<::delaunay::Vertex2D> vertex21 = std::make_shared<::delaunay::Vertex2D>();
-			std::shared_ptr<::delaunay::Vertex2D> vertex22 = std::make_shared<::delaunay::Vertex2D>();
-			std::shared_ptr<::delaunay::Vertex2D> vertex23 = std::make_shared<::delaunay::Vertex2D>();
+			std::shared_ptr<::delaunay::Vertex2D> vertex22 = vertex13;
+			std::shared_ptr<::delaunay::Vertex2D> vertex23 = vertex12;
 			std::shared_ptr<::delaunay::Triangle> triangle2 = std::make_shared<::delaunay::Triangle>();
 			vertex21->x = 2.0f;
 			vertex21->y = -1.0f;
-			vertex22->x = 1.0f;
-			vertex22->y = 0.0f;
-			vertex23->x = 3.0f;
-			vertex23->y = 0.0f;
 			triangle2->vertex1 = vertex21;
 			triangle2->vertex2 = vertex22;
 			triangle2->vertex3 = vertex23;
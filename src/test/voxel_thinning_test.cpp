@@ -0,0 +1,88 @@
+#include "voxel_thinning_test.h"
+
+#include "triangulation/vertex_3d.h"
+#include "triangulation/voxel_thinning.h"
+
+#include "test.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		/**
+		 * Плоское облако: countX * countY квадратов со стороной 1, в каждом по
+		 * perCell вершин, одна из которых - в центре квадрата
+		 */
+		std::vector<::triangulation::Vertex3D> cloud(int countX, int countY, int perCell)
+		{
+			std::vector<::triangulation::Vertex3D> result;
+			uint32_t seed = 42;
+			for (int cell = 0; cell < countX * countY; cell++) {
+				for (int k = 0; k < perCell; k++) {
+					seed = seed * 1103515245u + 12345u;
+					const float dx = k == 0 ? 0.5f : static_cast<float>((seed >> 8) % 800 + 100) / 1000.0f;
+					seed = seed * 1103515245u + 12345u;
+					const float dy = k == 0 ? 0.5f : static_cast<float>((seed >> 8) % 800 + 100) / 1000.0f;
+					::triangulation::Vertex3D vertex;
+					vertex.id = static_cast<int>(result.size()) + 1000;
+					vertex.x = static_cast<float>(cell % countX) + dx;
+					vertex.y = static_cast<float>(cell / countX) + dy;
+					vertex.z = 0.0f;
+					result.push_back(vertex);
+				}
+			}
+			// габаритный прямоугольник начинается в (0, 0), чтобы кубы совпали с квадратами
+			result[0].x = 0.0f;
+			result[0].y = 0.0f;
+			result[0].id = 1;
+			return result;
+		}
+	}
+
+	void VoxelThinningTest::testThin()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const std::vector<::triangulation::Vertex3D> coordinates = cloud(300, 300, 10);
+			::triangulation::VoxelThinning serial;
+			const std::vector<::triangulation::Vertex3D> thinned = serial.thin(coordinates, 1.0);
+			DELAUNAY_TEST(thinned.size() == 300 * 300);
+			// остаются центральные вершины квадратов (кроме первого, центр которого сдвинут
+			// в угол) с исходными id и в исходном порядке
+			bool centers = true;
+			for (size_t i = 1; i < thinned.size(); i++) {
+				const ::triangulation::Vertex3D& vertex = thinned[i];
+				centers = centers && (vertex.id - 1000) % 10 == 0 && vertex.id > thinned[i - 1].id
+						&& coordinates[static_cast<size_t>(vertex.id - 1000)].x == vertex.x;
+			}
+			DELAUNAY_TEST(centers);
+
+			::triangulation::VoxelThinning parallel(4);
+			const std::vector<::triangulation::Vertex3D> parallelThinned = parallel.thin(coordinates, 1.0);
+			bool same = parallelThinned.size() == thinned.size();
+			for (size_t i = 0; same && i < thinned.size(); i++) {
+				same = parallelThinned[i].id == thinned[i].id;
+			}
+			DELAUNAY_TEST(same);
+
+			DELAUNAY_TEST(serial.thin(coordinates, 0.0).size() == coordinates.size());
+		DELAUNAY_TEST_END();
+	}
+
+	void VoxelThinningTest::testBudget()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const std::vector<::triangulation::Vertex3D> coordinates = cloud(100, 100, 5);
+			::triangulation::VoxelThinning thinning;
+			DELAUNAY_TEST(thinning.spacingForBudget(coordinates, coordinates.size()) == 0.0);
+			const double spacing = thinning.spacingForBudget(coordinates, 2000);
+			DELAUNAY_TEST(spacing > 0.0);
+			const size_t count = thinning.thin(coordinates, spacing).size();
+			DELAUNAY_TEST(count <= 2000);
+			DELAUNAY_TEST(count >= 1500);
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_VOXEL_THINNING_TEST_H
+#define TEST_VOXEL_THINNING_TEST_H
+
+
+namespace test::triangulation
+{
+	class VoxelThinningTest
+	{
+	public:
+		VoxelThinningTest() = default;
+		~VoxelThinningTest() = default;
+		VoxelThinningTest(const VoxelThinningTest&) = delete;
+		VoxelThinningTest(VoxelThinningTest&&) = delete;
+		VoxelThinningTest & operator=(const VoxelThinningTest&) = delete;
+		VoxelThinningTest & operator=(VoxelThinningTest&&) = delete;
+
+		void testThin();
+		void testBudget();
+
+	};
+}
+
+#endif //TEST_VOXEL_THINNING_TEST_H
@@ -0,0 +1,419 @@
+#include "writer_test.h"
+
+#include "delaunay/delaunay_service.h"
+#include "delaunay/triangle.h"
+#include "delaunay/vertex_2d.h"
+#include "triangulation/default_writer.h"
+#include "triangulation/obj_writer.h"
+#include "triangulation/parallel_writer.h"
+#include "triangulation/ply_writer.h"
+#include "triangulation/stl_writer.h"
+#include "triangulation/vertex_3d.h"
+
+#include "test.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace test::triangulation
+{
+	namespace
+	{
+		struct Mesh
+		{
+			std::vector<::triangulation::Vertex3D> coordinates;
+			std::vector<std::shared_ptr<::delaunay::Vertex2D> > vertices;
+			std::list<std::shared_ptr<::delaunay::Triangle> > triangles;
+			std::vector<bool> usedVertices;
+		};
+
+		/**
+		 * Регулярная сетка size x size вершин, каждая ячейка - два треугольника.
+		 * Ячейки, для которых skipCell возвращает true, пропускаются, поэтому часть
+		 * вершин не используется.
+		 */
+		template<typename SkipCell>
+		Mesh createGrid(int size, SkipCell skipCell)
+		{
+			Mesh mesh;
+			for (int y = 0; y < size; y++) {
+				for (int x = 0; x < size; x++) {
+					const int i = y * size + x;
+					::triangulation::Vertex3D vertex;
+					vertex.id = 10 * i + 1;
+					vertex.x = static_cast<float>(x) * 0.37f - 12.5f;
+					vertex.y = static_cast<float>(y) * 1.13f + 1000.0f;
+					vertex.z = static_cast<float>((x * 7 + y * 13) % 101) / 3.0f - 16.0f;
+					mesh.coordinates.push_back(vertex);
+
+					auto vertex2D = std::make_shared<::delaunay::Vertex2D>();
+					vertex2D->id = i;
+					vertex2D->x = vertex.x;
+					vertex2D->y = vertex.y;
+					mesh.vertices.push_back(vertex2D);
+				}
+			}
+			int id = 1;
+			for (int y = 0; y + 1 < size; y++) {
+				for (int x = 0; x + 1 < size; x++) {
+					if (skipCell(x, y)) {
+						continue;
+					}
+					const auto& v00 = mesh.vertices[y * size + x];
+					const auto& v10 = mesh.vertices[y * size + x + 1];
+					const auto& v01 = mesh.vertices[(y + 1) * size + x];
+					const auto& v11 = mesh.vertices[(y + 1) * size + x + 1];
+					auto lower = std::make_shared<::delaunay::Triangle>();
+					lower->id = id++;
+					lower->vertex1 = v11;
+					lower->vertex2 = v10;
+					lower->vertex3 = v00;
+					auto upper = std::make_shared<::delaunay::Triangle>();
+					upper->id = id++;
+					upper->vertex1 = v01;
+					upper->vertex2 = v11;
+					upper->vertex3 = v00;
+					lower->triangle2 = upper;
+					upper->triangle1 = lower;
+					mesh.triangles.push_back(lower);
+					mesh.triangles.push_back(upper);
+				}
+			}
+			mesh.usedVertices = ::delaunay::DelaunayService::usedVertices(mesh.triangles, mesh.coordinates.size());
+			return mesh;
+		}
+
+		/**
+		 * Квадрат из двух треугольников и неиспользованная вершина между ними
+		 * в coordinates. Треугольники заданы по часовой стрелке, как в DelaunayService.
+		 */
+		Mesh createSquare()
+		{
+			Mesh mesh;
+			const float points[5][3] = {
+					{0.0f, 0.0f, 1.5f},
+					{2.0f, 0.0f, -0.25f},
+					{9.0f, 9.0f, 9.0f},
+					{2.0f, 2.0f, 3.0f},
+					{0.0f, 2.0f, 1.0e6f}};
+			for (int i = 0; i < 5; i++) {
+				::triangulation::Vertex3D vertex;
+				vertex.id = 11 + i;
+				vertex.x = points[i][0];
+				vertex.y = points[i][1];
+				vertex.z = points[i][2];
+				mesh.coordinates.push_back(vertex);
+
+				auto vertex2D = std::make_shared<::delaunay::Vertex2D>();
+				vertex2D->id = i;
+				vertex2D->x = vertex.x;
+				vertex2D->y = vertex.y;
+				mesh.vertices.push_back(vertex2D);
+			}
+			auto lower = std::make_shared<::delaunay::Triangle>();
+			lower->id = 1;
+			lower->vertex1 = mesh.vertices[3];
+			lower->vertex2 = mesh.vertices[1];
+			lower->vertex3 = mesh.vertices[0];
+			auto upper = std::make_shared<::delaunay::Triangle>();
+			upper->id = 2;
+			upper->vertex1 = mesh.vertices[4];
+			upper->vertex2 = mesh.vertices[3];
+			upper->vertex3 = mesh.vertices[0];
+			lower->triangle2 = upper;
+			upper->triangle1 = lower;
+			mesh.triangles = {lower, upper};
+			mesh.usedVertices = ::delaunay::DelaunayService::usedVertices(mesh.triangles, mesh.coordinates.size());
+			return mesh;
+		}
+
+		/**
+		 * Вершины треугольника в том порядке, в котором их перечисляют OBJ, PLY и
+		 * STL: 1, 3, 2, то есть против часовой стрелки.
+		 */
+		std::array<size_t, 3> counterClockwise(const ::delaunay::Triangle& triangle)
+		{
+			return {
+					static_cast<size_t>(triangle.vertex1->id),
+					static_cast<size_t>(triangle.vertex3->id),
+					static_cast<size_t>(triangle.vertex2->id)};
+		}
+
+		/**
+		 * Удвоенная ориентированная площадь треугольника в плоскости проекции,
+		 * положительная при обходе против часовой стрелки.
+		 */
+		float orientedArea(const Mesh& mesh, const std::array<size_t, 3>& order)
+		{
+			const ::triangulation::Vertex3D& a = mesh.coordinates[order[0]];
+			const ::triangulation::Vertex3D& b = mesh.coordinates[order[1]];
+			const ::triangulation::Vertex3D& c = mesh.coordinates[order[2]];
+			return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		}
+
+		template<typename T>
+		void appendValue(std::string& data, T value)
+		{
+			data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		template<typename T>
+		T readValue(const std::string& data, size_t offset)
+		{
+			T value;
+			std::memcpy(&value, data.data() + offset, sizeof(value));
+			return value;
+		}
+
+		std::string write(::triangulation::IFileWriter& writer, const Mesh& mesh, bool* ok)
+		{
+			std::ostringstream stream(std::ios::out | std::ios::binary);
+			*ok = writer.writeStream(stream, mesh.coordinates, mesh.triangles, mesh.usedVertices);
+			return stream.str();
+		}
+	}
+
+	void WriterTest::testParallelWriter()
+	{
+		DELAUNAY_TEST_BEGIN();
+			const size_t chunk = ::triangulation::ParallelWriter::LINES_PER_CHUNK;
+			// вершин и треугольников больше, чем строк в одной части, и части
+			// начинаются на пропущенных вершинах
+			std::vector<Mesh> meshes;
+			meshes.push_back(createGrid(300, [](int x, int y) { return (x / 10 + y / 10) % 5 == 0; }));
+			meshes.push_back(createGrid(3, [](int, int) { return false; }));
+			meshes.push_back(createGrid(0, [](int, int) { return false; }));
+			DELAUNAY_TEST(meshes[0].coordinates.size() > chunk);
+			DELAUNAY_TEST(meshes[0].triangles.size() > 2 * chunk);
+
+			for (const Mesh& mesh : meshes) {
+				::triangulation::DefaultWriter defaultWriter;
+				bool ok;
+				const std::string expected = write(defaultWriter, mesh, &ok);
+				DELAUNAY_TEST(ok);
+				for (size_t threadCount : {1, 3, 0}) {
+					::triangulation::ParallelWriter parallelWriter(threadCount);
+					const std::string actual = write(parallelWriter, mesh, &ok);
+					DELAUNAY_TEST(ok);
+					DELAUNAY_TEST(actual == expected);
+				}
+			}
+
+			// пул потоков одного объекта переиспользуется в следующих записях
+			::triangulation::ParallelWriter reusedWriter(3);
+			for (size_t pass = 0; pass < 2; pass++) {
+				for (const Mesh& mesh : meshes) {
+					::triangulation::DefaultWriter defaultWriter;
+					bool ok;
+					const std::string expected = write(defaultWriter, mesh, &ok);
+					DELAUNAY_TEST(ok);
+					const std::string actual = write(reusedWriter, mesh, &ok);
+					DELAUNAY_TEST(ok);
+					DELAUNAY_TEST(actual == expected);
+				}
+			}
+		DELAUNAY_TEST_END();
+	}
+
+	void WriterTest::testObjWriter()
+	{
+		DELAUNAY_TEST_BEGIN();
+			::triangulation::ObjWriter writer;
+			bool ok;
+			const Mesh square = createSquare();
+			const std::string actual = write(writer, square, &ok);
+			DELAUNAY_TEST(ok);
+			// неиспользованная вершина пропускается, грани против часовой стрелки
+			DELAUNAY_TEST(actual ==
+					"v 0 0 1.5\n"
+					"v 2 0 -0.25\n"
+					"v 2 2 3\n"
+					"v 0 2 1e+06\n"
+					"f 3 1 2\n"
+					"f 4 1 3\n");
+
+			// в отличие от треугольников триангуляции, заданных по часовой стрелке,
+			// грани записываются в порядке вершин 1, 3, 2
+			const size_t objIndex[5] = {1, 2, 0, 3, 4};
+			const size_t faces[2][3] = {{3, 1, 2}, {4, 1, 3}};
+			size_t t = 0;
+			for (const auto& triangle : square.triangles) {
+				const std::array<size_t, 3> order = counterClockwise(*triangle);
+				DELAUNAY_TEST(orientedArea(square, order) > 0.0f);
+				DELAUNAY_TEST(orientedArea(square, {order[0], order[2], order[1]}) < 0.0f);
+				for (size_t v = 0; v < 3; v++) {
+					DELAUNAY_TEST(objIndex[order[v]] == faces[t][v]);
+				}
+				t++;
+			}
+
+			const std::string empty = write(writer, createGrid(0, [](int, int) { return false; }), &ok);
+			DELAUNAY_TEST(ok);
+			DELAUNAY_TEST(empty.empty());
+		DELAUNAY_TEST_END();
+	}
+
+	void WriterTest::testPlyWriter()
+	{
+		DELAUNAY_TEST_BEGIN();
+			::triangulation::PlyWriter writer;
+			bool ok;
+			const Mesh square = createSquare();
+			const std::string actual = write(writer, square, &ok);
+			DELAUNAY_TEST(ok);
+
+			std::string expected =
+					"ply\n"
+					"format binary_little_endian 1.0\n"
+					"element vertex 4\n"
+					"property float x\n"
+					"property float y\n"
+					"property float z\n"
+					"element face 2\n"
+					"property list uchar int vertex_indices\n"
+					"end_header\n";
+			for (size_t i : {0, 1, 3, 4}) {
+				appendValue(expected, square.coordinates[i].x);
+				appendValue(expected, square.coordinates[i].y);
+				appendValue(expected, square.coordinates[i].z);
+			}
+			const int32_t faces[2][3] = {{2, 0, 1}, {3, 0, 2}};
+			for (const auto& face : faces) {
+				appendValue(expected, static_cast<uint8_t>(3));
+				for (int32_t index : face) {
+					appendValue(expected, index);
+				}
+			}
+			DELAUNAY_TEST(actual == expected);
+
+			// грани в порядке вершин 1, 3, 2, против часовой стрелки
+			const int32_t plyIndex[5] = {0, 1, -1, 2, 3};
+			size_t t = 0;
+			for (const auto& triangle : square.triangles) {
+				const std::array<size_t, 3> order = counterClockwise(*triangle);
+				DELAUNAY_TEST(orientedArea(square, order) > 0.0f);
+				for (size_t v = 0; v < 3; v++) {
+					DELAUNAY_TEST(plyIndex[order[v]] == faces[t][v]);
+				}
+				t++;
+			}
+
+			// размер файла сетки с пропущенными вершинами сходится с заголовком
+			const Mesh grid = createGrid(20, [](int x, int y) { return (x + y) % 7 == 0; });
+			const std::string data = write(writer, grid, &ok);
+			DELAUNAY_TEST(ok);
+			size_t vertexCount = 0;
+			for (bool used : grid.usedVertices) {
+				vertexCount += used ? 1 : 0;
+			}
+			const std::string header = "element vertex " + std::to_string(vertexCount) + "\n";
+			DELAUNAY_TEST(data.find(header) != std::string::npos);
+			const size_t end = data.find("end_header\n") + std::strlen("end_header\n");
+			DELAUNAY_TEST(data.size() == end + vertexCount * 3 * sizeof(float)
+					+ grid.triangles.size() * (1 + 3 * sizeof(int32_t)));
+		DELAUNAY_TEST_END();
+	}
+
+	void WriterTest::testStlWriter()
+	{
+		DELAUNAY_TEST_BEGIN();
+			::triangulation::StlWriter writer;
+			bool ok;
+			const Mesh square = createSquare();
+			const std::string actual = write(writer, square, &ok);
+			DELAUNAY_TEST(ok);
+			const size_t headerSize = 80;
+			const size_t triangleSize = 50;
+			DELAUNAY_TEST(actual.size() == headerSize + sizeof(uint32_t) + 2 * triangleSize);
+			DELAUNAY_TEST(actual.compare(0, 21, "DelaunayTriangulation") == 0);
+			DELAUNAY_TEST(actual.find_first_not_of('\0', 21) == headerSize);
+			DELAUNAY_TEST(readValue<uint32_t>(actual, headerSize) == 2);
+
+			// вершины треугольников против часовой стрелки
+			const size_t order[2][3] = {{3, 0, 1}, {4, 0, 3}};
+			size_t t = 0;
+			for (const auto& triangle : square.triangles) {
+				const std::array<size_t, 3> expected = counterClockwise(*triangle);
+				DELAUNAY_TEST(orientedArea(square, expected) > 0.0f);
+				for (size_t v = 0; v < 3; v++) {
+					DELAUNAY_TEST(order[t][v] == expected[v]);
+				}
+				t++;
+			}
+			for (size_t t = 0; t < 2; t++) {
+				const size_t offset = headerSize + sizeof(uint32_t) + t * triangleSize;
+				float normal[3];
+				for (size_t j = 0; j < 3; j++) {
+					normal[j] = readValue<float>(actual, offset + j * sizeof(float));
+				}
+				float vertices[3][3];
+				for (size_t v = 0; v < 3; v++) {
+					const ::triangulation::Vertex3D& expected = square.coordinates[order[t][v]];
+					for (size_t j = 0; j < 3; j++) {
+						vertices[v][j] = readValue<float>(actual, offset + (3 + 3 * v + j) * sizeof(float));
+					}
+					DELAUNAY_TEST(vertices[v][0] == expected.x);
+					DELAUNAY_TEST(vertices[v][1] == expected.y);
+					DELAUNAY_TEST(vertices[v][2] == expected.z);
+				}
+				DELAUNAY_TEST(readValue<uint16_t>(actual, offset + 12 * sizeof(float)) == 0);
+
+				// единичная нормаль, перпендикулярная сторонам и направленная по
+				// правилу правой руки
+				const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				DELAUNAY_TEST(std::fabs(length - 1.0f) < 1e-5f);
+				for (size_t v = 1; v < 3; v++) {
+					float side[3];
+					float sideLength = 0.0f;
+					for (size_t j = 0; j < 3; j++) {
+						side[j] = vertices[v][j] - vertices[0][j];
+						sideLength += side[j] * side[j];
+					}
+					const float dot = normal[0] * side[0] + normal[1] * side[1] + normal[2] * side[2];
+					DELAUNAY_TEST(std::fabs(dot) < 1e-5f * std::sqrt(sideLength));
+				}
+				DELAUNAY_TEST(normal[2] > 0.0f);
+			}
+
+			// вырожденный треугольник получает нулевую нормаль
+			Mesh degenerate = createSquare();
+			degenerate.coordinates[3] = degenerate.coordinates[0];
+			const std::string data = write(writer, degenerate, &ok);
+			DELAUNAY_TEST(ok);
+			for (size_t j = 0; j < 3; j++) {
+				DELAUNAY_TEST(readValue<float>(data, headerSize + sizeof(uint32_t) + j * sizeof(float)) == 0.0f);
+			}
+		DELAUNAY_TEST_END();
+	}
+
+	void WriterTest::testMissingVertexIndex()
+	{
+		DELAUNAY_TEST_BEGIN();
+			// вершина второго треугольника помечена как неиспользованная: запись
+			// должна завершиться ошибкой, не оставив в потоке начало файла
+			Mesh square = createSquare();
+			square.usedVertices[4] = false;
+			::triangulation::ObjWriter objWriter;
+			::triangulation::PlyWriter plyWriter;
+			::triangulation::StlWriter stlWriter;
+			for (::triangulation::IFileWriter* writer : {
+					static_cast<::triangulation::IFileWriter*>(&objWriter),
+					static_cast<::triangulation::IFileWriter*>(&plyWriter),
+					static_cast<::triangulation::IFileWriter*>(&stlWriter)}) {
+				bool ok = true;
+				const std::string actual = write(*writer, square, &ok);
+				DELAUNAY_TEST(!ok);
+				DELAUNAY_TEST(actual.empty());
+			}
+		DELAUNAY_TEST_END();
+	}
+}
@@ -0,0 +1,26 @@
+#ifndef TEST_WRITER_TEST_H
+#define TEST_WRITER_TEST_H
+
+
+namespace test::triangulation
+{
+	class WriterTest
+	{
+	public:
+		WriterTest() = default;
+		~WriterTest() = default;
+		WriterTest(const WriterTest&) = delete;
+		WriterTest(WriterTest&&) = delete;
+		WriterTest & operator=(const WriterTest&) = delete;
+		WriterTest & operator=(WriterTest&&) = delete;
+
+		void testParallelWriter();
+		void testObjWriter();
+		void testPlyWriter();
+		void testStlWriter();
+		void testMissingVertexIndex();
+
+	};
+}
+
+#endif //TEST_WRITER_TEST_H
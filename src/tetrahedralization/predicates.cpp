@@ -0,0 +1,354 @@
+#include "predicates.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace tetrahedralization
+{
+	namespace
+	{
+		// 2^-53 - половина единицы последнего разряда double
+		const double EPSILON = 1.1102230246251565e-16;
+		// 2^27 + 1 - для разбиения double на две половины по 26 бит
+		const double SPLITTER = 134217729.0;
+		const double ORIENT_2D_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+		const double ORIENT_3D_BOUND = (7.0 + 56.0 * EPSILON) * EPSILON;
+		const double INSPHERE_BOUND = (16.0 + 224.0 * EPSILON) * EPSILON;
+
+		/**
+		 * Разложение - сумма неперекрывающихся чисел double по возрастанию модуля.
+		 * Знак разложения - знак последнего (наибольшего) слагаемого.
+		 */
+		using Expansion = std::vector<double>;
+
+		inline void twoSum(double a, double b, double& sum, double& error)
+		{
+			sum = a + b;
+			const double bVirtual = sum - a;
+			const double aVirtual = sum - bVirtual;
+			error = (a - aVirtual) + (b - bVirtual);
+		}
+
+		inline void split(double a, double& high, double& low)
+		{
+			const double c = SPLITTER * a;
+			high = c - (c - a);
+			low = a - high;
+		}
+
+		inline void twoProduct(double a, double b, double& product, double& error)
+		{
+			product = a * b;
+			double aHigh;
+			double aLow;
+			double bHigh;
+			double bLow;
+			split(a, aHigh, aLow);
+			split(b, bHigh, bLow);
+			error = aLow * bLow - (((product - aHigh * bHigh) - aLow * bHigh) - aHigh * bLow);
+		}
+
+		// точная разность a - b
+		Expansion difference(double a, double b)
+		{
+			double sum;
+			double error;
+			twoSum(a, -b, sum, error);
+			Expansion result;
+			if (error != 0.0) {
+				result.push_back(error);
+			}
+			if (sum != 0.0) {
+				result.push_back(sum);
+			}
+			return result;
+		}
+
+		// сумма разложения и числа (grow_expansion с удалением нулей)
+		void grow(Expansion& expansion, double value)
+		{
+			size_t count = 0;
+			for (double component : expansion) {
+				double error;
+				twoSum(value, component, value, error);
+				if (error != 0.0) {
+					expansion[count++] = error;
+				}
+			}
+			expansion.resize(count);
+			if (value != 0.0) {
+				expansion.push_back(value);
+			}
+		}
+
+		Expansion sum(const Expansion& left, const Expansion& right)
+		{
+			Expansion result = left;
+			for (double component : right) {
+				grow(result, component);
+			}
+			return result;
+		}
+
+		Expansion negate(Expansion expansion)
+		{
+			for (double& component : expansion) {
+				component = -component;
+			}
+			return expansion;
+		}
+
+		// произведение разложения на число (scale_expansion с удалением нулей)
+		Expansion scale(const Expansion& expansion, double value)
+		{
+			Expansion result;
+			if (expansion.empty() || value == 0.0) {
+				return result;
+			}
+			double accumulator;
+			double error;
+			twoProduct(expansion[0], value, accumulator, error);
+			if (error != 0.0) {
+				result.push_back(error);
+			}
+			for (size_t i = 1; i < expansion.size(); i++) {
+				double product;
+				double productError;
+				twoProduct(expansion[i], value, product, productError);
+				double partial;
+				twoSum(accumulator, productError, partial, error);
+				if (error != 0.0) {
+					result.push_back(error);
+				}
+				// |partial| <= |product| - быстрая сумма без потери точности
+				accumulator = product + partial;
+				error = partial - (accumulator - product);
+				if (error != 0.0) {
+					result.push_back(error);
+				}
+			}
+			if (accumulator != 0.0) {
+				result.push_back(accumulator);
+			}
+			return result;
+		}
+
+		Expansion product(const Expansion& left, const Expansion& right)
+		{
+			Expansion result;
+			for (double component : right) {
+				result = sum(result, scale(left, component));
+			}
+			return result;
+		}
+
+		// left1 * right1 - left2 * right2
+		Expansion crossProduct(
+				const Expansion& left1,
+				const Expansion& right1,
+				const Expansion& left2,
+				const Expansion& right2)
+		{
+			return sum(product(left1, right1), negate(product(left2, right2)));
+		}
+
+		double sign(const Expansion& expansion)
+		{
+			return expansion.empty() ? 0.0 : expansion.back();
+		}
+	}
+
+	double Predicates::orient2d(const double a[2], const double b[2], const double c[2])
+	{
+		const double left = (a[0] - c[0]) * (b[1] - c[1]);
+		const double right = (a[1] - c[1]) * (b[0] - c[0]);
+		const double determinant = left - right;
+		const double bound = ORIENT_2D_BOUND * (std::fabs(left) + std::fabs(right));
+		if (determinant > bound || -determinant > bound) {
+			return determinant;
+		}
+		return orient2dExact(a, b, c);
+	}
+
+	double Predicates::orient3d(
+			const double a[3],
+			const double b[3],
+			const double c[3],
+			const double d[3])
+	{
+		const double adx = a[0] - d[0];
+		const double bdx = b[0] - d[0];
+		const double cdx = c[0] - d[0];
+		const double ady = a[1] - d[1];
+		const double bdy = b[1] - d[1];
+		const double cdy = c[1] - d[1];
+		const double adz = a[2] - d[2];
+		const double bdz = b[2] - d[2];
+		const double cdz = c[2] - d[2];
+
+		const double bdxcdy = bdx * cdy;
+		const double cdxbdy = cdx * bdy;
+		const double cdxady = cdx * ady;
+		const double adxcdy = adx * cdy;
+		const double adxbdy = adx * bdy;
+		const double bdxady = bdx * ady;
+
+		const double determinant = adz * (bdxcdy - cdxbdy)
+				+ bdz * (cdxady - adxcdy)
+				+ cdz * (adxbdy - bdxady);
+		const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+				+ (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+				+ (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+		const double bound = ORIENT_3D_BOUND * permanent;
+		if (determinant > bound || -determinant > bound) {
+			return determinant;
+		}
+		return orient3dExact(a, b, c, d);
+	}
+
+	double Predicates::insphere(
+			const double a[3],
+			const double b[3],
+			const double c[3],
+			const double d[3],
+			const double e[3])
+	{
+		const double aex = a[0] - e[0];
+		const double bex = b[0] - e[0];
+		const double cex = c[0] - e[0];
+		const double dex = d[0] - e[0];
+		const double aey = a[1] - e[1];
+		const double bey = b[1] - e[1];
+		const double cey = c[1] - e[1];
+		const double dey = d[1] - e[1];
+		const double aez = a[2] - e[2];
+		const double bez = b[2] - e[2];
+		const double cez = c[2] - e[2];
+		const double dez = d[2] - e[2];
+
+		const double aexbey = aex * bey;
+		const double bexaey = bex * aey;
+		const double ab = aexbey - bexaey;
+		const double bexcey = bex * cey;
+		const double cexbey = cex * bey;
+		const double bc = bexcey - cexbey;
+		const double cexdey = cex * dey;
+		const double dexcey = dex * cey;
+		const double cd = cexdey - dexcey;
+		const double dexaey = dex * aey;
+		const double aexdey = aex * dey;
+		const double da = dexaey - aexdey;
+		const double aexcey = aex * cey;
+		const double cexaey = cex * aey;
+		const double ac = aexcey - cexaey;
+		const double bexdey = bex * dey;
+		const double dexbey = dex * bey;
+		const double bd = bexdey - dexbey;
+
+		const double abc = aez * bc - bez * ac + cez * ab;
+		const double bcd = bez * cd - cez * bd + dez * bc;
+		const double cda = cez * da + dez * ac + aez * cd;
+		const double dab = dez * ab + aez * bd + bez * da;
+
+		const double aLift = aex * aex + aey * aey + aez * aez;
+		const double bLift = bex * bex + bey * bey + bez * bez;
+		const double cLift = cex * cex + cey * cey + cez * cez;
+		const double dLift = dex * dex + dey * dey + dez * dez;
+
+		const double determinant = (dLift * abc - cLift * dab) + (bLift * cda - aLift * bcd);
+
+		const double aezPlus = std::fabs(aez);
+		const double bezPlus = std::fabs(bez);
+		const double cezPlus = std::fabs(cez);
+		const double dezPlus = std::fabs(dez);
+		const double abPlus = std::fabs(aexbey) + std::fabs(bexaey);
+		const double bcPlus = std::fabs(bexcey) + std::fabs(cexbey);
+		const double cdPlus = std::fabs(cexdey) + std::fabs(dexcey);
+		const double daPlus = std::fabs(dexaey) + std::fabs(aexdey);
+		const double acPlus = std::fabs(aexcey) + std::fabs(cexaey);
+		const double bdPlus = std::fabs(bexdey) + std::fabs(dexbey);
+		const double permanent = (cdPlus * bezPlus + bdPlus * cezPlus + bcPlus * dezPlus) * aLift
+				+ (daPlus * cezPlus + acPlus * dezPlus + cdPlus * aezPlus) * bLift
+				+ (abPlus * dezPlus + bdPlus * aezPlus + daPlus * bezPlus) * cLift
+				+ (bcPlus * aezPlus + acPlus * bezPlus + abPlus * cezPlus) * dLift;
+		const double bound = INSPHERE_BOUND * permanent;
+		if (determinant > bound || -determinant > bound) {
+			return determinant;
+		}
+		return insphereExact(a, b, c, d, e);
+	}
+
+	double Predicates::orient2dExact(const double a[2], const double b[2], const double c[2])
+	{
+		const Expansion acx = difference(a[0], c[0]);
+		const Expansion bcx = difference(b[0], c[0]);
+		const Expansion acy = difference(a[1], c[1]);
+		const Expansion bcy = difference(b[1], c[1]);
+		return sign(crossProduct(acx, bcy, acy, bcx));
+	}
+
+	double Predicates::orient3dExact(
+			const double a[3],
+			const double b[3],
+			const double c[3],
+			const double d[3])
+	{
+		const Expansion adx = difference(a[0], d[0]);
+		const Expansion bdx = difference(b[0], d[0]);
+		const Expansion cdx = difference(c[0], d[0]);
+		const Expansion ady = difference(a[1], d[1]);
+		const Expansion bdy = difference(b[1], d[1]);
+		const Expansion cdy = difference(c[1], d[1]);
+		const Expansion adz = difference(a[2], d[2]);
+		const Expansion bdz = difference(b[2], d[2]);
+		const Expansion cdz = difference(c[2], d[2]);
+
+		const Expansion determinant = sum(
+				sum(product(adz, crossProduct(bdx, cdy, cdx, bdy)),
+						product(bdz, crossProduct(cdx, ady, adx, cdy))),
+				product(cdz, crossProduct(adx, bdy, bdx, ady)));
+		return sign(determinant);
+	}
+
+	double Predicates::insphereExact(
+			const double a[3],
+			const double b[3],
+			const double c[3],
+			const double d[3],
+			const double e[3])
+	{
+		const Expansion aex = difference(a[0], e[0]);
+		const Expansion bex = difference(b[0], e[0]);
+		const Expansion cex = difference(c[0], e[0]);
+		const Expansion dex = difference(d[0], e[0]);
+		const Expansion aey = difference(a[1], e[1]);
+		const Expansion bey = difference(b[1], e[1]);
+		const Expansion cey = difference(c[1], e[1]);
+		const Expansion dey = difference(d[1], e[1]);
+		const Expansion aez = difference(a[2], e[2]);
+		const Expansion bez = difference(b[2], e[2]);
+		const Expansion cez = difference(c[2], e[2]);
+		const Expansion dez = difference(d[2], e[2]);
+
+		const Expansion ab = crossProduct(aex, bey, bex, aey);
+		const Expansion bc = crossProduct(bex, cey, cex, bey);
+		const Expansion cd = crossProduct(cex, dey, dex, cey);
+		const Expansion da = crossProduct(dex, aey, aex, dey);
+		const Expansion ac = crossProduct(aex, cey, cex, aey);
+		const Expansion bd = crossProduct(bex, dey, dex, bey);
+
+		const Expansion abc = sum(sum(product(aez, bc), negate(product(bez, ac))), product(cez, ab));
+		const Expansion bcd = sum(sum(product(bez, cd), negate(product(cez, bd))), product(dez, bc));
+		const Expansion cda = sum(sum(product(cez, da), product(dez, ac)), product(aez, cd));
+		const Expansion dab = sum(sum(product(dez, ab), product(aez, bd)), product(bez, da));
+
+		const auto lift = [](const Expansion& x, const Expansion& y, const Expansion& z) {
+			return sum(sum(product(x, x), product(y, y)), product(z, z));
+		};
+		const Expansion determinant = sum(
+				crossProduct(lift(dex, dey, dez), abc, lift(cex, cey, cez), dab),
+				crossProduct(lift(bex, bey, bez), cda, lift(aex, aey, aez), bcd));
+		return sign(determinant);
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef TETRAHEDRALIZATION_PREDICATES_H
+#define TETRAHEDRALIZATION_PREDICATES_H
+
+
+namespace tetrahedralization
+{
+	/**
+	 * Геометрические предикаты с точным знаком результата. Сначала определитель
+	 * считается в double и сравнивается с оценкой погрешности (фильтр по
+	 * Шевчуку); только если знак не определён, он пересчитывается точно в
+	 * арифметике разложений (сумм чисел double без потери точности).
+	 */
+	class Predicates
+	{
+	public:
+		Predicates() = delete;
+		~Predicates() = delete;
+		Predicates(const Predicates&) = delete;
+		Predicates(Predicates&&) = delete;
+		Predicates & operator=(const Predicates&) = delete;
+		Predicates & operator=(Predicates&&) = delete;
+
+		/**
+		 * @return > 0 если точки a, b, c на плоскости перечислены против часовой
+		 * стрелки, < 0 если по часовой, 0 если лежат на одной прямой
+		 */
+		static double orient2d(const double a[2], const double b[2], const double c[2]);
+
+		/**
+		 * @return > 0 если d лежит ниже плоскости через a, b, c (a, b, c против
+		 * часовой стрелки, если смотреть сверху), < 0 если выше, 0 если все четыре
+		 * точки лежат в одной плоскости
+		 */
+		static double orient3d(
+				const double a[3],
+				const double b[3],
+				const double c[3],
+				const double d[3]);
+
+		/**
+		 * Для orient3d(a, b, c, d) > 0
+		 * @return > 0 если e лежит внутри сферы через a, b, c, d, < 0 если снаружи,
+		 * 0 если на сфере
+		 */
+		static double insphere(
+				const double a[3],
+				const double b[3],
+				const double c[3],
+				const double d[3],
+				const double e[3]);
+
+	private:
+		static double orient2dExact(const double a[2], const double b[2], const double c[2]);
+
+		static double orient3dExact(
+				const double a[3],
+				const double b[3],
+				const double c[3],
+				const double d[3]);
+
+		static double insphereExact(
+				const double a[3],
+				const double b[3],
+				const double c[3],
+				const double d[3],
+				const double e[3]);
+
+	};
+}
+
+#endif //TETRAHEDRALIZATION_PREDICATES_H
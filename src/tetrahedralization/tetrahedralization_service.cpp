@@ -0,0 +1,562 @@
+#include "tetrahedralization_service.h"
+
+#include "predicates.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <utility>
+
+
+namespace tetrahedralization
+{
+	namespace
+	{
+		// бесконечно удалённая вершина фиктивных тетраэдров вне оболочки
+		const int INFINITE_VERTEX = -1;
+		// первая вершина освобождённого места в массиве тетраэдров
+		const int FREE_VERTEX = -2;
+		// FACES[i] - вершины грани напротив вершины i, перечисленные так, что сама
+		// вершина i лежит с положительной стороны грани (orient3d > 0)
+		const int FACES[4][3] = {{1, 3, 2}, {0, 2, 3}, {0, 3, 1}, {0, 1, 2}};
+		// раунды BRIO меньше этого размера не делятся
+		const size_t MIN_ROUND_SIZE = 1024;
+		// бит на координату в ключе кривой Гильберта
+		const int CURVE_BITS = 21;
+
+		// раздвигает младшие 21 бит value так, что между ними остаётся по два нуля
+		uint64_t spreadBits(uint64_t value)
+		{
+			value &= (1u << CURVE_BITS) - 1;
+			value = (value | value << 32) & 0x1f00000000ffffULL;
+			value = (value | value << 16) & 0x1f0000ff0000ffULL;
+			value = (value | value << 8) & 0x100f00f00f00f00fULL;
+			value = (value | value << 4) & 0x10c30c30c30c30c3ULL;
+			value = (value | value << 2) & 0x1249249249249249ULL;
+			return value;
+		}
+
+		/**
+		 * Номер ячейки cell на кривой Гильберта (алгоритм Скиллинга: координаты
+		 * преобразуются так, что чередование их бит даёт номер на кривой)
+		 */
+		uint64_t hilbertKey(std::array<uint32_t, 3> cell)
+		{
+			const uint32_t highest = 1u << (CURVE_BITS - 1);
+			for (uint32_t bit = highest; bit > 1; bit >>= 1) {
+				const uint32_t lower = bit - 1;
+				for (uint32_t& coordinate : cell) {
+					if (coordinate & bit) {
+						cell[0] ^= lower;
+					}
+					else {
+						const uint32_t swapped = (cell[0] ^ coordinate) & lower;
+						cell[0] ^= swapped;
+						coordinate ^= swapped;
+					}
+				}
+			}
+			cell[1] ^= cell[0];
+			cell[2] ^= cell[1];
+			uint32_t gray = 0;
+			for (uint32_t bit = highest; bit > 1; bit >>= 1) {
+				if (cell[2] & bit) {
+					gray ^= bit - 1;
+				}
+			}
+			return (spreadBits(cell[0] ^ gray) << 2) | (spreadBits(cell[1] ^ gray) << 1) | spreadBits(cell[2] ^ gray);
+		}
+
+		/**
+		 * Построение одной тетраэдризации. Во время построения neighbours[i]
+		 * тетраэдра - индекс соседа * 4 + номер общей грани в соседе, чтобы связь
+		 * восстанавливалась без поиска.
+		 */
+		class TetrahedralizationBuilder
+		{
+		private:
+			// грань нового тетраэдра с ребром vertex1, vertex2 границы полости
+			struct PendingFace
+			{
+				int vertex1 = 0;
+				int vertex2 = 0;
+				int face = Tetrahedron::NO_NEIGHBOUR;
+			};
+
+			const std::vector<triangulation::Vertex3D>& _coordinates;
+			// индексы вершин в _coordinates в порядке добавления
+			std::vector<int> _order;
+			// x, y, z вершин в порядке добавления: тетраэдры ссылаются на вершины по
+			// номеру в этом порядке, поэтому соседние тетраэдры читают соседнюю память
+			std::vector<double> _points;
+			std::vector<Tetrahedron> _tetrahedra;
+			std::vector<int> _free;
+			// отметки обхода полости: _mark - тетраэдр в полости, _mark + 1 - проверен и
+			// не конфликтует с добавляемой вершиной
+			std::vector<uint32_t> _marks;
+			uint32_t _mark = 0;
+			// конечный тетраэдр рядом с последней добавленной вершиной
+			int _last = 0;
+			uint32_t _random = 1;
+			size_t _skipped = 0;
+			// буферы insert, чтобы не выделять память на каждую вершину
+			std::vector<int> _stack;
+			std::vector<int> _cavity;
+			std::vector<int> _boundary;
+			std::vector<Tetrahedron> _created;
+			// новые грани по рёбрам границы полости: хеш-таблица с открытой адресацией
+			// размером степень двойки, очищается по списку занятых ячеек
+			std::vector<PendingFace> _pending;
+			std::vector<size_t> _pendingUsed;
+
+		public:
+			explicit TetrahedralizationBuilder(const std::vector<triangulation::Vertex3D>& coordinates) :
+					_coordinates(coordinates)
+			{}
+
+			bool build()
+			{
+				_order = insertionOrder();
+				_points.resize(_order.size() * 3);
+				for (size_t i = 0; i < _order.size(); i++) {
+					const triangulation::Vertex3D& vertex = _coordinates[_order[i]];
+					_points[i * 3] = vertex.x;
+					_points[i * 3 + 1] = vertex.y;
+					_points[i * 3 + 2] = vertex.z;
+				}
+				std::array<int, 4> simplex {};
+				if (!initialSimplex(simplex)) {
+					return false;
+				}
+				// в тетраэдризации Делоне около 6.5 тетраэдров на вершину
+				_tetrahedra.reserve(_coordinates.size() * 7 + 16);
+				_marks.reserve(_tetrahedra.capacity());
+				createSimplex(simplex);
+				for (int vertex = 0; vertex < static_cast<int>(_order.size()); vertex++) {
+					if (std::find(simplex.begin(), simplex.end(), vertex) == simplex.end()) {
+						insert(vertex);
+					}
+				}
+				return true;
+			}
+
+			[[nodiscard]] size_t skipped() const noexcept
+			{
+				return _skipped;
+			}
+
+			/**
+			 * Конечные тетраэдры с соседями по индексу в результате
+			 */
+			std::vector<Tetrahedron> result()
+			{
+				std::vector<int> indexes(_tetrahedra.size(), Tetrahedron::NO_NEIGHBOUR);
+				int count = 0;
+				for (size_t i = 0; i < _tetrahedra.size(); i++) {
+					if (_tetrahedra[i].vertices[0] != FREE_VERTEX && !isGhost(static_cast<int>(i))) {
+						indexes[i] = count++;
+					}
+				}
+				// индекс в результате не больше исходного, поэтому массив сжимается на месте
+				for (size_t i = 0; i < _tetrahedra.size(); i++) {
+					if (indexes[i] == Tetrahedron::NO_NEIGHBOUR) {
+						continue;
+					}
+					Tetrahedron tetrahedron = _tetrahedra[i];
+					for (int& vertex : tetrahedron.vertices) {
+						vertex = _order[vertex];
+					}
+					for (int& neighbour : tetrahedron.neighbours) {
+						neighbour = indexes[neighbour >> 2];
+					}
+					_tetrahedra[indexes[i]] = tetrahedron;
+				}
+				_tetrahedra.resize(count);
+				return std::move(_tetrahedra);
+			}
+
+		private:
+			[[nodiscard]] const double* point(int vertex) const noexcept
+			{
+				return &_points[static_cast<size_t>(vertex) * 3];
+			}
+
+			static double coordinate(const triangulation::Vertex3D& vertex, int axis) noexcept
+			{
+				return axis == 0 ? vertex.x : (axis == 1 ? vertex.y : vertex.z);
+			}
+
+			[[nodiscard]] bool isGhost(int tetrahedron) const noexcept
+			{
+				const int* vertices = _tetrahedra[tetrahedron].vertices;
+				return vertices[0] == INFINITE_VERTEX || vertices[1] == INFINITE_VERTEX
+						|| vertices[2] == INFINITE_VERTEX || vertices[3] == INFINITE_VERTEX;
+			}
+
+			// orient3d грани face тетраэдра и точки p: < 0 если p по другую сторону грани
+			[[nodiscard]] double orientFace(const Tetrahedron& tetrahedron, int face, const double* p) const
+			{
+				return Predicates::orient3d(
+						point(tetrahedron.vertices[FACES[face][0]]),
+						point(tetrahedron.vertices[FACES[face][1]]),
+						point(tetrahedron.vertices[FACES[face][2]]),
+						p);
+			}
+
+			/**
+			 * Порядок BRIO: вершины перемешиваются, делятся на раунды, каждый вдвое
+			 * больше предыдущего, и внутри раунда сортируются по кривой Гильберта
+			 */
+			std::vector<int> insertionOrder() const
+			{
+				const size_t count = _coordinates.size();
+				std::vector<int> order(count);
+				std::iota(order.begin(), order.end(), 0);
+				// собственный генератор, чтобы порядок не зависел от стандартной библиотеки
+				uint64_t seed = 0x9e3779b97f4a7c15ULL;
+				for (size_t i = count; i > 1; i--) {
+					seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+					std::swap(order[i - 1], order[(seed >> 33) % i]);
+				}
+
+				double minimum[3] = {0.0, 0.0, 0.0};
+				double maximum[3] = {0.0, 0.0, 0.0};
+				for (size_t i = 0; i < count; i++) {
+					for (int axis = 0; axis < 3; axis++) {
+						const double value = coordinate(_coordinates[i], axis);
+						if (i == 0 || value < minimum[axis]) {
+							minimum[axis] = value;
+						}
+						if (i == 0 || value > maximum[axis]) {
+							maximum[axis] = value;
+						}
+					}
+				}
+				const double cells = static_cast<double>((1u << CURVE_BITS) - 1);
+				double scale[3];
+				for (int axis = 0; axis < 3; axis++) {
+					const double extent = maximum[axis] - minimum[axis];
+					scale[axis] = extent > 0.0 ? cells / extent : 0.0;
+				}
+				std::vector<uint64_t> keys(count);
+				for (size_t i = 0; i < count; i++) {
+					std::array<uint32_t, 3> cell {};
+					for (int axis = 0; axis < 3; axis++) {
+						cell[axis] = static_cast<uint32_t>((coordinate(_coordinates[i], axis) - minimum[axis]) * scale[axis]);
+					}
+					keys[i] = hilbertKey(cell);
+				}
+
+				size_t end = count;
+				while (end > 0) {
+					const size_t begin = end > MIN_ROUND_SIZE ? end / 2 : 0;
+					std::sort(order.begin() + static_cast<std::ptrdiff_t>(begin),
+							order.begin() + static_cast<std::ptrdiff_t>(end),
+							[&keys](int left, int right) { return keys[left] < keys[right]; });
+					end = begin;
+				}
+				return order;
+			}
+
+			bool collinear(int vertex1, int vertex2, int vertex3) const
+			{
+				// точки лежат на одной прямой, если на одной прямой их проекции на все
+				// три координатные плоскости
+				for (int axis = 0; axis < 3; axis++) {
+					const int next = (axis + 1) % 3;
+					const double a[2] = {point(vertex1)[axis], point(vertex1)[next]};
+					const double b[2] = {point(vertex2)[axis], point(vertex2)[next]};
+					const double c[2] = {point(vertex3)[axis], point(vertex3)[next]};
+					if (Predicates::orient2d(a, b, c) != 0.0) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			/**
+			 * Первые в порядке добавления четыре вершины, не лежащие в одной плоскости,
+			 * перечисленные с orient3d > 0
+			 */
+			bool initialSimplex(std::array<int, 4>& simplex) const
+			{
+				const int count = static_cast<int>(_order.size());
+				int second = 1;
+				while (second < count && std::equal(point(0), point(0) + 3, point(second))) {
+					second++;
+				}
+				int third = second + 1;
+				while (third < count && collinear(0, second, third)) {
+					third++;
+				}
+				int fourth = third + 1;
+				while (fourth < count && Predicates::orient3d(point(0), point(second), point(third), point(fourth)) == 0.0) {
+					fourth++;
+				}
+				if (fourth >= count) {
+					return false;
+				}
+				simplex = {0, second, third, fourth};
+				if (Predicates::orient3d(point(simplex[0]), point(simplex[1]), point(simplex[2]), point(simplex[3])) < 0.0) {
+					std::swap(simplex[0], simplex[1]);
+				}
+				return true;
+			}
+
+			/**
+			 * Первый тетраэдр и четыре фиктивных тетраэдра за его гранями
+			 */
+			void createSimplex(const std::array<int, 4>& simplex)
+			{
+				Tetrahedron first;
+				std::copy(simplex.begin(), simplex.end(), first.vertices);
+				_tetrahedra.push_back(first);
+				for (const int* face : FACES) {
+					// бесконечная вершина снаружи грани, т.е. с другой её стороны
+					Tetrahedron ghost;
+					ghost.vertices[0] = simplex[face[0]];
+					ghost.vertices[1] = simplex[face[2]];
+					ghost.vertices[2] = simplex[face[1]];
+					ghost.vertices[3] = INFINITE_VERTEX;
+					_tetrahedra.push_back(ghost);
+				}
+				for (size_t tetrahedron1 = 0; tetrahedron1 < _tetrahedra.size(); tetrahedron1++) {
+					for (size_t tetrahedron2 = tetrahedron1 + 1; tetrahedron2 < _tetrahedra.size(); tetrahedron2++) {
+						for (int face1 = 0; face1 < 4; face1++) {
+							for (int face2 = 0; face2 < 4; face2++) {
+								if (sameFace(_tetrahedra[tetrahedron1], face1, _tetrahedra[tetrahedron2], face2)) {
+									_tetrahedra[tetrahedron1].neighbours[face1] = static_cast<int>(tetrahedron2) * 4 + face2;
+									_tetrahedra[tetrahedron2].neighbours[face2] = static_cast<int>(tetrahedron1) * 4 + face1;
+								}
+							}
+						}
+					}
+				}
+				_marks.assign(_tetrahedra.size(), 0);
+				_last = 0;
+			}
+
+			static bool sameFace(const Tetrahedron& tetrahedron1, int face1, const Tetrahedron& tetrahedron2, int face2)
+			{
+				std::array<int, 3> vertices1 {};
+				std::array<int, 3> vertices2 {};
+				for (int i = 0; i < 3; i++) {
+					vertices1[i] = tetrahedron1.vertices[FACES[face1][i]];
+					vertices2[i] = tetrahedron2.vertices[FACES[face2][i]];
+				}
+				std::sort(vertices1.begin(), vertices1.end());
+				std::sort(vertices2.begin(), vertices2.end());
+				return vertices1 == vertices2;
+			}
+
+			/**
+			 * Обход от _last к тетраэдру, содержащему p: переход через первую
+			 * (со случайной грани) грань, за которой лежит p. Возвращает конечный
+			 * тетраэдр, содержащий p, или фиктивный, если p вне оболочки.
+			 */
+			int locate(const double* p)
+			{
+				int current = _last;
+				int previous = Tetrahedron::NO_NEIGHBOUR;
+				for (;;) {
+					const Tetrahedron& tetrahedron = _tetrahedra[current];
+					_random = _random * 1103515245u + 12345u;
+					const int firstFace = static_cast<int>(_random >> 16) & 3;
+					int next = Tetrahedron::NO_NEIGHBOUR;
+					for (int i = 0; i < 4; i++) {
+						const int face = (firstFace + i) & 3;
+						const int neighbour = tetrahedron.neighbours[face] >> 2;
+						if (neighbour != previous && orientFace(tetrahedron, face, p) < 0.0) {
+							next = neighbour;
+							break;
+						}
+					}
+					if (next == Tetrahedron::NO_NEIGHBOUR) {
+						return current;
+					}
+					previous = current;
+					current = next;
+					if (isGhost(current)) {
+						return current;
+					}
+				}
+			}
+
+			/**
+			 * Попадает ли p внутрь описанной сферы тетраэдра. Для фиктивного
+			 * тетраэдра - лежит ли p снаружи его грани на оболочке, а если в её
+			 * плоскости, то конфликтует ли с конечным тетраэдром за этой гранью.
+			 */
+			bool inConflict(int index, const double* p) const
+			{
+				const Tetrahedron& tetrahedron = _tetrahedra[index];
+				for (int i = 0; i < 4; i++) {
+					if (tetrahedron.vertices[i] == INFINITE_VERTEX) {
+						const double orientation = orientFace(tetrahedron, i, p);
+						if (orientation != 0.0) {
+							return orientation > 0.0;
+						}
+						return inConflict(tetrahedron.neighbours[i] >> 2, p);
+					}
+				}
+				return Predicates::insphere(
+						point(tetrahedron.vertices[0]),
+						point(tetrahedron.vertices[1]),
+						point(tetrahedron.vertices[2]),
+						point(tetrahedron.vertices[3]),
+						p) > 0.0;
+			}
+
+			int allocate()
+			{
+				if (!_free.empty()) {
+					const int index = _free.back();
+					_free.pop_back();
+					return index;
+				}
+				_tetrahedra.emplace_back();
+				_marks.push_back(0);
+				return static_cast<int>(_tetrahedra.size()) - 1;
+			}
+
+			void insert(int vertex)
+			{
+				const double* p = point(vertex);
+				const int start = locate(p);
+				if (!inConflict(start, p)) {
+					// p лежит на описанной сфере тетраэдра, который её содержит, -
+					// значит совпадает с его вершиной
+					std::cout << "Skipped vertex: " << _coordinates[_order[vertex]].id << " (duplicate)." << std::endl;
+					_skipped++;
+					return;
+				}
+
+				// полость - связная область тетраэдров, конфликтующих с p
+				_mark += 2;
+				const uint32_t cavityMark = _mark;
+				const uint32_t testedMark = _mark + 1;
+				_stack.clear();
+				_cavity.clear();
+				_boundary.clear();
+				_marks[start] = cavityMark;
+				_stack.push_back(start);
+				_cavity.push_back(start);
+				while (!_stack.empty()) {
+					const int current = _stack.back();
+					_stack.pop_back();
+					for (int face = 0; face < 4; face++) {
+						const int neighbour = _tetrahedra[current].neighbours[face] >> 2;
+						if (_marks[neighbour] == cavityMark) {
+							continue;
+						}
+						if (_marks[neighbour] != testedMark) {
+							if (inConflict(neighbour, p)) {
+								_marks[neighbour] = cavityMark;
+								_stack.push_back(neighbour);
+								_cavity.push_back(neighbour);
+								continue;
+							}
+							_marks[neighbour] = testedMark;
+						}
+						_boundary.push_back(current * 4 + face);
+					}
+				}
+
+				// каждая грань границы полости с p образует новый тетраэдр; p лежит с той
+				// же стороны грани, что и заменяемая вершина, поэтому ориентация сохраняется
+				_created.clear();
+				for (int face : _boundary) {
+					Tetrahedron created = _tetrahedra[face >> 2];
+					created.vertices[face & 3] = vertex;
+					_created.push_back(created);
+				}
+				for (int index : _cavity) {
+					_tetrahedra[index].vertices[0] = FREE_VERTEX;
+					_free.push_back(index);
+				}
+				// каждое ребро границы полости встречается в двух новых гранях
+				size_t pendingSize = std::max<size_t>(_pending.size(), 256);
+				while (pendingSize < _created.size() * 6) {
+					pendingSize *= 2;
+				}
+				if (pendingSize != _pending.size()) {
+					_pending.assign(pendingSize, PendingFace());
+				}
+				const size_t mask = pendingSize - 1;
+				for (size_t i = 0; i < _created.size(); i++) {
+					const int index = allocate();
+					Tetrahedron& tetrahedron = _tetrahedra[index];
+					tetrahedron = _created[i];
+					const int outerFace = _boundary[i] & 3;
+					const int outer = tetrahedron.neighbours[outerFace];
+					_tetrahedra[outer >> 2].neighbours[outer & 3] = index * 4 + outerFace;
+					// остальные грани содержат p и ребро границы полости, по которому
+					// и находится соседний новый тетраэдр
+					for (int face = 0; face < 4; face++) {
+						if (face == outerFace) {
+							continue;
+						}
+						int edge[2];
+						int count = 0;
+						for (int k = 0; k < 4; k++) {
+							if (k != face && k != outerFace) {
+								edge[count++] = tetrahedron.vertices[k];
+							}
+						}
+						const int vertex1 = std::min(edge[0], edge[1]);
+						const int vertex2 = std::max(edge[0], edge[1]);
+						size_t slot = (static_cast<size_t>(vertex1) * 73856093u
+								^ static_cast<size_t>(vertex2) * 19349663u) & mask;
+						while (_pending[slot].face != Tetrahedron::NO_NEIGHBOUR
+								&& (_pending[slot].vertex1 != vertex1 || _pending[slot].vertex2 != vertex2)) {
+							slot = (slot + 1) & mask;
+						}
+						PendingFace& pending = _pending[slot];
+						if (pending.face == Tetrahedron::NO_NEIGHBOUR) {
+							pending = {vertex1, vertex2, index * 4 + face};
+							_pendingUsed.push_back(slot);
+						}
+						else {
+							// вторая грань с тем же ребром; ячейка остаётся занятой до конца insert
+							tetrahedron.neighbours[face] = pending.face;
+							_tetrahedra[pending.face >> 2].neighbours[pending.face & 3] = index * 4 + face;
+						}
+					}
+					if (!isGhost(index)) {
+						_last = index;
+					}
+				}
+				for (size_t slot : _pendingUsed) {
+					_pending[slot].face = Tetrahedron::NO_NEIGHBOUR;
+				}
+				_pendingUsed.clear();
+			}
+		};
+	}
+
+	std::vector<Tetrahedron> TetrahedralizationService::process(
+			const std::vector<triangulation::Vertex3D>& coordinates,
+			bool* ok)
+	{
+		_skippedVertices = 0;
+		TetrahedralizationBuilder builder(coordinates);
+		if (!builder.build()) {
+			if (ok) {
+				*ok = false;
+			}
+			return {};
+		}
+		if (ok) {
+			*ok = true;
+		}
+		_skippedVertices = builder.skipped();
+		return builder.result();
+	}
+
+	size_t TetrahedralizationService::skippedVertices() const noexcept
+	{
+		return _skippedVertices;
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef TETRAHEDRALIZATION_TETRAHEDRALIZATION_SERVICE_H
+#define TETRAHEDRALIZATION_TETRAHEDRALIZATION_SERVICE_H
+
+#include "tetrahedron.h"
+#include <triangulation/vertex_3d.h>
+
+#include <vector>
+
+
+namespace tetrahedralization
+{
+	/**
+	 * Тетраэдризация Делоне вершин 3D (алгоритм Боуэра-Уотсона): вершины
+	 * добавляются по одной, тетраэдры, в описанную сферу которых попадает вершина,
+	 * удаляются, а образовавшаяся полость заполняется тетраэдрами с этой вершиной.
+	 *
+	 * Вершины добавляются в порядке BRIO (случайные раунды удваивающегося размера,
+	 * внутри раунда - по кривой Мортона), поэтому поиск тетраэдра обходом от
+	 * предыдущей вершины короткий. Тетраэдры хранятся в одном массиве и
+	 * ссылаются друг на друга по индексу, освобождённые места используются
+	 * повторно. Внешность оболочки покрыта фиктивными тетраэдрами с бесконечно
+	 * удалённой вершиной, поэтому новые вершины могут лежать и вне оболочки.
+	 * Все проверки выполняются точными предикатами Predicates.
+	 */
+	class TetrahedralizationService
+	{
+	private:
+		size_t _skippedVertices = 0;
+
+	public:
+		TetrahedralizationService() = default;
+		~TetrahedralizationService() = default;
+		TetrahedralizationService(const TetrahedralizationService&) = delete;
+		TetrahedralizationService(TetrahedralizationService&&) = delete;
+		TetrahedralizationService & operator=(const TetrahedralizationService&) = delete;
+		TetrahedralizationService & operator=(TetrahedralizationService&&) = delete;
+
+		/**
+		 * @param coordinates
+		 * @param ok - false если все вершины лежат в одной плоскости
+		 * @return Тетраэдры, вершины которых - индексы в coordinates
+		 */
+		std::vector<Tetrahedron> process(
+				const std::vector<triangulation::Vertex3D>& coordinates,
+				bool* ok);
+
+		/**
+		 * @return Количество вершин последнего process(), совпавших с уже добавленными
+		 */
+		[[nodiscard]] size_t skippedVertices() const noexcept;
+
+	};
+}
+
+#endif //TETRAHEDRALIZATION_TETRAHEDRALIZATION_SERVICE_H
@@ -0,0 +1,22 @@
+#ifndef TETRAHEDRALIZATION_TETRAHEDRON_H
+#define TETRAHEDRALIZATION_TETRAHEDRON_H
+
+
+namespace tetrahedralization
+{
+	/**
+	 * Данные тетраэдра. Вершины - индексы в массиве координат, перечислены так,
+	 * что Predicates::orient3d(vertices[0], vertices[1], vertices[2], vertices[3]) > 0.
+	 * neighbours[i] - индекс тетраэдра напротив вершины vertices[i] (с общей гранью
+	 * из трёх остальных вершин), NO_NEIGHBOUR на границе выпуклой оболочки.
+	 */
+	struct Tetrahedron
+	{
+		static constexpr int NO_NEIGHBOUR = -1;
+
+		int vertices[4] = {0, 0, 0, 0};
+		int neighbours[4] = {NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR};
+	};
+}
+
+#endif //TETRAHEDRALIZATION_TETRAHEDRON_H
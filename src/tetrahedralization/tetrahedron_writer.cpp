@@ -0,0 +1,58 @@
+#include "tetrahedron_writer.h"
+
+#include <triangulation/default_writer.h>
+#include <triangulation/output_buffer.h>
+
+#include <fstream>
+
+
+namespace tetrahedralization
+{
+	bool TetrahedronWriter::writeFile(
+			const std::string& outputFileName,
+			const std::vector<triangulation::Vertex3D>& coordinates,
+			const std::vector<Tetrahedron>& tetrahedra)
+	{
+		std::fstream file;
+		file.open(outputFileName, std::ios::out);
+		if (!file.is_open()) {
+			return false;
+		}
+		const bool ok = writeStream(file, coordinates, tetrahedra);
+		file.close();
+		return ok && !file.fail();
+	}
+
+	bool TetrahedronWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<triangulation::Vertex3D>& coordinates,
+			const std::vector<Tetrahedron>& tetrahedra)
+	{
+		std::vector<bool> usedVertices(coordinates.size(), false);
+		for (const Tetrahedron& tetrahedron : tetrahedra) {
+			for (int vertex : tetrahedron.vertices) {
+				usedVertices[vertex] = true;
+			}
+		}
+
+		triangulation::OutputBuffer output(stream);
+		output.append(triangulation::DefaultWriter::NODES_HEADER);
+		for (size_t i = 0; i < coordinates.size(); i++) {
+			if (usedVertices[i]) {
+				triangulation::DefaultWriter::appendNode(output, coordinates[i]);
+			}
+		}
+
+		output.append(triangulation::DefaultWriter::ELEMENTS_HEADER);
+		int id = 1;
+		for (const Tetrahedron& tetrahedron : tetrahedra) {
+			output.appendInt(id++, 5);
+			for (int vertex : tetrahedron.vertices) {
+				output.append(',');
+				output.appendInt(coordinates[vertex].id, 5);
+			}
+			output.append('\n');
+		}
+		return output.flush();
+	}
+}
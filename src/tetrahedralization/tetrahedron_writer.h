@@ -0,0 +1,49 @@
+#ifndef TETRAHEDRALIZATION_TETRAHEDRON_WRITER_H
+#define TETRAHEDRALIZATION_TETRAHEDRON_WRITER_H
+
+#include "tetrahedron.h"
+#include <triangulation/vertex_3d.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace tetrahedralization
+{
+	/**
+	 * Запись тетраэдров в текстовом формате DefaultWriter: раздел узлов и раздел
+	 * четырёхузловых элементов "N, N1, N2, N3, N4" с внешними номерами вершин.
+	 * Номер элемента - порядковый номер тетраэдра, начиная с 1.
+	 */
+	class TetrahedronWriter
+	{
+	public:
+		TetrahedronWriter() = default;
+		~TetrahedronWriter() = default;
+		TetrahedronWriter(const TetrahedronWriter&) = delete;
+		TetrahedronWriter(TetrahedronWriter&&) = delete;
+		TetrahedronWriter & operator=(const TetrahedronWriter&) = delete;
+		TetrahedronWriter & operator=(TetrahedronWriter&&) = delete;
+
+		/**
+		 * @return false если файл не удалось открыть или записать
+		 */
+		bool writeFile(
+				const std::string& outputFileName,
+				const std::vector<triangulation::Vertex3D>& coordinates,
+				const std::vector<Tetrahedron>& tetrahedra);
+
+		/**
+		 * Записывает узлы, входящие хотя бы в один тетраэдр, и тетраэдры в открытый поток
+		 * @return false если сетку не удалось записать
+		 */
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<triangulation::Vertex3D>& coordinates,
+				const std::vector<Tetrahedron>& tetrahedra);
+
+	};
+}
+
+#endif //TETRAHEDRALIZATION_TETRAHEDRON_WRITER_H
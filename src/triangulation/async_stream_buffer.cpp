@@ -0,0 +1,118 @@
+#include "async_stream_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace triangulation
+{
+	AsyncStreamBuffer::AsyncStreamBuffer(std::ostream& target, size_t capacity) :
+			_target(target)
+	{
+		capacity = std::max<size_t>(capacity, 1);
+		_buffers[0].resize(capacity);
+		_buffers[1].resize(capacity);
+		setp(_buffers[0].data(), _buffers[0].data() + capacity);
+		_thread = std::thread(&AsyncStreamBuffer::run, this);
+	}
+
+	AsyncStreamBuffer::~AsyncStreamBuffer()
+	{
+		sync();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopped = true;
+		}
+		_condition.notify_all();
+		_thread.join();
+	}
+
+	AsyncStreamBuffer::int_type AsyncStreamBuffer::overflow(int_type c)
+	{
+		if (!swapBuffers()) {
+			return traits_type::eof();
+		}
+		if (!traits_type::eq_int_type(c, traits_type::eof())) {
+			*pptr() = traits_type::to_char_type(c);
+			pbump(1);
+		}
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize AsyncStreamBuffer::xsputn(const char* data, std::streamsize size)
+	{
+		std::streamsize written = 0;
+		while (written < size) {
+			if (pptr() == epptr() && !swapBuffers()) {
+				break;
+			}
+			const auto count = std::min<std::streamsize>(size - written, epptr() - pptr());
+			std::memcpy(pptr(), data + written, static_cast<size_t>(count));
+			// pbump принимает int, поэтому count не больше размера буфера
+			pbump(static_cast<int>(count));
+			written += count;
+		}
+		return written;
+	}
+
+	int AsyncStreamBuffer::sync()
+	{
+		if (!swapBuffers()) {
+			return -1;
+		}
+		std::unique_lock<std::mutex> lock(_mutex);
+		waitPending(lock);
+		if (_failed) {
+			return -1;
+		}
+		_target.flush();
+		return _target.good() ? 0 : -1;
+	}
+
+	bool AsyncStreamBuffer::swapBuffers()
+	{
+		const size_t size = static_cast<size_t>(pptr() - pbase());
+		std::unique_lock<std::mutex> lock(_mutex);
+		waitPending(lock);
+		if (_failed) {
+			return false;
+		}
+		if (size > 0) {
+			_pendingData = pbase();
+			_pendingSize = size;
+			_current = 1 - _current;
+			std::vector<char>& buffer = _buffers[_current];
+			setp(buffer.data(), buffer.data() + buffer.size());
+			lock.unlock();
+			_condition.notify_all();
+		}
+		return true;
+	}
+
+	void AsyncStreamBuffer::waitPending(std::unique_lock<std::mutex>& lock)
+	{
+		_condition.wait(lock, [this]() { return _pendingSize == 0; });
+	}
+
+	void AsyncStreamBuffer::run()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_condition.wait(lock, [this]() { return _stopped || _pendingSize > 0; });
+			if (_pendingSize == 0) {
+				return;
+			}
+			const char* data = _pendingData;
+			const size_t size = _pendingSize;
+			// Запись идёт без блокировки: буфер data не изменяется, пока _pendingSize != 0
+			lock.unlock();
+			_target.write(data, static_cast<std::streamsize>(size));
+			const bool failed = !_target.good();
+			lock.lock();
+			_failed = _failed || failed;
+			_pendingSize = 0;
+			_pendingData = nullptr;
+			_condition.notify_all();
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef TRIANGULATION_ASYNC_STREAM_BUFFER_H
+#define TRIANGULATION_ASYNC_STREAM_BUFFER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+
+namespace triangulation
+{
+	/**
+	 * Буфер потока вывода с двойной буферизацией: пока фоновый поток записывает
+	 * заполненный буфер в целевой поток, данные накапливаются во втором буфере.
+	 * Форматирование вывода при этом не ждёт записи на диск или в pipe.
+	 *
+	 * Используется как std::ostream output(&buffer). Ошибка записи в целевой поток
+	 * обнаруживается при следующем переключении буферов или pubsync().
+	 */
+	class AsyncStreamBuffer : public std::streambuf
+	{
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+	private:
+		std::ostream& _target;
+		std::vector<char> _buffers[2];
+		// индекс буфера, который сейчас заполняется
+		size_t _current = 0;
+
+		std::thread _thread;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		// размер буфера, переданного фоновому потоку, 0 - фоновый поток свободен
+		size_t _pendingSize = 0;
+		const char* _pendingData = nullptr;
+		bool _failed = false;
+		bool _stopped = false;
+
+	public:
+		explicit AsyncStreamBuffer(std::ostream& target, size_t capacity = DEFAULT_CAPACITY);
+		~AsyncStreamBuffer() override;
+		AsyncStreamBuffer(const AsyncStreamBuffer&) = delete;
+		AsyncStreamBuffer(AsyncStreamBuffer&&) = delete;
+		AsyncStreamBuffer & operator=(const AsyncStreamBuffer&) = delete;
+		AsyncStreamBuffer & operator=(AsyncStreamBuffer&&) = delete;
+
+	protected:
+		int_type overflow(int_type c) override;
+		std::streamsize xsputn(const char* data, std::streamsize size) override;
+		int sync() override;
+
+	private:
+		/**
+		 * Передаёт заполненную часть текущего буфера фоновому потоку и переключается
+		 * на второй буфер
+		 * @return false если предыдущая запись завершилась ошибкой
+		 */
+		bool swapBuffers();
+		void waitPending(std::unique_lock<std::mutex>& lock);
+		void run();
+
+	};
+}
+
+#endif //TRIANGULATION_ASYNC_STREAM_BUFFER_H
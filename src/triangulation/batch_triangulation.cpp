@@ -0,0 +1,217 @@
+#include "batch_triangulation.h"
+
+#include "coordinates_file_parser.h"
+#include "file_writer_interface.h"
+#include "projection_interface.h"
+#include "thread_pool.h"
+#include "vertex_3d.h"
+#include <delaunay/delaunay_service.h>
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <list>
+#include <numeric>
+#include <system_error>
+
+
+namespace triangulation
+{
+	const char* const BatchTriangulation::INPUT_FILE_EXTENSION = ".xyz";
+	const char* const BatchTriangulation::OUTPUT_FILE_SUFFIX = ".output";
+	const char* const BatchTriangulation::SUMMARY_FILE_NAME = "batch-summary.csv";
+
+	static const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+	namespace
+	{
+		void writeCsvField(std::ostream& output, const std::string& field)
+		{
+			if (field.find_first_of(",\"\r\n") == std::string::npos) {
+				output << field;
+				return;
+			}
+			output << '"';
+			for (char c : field) {
+				if (c == '"') {
+					output << '"';
+				}
+				output << c;
+			}
+			output << '"';
+		}
+
+		/**
+		 * Состояние потока, которое сохраняется между заданиями
+		 */
+		struct Worker
+		{
+			CoordinatesFileParser parser;
+			delaunay::DelaunayService service;
+			std::unique_ptr<IFileWriter> writer;
+			std::list<std::shared_ptr<delaunay::Vertex2D> > vertices;
+			std::vector<char> fileBuffer;
+		};
+
+		void processJob(Worker& worker, const BatchTriangulation::ProjectionFactory& projectionFactory, BatchJob& job)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			job.ok = false;
+			job.error.clear();
+			job.skippedVertices.clear();
+			worker.parser.clear();
+			worker.vertices.clear();
+			// файлы маленькие, поэтому каждый разбирается в одном потоке
+			if (!worker.parser.loadFile(job.inputFileName, 1)) {
+				job.error = "cannot read the input file";
+				job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				return;
+			}
+			const std::vector<Vertex3D>& coordinates = worker.parser.coordinates();
+			job.vertexCount = coordinates.size();
+			job.invalidLineCount = worker.parser.invalidLines().size();
+
+			std::unique_ptr<IProjection> projection = projectionFactory();
+			if (projection->needsFit()) {
+				projection->fit(coordinates.data(), coordinates.size());
+			}
+			projectVertex3D(*projection, coordinates.data(), coordinates.size(), worker.vertices);
+			bool ok;
+			// кэш и треугольники сервиса переходят от задания к заданию
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles =
+					worker.service.process(worker.vertices, &ok);
+			job.triangleCount = triangles.size();
+			for (const auto& skippedVertex : worker.service.skippedVertices()) {
+				job.skippedVertices.push_back({coordinates[skippedVertex.id].id, skippedVertex.reason});
+			}
+			if (ok) {
+				const std::vector<bool> usedVertices =
+						delaunay::DelaunayService::usedVertices(triangles, coordinates.size());
+				std::ofstream file;
+				file.rdbuf()->pubsetbuf(worker.fileBuffer.data(), static_cast<std::streamsize>(worker.fileBuffer.size()));
+				file.open(job.outputFileName, worker.writer->isBinary()
+						? std::ios::out | std::ios::binary | std::ios::trunc
+						: std::ios::out | std::ios::trunc);
+				job.ok = file.is_open()
+						&& worker.writer->writeStream(file, coordinates, triangles, usedVertices)
+						&& file.flush();
+				if (!job.ok) {
+					job.error = "cannot write the output file";
+				}
+			}
+			else {
+				job.error = coordinates.size() < 3 ? "fewer than 3 vertices" : "cannot triangulate";
+			}
+			job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+
+	BatchTriangulation::BatchTriangulation(
+			WriterFactory writerFactory,
+			ProjectionFactory projectionFactory,
+			size_t threadCount)
+		: _writerFactory(std::move(writerFactory))
+		, _projectionFactory(std::move(projectionFactory))
+		, _threadCount(threadCount)
+	{}
+
+	bool BatchTriangulation::listInputs(const std::string& path, std::vector<std::string>& inputFileNames)
+	{
+		std::error_code error;
+		if (std::filesystem::is_directory(path, error)) {
+			std::vector<std::string> names;
+			for (const auto& item : std::filesystem::directory_iterator(path, error)) {
+				if (item.is_regular_file(error) && item.path().extension() == INPUT_FILE_EXTENSION) {
+					names.push_back(item.path().string());
+				}
+			}
+			if (error) {
+				return false;
+			}
+			std::sort(names.begin(), names.end());
+			inputFileNames.insert(inputFileNames.end(), names.begin(), names.end());
+			return true;
+		}
+
+		std::ifstream manifest(path, std::ios::in);
+		if (!manifest.is_open()) {
+			return false;
+		}
+		const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+		std::string line;
+		while (std::getline(manifest, line)) {
+			const size_t begin = line.find_first_not_of(" \t\r");
+			if (begin == std::string::npos || line[begin] == '#') {
+				continue;
+			}
+			const size_t end = line.find_last_not_of(" \t\r");
+			const std::filesystem::path name = line.substr(begin, end - begin + 1);
+			inputFileNames.push_back((name.is_relative() ? directory / name : name).string());
+		}
+		return !manifest.bad();
+	}
+
+	size_t BatchTriangulation::process(std::vector<BatchJob>& jobs) const
+	{
+		// большие файлы первыми
+		std::vector<uintmax_t> sizes(jobs.size());
+		for (size_t i = 0; i < jobs.size(); i++) {
+			std::error_code error;
+			sizes[i] = std::filesystem::file_size(jobs[i].inputFileName, error);
+			if (error) {
+				sizes[i] = 0;
+			}
+		}
+		std::vector<size_t> order(jobs.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&sizes](size_t first, size_t second) {
+			return sizes[first] > sizes[second];
+		});
+
+		const size_t threadCount = std::max<size_t>(1, std::min(
+				_threadCount > 0 ? _threadCount : ThreadPool::defaultThreadCount(), jobs.size()));
+		std::atomic<size_t> next(0);
+		{
+			ThreadPool pool(threadCount);
+			std::vector<std::future<void> > results;
+			for (size_t i = 0; i < threadCount; i++) {
+				results.push_back(pool.submit([this, &jobs, &order, &next]() {
+					Worker worker;
+					worker.writer = _writerFactory();
+					worker.fileBuffer.resize(FILE_BUFFER_SIZE);
+					for (size_t index = next++; index < order.size(); index = next++) {
+						processJob(worker, _projectionFactory, jobs[order[index]]);
+					}
+				}));
+			}
+			for (auto& result : results) {
+				result.get();
+			}
+		}
+		return static_cast<size_t>(std::count_if(jobs.begin(), jobs.end(), [](const BatchJob& job) {
+			return !job.ok;
+		}));
+	}
+
+	bool BatchTriangulation::writeSummary(std::ostream& output, const std::vector<BatchJob>& jobs)
+	{
+		output << "input,output,status,error,vertices,invalid lines,skipped vertices,triangles,milliseconds\n";
+		for (const BatchJob& job : jobs) {
+			writeCsvField(output, job.inputFileName);
+			output << ',';
+			writeCsvField(output, job.outputFileName);
+			output << ',' << (job.ok ? "ok" : "failed") << ',';
+			writeCsvField(output, job.error);
+			output << ',' << job.vertexCount << ',' << job.invalidLineCount << ',' << job.skippedVertices.size()
+					<< ',' << job.triangleCount << ',' << static_cast<long long>(std::llround(job.seconds * 1000.0)) << '\n';
+		}
+		return output.flush().good();
+	}
+}
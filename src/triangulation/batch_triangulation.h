@@ -0,0 +1,104 @@
+#ifndef TRIANGULATION_BATCH_TRIANGULATION_H
+#define TRIANGULATION_BATCH_TRIANGULATION_H
+
+#include <delaunay/skipped_vertex.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace triangulation
+{
+	class IFileWriter;
+	class IProjection;
+
+	/**
+	 * Одно входное задание пакета и его результат
+	 */
+	struct BatchJob
+	{
+		std::string inputFileName;
+		std::string outputFileName;
+		bool ok = false;
+		// причина ошибки, пустая если ok
+		std::string error;
+		size_t vertexCount = 0;
+		size_t invalidLineCount = 0;
+		size_t triangleCount = 0;
+		// id - номера вершин из входного файла
+		std::vector<delaunay::SkippedVertex> skippedVertices;
+		// время загрузки, триангуляции и записи
+		double seconds = 0.0;
+	};
+
+	/**
+	 * Триангуляция множества небольших файлов в одном процессе. Файлы независимы,
+	 * поэтому каждый поток пула берёт следующее задание из общего счётчика, пока
+	 * задания не кончатся; большие файлы берутся первыми, чтобы в конце не ждать
+	 * одно длинное задание. Каждый поток между заданиями использует одни и те же
+	 * разборщик координат, DelaunayService, writer и буфер файла.
+	 */
+	class BatchTriangulation
+	{
+	public:
+		using WriterFactory = std::function<std::unique_ptr<IFileWriter>()>;
+		using ProjectionFactory = std::function<std::unique_ptr<IProjection>()>;
+
+		static const char* const INPUT_FILE_EXTENSION;
+		static const char* const OUTPUT_FILE_SUFFIX;
+		static const char* const SUMMARY_FILE_NAME;
+
+	private:
+		WriterFactory _writerFactory;
+		ProjectionFactory _projectionFactory;
+		size_t _threadCount;
+
+	public:
+		/**
+		 * @param writerFactory - writer для каждого потока
+		 * @param projectionFactory - проекция для каждого файла (fit() вызывается
+		 * по вершинам файла)
+		 * @param threadCount - 0 для количества ядер
+		 */
+		BatchTriangulation(WriterFactory writerFactory, ProjectionFactory projectionFactory, size_t threadCount = 0);
+		~BatchTriangulation() = default;
+		BatchTriangulation(const BatchTriangulation&) = delete;
+		BatchTriangulation(BatchTriangulation&&) = delete;
+		BatchTriangulation & operator=(const BatchTriangulation&) = delete;
+		BatchTriangulation & operator=(BatchTriangulation&&) = delete;
+
+		/**
+		 * Входные файлы пакета: файлы каталога с расширением INPUT_FILE_EXTENSION по
+		 * имени или строки файла-списка по порядку. В списке пустые строки и строки,
+		 * начинающиеся с '#', пропускаются, относительные пути отсчитываются от
+		 * каталога списка.
+		 * @param path - каталог или файл-список
+		 * @param inputFileNames
+		 * @return false если каталог или список не удалось прочитать
+		 */
+		static bool listInputs(const std::string& path, std::vector<std::string>& inputFileNames);
+
+		/**
+		 * Триангулирует все задания и заполняет их результаты
+		 * @param jobs
+		 * @return количество заданий с ошибкой
+		 */
+		size_t process(std::vector<BatchJob>& jobs) const;
+
+		/**
+		 * Записывает сводку в формате CSV: строка на задание в порядке jobs. Поля с
+		 * запятыми, кавычками и переводами строк берутся в кавычки (RFC 4180).
+		 * @param output
+		 * @param jobs
+		 * @return
+		 */
+		static bool writeSummary(std::ostream& output, const std::vector<BatchJob>& jobs);
+
+	};
+}
+
+#endif //TRIANGULATION_BATCH_TRIANGULATION_H
@@ -0,0 +1,185 @@
+#include "binary_coordinates_file.h"
+
+#include "utils.h"
+#include "vertex_3d.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+
+namespace triangulation
+{
+	const char BinaryCoordinatesFile::MAGIC[8] = {'D', 'T', 'X', 'Y', 'Z', 'B', 'I', 'N'};
+
+	// количество элементов столбца, записываемых за один раз
+	static const size_t WRITE_BLOCK_SIZE = 1 << 16;
+
+	namespace
+	{
+		template<typename T, typename Getter>
+		bool writeColumn(
+				std::ofstream& file,
+				const std::vector<Vertex3D>& coordinates,
+				std::vector<T>& block,
+				Getter getter)
+		{
+			for (size_t i = 0; i < coordinates.size(); i += WRITE_BLOCK_SIZE) {
+				const size_t blockSize = std::min(WRITE_BLOCK_SIZE, coordinates.size() - i);
+				for (size_t j = 0; j < blockSize; j++) {
+					block[j] = getter(coordinates[i + j]);
+				}
+				file.write(
+						reinterpret_cast<const char*>(block.data()),
+						static_cast<std::streamsize>(blockSize * sizeof(T)));
+			}
+			return file.good();
+		}
+	}
+
+	bool BinaryCoordinatesFile::isBinaryFile(const std::string& fileName)
+	{
+		std::ifstream file(fileName, std::ios::in | std::ios::binary);
+		if (!file.is_open()) {
+			return false;
+		}
+		char magic[sizeof(MAGIC)];
+		if (!file.read(magic, sizeof(magic))) {
+			return false;
+		}
+		return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+	}
+
+	bool BinaryCoordinatesFile::write(
+			const std::string& fileName,
+			const std::vector<Vertex3D>& coordinates,
+			bool withBoundingBox)
+	{
+		if (!Utils::isLittleEndian()) {
+			return false;
+		}
+		std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+
+		BinaryCoordinatesHeader header {};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.count = coordinates.size();
+		if (withBoundingBox && !coordinates.empty()) {
+			header.flags |= HAS_BOUNDING_BOX;
+			header.minX = header.maxX = coordinates.front().x;
+			header.minY = header.maxY = coordinates.front().y;
+			header.minZ = header.maxZ = coordinates.front().z;
+			for (const auto& vertex : coordinates) {
+				header.minX = std::min(header.minX, vertex.x);
+				header.minY = std::min(header.minY, vertex.y);
+				header.minZ = std::min(header.minZ, vertex.z);
+				header.maxX = std::max(header.maxX, vertex.x);
+				header.maxY = std::max(header.maxY, vertex.y);
+				header.maxZ = std::max(header.maxZ, vertex.z);
+			}
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<int32_t> idBlock(std::min(WRITE_BLOCK_SIZE, coordinates.size()));
+		std::vector<float> valueBlock(idBlock.size());
+		return writeColumn(file, coordinates, idBlock,
+						   [](const Vertex3D& vertex) { return static_cast<int32_t>(vertex.id); })
+			   && writeColumn(file, coordinates, valueBlock,
+							  [](const Vertex3D& vertex) { return vertex.x; })
+			   && writeColumn(file, coordinates, valueBlock,
+							  [](const Vertex3D& vertex) { return vertex.y; })
+			   && writeColumn(file, coordinates, valueBlock,
+							  [](const Vertex3D& vertex) { return vertex.z; });
+	}
+
+	bool BinaryCoordinatesFile::open(const std::string& fileName)
+	{
+		_header = nullptr;
+		if (!Utils::isLittleEndian() || !_file.open(fileName)) {
+			return false;
+		}
+		if (_file.size() < sizeof(BinaryCoordinatesHeader)) {
+			_file.close();
+			return false;
+		}
+		const auto* header = reinterpret_cast<const BinaryCoordinatesHeader*>(_file.data());
+		const uint64_t columnsSize = (_file.size() - sizeof(BinaryCoordinatesHeader)) / 16;
+		if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+				|| header->version != VERSION
+				|| header->count > columnsSize) {
+			_file.close();
+			return false;
+		}
+		_header = header;
+		return true;
+	}
+
+	size_t BinaryCoordinatesFile::count() const noexcept
+	{
+		return _header ? static_cast<size_t>(_header->count) : 0;
+	}
+
+	const int32_t* BinaryCoordinatesFile::ids() const noexcept
+	{
+		if (!_header) {
+			return nullptr;
+		}
+		return reinterpret_cast<const int32_t*>(_file.data() + sizeof(BinaryCoordinatesHeader));
+	}
+
+	const float* BinaryCoordinatesFile::x() const noexcept
+	{
+		return column(1);
+	}
+
+	const float* BinaryCoordinatesFile::y() const noexcept
+	{
+		return column(2);
+	}
+
+	const float* BinaryCoordinatesFile::z() const noexcept
+	{
+		return column(3);
+	}
+
+	bool BinaryCoordinatesFile::hasBoundingBox() const noexcept
+	{
+		return _header && (_header->flags & HAS_BOUNDING_BOX) != 0;
+	}
+
+	const BinaryCoordinatesHeader* BinaryCoordinatesFile::header() const noexcept
+	{
+		return _header;
+	}
+
+	void BinaryCoordinatesFile::appendCoordinates(std::vector<Vertex3D>& coordinates) const
+	{
+		const size_t n = count();
+		const int32_t* idColumn = ids();
+		const float* xColumn = x();
+		const float* yColumn = y();
+		const float* zColumn = z();
+		coordinates.reserve(coordinates.size() + n);
+		for (size_t i = 0; i < n; i++) {
+			Vertex3D vertex;
+			vertex.id = idColumn[i];
+			vertex.x = xColumn[i];
+			vertex.y = yColumn[i];
+			vertex.z = zColumn[i];
+			coordinates.push_back(vertex);
+		}
+	}
+
+	const float* BinaryCoordinatesFile::column(size_t number) const noexcept
+	{
+		if (!_header) {
+			return nullptr;
+		}
+		const size_t offset = sizeof(BinaryCoordinatesHeader)
+				+ number * static_cast<size_t>(_header->count) * sizeof(float);
+		return reinterpret_cast<const float*>(_file.data() + offset);
+	}
+}
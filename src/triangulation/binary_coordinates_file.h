@@ -0,0 +1,108 @@
+#ifndef TRIANGULATION_BINARY_COORDINATES_FILE_H
+#define TRIANGULATION_BINARY_COORDINATES_FILE_H
+
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace triangulation
+{
+	struct Vertex3D;
+
+	/**
+	 * Заголовок бинарного файла координат. Все значения little-endian.
+	 * Сразу за заголовком располагаются столбцы по count элементов:
+	 * int32 id, float x, float y, float z.
+	 */
+	struct BinaryCoordinatesHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+		uint64_t count;
+		// габаритный прямоугольник, заполнен если установлен флаг HAS_BOUNDING_BOX
+		float minX;
+		float minY;
+		float minZ;
+		float maxX;
+		float maxY;
+		float maxZ;
+		uint8_t reserved[16];
+	};
+	static_assert(sizeof(BinaryCoordinatesHeader) == 64, "Unexpected binary header size");
+
+	/**
+	 * Бинарный формат-компаньон текстовых .xyz файлов. Файл отображается в память
+	 * целиком и не требует разбора: столбцы координат доступны напрямую.
+	 */
+	class BinaryCoordinatesFile
+	{
+	public:
+		static const char MAGIC[8];
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t HAS_BOUNDING_BOX = 1u;
+
+	private:
+		MappedFile _file;
+		const BinaryCoordinatesHeader* _header = nullptr;
+
+	public:
+		BinaryCoordinatesFile() = default;
+		~BinaryCoordinatesFile() = default;
+		BinaryCoordinatesFile(const BinaryCoordinatesFile&) = delete;
+		BinaryCoordinatesFile(BinaryCoordinatesFile&&) = delete;
+		BinaryCoordinatesFile & operator=(const BinaryCoordinatesFile&) = delete;
+		BinaryCoordinatesFile & operator=(BinaryCoordinatesFile&&) = delete;
+
+		/**
+		 * Проверяет по первым байтам, что файл записан в бинарном формате
+		 * @param fileName
+		 * @return
+		 */
+		static bool isBinaryFile(const std::string& fileName);
+
+		/**
+		 * Записывает координаты в бинарном формате
+		 * @param fileName
+		 * @param coordinates
+		 * @param withBoundingBox - сохранить габаритный прямоугольник в заголовке
+		 * @return
+		 */
+		static bool write(
+				const std::string& fileName,
+				const std::vector<Vertex3D>& coordinates,
+				bool withBoundingBox);
+
+		/**
+		 * Отображает файл в память и проверяет заголовок. Поддерживаются только
+		 * little-endian платформы.
+		 * @param fileName
+		 * @return false если файл не открыт или не соответствует формату
+		 */
+		bool open(const std::string& fileName);
+
+		[[nodiscard]] size_t count() const noexcept;
+		[[nodiscard]] const int32_t* ids() const noexcept;
+		[[nodiscard]] const float* x() const noexcept;
+		[[nodiscard]] const float* y() const noexcept;
+		[[nodiscard]] const float* z() const noexcept;
+
+		[[nodiscard]] bool hasBoundingBox() const noexcept;
+		[[nodiscard]] const BinaryCoordinatesHeader* header() const noexcept;
+
+		/**
+		 * Добавляет координаты из столбцов файла в coordinates
+		 * @param coordinates
+		 */
+		void appendCoordinates(std::vector<Vertex3D>& coordinates) const;
+
+	private:
+		[[nodiscard]] const float* column(size_t number) const noexcept;
+
+	};
+}
+
+#endif //TRIANGULATION_BINARY_COORDINATES_FILE_H
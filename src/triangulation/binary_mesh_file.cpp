@@ -0,0 +1,89 @@
+#include "binary_mesh_file.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+
+namespace triangulation
+{
+	const char BinaryMeshFile::MAGIC[8] = {'D', 'T', 'M', 'E', 'S', 'H', 'B', 'N'};
+
+	namespace
+	{
+		/**
+		 * Количество элементов сравнивается с остатком файла делением, т.к. размер
+		 * блока count * elementSize может переполниться при повреждённом заголовке
+		 */
+		bool isBlockInside(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) noexcept
+		{
+			return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+		}
+	}
+
+	bool BinaryMeshFile::open(const std::string& fileName)
+	{
+		_header = nullptr;
+		if (!Utils::isLittleEndian() || !_file.open(fileName)) {
+			return false;
+		}
+		const uint64_t fileSize = _file.size();
+		if (fileSize < sizeof(BinaryMeshHeader)) {
+			_file.close();
+			return false;
+		}
+		const auto* header = reinterpret_cast<const BinaryMeshHeader*>(_file.data());
+		const uint64_t triangleSize = 3 * sizeof(int32_t);
+		if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+				|| header->version != VERSION
+				|| !isBlockInside(header->vertexOffset,
+								  header->vertexCount, sizeof(BinaryMeshVertex), fileSize)
+				|| !isBlockInside(header->triangleOffset, header->triangleCount, triangleSize, fileSize)
+				|| ((header->flags & HAS_NEIGHBOURS) != 0
+					&& !isBlockInside(header->neighbourOffset, header->triangleCount, triangleSize, fileSize))) {
+			_file.close();
+			return false;
+		}
+		_header = header;
+		return true;
+	}
+
+	const BinaryMeshHeader* BinaryMeshFile::header() const noexcept
+	{
+		return _header;
+	}
+
+	size_t BinaryMeshFile::vertexCount() const noexcept
+	{
+		return _header ? static_cast<size_t>(_header->vertexCount) : 0;
+	}
+
+	size_t BinaryMeshFile::triangleCount() const noexcept
+	{
+		return _header ? static_cast<size_t>(_header->triangleCount) : 0;
+	}
+
+	const BinaryMeshVertex* BinaryMeshFile::vertices() const noexcept
+	{
+		if (!_header) {
+			return nullptr;
+		}
+		return reinterpret_cast<const BinaryMeshVertex*>(_file.data() + _header->vertexOffset);
+	}
+
+	const int32_t* BinaryMeshFile::triangles() const noexcept
+	{
+		if (!_header) {
+			return nullptr;
+		}
+		return reinterpret_cast<const int32_t*>(_file.data() + _header->triangleOffset);
+	}
+
+	const int32_t* BinaryMeshFile::neighbours() const noexcept
+	{
+		if (!_header || (_header->flags & HAS_NEIGHBOURS) == 0) {
+			return nullptr;
+		}
+		return reinterpret_cast<const int32_t*>(_file.data() + _header->neighbourOffset);
+	}
+}
@@ -0,0 +1,87 @@
+#ifndef TRIANGULATION_BINARY_MESH_FILE_H
+#define TRIANGULATION_BINARY_MESH_FILE_H
+
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <string>
+
+
+namespace triangulation
+{
+	/**
+	 * Заголовок бинарного файла сетки. Все значения little-endian, смещения
+	 * блоков считаются от начала файла.
+	 */
+	struct BinaryMeshHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+		uint64_t vertexCount;
+		uint64_t triangleCount;
+		uint64_t vertexOffset;		// блок BinaryMeshVertex[vertexCount]
+		uint64_t triangleOffset;	// блок int32[3 * triangleCount] - индексы вершин
+		uint64_t neighbourOffset;	// блок int32[3 * triangleCount] - индексы соседей или 0
+		uint8_t reserved[8];
+	};
+	static_assert(sizeof(BinaryMeshHeader) == 64, "Unexpected binary mesh header size");
+
+	struct BinaryMeshVertex
+	{
+		int32_t id;
+		float x;
+		float y;
+		float z;
+	};
+	static_assert(sizeof(BinaryMeshVertex) == 16, "Unexpected binary mesh vertex size");
+
+	/**
+	 * Бинарный файл сетки, записанный BinaryMeshWriter. Файл отображается в память,
+	 * блоки доступны напрямую без разбора.
+	 *
+	 * Треугольник i задаётся индексами вершин triangles()[3 * i .. 3 * i + 2] в порядке
+	 * vertex1, vertex2, vertex3. Соседи neighbours()[3 * i .. 3 * i + 2] - индексы
+	 * треугольников напротив соответствующих вершин или -1.
+	 */
+	class BinaryMeshFile
+	{
+	public:
+		static const char MAGIC[8];
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t HAS_NEIGHBOURS = 1u;
+		static constexpr int32_t NO_NEIGHBOUR = -1;
+
+	private:
+		MappedFile _file;
+		const BinaryMeshHeader* _header = nullptr;
+
+	public:
+		BinaryMeshFile() = default;
+		~BinaryMeshFile() = default;
+		BinaryMeshFile(const BinaryMeshFile&) = delete;
+		BinaryMeshFile(BinaryMeshFile&&) = delete;
+		BinaryMeshFile & operator=(const BinaryMeshFile&) = delete;
+		BinaryMeshFile & operator=(BinaryMeshFile&&) = delete;
+
+		/**
+		 * Отображает файл в память и проверяет заголовок и размеры блоков
+		 * @param fileName
+		 * @return false если файл не открыт или не соответствует формату
+		 */
+		bool open(const std::string& fileName);
+
+		[[nodiscard]] const BinaryMeshHeader* header() const noexcept;
+		[[nodiscard]] size_t vertexCount() const noexcept;
+		[[nodiscard]] size_t triangleCount() const noexcept;
+		[[nodiscard]] const BinaryMeshVertex* vertices() const noexcept;
+		[[nodiscard]] const int32_t* triangles() const noexcept;
+		/**
+		 * @return nullptr если файл записан без соседей
+		 */
+		[[nodiscard]] const int32_t* neighbours() const noexcept;
+
+	};
+}
+
+#endif //TRIANGULATION_BINARY_MESH_FILE_H
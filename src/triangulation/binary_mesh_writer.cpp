@@ -0,0 +1,130 @@
+#include "binary_mesh_writer.h"
+
+#include "binary_mesh_file.h"
+#include "utils.h"
+#include "vertex_index.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <cstring>
+#include <unordered_map>
+
+
+namespace triangulation
+{
+	// количество записей, записываемых за один раз
+	static const size_t WRITE_BLOCK_SIZE = 1 << 16;
+
+	namespace
+	{
+		/**
+		 * Накапливает записи и передаёт их в поток блоками по WRITE_BLOCK_SIZE
+		 */
+		template<typename T>
+		class BlockWriter
+		{
+		private:
+			std::ostream& _stream;
+			std::vector<T> _block;
+
+		public:
+			explicit BlockWriter(std::ostream& stream) : _stream(stream)
+			{
+				_block.reserve(WRITE_BLOCK_SIZE);
+			}
+
+			void push(const T& value)
+			{
+				_block.push_back(value);
+				if (_block.size() == WRITE_BLOCK_SIZE) {
+					flush();
+				}
+			}
+
+			void flush()
+			{
+				_stream.write(
+						reinterpret_cast<const char*>(_block.data()),
+						static_cast<std::streamsize>(_block.size() * sizeof(T)));
+				_block.clear();
+			}
+		};
+
+		int32_t index(
+				const std::unordered_map<const delaunay::Triangle*, int32_t>& indices,
+				const std::shared_ptr<delaunay::Triangle>& triangle)
+		{
+			if (!triangle) {
+				return BinaryMeshFile::NO_NEIGHBOUR;
+			}
+			auto i = indices.find(triangle.get());
+			return i != indices.end() ? i->second : BinaryMeshFile::NO_NEIGHBOUR;
+		}
+	}
+
+	BinaryMeshWriter::BinaryMeshWriter(bool withNeighbours) :
+			IFileWriter(),
+			_withNeighbours(withNeighbours)
+	{}
+
+	bool BinaryMeshWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		if (!Utils::isLittleEndian()) {
+			return false;
+		}
+		const VertexIndex vertexIndex(usedVertices);
+
+		BinaryMeshHeader header {};
+		std::memcpy(header.magic, BinaryMeshFile::MAGIC, sizeof(BinaryMeshFile::MAGIC));
+		header.version = BinaryMeshFile::VERSION;
+		header.flags = _withNeighbours ? BinaryMeshFile::HAS_NEIGHBOURS : 0u;
+		header.vertexCount = vertexIndex.size();
+		header.triangleCount = triangles.size();
+		header.vertexOffset = sizeof(BinaryMeshHeader);
+		header.triangleOffset = header.vertexOffset + header.vertexCount * sizeof(BinaryMeshVertex);
+		header.neighbourOffset = _withNeighbours
+				? header.triangleOffset + header.triangleCount * 3 * sizeof(int32_t)
+				: 0;
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		BlockWriter<BinaryMeshVertex> vertexWriter(stream);
+		for (size_t position : vertexIndex.positions()) {
+			const Vertex3D& vertex = coordinates[position];
+			vertexWriter.push({vertex.id, vertex.x, vertex.y, vertex.z});
+		}
+		vertexWriter.flush();
+
+		std::unordered_map<const delaunay::Triangle*, int32_t> triangleIndices;
+		BlockWriter<int32_t> triangleWriter(stream);
+		for (const auto& triangle : triangles) {
+			if (_withNeighbours) {
+				triangleIndices.emplace(
+						triangle.get(), static_cast<int32_t>(triangleIndices.size()));
+			}
+			for (int id : triangle->vertexIds()) {
+				triangleWriter.push(vertexIndex.index(id));
+			}
+		}
+		triangleWriter.flush();
+
+		if (_withNeighbours) {
+			BlockWriter<int32_t> neighbourWriter(stream);
+			for (const auto& triangle : triangles) {
+				neighbourWriter.push(index(triangleIndices, triangle->triangle1));
+				neighbourWriter.push(index(triangleIndices, triangle->triangle2));
+				neighbourWriter.push(index(triangleIndices, triangle->triangle3));
+			}
+			neighbourWriter.flush();
+		}
+		return !stream.fail();
+	}
+
+	bool BinaryMeshWriter::isBinary() const noexcept
+	{
+		return true;
+	}
+}
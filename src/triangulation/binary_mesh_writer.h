@@ -0,0 +1,38 @@
+#ifndef TRIANGULATION_BINARY_MESH_WRITER_H
+#define TRIANGULATION_BINARY_MESH_WRITER_H
+
+#include "file_writer_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Записывает сетку в бинарном формате (см. BinaryMeshFile): заголовок, блок
+	 * использованных вершин и блок треугольников с индексами вершин и, при
+	 * необходимости, индексами соседних треугольников. Вершины треугольника
+	 * перечислены в порядке обхода по часовой стрелке, как в Triangle.
+	 */
+	class BinaryMeshWriter : public IFileWriter
+	{
+	private:
+		bool _withNeighbours = true;
+
+	public:
+		BinaryMeshWriter(const BinaryMeshWriter&) = delete;
+		BinaryMeshWriter(BinaryMeshWriter&&) = delete;
+		BinaryMeshWriter& operator=(const BinaryMeshWriter&) = delete;
+		BinaryMeshWriter& operator=(BinaryMeshWriter&&) = delete;
+		explicit BinaryMeshWriter(bool withNeighbours = true);
+
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_BINARY_MESH_WRITER_H
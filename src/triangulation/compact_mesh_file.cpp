@@ -0,0 +1,151 @@
+#include "compact_mesh_file.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+
+namespace triangulation
+{
+	const char CompactMeshFile::MAGIC[8] = {'D', 'T', 'M', 'E', 'S', 'H', 'C', 'Z'};
+
+	namespace
+	{
+		bool isBlockInside(uint64_t offset, uint64_t size, uint64_t fileSize) noexcept
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		}
+
+		/**
+		 * Читает varint (LEB128)
+		 * @return false если данные закончились раньше значения
+		 */
+		bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t* value) noexcept
+		{
+			uint64_t result = 0;
+			for (int shift = 0; shift < 64 && data < end; shift += 7) {
+				const uint8_t byte = *data++;
+				result |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+				if ((byte & 0x80u) == 0) {
+					*value = result;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		int64_t unzigzag(uint64_t value) noexcept
+		{
+			return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1u);
+		}
+	}
+
+	bool CompactMeshFile::open(const std::string& fileName)
+	{
+		_header = nullptr;
+		_triangles.clear();
+		_triangleIds.clear();
+		if (!Utils::isLittleEndian() || !_file.open(fileName)) {
+			return false;
+		}
+		const uint64_t fileSize = _file.size();
+		if (fileSize < sizeof(CompactMeshHeader)) {
+			_file.close();
+			return false;
+		}
+		const auto* header = reinterpret_cast<const CompactMeshHeader*>(_file.data());
+		if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+				|| header->version != VERSION
+				|| header->vertexCount > static_cast<uint64_t>(INT32_MAX)
+				|| !isBlockInside(header->vertexOffset,
+								  header->vertexCount * sizeof(BinaryMeshVertex), fileSize)
+				|| !isBlockInside(header->connectivityOffset, header->connectivitySize, fileSize)
+				// каждый треугольник занимает в блоке связности не меньше четырёх байт
+				|| header->triangleCount > header->connectivitySize / 4) {
+			_file.close();
+			return false;
+		}
+		_header = header;
+		const auto* connectivity =
+				reinterpret_cast<const uint8_t*>(_file.data() + header->connectivityOffset);
+		if (!decodeConnectivity(connectivity, static_cast<size_t>(header->connectivitySize))) {
+			_header = nullptr;
+			_triangles.clear();
+			_triangleIds.clear();
+			_file.close();
+			return false;
+		}
+		return true;
+	}
+
+	const CompactMeshHeader* CompactMeshFile::header() const noexcept
+	{
+		return _header;
+	}
+
+	size_t CompactMeshFile::vertexCount() const noexcept
+	{
+		return _header ? static_cast<size_t>(_header->vertexCount) : 0;
+	}
+
+	size_t CompactMeshFile::triangleCount() const noexcept
+	{
+		return _header ? static_cast<size_t>(_header->triangleCount) : 0;
+	}
+
+	const BinaryMeshVertex* CompactMeshFile::vertices() const noexcept
+	{
+		if (!_header) {
+			return nullptr;
+		}
+		return reinterpret_cast<const BinaryMeshVertex*>(_file.data() + _header->vertexOffset);
+	}
+
+	const int32_t* CompactMeshFile::triangles() const noexcept
+	{
+		return _header ? _triangles.data() : nullptr;
+	}
+
+	const int32_t* CompactMeshFile::triangleIds() const noexcept
+	{
+		return _header ? _triangleIds.data() : nullptr;
+	}
+
+	bool CompactMeshFile::decodeConnectivity(const uint8_t* data, size_t size)
+	{
+		const uint8_t* end = data + size;
+		const size_t triangleCount = static_cast<size_t>(_header->triangleCount);
+		const auto vertexCount = static_cast<int64_t>(_header->vertexCount);
+		_triangles.resize(3 * triangleCount);
+		_triangleIds.resize(triangleCount);
+
+		int64_t previousId = 0;
+		int64_t previousIndex = 0;
+		for (size_t i = 0; i < triangleCount; i++) {
+			uint64_t id = 0;
+			uint64_t a = 0;
+			uint64_t b = 0;
+			uint64_t c = 0;
+			if (!readVarint(data, end, &id)
+					|| !readVarint(data, end, &a)
+					|| !readVarint(data, end, &b)
+					|| !readVarint(data, end, &c)) {
+				return false;
+			}
+			previousId += unzigzag(id);
+			previousIndex += unzigzag(a);
+			if (previousIndex < 0
+					|| b >= static_cast<uint64_t>(vertexCount)
+					|| c >= static_cast<uint64_t>(vertexCount)
+					|| previousIndex + static_cast<int64_t>(b) >= vertexCount
+					|| previousIndex + static_cast<int64_t>(c) >= vertexCount) {
+				return false;
+			}
+			_triangleIds[i] = static_cast<int32_t>(previousId);
+			_triangles[3 * i] = static_cast<int32_t>(previousIndex);
+			_triangles[3 * i + 1] = static_cast<int32_t>(previousIndex + static_cast<int64_t>(b));
+			_triangles[3 * i + 2] = static_cast<int32_t>(previousIndex + static_cast<int64_t>(c));
+		}
+		return data == end;
+	}
+}
@@ -0,0 +1,92 @@
+#ifndef TRIANGULATION_COMPACT_MESH_FILE_H
+#define TRIANGULATION_COMPACT_MESH_FILE_H
+
+#include "binary_mesh_file.h"
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace triangulation
+{
+	/**
+	 * Заголовок сжатого файла сетки. Все значения little-endian, смещения
+	 * блоков считаются от начала файла.
+	 */
+	struct CompactMeshHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+		uint64_t vertexCount;
+		uint64_t triangleCount;
+		uint64_t vertexOffset;			// блок BinaryMeshVertex[vertexCount]
+		uint64_t connectivityOffset;	// сжатый блок треугольников
+		uint64_t connectivitySize;
+		uint8_t reserved[8];
+	};
+	static_assert(sizeof(CompactMeshHeader) == 64, "Unexpected compact mesh header size");
+
+	/**
+	 * Сжатый файл сетки, записанный CompactMeshWriter.
+	 *
+	 * Треугольники записаны в порядке обхода в ширину по соседям, вершины
+	 * пронумерованы в порядке первого появления в этом обходе, поэтому индексы
+	 * соседних треугольников близки. Для каждого треугольника в блок связности
+	 * пишутся varint (LEB128) значения:
+	 *  - zigzag разности id треугольника и id предыдущего треугольника;
+	 *  - zigzag разности наименьшего индекса вершины a и такого же индекса
+	 *    предыдущего треугольника;
+	 *  - b - a и c - a для двух следующих вершин, где a, b, c - вершины
+	 *    треугольника, циклически сдвинутые так, чтобы a была наименьшей
+	 *    (обход вершин сохраняется).
+	 *
+	 * При открытии блок связности распаковывается: triangles() возвращает индексы
+	 * вершин в том же виде, что и BinaryMeshFile.
+	 */
+	class CompactMeshFile
+	{
+	public:
+		static const char MAGIC[8];
+		static constexpr uint32_t VERSION = 1;
+
+	private:
+		MappedFile _file;
+		const CompactMeshHeader* _header = nullptr;
+		std::vector<int32_t> _triangles;
+		std::vector<int32_t> _triangleIds;
+
+	public:
+		CompactMeshFile() = default;
+		~CompactMeshFile() = default;
+		CompactMeshFile(const CompactMeshFile&) = delete;
+		CompactMeshFile(CompactMeshFile&&) = delete;
+		CompactMeshFile & operator=(const CompactMeshFile&) = delete;
+		CompactMeshFile & operator=(CompactMeshFile&&) = delete;
+
+		/**
+		 * Отображает файл в память, проверяет заголовок и распаковывает треугольники
+		 * @param fileName
+		 * @return false если файл не открыт или не соответствует формату
+		 */
+		bool open(const std::string& fileName);
+
+		[[nodiscard]] const CompactMeshHeader* header() const noexcept;
+		[[nodiscard]] size_t vertexCount() const noexcept;
+		[[nodiscard]] size_t triangleCount() const noexcept;
+		[[nodiscard]] const BinaryMeshVertex* vertices() const noexcept;
+		/**
+		 * @return индексы вершин, по три на треугольник
+		 */
+		[[nodiscard]] const int32_t* triangles() const noexcept;
+		[[nodiscard]] const int32_t* triangleIds() const noexcept;
+
+	private:
+		bool decodeConnectivity(const uint8_t* data, size_t size);
+
+	};
+}
+
+#endif //TRIANGULATION_COMPACT_MESH_FILE_H
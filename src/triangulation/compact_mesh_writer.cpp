@@ -0,0 +1,156 @@
+#include "compact_mesh_writer.h"
+
+#include "compact_mesh_file.h"
+#include "output_buffer.h"
+#include "utils.h"
+#include "vertex_index.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+
+namespace triangulation
+{
+	namespace
+	{
+		void appendVarint(OutputBuffer& output, uint64_t value)
+		{
+			while (value >= 0x80u) {
+				output.append(static_cast<char>((value & 0x7fu) | 0x80u));
+				value >>= 7;
+			}
+			output.append(static_cast<char>(value));
+		}
+
+		uint64_t zigzag(int64_t value) noexcept
+		{
+			return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+		}
+
+		/**
+		 * Порядок обхода треугольников в ширину по соседям. Каждая связная область
+		 * начинается с первого ещё не посещённого треугольника списка.
+		 */
+		std::vector<const delaunay::Triangle*> traversalOrder(
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles)
+		{
+			std::unordered_map<const delaunay::Triangle*, bool> visited;
+			visited.reserve(triangles.size());
+			for (const auto& triangle : triangles) {
+				visited.emplace(triangle.get(), false);
+			}
+
+			std::vector<const delaunay::Triangle*> order;
+			order.reserve(triangles.size());
+			for (const auto& start : triangles) {
+				bool& startVisited = visited[start.get()];
+				if (startVisited) {
+					continue;
+				}
+				startVisited = true;
+				// order одновременно служит очередью обхода
+				size_t head = order.size();
+				order.push_back(start.get());
+				while (head < order.size()) {
+					const delaunay::Triangle* triangle = order[head++];
+					for (const auto* neighbour : {
+							triangle->triangle1.get(),
+							triangle->triangle2.get(),
+							triangle->triangle3.get()}) {
+						auto i = visited.find(neighbour);
+						if (i != visited.end() && !i->second) {
+							i->second = true;
+							order.push_back(neighbour);
+						}
+					}
+				}
+			}
+			return order;
+		}
+	}
+
+	CompactMeshWriter::CompactMeshWriter() : IFileWriter()
+	{}
+
+	bool CompactMeshWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		if (!Utils::isLittleEndian()) {
+			return false;
+		}
+		const VertexIndex vertexIndex(usedVertices);
+		const std::vector<const delaunay::Triangle*> order = traversalOrder(triangles);
+
+		// Новые индексы вершин в порядке первого появления при обходе
+		std::vector<int32_t> renumbered(vertexIndex.size(), VertexIndex::NO_INDEX);
+		std::vector<size_t> vertexPositions;
+		vertexPositions.reserve(vertexIndex.size());
+		auto renumber = [&](int id) -> int32_t {
+			const int32_t index = vertexIndex.index(id);
+			if (index == VertexIndex::NO_INDEX) {
+				return VertexIndex::NO_INDEX;
+			}
+			if (renumbered[index] == VertexIndex::NO_INDEX) {
+				renumbered[index] = static_cast<int32_t>(vertexPositions.size());
+				vertexPositions.push_back(vertexIndex.positions()[index]);
+			}
+			return renumbered[index];
+		};
+
+		OutputBuffer connectivity;
+		int64_t previousId = 0;
+		int64_t previousIndex = 0;
+		for (const delaunay::Triangle* triangle : order) {
+			int32_t indices[3] = {
+					renumber(triangle->vertex1->id),
+					renumber(triangle->vertex2->id),
+					renumber(triangle->vertex3->id)};
+			if (std::find(indices, indices + 3, VertexIndex::NO_INDEX) != indices + 3) {
+				return false;
+			}
+			std::rotate(indices, std::min_element(indices, indices + 3), indices + 3);
+			appendVarint(connectivity, zigzag(triangle->id - previousId));
+			appendVarint(connectivity, zigzag(indices[0] - previousIndex));
+			appendVarint(connectivity, static_cast<uint64_t>(indices[1] - indices[0]));
+			appendVarint(connectivity, static_cast<uint64_t>(indices[2] - indices[0]));
+			previousId = triangle->id;
+			previousIndex = indices[0];
+		}
+		// использованные вершины вне треугольников записываются в конце
+		for (size_t index = 0; index < renumbered.size(); index++) {
+			if (renumbered[index] == VertexIndex::NO_INDEX) {
+				renumbered[index] = static_cast<int32_t>(vertexPositions.size());
+				vertexPositions.push_back(vertexIndex.positions()[index]);
+			}
+		}
+
+		CompactMeshHeader header {};
+		std::memcpy(header.magic, CompactMeshFile::MAGIC, sizeof(CompactMeshFile::MAGIC));
+		header.version = CompactMeshFile::VERSION;
+		header.vertexCount = vertexPositions.size();
+		header.triangleCount = order.size();
+		header.vertexOffset = sizeof(CompactMeshHeader);
+		header.connectivityOffset = header.vertexOffset + header.vertexCount * sizeof(BinaryMeshVertex);
+		header.connectivitySize = connectivity.size();
+
+		OutputBuffer output(stream);
+		output.appendValue(header);
+		for (size_t position : vertexPositions) {
+			const Vertex3D& vertex = coordinates[position];
+			output.appendValue(BinaryMeshVertex {vertex.id, vertex.x, vertex.y, vertex.z});
+		}
+		output.append(connectivity.data(), connectivity.size());
+		return output.flush();
+	}
+
+	bool CompactMeshWriter::isBinary() const noexcept
+	{
+		return true;
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef TRIANGULATION_COMPACT_MESH_WRITER_H
+#define TRIANGULATION_COMPACT_MESH_WRITER_H
+
+#include "file_writer_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Записывает сетку в сжатом бинарном формате (см. CompactMeshFile): блок
+	 * использованных вершин и блок треугольников с разностным varint кодированием
+	 * индексов вершин в порядке обхода по соседям.
+	 */
+	class CompactMeshWriter : public IFileWriter
+	{
+	public:
+		CompactMeshWriter();
+		CompactMeshWriter(const CompactMeshWriter&) = delete;
+		CompactMeshWriter(CompactMeshWriter&&) = delete;
+		CompactMeshWriter& operator=(const CompactMeshWriter&) = delete;
+		CompactMeshWriter& operator=(CompactMeshWriter&&) = delete;
+
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_COMPACT_MESH_WRITER_H
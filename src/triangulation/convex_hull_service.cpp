@@ -0,0 +1,464 @@
+#include "convex_hull_service.h"
+
+#include "thread_pool.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+
+namespace triangulation
+{
+	namespace
+	{
+		const int NO_FACE = -1;
+
+		struct HullFace
+		{
+			// против часовой стрелки, если смотреть снаружи
+			std::array<int, 3> vertices {};
+			// neighbours[k] - грань за ребром (vertices[k], vertices[(k + 1) % 3])
+			std::array<int, 3> neighbours {NO_FACE, NO_FACE, NO_FACE};
+			std::array<double, 3> normal {};
+			double offset = 0.0;
+			// первая вершина над гранью (граф конфликтов, следующие - по
+			// HullBuilder::_nextConflict) и самая удалённая из них
+			int firstConflict = NO_FACE;
+			int furthest = NO_FACE;
+			double furthestDistance = 0.0;
+			bool alive = true;
+			size_t visitMark = 0;
+		};
+
+		/**
+		 * Построение одной оболочки. Вершины, лежащие ближе _epsilon к плоскости
+		 * грани, считаются лежащими в ней и в оболочку не добавляются.
+		 */
+		class HullBuilder
+		{
+		private:
+			const std::vector<Vertex3D>& _coordinates;
+			ThreadPool* _pool;
+			std::vector<HullFace> _faces;
+			// следующая вершина в списке конфликтов той же грани
+			std::vector<int> _nextConflict;
+			double _epsilon = 0.0;
+			size_t _visitMark = 0;
+			// буферы addPoint и assignConflicts, чтобы не выделять память на каждую вершину
+			std::vector<size_t> _visible;
+			std::vector<std::pair<size_t, int> > _horizon;
+			std::vector<size_t> _stack;
+			std::vector<int> _points;
+			std::vector<int> _targets;
+			std::vector<double> _distances;
+
+		public:
+			HullBuilder(const std::vector<Vertex3D>& coordinates, ThreadPool* pool) :
+					_coordinates(coordinates),
+					_pool(pool)
+			{}
+
+			bool build()
+			{
+				std::array<int, 4> simplex {};
+				if (!initialSimplex(simplex)) {
+					return false;
+				}
+				_nextConflict.assign(_coordinates.size(), NO_FACE);
+				std::vector<int> points;
+				points.reserve(_coordinates.size());
+				for (int i = 0; i < static_cast<int>(_coordinates.size()); i++) {
+					if (std::find(simplex.begin(), simplex.end(), i) == simplex.end()) {
+						points.push_back(i);
+					}
+				}
+				assignConflicts(points, 0, _faces.size());
+
+				// новые грани добавляются в конец и обрабатываются в том же цикле
+				for (size_t f = 0; f < _faces.size(); f++) {
+					if (_faces[f].alive && _faces[f].firstConflict != NO_FACE) {
+						addPoint(f);
+					}
+				}
+				return true;
+			}
+
+			[[nodiscard]] const std::vector<HullFace>& faces() const noexcept
+			{
+				return _faces;
+			}
+
+		private:
+			[[nodiscard]] std::array<double, 3> point(int i) const noexcept
+			{
+				const Vertex3D& vertex = _coordinates[static_cast<size_t>(i)];
+				return {vertex.x, vertex.y, vertex.z};
+			}
+
+			[[nodiscard]] double distance(const HullFace& face, int i) const noexcept
+			{
+				const Vertex3D& vertex = _coordinates[static_cast<size_t>(i)];
+				return face.normal[0] * vertex.x
+						+ face.normal[1] * vertex.y
+						+ face.normal[2] * vertex.z
+						- face.offset;
+			}
+
+			static std::array<double, 3> subtract(
+					const std::array<double, 3>& a,
+					const std::array<double, 3>& b) noexcept
+			{
+				return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+			}
+
+			static std::array<double, 3> cross(
+					const std::array<double, 3>& a,
+					const std::array<double, 3>& b) noexcept
+			{
+				return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+			}
+
+			static double dot(const std::array<double, 3>& a, const std::array<double, 3>& b) noexcept
+			{
+				return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+			}
+
+			int createFace(int a, int b, int c)
+			{
+				HullFace face;
+				face.vertices = {a, b, c};
+				const std::array<double, 3> pa = point(a);
+				std::array<double, 3> normal = cross(subtract(point(b), pa), subtract(point(c), pa));
+				const double length = std::sqrt(dot(normal, normal));
+				if (length > 0.0) {
+					for (double& value : normal) {
+						value /= length;
+					}
+				}
+				face.normal = normal;
+				face.offset = dot(normal, pa);
+				_faces.push_back(std::move(face));
+				return static_cast<int>(_faces.size() - 1);
+			}
+
+			bool initialSimplex(std::array<int, 4>& simplex)
+			{
+				const int count = static_cast<int>(_coordinates.size());
+				if (count < 4) {
+					return false;
+				}
+				// крайние вершины по осям и допуск по масштабу координат
+				std::array<int, 6> extremes {};
+				double maxCoordinates[3] = {};
+				for (int i = 0; i < count; i++) {
+					const std::array<double, 3> p = point(i);
+					for (int k = 0; k < 3; k++) {
+						if (p[k] < point(extremes[2 * k])[k]) {
+							extremes[2 * k] = i;
+						}
+						if (p[k] > point(extremes[2 * k + 1])[k]) {
+							extremes[2 * k + 1] = i;
+						}
+						maxCoordinates[k] = std::max(maxCoordinates[k], std::abs(p[k]));
+					}
+				}
+				_epsilon = 3.0 * std::numeric_limits<float>::epsilon()
+						* (maxCoordinates[0] + maxCoordinates[1] + maxCoordinates[2]);
+
+				double maxDistance = -1.0;
+				for (int i = 0; i < 6; i++) {
+					for (int j = i + 1; j < 6; j++) {
+						const std::array<double, 3> d = subtract(point(extremes[i]), point(extremes[j]));
+						if (dot(d, d) > maxDistance) {
+							maxDistance = dot(d, d);
+							simplex[0] = extremes[i];
+							simplex[1] = extremes[j];
+						}
+					}
+				}
+				if (std::sqrt(maxDistance) <= _epsilon) {
+					return false;
+				}
+
+				const std::array<double, 3> p0 = point(simplex[0]);
+				const std::array<double, 3> line = subtract(point(simplex[1]), p0);
+				maxDistance = -1.0;
+				for (int i = 0; i < count; i++) {
+					const std::array<double, 3> c = cross(line, subtract(point(i), p0));
+					if (dot(c, c) > maxDistance) {
+						maxDistance = dot(c, c);
+						simplex[2] = i;
+					}
+				}
+				if (std::sqrt(maxDistance / dot(line, line)) <= _epsilon) {
+					return false;
+				}
+
+				std::array<double, 3> normal = cross(line, subtract(point(simplex[2]), p0));
+				const double normalLength = std::sqrt(dot(normal, normal));
+				maxDistance = -1.0;
+				double signedDistance = 0.0;
+				for (int i = 0; i < count; i++) {
+					const double d = dot(normal, subtract(point(i), p0)) / normalLength;
+					if (std::abs(d) > maxDistance) {
+						maxDistance = std::abs(d);
+						signedDistance = d;
+						simplex[3] = i;
+					}
+				}
+				if (maxDistance <= _epsilon) {
+					return false;
+				}
+
+				// основание ориентируется так, чтобы вершина simplex[3] была под ним
+				int a = simplex[0];
+				int b = simplex[1];
+				const int c = simplex[2];
+				const int top = simplex[3];
+				if (signedDistance > 0.0) {
+					std::swap(a, b);
+				}
+				createFace(a, b, c);
+				createFace(b, a, top);
+				createFace(c, b, top);
+				createFace(a, c, top);
+				linkFaces(0, _faces.size());
+				return true;
+			}
+
+			/**
+			 * Связывает соседние грани среди _faces[begin .. end - 1] по общим рёбрам
+			 */
+			void linkFaces(size_t begin, size_t end)
+			{
+				std::unordered_map<uint64_t, std::pair<int, int> > edges;
+				auto key = [](int a, int b) {
+					return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+				};
+				for (size_t f = begin; f < end; f++) {
+					for (int k = 0; k < 3; k++) {
+						edges[key(_faces[f].vertices[k], _faces[f].vertices[(k + 1) % 3])] =
+								{static_cast<int>(f), k};
+					}
+				}
+				for (size_t f = begin; f < end; f++) {
+					for (int k = 0; k < 3; k++) {
+						auto i = edges.find(key(_faces[f].vertices[(k + 1) % 3], _faces[f].vertices[k]));
+						if (i != edges.end()) {
+							_faces[f].neighbours[k] = i->second.first;
+						}
+					}
+				}
+			}
+
+			/**
+			 * Распределяет вершины points по граням _faces[begin .. end - 1]: вершина
+			 * попадает в список первой грани, над которой лежит, остальные вершины
+			 * внутри оболочки и отбрасываются
+			 */
+			void assignConflicts(const std::vector<int>& points, size_t begin, size_t end)
+			{
+				std::vector<int>& targets = _targets;
+				std::vector<double>& distances = _distances;
+				targets.assign(points.size(), NO_FACE);
+				distances.assign(points.size(), 0.0);
+				auto assign = [this, &points, &targets, &distances, begin, end](size_t from, size_t to) {
+					for (size_t i = from; i < to; i++) {
+						for (size_t f = begin; f < end; f++) {
+							const double d = distance(_faces[f], points[i]);
+							if (d > _epsilon) {
+								targets[i] = static_cast<int>(f);
+								distances[i] = d;
+								break;
+							}
+						}
+					}
+				};
+				if (_pool && points.size() >= ConvexHullService::PARALLEL_THRESHOLD) {
+					const size_t parts = _pool->size();
+					const size_t partSize = (points.size() + parts - 1) / parts;
+					std::vector<std::future<void> > results;
+					for (size_t from = 0; from < points.size(); from += partSize) {
+						const size_t to = std::min(points.size(), from + partSize);
+						results.push_back(_pool->submit([&assign, from, to]() { assign(from, to); }));
+					}
+					for (auto& result : results) {
+						result.get();
+					}
+				}
+				else {
+					assign(0, points.size());
+				}
+
+				// списки заполняются по порядку вершин, поэтому результат не зависит
+				// от количества потоков
+				for (size_t i = 0; i < points.size(); i++) {
+					if (targets[i] == NO_FACE) {
+						continue;
+					}
+					HullFace& face = _faces[static_cast<size_t>(targets[i])];
+					_nextConflict[static_cast<size_t>(points[i])] = face.firstConflict;
+					face.firstConflict = points[i];
+					if (face.furthest == NO_FACE || distances[i] > face.furthestDistance) {
+						face.furthest = points[i];
+						face.furthestDistance = distances[i];
+					}
+				}
+			}
+
+			/**
+			 * Добавляет в оболочку самую удалённую вершину грани faceIndex: удаляет
+			 * видимые из неё грани и соединяет вершину с рёбрами горизонта
+			 */
+			void addPoint(size_t faceIndex)
+			{
+				const int eye = _faces[faceIndex].furthest;
+				_visitMark++;
+
+				// видимые грани и рёбра горизонта (видимая грань, номер ребра)
+				std::vector<size_t>& visible = _visible;
+				std::vector<std::pair<size_t, int> >& horizon = _horizon;
+				std::vector<size_t>& stack = _stack;
+				visible.clear();
+				horizon.clear();
+				stack.assign(1, faceIndex);
+				_faces[faceIndex].visitMark = _visitMark;
+				while (!stack.empty()) {
+					const size_t f = stack.back();
+					stack.pop_back();
+					visible.push_back(f);
+					for (int k = 0; k < 3; k++) {
+						const auto n = static_cast<size_t>(_faces[f].neighbours[k]);
+						HullFace& neighbour = _faces[n];
+						if (neighbour.visitMark == _visitMark) {
+							continue;
+						}
+						// видимость грани определяется только её плоскостью, поэтому
+						// невидимая грань не может оказаться видимой с другой стороны
+						if (distance(neighbour, eye) > _epsilon) {
+							neighbour.visitMark = _visitMark;
+							stack.push_back(n);
+						}
+						else {
+							horizon.emplace_back(f, k);
+						}
+					}
+				}
+				// новые грани (a, b, eye) над рёбрами горизонта (a, b)
+				const size_t firstNewFace = _faces.size();
+				for (const auto& edge : horizon) {
+					const HullFace& visibleFace = _faces[edge.first];
+					const int a = visibleFace.vertices[edge.second];
+					const int b = visibleFace.vertices[(edge.second + 1) % 3];
+					const int outside = visibleFace.neighbours[edge.second];
+					const int created = createFace(a, b, eye);
+					_faces[static_cast<size_t>(created)].neighbours[0] = outside;
+					HullFace& outsideFace = _faces[static_cast<size_t>(outside)];
+					for (int k = 0; k < 3; k++) {
+						if (outsideFace.vertices[k] == b && outsideFace.vertices[(k + 1) % 3] == a) {
+							outsideFace.neighbours[k] = created;
+						}
+					}
+				}
+				// горизонт обычно из нескольких рёбер, поэтому соседние новые грани
+				// ищутся перебором: ребро (b, eye) - общее с гранью, начинающейся в b,
+				// ребро (eye, a) - с гранью, заканчивающейся в a
+				for (size_t f = firstNewFace; f < _faces.size(); f++) {
+					for (size_t g = firstNewFace; g < _faces.size(); g++) {
+						if (_faces[g].vertices[0] == _faces[f].vertices[1]) {
+							_faces[f].neighbours[1] = static_cast<int>(g);
+						}
+						if (_faces[g].vertices[1] == _faces[f].vertices[0]) {
+							_faces[f].neighbours[2] = static_cast<int>(g);
+						}
+					}
+				}
+
+				std::vector<int>& points = _points;
+				points.clear();
+				for (size_t f : visible) {
+					HullFace& face = _faces[f];
+					face.alive = false;
+					for (int i = face.firstConflict; i != NO_FACE; i = _nextConflict[static_cast<size_t>(i)]) {
+						if (i != eye) {
+							points.push_back(i);
+						}
+					}
+					face.firstConflict = NO_FACE;
+				}
+				assignConflicts(points, firstNewFace, _faces.size());
+			}
+
+		};
+	}
+
+	ConvexHullService::ConvexHullService(size_t threadCount) :
+			_threadCount(threadCount)
+	{}
+
+	std::list<std::shared_ptr<delaunay::Triangle> > ConvexHullService::process(
+			const std::vector<Vertex3D>& coordinates,
+			bool* ok)
+	{
+		std::unique_ptr<ThreadPool> pool;
+		if (_threadCount != 1 && coordinates.size() >= PARALLEL_THRESHOLD) {
+			pool = std::make_unique<ThreadPool>(_threadCount);
+		}
+		HullBuilder builder(coordinates, pool.get());
+		const bool built = builder.build();
+		if (ok) {
+			*ok = built;
+		}
+		if (!built) {
+			return {};
+		}
+
+		const std::vector<HullFace>& faces = builder.faces();
+		std::vector<std::shared_ptr<delaunay::Vertex2D> > vertices(coordinates.size());
+		std::vector<std::shared_ptr<delaunay::Triangle> > triangles(faces.size());
+		std::list<std::shared_ptr<delaunay::Triangle> > result;
+		int triangleId = 1;
+		for (size_t f = 0; f < faces.size(); f++) {
+			if (!faces[f].alive) {
+				continue;
+			}
+			for (int i : faces[f].vertices) {
+				std::shared_ptr<delaunay::Vertex2D>& vertex = vertices[static_cast<size_t>(i)];
+				if (!vertex) {
+					vertex = std::make_shared<delaunay::Vertex2D>();
+					vertex->id = i;
+					vertex->x = coordinates[static_cast<size_t>(i)].x;
+					vertex->y = coordinates[static_cast<size_t>(i)].y;
+				}
+			}
+			// вершины грани против часовой стрелки снаружи, а у треугольника - по
+			// часовой: vertex1 = v0, vertex2 = v2, vertex3 = v1
+			auto triangle = std::make_shared<delaunay::Triangle>();
+			triangle->id = triangleId++;
+			triangle->vertex1 = vertices[static_cast<size_t>(faces[f].vertices[0])];
+			triangle->vertex2 = vertices[static_cast<size_t>(faces[f].vertices[2])];
+			triangle->vertex3 = vertices[static_cast<size_t>(faces[f].vertices[1])];
+			triangles[f] = triangle;
+			result.push_back(triangle);
+		}
+		// напротив vertex1 (v0) - ребро (v1, v2), напротив vertex2 (v2) - ребро
+		// (v0, v1), напротив vertex3 (v1) - ребро (v2, v0)
+		for (size_t f = 0; f < faces.size(); f++) {
+			if (!faces[f].alive) {
+				continue;
+			}
+			delaunay::Triangle& triangle = *triangles[f];
+			triangle.triangle1 = triangles[static_cast<size_t>(faces[f].neighbours[1])];
+			triangle.triangle2 = triangles[static_cast<size_t>(faces[f].neighbours[0])];
+			triangle.triangle3 = triangles[static_cast<size_t>(faces[f].neighbours[2])];
+		}
+		return result;
+	}
+}
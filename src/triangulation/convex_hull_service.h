@@ -0,0 +1,63 @@
+#ifndef TRIANGULATION_CONVEX_HULL_SERVICE_H
+#define TRIANGULATION_CONVEX_HULL_SERVICE_H
+
+#include "vertex_3d.h"
+
+#include <list>
+#include <memory>
+#include <vector>
+
+
+namespace delaunay
+{
+	struct Triangle;
+}
+
+namespace triangulation
+{
+	/**
+	 * Выпуклая оболочка вершин 3D (алгоритм Quickhull с графом конфликтов: каждая
+	 * ещё не добавленная вершина хранится в списке той грани, над которой лежит).
+	 * Подходит для замкнутых, близких к выпуклым поверхностей, для которых проекция
+	 * на плоскость неоднозначна.
+	 *
+	 * Результат - треугольники в том же виде, что и у DelaunayService: Vertex2D::id -
+	 * индекс вершины в coordinates (x, y - её координаты x, y), соседние треугольники
+	 * связаны. Вершины перечислены по часовой стрелке, если смотреть снаружи
+	 * оболочки, поэтому запись IFileWriter ориентирует грани наружу.
+	 */
+	class ConvexHullService
+	{
+	public:
+		// Минимальное количество вершин, распределение которых по новым граням
+		// выполняется в пуле потоков
+		static constexpr size_t PARALLEL_THRESHOLD = 1 << 14;
+
+	private:
+		size_t _threadCount;
+
+	public:
+		/**
+		 * @param threadCount - количество потоков, 0 - по количеству ядер, 1 - без
+		 * пула потоков. Результат от количества потоков не зависит.
+		 */
+		explicit ConvexHullService(size_t threadCount = 1);
+		~ConvexHullService() = default;
+		ConvexHullService(const ConvexHullService&) = delete;
+		ConvexHullService(ConvexHullService&&) = delete;
+		ConvexHullService & operator=(const ConvexHullService&) = delete;
+		ConvexHullService & operator=(ConvexHullService&&) = delete;
+
+		/**
+		 * @param coordinates
+		 * @param ok - false если все вершины лежат в одной плоскости
+		 * @return
+		 */
+		std::list<std::shared_ptr<delaunay::Triangle> > process(
+				const std::vector<Vertex3D>& coordinates,
+				bool* ok);
+
+	};
+}
+
+#endif //TRIANGULATION_CONVEX_HULL_SERVICE_H
@@ -0,0 +1,198 @@
+#include "coordinates_cache.h"
+
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include "utils.h"
+#include "vertex_3d.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <system_error>
+
+
+namespace triangulation
+{
+	const char CoordinatesCache::MAGIC[8] = {'D', 'T', 'X', 'Y', 'Z', 'C', 'C', 'H'};
+	const char* const CoordinatesCache::FILE_SUFFIX = ".cache";
+
+	static_assert(sizeof(Vertex3D) == 16, "Unexpected Vertex3D size");
+
+	namespace
+	{
+		/**
+		 * Размер и время модификации файла
+		 * @return false если файл недоступен
+		 */
+		bool fileStatus(const std::string& fileName, uint64_t* size, int64_t* modificationTime)
+		{
+			std::error_code error;
+			const auto fileSize = std::filesystem::file_size(fileName, error);
+			if (error) {
+				return false;
+			}
+			const auto fileTime = std::filesystem::last_write_time(fileName, error);
+			if (error) {
+				return false;
+			}
+			*size = static_cast<uint64_t>(fileSize);
+			*modificationTime = static_cast<int64_t>(fileTime.time_since_epoch().count());
+			return true;
+		}
+	}
+
+	std::string CoordinatesCache::cacheFileName(const std::string& fileName)
+	{
+		return fileName + FILE_SUFFIX;
+	}
+
+	uint64_t CoordinatesCache::contentHash(const char* data, size_t size, size_t threadCount)
+	{
+		const size_t blockCount = (size + HASH_BLOCK_SIZE - 1) / HASH_BLOCK_SIZE;
+		std::vector<uint64_t> hashes(blockCount);
+		auto hashBlock = [data, size, &hashes](size_t i) {
+			const size_t begin = i * HASH_BLOCK_SIZE;
+			hashes[i] = Utils::hash(data + begin, std::min(HASH_BLOCK_SIZE, size - begin), i);
+		};
+		if (blockCount <= 1) {
+			for (size_t i = 0; i < blockCount; i++) {
+				hashBlock(i);
+			}
+		}
+		else {
+			ThreadPool pool(std::min(
+					threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount, blockCount));
+			std::vector<std::future<void> > results;
+			results.reserve(blockCount);
+			for (size_t i = 0; i < blockCount; i++) {
+				results.push_back(pool.submit([&hashBlock, i]() { hashBlock(i); }));
+			}
+			for (auto& result : results) {
+				result.get();
+			}
+		}
+		return Utils::hash(hashes.data(), hashes.size() * sizeof(uint64_t), size);
+	}
+
+	bool CoordinatesCache::load(
+			const std::string& fileName,
+			const char* data,
+			size_t size,
+			size_t threadCount,
+			std::vector<Vertex3D>& coordinates,
+			std::vector<size_t>& invalidLines,
+			size_t& lineCount)
+	{
+		uint64_t sourceSize;
+		int64_t sourceModificationTime;
+		if (!Utils::isLittleEndian()
+				|| !fileStatus(fileName, &sourceSize, &sourceModificationTime)
+				|| sourceSize != size) {
+			return false;
+		}
+		MappedFile cache;
+		if (!cache.open(cacheFileName(fileName)) || cache.size() < sizeof(CoordinatesCacheHeader)) {
+			return false;
+		}
+		const auto* header = reinterpret_cast<const CoordinatesCacheHeader*>(cache.data());
+		const uint64_t available = cache.size() - sizeof(CoordinatesCacheHeader);
+		if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+				|| header->version != VERSION
+				|| header->sourceSize != sourceSize
+				|| header->coordinateCount > available / sizeof(Vertex3D)
+				|| header->invalidLineCount
+						!= (available - header->coordinateCount * sizeof(Vertex3D)) / sizeof(uint64_t)) {
+			return false;
+		}
+		// Содержимое хэшируется, только если изменилось время модификации
+		// (например, файл скопирован или перезаписан тем же содержимым)
+		const bool modificationTimeChanged = header->sourceModificationTime != sourceModificationTime;
+		if (modificationTimeChanged && header->sourceHash != contentHash(data, size, threadCount)) {
+			return false;
+		}
+
+		const char* block = cache.data() + sizeof(CoordinatesCacheHeader);
+		const size_t coordinateCount = static_cast<size_t>(header->coordinateCount);
+		const size_t begin = coordinates.size();
+		coordinates.resize(begin + coordinateCount);
+		std::memcpy(coordinates.data() + begin, block, coordinateCount * sizeof(Vertex3D));
+		block += coordinateCount * sizeof(Vertex3D);
+		invalidLines.reserve(invalidLines.size() + static_cast<size_t>(header->invalidLineCount));
+		for (uint64_t i = 0; i < header->invalidLineCount; i++) {
+			uint64_t invalidLine;
+			std::memcpy(&invalidLine, block + i * sizeof(uint64_t), sizeof(invalidLine));
+			invalidLines.push_back(lineCount + static_cast<size_t>(invalidLine));
+		}
+		lineCount += static_cast<size_t>(header->lineCount);
+
+		if (modificationTimeChanged) {
+			// содержимое то же, новое время запоминается, чтобы не хэшировать файл
+			// при следующей загрузке; ошибка записи не мешает загрузке
+			cache.close();
+			std::fstream file(cacheFileName(fileName), std::ios::in | std::ios::out | std::ios::binary);
+			if (file.is_open()) {
+				file.seekp(offsetof(CoordinatesCacheHeader, sourceModificationTime));
+				file.write(reinterpret_cast<const char*>(&sourceModificationTime), sizeof(sourceModificationTime));
+			}
+		}
+		return true;
+	}
+
+	bool CoordinatesCache::save(
+			const std::string& fileName,
+			const char* data,
+			size_t size,
+			size_t threadCount,
+			const Vertex3D* coordinates,
+			size_t coordinateCount,
+			const size_t* invalidLines,
+			size_t invalidLineCount,
+			size_t lineCount)
+	{
+		CoordinatesCacheHeader header {};
+		if (!Utils::isLittleEndian()
+				|| !fileStatus(fileName, &header.sourceSize, &header.sourceModificationTime)
+				|| header.sourceSize != size) {
+			return false;
+		}
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.sourceHash = contentHash(data, size, threadCount);
+		header.coordinateCount = coordinateCount;
+		header.invalidLineCount = invalidLineCount;
+		header.lineCount = lineCount;
+
+		const std::string cacheName = cacheFileName(fileName);
+		const std::string temporaryName = cacheName + ".tmp";
+		{
+			std::ofstream file(temporaryName, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(
+					reinterpret_cast<const char*>(coordinates),
+					static_cast<std::streamsize>(coordinateCount * sizeof(Vertex3D)));
+			for (size_t i = 0; i < invalidLineCount; i++) {
+				const auto invalidLine = static_cast<uint64_t>(invalidLines[i]);
+				file.write(reinterpret_cast<const char*>(&invalidLine), sizeof(invalidLine));
+			}
+			file.close();
+			if (file.fail()) {
+				std::remove(temporaryName.c_str());
+				return false;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(temporaryName, cacheName, error);
+		if (error) {
+			std::remove(temporaryName.c_str());
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,107 @@
+#ifndef TRIANGULATION_COORDINATES_CACHE_H
+#define TRIANGULATION_COORDINATES_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace triangulation
+{
+	struct Vertex3D;
+
+	/**
+	 * Заголовок файла кэша разобранных координат. Все значения little-endian.
+	 * За заголовком следуют Vertex3D[coordinateCount] и uint64[invalidLineCount].
+	 */
+	struct CoordinatesCacheHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+		uint64_t sourceSize;
+		int64_t sourceModificationTime;
+		uint64_t sourceHash;
+		uint64_t coordinateCount;
+		uint64_t invalidLineCount;
+		uint64_t lineCount;
+	};
+	static_assert(sizeof(CoordinatesCacheHeader) == 64, "Unexpected coordinates cache header size");
+
+	/**
+	 * Кэш разобранного текстового файла координат рядом с ним (<file>.cache).
+	 * Кэш действителен, если у исходного файла не изменились размер и время
+	 * модификации. Если изменилось только время, сравнивается хэш содержимого,
+	 * поэтому обычная повторная загрузка не читает исходный файл целиком.
+	 * Изменение файла с сохранением размера и времени модификации не
+	 * обнаруживается.
+	 */
+	class CoordinatesCache
+	{
+	public:
+		static const char MAGIC[8];
+		static constexpr uint32_t VERSION = 1;
+		static const char* const FILE_SUFFIX;
+		// размер блока, хэши которых считаются параллельно
+		static constexpr size_t HASH_BLOCK_SIZE = 1 << 20;
+
+		CoordinatesCache() = delete;
+
+		[[nodiscard]] static std::string cacheFileName(const std::string& fileName);
+
+		/**
+		 * Хэш содержимого файла. Блоки по HASH_BLOCK_SIZE хэшируются параллельно,
+		 * результат не зависит от количества потоков.
+		 * @param data
+		 * @param size
+		 * @param threadCount - количество потоков, 0 - по количеству ядер
+		 * @return
+		 */
+		static uint64_t contentHash(const char* data, size_t size, size_t threadCount = 0);
+
+		/**
+		 * Добавляет координаты из кэша, если он соответствует исходному файлу. Если
+		 * совпало содержимое, но не время модификации, в кэш записывается новое время.
+		 * @param fileName - имя исходного файла
+		 * @param data, size - содержимое исходного файла
+		 * @param threadCount - количество потоков для хэширования
+		 * @param coordinates
+		 * @param invalidLines - номера строк добавляются со смещением lineCount
+		 * @param lineCount - увеличивается на количество строк файла
+		 * @return false если кэша нет или он устарел, при этом данные не изменяются
+		 */
+		static bool load(
+				const std::string& fileName,
+				const char* data,
+				size_t size,
+				size_t threadCount,
+				std::vector<Vertex3D>& coordinates,
+				std::vector<size_t>& invalidLines,
+				size_t& lineCount);
+
+		/**
+		 * Записывает кэш для исходного файла. Файл кэша сначала пишется во временный
+		 * файл и затем переименовывается, поэтому недописанный кэш не используется.
+		 * @param fileName - имя исходного файла
+		 * @param data, size - содержимое исходного файла
+		 * @param threadCount - количество потоков для хэширования
+		 * @param coordinates, coordinateCount - координаты файла
+		 * @param invalidLines, invalidLineCount - номера строк от начала файла
+		 * @param lineCount - количество строк файла
+		 * @return false если кэш не удалось записать
+		 */
+		static bool save(
+				const std::string& fileName,
+				const char* data,
+				size_t size,
+				size_t threadCount,
+				const Vertex3D* coordinates,
+				size_t coordinateCount,
+				const size_t* invalidLines,
+				size_t invalidLineCount,
+				size_t lineCount);
+
+	};
+}
+
+#endif //TRIANGULATION_COORDINATES_CACHE_H
@@ -1,71 +1,411 @@
 #include "coordinates_file_parser.h"
+#include "binary_coordinates_file.h"
+#include "coordinates_cache.h"
 #include "default_writer.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
 #include "utils.h"
 #include "vertex_3d.h"
 #include <delaunay/triangle.h>
 #include <delaunay/vertex_2d.h>
 
-#include <iostream>
-#include <fstream>
-#include <regex>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <istream>
 
 
 namespace triangulation
 {
-	const std::regex COMMENT_REGEX("^\\s*\\*.*");
-// ^\s*([0-9]+),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?).*
-	const std::regex NUMBERS_LINE_REGEX(R"(^\s*([0-9]+),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?),\s*([-+]?[0-9]+\.?[0-9]*(?:[eE][-+]?[0-9]+)?).*)");
+	// Минимальный размер части буфера, которая разбирается отдельной задачей
+	static const size_t MIN_CHUNK_SIZE = 1 << 20;
+	// Размер блока, читаемого из потока за один раз
+	static const size_t STREAM_BLOCK_SIZE = 4 << 20;
 
-	bool CoordinatesFileParser::loadFile(const std::string& fileName)
+	namespace
 	{
-		std::fstream file;
-		file.open(fileName, std::ios::in);
-		if (!file.is_open()) {
-			return false;
+		enum class LineType
+		{
+			Comment = 0,	// строка начинается с '*'
+			Vertex,			// строка вида "N, X, Y, Z"
+			Invalid
+		};
+
+		inline bool isSpace(char c) noexcept
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
 		}
 
-		std::string line;
-		while (std::getline(file, line)) {
-			if (std::regex_match(line, COMMENT_REGEX)) {
-				continue;
+		inline bool isDigit(char c) noexcept
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		inline const char* skipSpaces(const char* i, const char* end) noexcept
+		{
+			while (i != end && isSpace(*i)) {
+				++i;
+			}
+			return i;
+		}
+
+		/**
+		 * Число с плавающей точкой в формате [-+]?[0-9]+\.?[0-9]*([eE][-+]?[0-9]+)?
+		 */
+		bool parseFloat(const char*& i, const char* end, float& value) noexcept
+		{
+			const char* first = i;
+			// std::from_chars не принимает ведущий '+'
+			if (first != end && *first == '+') {
+				++first;
+			}
+			const char* digits = first;
+			if (digits != end && *digits == '-' && first == i) {
+				++digits;
+			}
+			if (digits == end || !isDigit(*digits)) {
+				return false;
+			}
+			auto [ptr, ec] = std::from_chars(first, end, value);
+			if (ec != std::errc()) {
+				return false;
+			}
+			i = ptr;
+			return true;
+		}
+
+		bool parseSeparator(const char*& i, const char* end) noexcept
+		{
+			if (i == end || *i != ',') {
+				return false;
+			}
+			i = skipSpaces(i + 1, end);
+			return true;
+		}
+
+		LineType parseLine(const char* begin, const char* end, Vertex3D& vertex) noexcept
+		{
+			const char* i = skipSpaces(begin, end);
+			if (i != end && *i == '*') {
+				return LineType::Comment;
+			}
+			if (i == end || !isDigit(*i)) {
+				return LineType::Invalid;
 			}
-			std::smatch matches;
-			if (std::regex_search(line, matches, NUMBERS_LINE_REGEX)) {
-				if (matches.size() != 5) {
-					continue;
+			auto [ptr, ec] = std::from_chars(i, end, vertex.id);
+			if (ec != std::errc()) {
+				return LineType::Invalid;
+			}
+			i = ptr;
+			if (!parseSeparator(i, end)
+					|| !parseFloat(i, end, vertex.x)
+					|| !parseSeparator(i, end)
+					|| !parseFloat(i, end, vertex.y)
+					|| !parseSeparator(i, end)
+					|| !parseFloat(i, end, vertex.z)) {
+				return LineType::Invalid;
+			}
+			// Остаток строки после координаты Z игнорируется
+			return LineType::Vertex;
+		}
+
+		/**
+		 * Результат разбора части буфера. Номера строк считаются от начала части.
+		 */
+		struct ParsedChunk
+		{
+			std::vector<Vertex3D> coordinates;
+			std::vector<size_t> invalidLines;
+			size_t lineCount = 0;
+		};
+
+		void parseChunk(const char* begin, const char* end, ParsedChunk& chunk)
+		{
+			chunk.coordinates.reserve(
+					static_cast<size_t>(std::count(begin, end, '\n')) + 1);
+
+			Vertex3D vertex;
+			const char* lineBegin = begin;
+			while (lineBegin < end) {
+				const char* lineEnd = static_cast<const char*>(
+						std::memchr(lineBegin, '\n', static_cast<size_t>(end - lineBegin)));
+				if (!lineEnd) {
+					lineEnd = end;
 				}
-				Vertex3D vertex;
-				vertex.id = std::stoi(matches[1].str());
-				vertex.x = std::stof(matches[2].str());
-				vertex.y = std::stof(matches[3].str());
-				vertex.z = std::stof(matches[4].str());
-				_coordinates.push_back(vertex);
+				chunk.lineCount++;
+				switch (parseLine(lineBegin, lineEnd, vertex)) {
+					case LineType::Comment:
+						break;
+					case LineType::Vertex:
+						chunk.coordinates.push_back(vertex);
+						break;
+					case LineType::Invalid:
+						chunk.invalidLines.push_back(chunk.lineCount);
+						break;
+				}
+				lineBegin = lineEnd + 1;
+			}
+		}
+
+		/**
+		 * Добавляет результат разбора части к уже загруженным координатам
+		 * @param lineCount - количество строк до начала части, увеличивается на
+		 * количество строк части
+		 */
+		void appendChunk(
+				const ParsedChunk& chunk,
+				std::vector<Vertex3D>& coordinates,
+				std::vector<size_t>& invalidLines,
+				size_t& lineCount)
+		{
+			coordinates.insert(
+					coordinates.end(), chunk.coordinates.begin(), chunk.coordinates.end());
+			for (size_t invalidLine : chunk.invalidLines) {
+				invalidLines.push_back(lineCount + invalidLine);
 			}
-			else {
-				std::cout << "Can not load line: " << line << std::endl;
+			lineCount += chunk.lineCount;
+		}
+	}
+
+	bool CoordinatesFileParser::loadFile(const std::string& fileName, size_t threadCount)
+	{
+		_loadedFromCache = false;
+		MappedFile file;
+		if (!file.open(fileName)) {
+			return false;
+		}
+		const size_t coordinateBegin = _coordinates.size();
+		const size_t invalidLineBegin = _invalidLines.size();
+		const size_t lineBegin = _lineCount;
+		if (_useCache && CoordinatesCache::load(
+				fileName, file.data(), file.size(), threadCount,
+				_coordinates, _invalidLines, _lineCount)) {
+			_loadedFromCache = true;
+			handleChunk(coordinateBegin);
+			return true;
+		}
+
+		parseBuffer(file.data(), file.size(), threadCount);
+		if (_useCache) {
+			// номера строк в кэше считаются от начала файла
+			std::vector<size_t> invalidLines(
+					_invalidLines.begin() + static_cast<std::ptrdiff_t>(invalidLineBegin),
+					_invalidLines.end());
+			for (size_t& invalidLine : invalidLines) {
+				invalidLine -= lineBegin;
 			}
+			// ошибка записи кэша не мешает загрузке
+			CoordinatesCache::save(
+					fileName, file.data(), file.size(), threadCount,
+					_coordinates.data() + coordinateBegin, _coordinates.size() - coordinateBegin,
+					invalidLines.data(), invalidLines.size(), _lineCount - lineBegin);
 		}
-		file.close();
 		return true;
 	}
 
-	const std::list<Vertex3D>& CoordinatesFileParser::coordinates() const
+	void CoordinatesFileParser::parseBuffer(const char* data, size_t size, size_t threadCount)
+	{
+		if (!data || size == 0) {
+			return;
+		}
+		if (threadCount == 0) {
+			threadCount = ThreadPool::defaultThreadCount();
+		}
+
+		// Делим буфер на части по границам строк, при этом части не делаются
+		// меньше MIN_CHUNK_SIZE, чтобы не тратить время на запуск лишних задач
+		const size_t minChunkSize = _chunkSize > 0 ? _chunkSize : MIN_CHUNK_SIZE;
+		const size_t chunkCount = std::max<size_t>(
+				1, std::min(threadCount, size / minChunkSize));
+		const char* end = data + size;
+		std::vector<const char*> bounds;
+		bounds.reserve(chunkCount + 1);
+		bounds.push_back(data);
+		for (size_t i = 1; i < chunkCount; i++) {
+			const char* bound = std::max(data + size / chunkCount * i, bounds.back());
+			bound = static_cast<const char*>(
+					std::memchr(bound, '\n', static_cast<size_t>(end - bound)));
+			if (!bound) {
+				break;
+			}
+			bounds.push_back(bound + 1);
+		}
+		bounds.push_back(end);
+
+		std::vector<ParsedChunk> chunks(bounds.size() - 1);
+		if (chunks.size() == 1) {
+			parseChunk(bounds[0], bounds[1], chunks[0]);
+		}
+		else {
+			ThreadPool pool(std::min(threadCount, chunks.size()));
+			std::vector<std::future<void> > results;
+			results.reserve(chunks.size());
+			for (size_t i = 0; i < chunks.size(); i++) {
+				results.push_back(pool.submit([&bounds, &chunks, i]() {
+					parseChunk(bounds[i], bounds[i + 1], chunks[i]);
+				}));
+			}
+			for (auto& result : results) {
+				result.get();
+			}
+		}
+
+		// Склеиваем результаты в порядке следования частей в файле
+		size_t coordinateCount = _coordinates.size();
+		for (const auto& chunk : chunks) {
+			coordinateCount += chunk.coordinates.size();
+		}
+		_coordinates.reserve(coordinateCount);
+		for (const auto& chunk : chunks) {
+			const size_t begin = _coordinates.size();
+			appendChunk(chunk, _coordinates, _invalidLines, _lineCount);
+			handleChunk(begin);
+		}
+	}
+
+	bool CoordinatesFileParser::loadStream(std::istream& stream, size_t threadCount)
+	{
+		if (threadCount == 0) {
+			threadCount = ThreadPool::defaultThreadCount();
+		}
+		const size_t blockSize = _chunkSize > 0 ? _chunkSize : STREAM_BLOCK_SIZE;
+
+		// Блок потока, который разбирается в пуле
+		struct Block
+		{
+			std::vector<char> data;
+			ParsedChunk chunk;
+			std::future<void> result;
+		};
+		std::deque<std::unique_ptr<Block> > blocks;
+		ThreadPool pool(threadCount);
+		auto appendFirstBlock = [this, &blocks]() {
+			blocks.front()->result.get();
+			const size_t begin = _coordinates.size();
+			appendChunk(blocks.front()->chunk, _coordinates, _invalidLines, _lineCount);
+			handleChunk(begin);
+			blocks.pop_front();
+		};
+
+		// Блоки читаются, пока предыдущие разбираются. Неполная последняя строка
+		// блока переносится в начало следующего. В памяти находится не больше
+		// двух блоков на поток.
+		std::vector<char> tail;
+		while (stream) {
+			auto block = std::make_unique<Block>();
+			block->data.resize(tail.size() + blockSize);
+			std::copy(tail.begin(), tail.end(), block->data.begin());
+			stream.read(block->data.data() + tail.size(), static_cast<std::streamsize>(blockSize));
+			size_t size = tail.size() + static_cast<size_t>(stream.gcount());
+			tail.clear();
+			if (stream) {
+				const auto lastLineEnd = std::find(
+						block->data.rbegin() + static_cast<std::ptrdiff_t>(block->data.size() - size),
+						block->data.rend(),
+						'\n');
+				const size_t lineEnd = static_cast<size_t>(block->data.rend() - lastLineEnd);
+				tail.assign(
+						block->data.begin() + static_cast<std::ptrdiff_t>(lineEnd),
+						block->data.begin() + static_cast<std::ptrdiff_t>(size));
+				size = lineEnd;
+			}
+			if (size == 0) {
+				continue;
+			}
+			block->data.resize(size);
+			Block* current = block.get();
+			current->result = pool.submit([current]() {
+				parseChunk(
+						current->data.data(),
+						current->data.data() + current->data.size(),
+						current->chunk);
+			});
+			blocks.push_back(std::move(block));
+			if (blocks.size() > 2 * pool.size()) {
+				appendFirstBlock();
+			}
+		}
+		while (!blocks.empty()) {
+			appendFirstBlock();
+		}
+		return !stream.bad();
+	}
+
+	bool CoordinatesFileParser::loadBinaryFile(const std::string& fileName)
+	{
+		BinaryCoordinatesFile file;
+		if (!file.open(fileName)) {
+			return false;
+		}
+		const size_t begin = _coordinates.size();
+		file.appendCoordinates(_coordinates);
+		handleChunk(begin);
+		return true;
+	}
+
+	bool CoordinatesFileParser::parseVertex(const char* begin, const char* end, Vertex3D& vertex) noexcept
+	{
+		return parseLine(begin, end, vertex) == LineType::Vertex;
+	}
+
+	void CoordinatesFileParser::setChunkHandler(ChunkHandler handler)
+	{
+		_chunkHandler = std::move(handler);
+	}
+
+	void CoordinatesFileParser::setChunkSize(size_t chunkSize)
+	{
+		_chunkSize = chunkSize;
+	}
+
+	void CoordinatesFileParser::setUseCache(bool useCache)
+	{
+		_useCache = useCache;
+	}
+
+	bool CoordinatesFileParser::isLoadedFromCache() const
+	{
+		return _loadedFromCache;
+	}
+
+	void CoordinatesFileParser::clear() noexcept
+	{
+		_coordinates.clear();
+		_invalidLines.clear();
+		_lineCount = 0;
+		_loadedFromCache = false;
+	}
+
+	const std::vector<Vertex3D>& CoordinatesFileParser::coordinates() const
 	{
 		return _coordinates;
 	}
 
+	const std::vector<size_t>& CoordinatesFileParser::invalidLines() const
+	{
+		return _invalidLines;
+	}
+
 	bool CoordinatesFileParser::writeFile(
 			const std::string& outputFileName,
-			const std::list<Vertex3D>& coordinates,
+			const std::vector<Vertex3D>& coordinates,
 			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
-			const std::set<int>& usedVertexIds)
+			const std::vector<bool>& usedVertices)
 	{
 		std::unique_ptr<DefaultWriter> writer = std::make_unique<DefaultWriter>();
 		return  writer->writeFile(
 				outputFileName,
 				coordinates,
 				triangles,
-				usedVertexIds);
+				usedVertices);
+	}
+
+	void CoordinatesFileParser::handleChunk(size_t begin)
+	{
+		if (_chunkHandler && begin < _coordinates.size()) {
+			_chunkHandler(_coordinates.data() + begin, _coordinates.size() - begin);
+		}
 	}
 }
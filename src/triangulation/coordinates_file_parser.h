@@ -1,10 +1,12 @@
 #ifndef TRIANGULATION_COORDINATES_FILE_PARSER_H
 #define TRIANGULATION_COORDINATES_FILE_PARSER_H
 
+#include <functional>
+#include <istream>
 #include <list>
 #include <memory>
 #include <string>
-#include <set>
+#include <vector>
 
 
 
@@ -19,8 +21,25 @@ namespace triangulation
 
 	class CoordinatesFileParser
 	{
+	public:
+		/**
+		 * Обработчик очередной загруженной части координат. Вызывается в потоке
+		 * загрузки в порядке следования частей, указатель действителен только во
+		 * время вызова.
+		 */
+		using ChunkHandler = std::function<void(const Vertex3D* coordinates, size_t count)>;
+
 	private:
-		std::list<Vertex3D> _coordinates;
+		std::vector<Vertex3D> _coordinates;
+		// номера (с 1) строк, которые не удалось разобрать
+		std::vector<size_t> _invalidLines;
+		// количество уже разобранных строк
+		size_t _lineCount = 0;
+		// размер части буфера и блока потока, 0 - по умолчанию
+		size_t _chunkSize = 0;
+		ChunkHandler _chunkHandler;
+		bool _useCache = false;
+		bool _loadedFromCache = false;
 
 	public:
 		CoordinatesFileParser() = default;
@@ -30,13 +49,100 @@ namespace triangulation
 		CoordinatesFileParser & operator=(const CoordinatesFileParser&) = delete;
 		CoordinatesFileParser & operator=(CoordinatesFileParser&&) = delete;
 
-		bool loadFile(const std::string& fileName);
-		[[nodiscard]] const std::list<Vertex3D>& coordinates() const;
+		/**
+		 * Загружает координаты из текстового файла, отображая его в память.
+		 * Строки, начинающиеся с '*', считаются комментариями, остальные должны
+		 * иметь вид "N, X, Y, Z". Номера строк, которые не удалось разобрать,
+		 * доступны через invalidLines().
+		 *
+		 * Если включён кэш (setUseCache), то при действительном кэше рядом с файлом
+		 * координаты загружаются из него без разбора, иначе после разбора кэш
+		 * записывается (см. CoordinatesCache).
+		 * @param fileName
+		 * @param threadCount - количество потоков разбора, 0 - по количеству ядер
+		 * @return false если файл не удалось открыть
+		 */
+		bool loadFile(const std::string& fileName, size_t threadCount = 0);
+
+		/**
+		 * Разбирает строки "N, X, Y, Z" из буфера и добавляет координаты к уже
+		 * загруженным. Большой буфер делится по границам строк на части, которые
+		 * разбираются параллельно, порядок координат при этом сохраняется.
+		 * @param data
+		 * @param size
+		 * @param threadCount - количество потоков разбора, 0 - по количеству ядер
+		 */
+		void parseBuffer(const char* data, size_t size, size_t threadCount = 0);
+
+		/**
+		 * Загружает координаты из потока (например, std::cin) по мере чтения: поток
+		 * читается блоками, которые разбираются в пуле потоков, пока читаются
+		 * следующие. Формат строк тот же, что и для loadFile().
+		 * @param stream
+		 * @param threadCount - количество потоков разбора, 0 - по количеству ядер
+		 * @return false при ошибке чтения потока
+		 */
+		bool loadStream(std::istream& stream, size_t threadCount = 0);
+
+		/**
+		 * Загружает координаты из бинарного файла (см. BinaryCoordinatesFile)
+		 * @param fileName
+		 * @return false если файл не удалось открыть или он не в бинарном формате
+		 */
+		bool loadBinaryFile(const std::string& fileName);
+
+		/**
+		 * Разбирает одну строку "N, X, Y, Z" без символа перевода строки
+		 * @return false для комментария и строки, которую не удалось разобрать
+		 */
+		static bool parseVertex(const char* begin, const char* end, Vertex3D& vertex) noexcept;
+
+		/**
+		 * Задаёт обработчик, который получает координаты частями по мере загрузки,
+		 * например для проекции вершин, пока разбираются следующие части потока
+		 * @param handler
+		 */
+		void setChunkHandler(ChunkHandler handler);
+
+		/**
+		 * Задаёт минимальный размер части буфера, которая разбирается отдельной
+		 * задачей в parseBuffer(), и размер блока, читаемого loadStream() за один
+		 * раз. Маленький размер нужен, например, чтобы проверить строки на
+		 * границах частей.
+		 * @param chunkSize - 0 для размеров по умолчанию
+		 */
+		void setChunkSize(size_t chunkSize);
+
+		/**
+		 * Включает кэш разобранных координат для loadFile()
+		 * @param useCache
+		 */
+		void setUseCache(bool useCache);
+
+		/**
+		 * @return true если последний loadFile() загрузил координаты из кэша
+		 */
+		[[nodiscard]] bool isLoadedFromCache() const;
+
+		/**
+		 * Забывает загруженные координаты и номера строк, сохраняя выделенную память,
+		 * чтобы загрузить следующий файл тем же объектом (см. BatchTriangulation)
+		 */
+		void clear() noexcept;
+
+		[[nodiscard]] const std::vector<Vertex3D>& coordinates() const;
+		[[nodiscard]] const std::vector<size_t>& invalidLines() const;
 		bool writeFile(
 				const std::string& outputFileName,
-				const std::list<Vertex3D>& coordinates,
+				const std::vector<Vertex3D>& coordinates,
 				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
-				const std::set<int>& usedVertexIds);
+				const std::vector<bool>& usedVertices);
+
+	private:
+		/**
+		 * Передаёт обработчику координаты, добавленные начиная с позиции begin
+		 */
+		void handleChunk(size_t begin);
 
 	};
 }
@@ -0,0 +1,58 @@
+#include "cylindrical_projection.h"
+
+#include "surface_fit.h"
+#include <delaunay/vertex_2d.h>
+
+#include <cmath>
+
+
+namespace triangulation
+{
+	bool CylindricalProjection::needsFit() const noexcept
+	{
+		return true;
+	}
+
+	void CylindricalProjection::fit(const Vertex3D* vertices, size_t count)
+	{
+		const PrincipalAxes axes = SurfaceFit::principalAxes(vertices, count);
+		double centerX = 0.0;
+		double centerY = 0.0;
+		double radius;
+		if (!SurfaceFit::fitCircle(vertices, count, axes.center, axes.axes[1], axes.axes[2],
+				centerX, centerY, radius)) {
+			centerX = 0.0;
+			centerY = 0.0;
+			radius = std::sqrt(axes.variances[1] + axes.variances[2]);
+		}
+		for (int k = 0; k < 3; k++) {
+			_axis[k] = axes.axes[0][k];
+			_center[k] = axes.center[k] + centerX * axes.axes[1][k] + centerY * axes.axes[2][k];
+			// нулевой угол - направление из оси на центр масс вершин
+			_directionX[k] = axes.center[k] - _center[k];
+		}
+		if (!SurfaceFit::normalize(_directionX)) {
+			for (int k = 0; k < 3; k++) {
+				_directionX[k] = axes.axes[1][k];
+			}
+		}
+		SurfaceFit::cross(_axis, _directionX, _directionY);
+		_radius = radius > 0.0 ? radius : 1.0;
+	}
+
+	void CylindricalProjection::project(
+			const Vertex3D* vertices,
+			size_t count,
+			delaunay::Vertex2D* result) const noexcept
+	{
+		for (size_t i = 0; i < count; i++) {
+			const double d[3] = {
+					vertices[i].x - _center[0],
+					vertices[i].y - _center[1],
+					vertices[i].z - _center[2]};
+			const double angle = std::atan2(SurfaceFit::dot(d, _directionY), SurfaceFit::dot(d, _directionX));
+			result[i].x = static_cast<float>(_radius * angle);
+			result[i].y = static_cast<float>(SurfaceFit::dot(d, _axis));
+		}
+	}
+}
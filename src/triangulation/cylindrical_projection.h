@@ -0,0 +1,45 @@
+#ifndef TRIANGULATION_CYLINDRICAL_PROJECTION_H
+#define TRIANGULATION_CYLINDRICAL_PROJECTION_H
+
+#include "projection_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Развёртка цилиндра. Ось цилиндра - главная ось с наибольшим разбросом вершин,
+	 * окружность сечения подбирается методом наименьших квадратов. Координаты -
+	 * длина дуги по окружности (шов напротив середины облака вершин) и положение
+	 * вдоль оси.
+	 */
+	class CylindricalProjection : public IProjection
+	{
+	private:
+		// точка на оси, через которую проходит плоскость начала отсчёта
+		double _center[3] = {0.0, 0.0, 0.0};
+		// ось цилиндра и направления на начало отсчёта угла и под прямым углом к нему
+		double _axis[3] = {0.0, 0.0, 1.0};
+		double _directionX[3] = {1.0, 0.0, 0.0};
+		double _directionY[3] = {0.0, 1.0, 0.0};
+		double _radius = 1.0;
+
+	public:
+		CylindricalProjection() = default;
+		CylindricalProjection(const CylindricalProjection&) = delete;
+		CylindricalProjection(CylindricalProjection&&) = delete;
+		CylindricalProjection& operator=(const CylindricalProjection&) = delete;
+		CylindricalProjection& operator=(CylindricalProjection&&) = delete;
+
+		[[nodiscard]] bool needsFit() const noexcept final;
+
+		void fit(const Vertex3D* vertices, size_t count) final;
+
+		void project(
+				const Vertex3D* vertices,
+				size_t count,
+				delaunay::Vertex2D* result) const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_CYLINDRICAL_PROJECTION_H
@@ -1,48 +1,85 @@
 #include "default_writer.h"
 
-#include "utils.h"
+#include "output_buffer.h"
 #include <delaunay/triangle.h>
 #include <delaunay/vertex_2d.h>
-#include <fstream>
 
 
 namespace triangulation
 {
+	const char* const DefaultWriter::NODES_HEADER =
+			"*   N,            X             Y             Z\n"
+			"* Nodes\n";
+	const char* const DefaultWriter::ELEMENTS_HEADER = "*Elements\n";
+
 	DefaultWriter::DefaultWriter() : IFileWriter()
 	{}
 
-	bool DefaultWriter::writeFile(
-			const std::string& outputFileName,
-			const std::list<Vertex3D>& coordinates,
+	bool DefaultWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
 			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
-			const std::set<int>& usedVertexIds)
+			const std::vector<bool>& usedVertices)
 	{
-		std::fstream file;
-		file.open(outputFileName, std::ios::out);
-		if (!file.is_open()) {
-			return false;
-		}
-		file << "*   N,            X             Y             Z" << std::endl;
-		file << "* Nodes" << std::endl;
-		for (const auto& vertex : coordinates) {
-			auto i = usedVertexIds.find(vertex.id);
-			if (i == usedVertexIds.end()) {
-				continue;
+		OutputBuffer output(stream);
+		output.append(NODES_HEADER);
+		for (size_t i = 0; i < coordinates.size(); i++) {
+			if (usedVertices[i]) {
+				appendNode(output, coordinates[i]);
 			}
-			file << Utils::intToString(vertex.id, 5) << ','
-				 << Utils::floatToString(vertex.x, 13) << ','
-				 << Utils::floatToString(vertex.y, 13) << ','
-				 << Utils::floatToString(vertex.z, 13) << std::endl;
 		}
 
-		file << "*Elements" << std::endl;
+		output.append(ELEMENTS_HEADER);
 		for (const auto& triangle : triangles) {
-			file << Utils::intToString(triangle->id, 5) << ','
-				 << Utils::intToString(triangle->vertex1->id, 5) << ','
-				 << Utils::intToString(triangle->vertex2->id, 5) << ','
-				 << Utils::intToString(triangle->vertex3->id, 5) << std::endl;
+			appendElement(output, *triangle, coordinates);
 		}
-		file.close();
-		return true;
+		return output.flush();
+	}
+
+	void DefaultWriter::appendNode(OutputBuffer& output, const Vertex3D& vertex)
+	{
+		output.appendInt(vertex.id, 5);
+		output.append(',');
+		output.appendFloat(vertex.x, 13);
+		output.append(',');
+		output.appendFloat(vertex.y, 13);
+		output.append(',');
+		output.appendFloat(vertex.z, 13);
+		output.append('\n');
+	}
+
+	void DefaultWriter::appendElement(
+			OutputBuffer& output,
+			const delaunay::Triangle& triangle,
+			const std::vector<Vertex3D>& coordinates)
+	{
+		appendElement(
+				output,
+				triangle.id,
+				coordinates[triangle.vertex1->id].id,
+				coordinates[triangle.vertex2->id].id,
+				coordinates[triangle.vertex3->id].id);
+	}
+
+	void DefaultWriter::appendElement(
+			OutputBuffer& output,
+			int id,
+			int vertex1,
+			int vertex2,
+			int vertex3)
+	{
+		output.appendInt(id, 5);
+		output.append(',');
+		output.appendInt(vertex1, 5);
+		output.append(',');
+		output.appendInt(vertex2, 5);
+		output.append(',');
+		output.appendInt(vertex3, 5);
+		output.append('\n');
+	}
+
+	bool DefaultWriter::isBinary() const noexcept
+	{
+		return false;
 	}
 }
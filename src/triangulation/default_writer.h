@@ -6,20 +6,51 @@
 
 namespace triangulation
 {
+	class OutputBuffer;
+
 	class DefaultWriter : public IFileWriter
 	{
 	public:
+		static const char* const NODES_HEADER;
+		static const char* const ELEMENTS_HEADER;
+
 		DefaultWriter(const DefaultWriter&) = delete;
 		DefaultWriter(DefaultWriter&&) = delete;
 		DefaultWriter& operator=(const DefaultWriter&) = delete;
 		DefaultWriter& operator=(DefaultWriter&&) = delete;
 		DefaultWriter();
 
-		bool writeFile(
-				const std::string& outputFileName,
-				const std::list<Vertex3D>& coordinates,
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
 				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
-				const std::set<int>& usedVertexIds) final;
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+		/**
+		 * Строка раздела узлов: "N, X, Y, Z"
+		 */
+		static void appendNode(OutputBuffer& output, const Vertex3D& vertex);
+
+		/**
+		 * Строка раздела элементов: номер треугольника и внешние номера трёх его вершин
+		 */
+		static void appendElement(
+				OutputBuffer& output,
+				const delaunay::Triangle& triangle,
+				const std::vector<Vertex3D>& coordinates);
+
+		/**
+		 * То же по номеру треугольника и внешним номерам вершин, например когда
+		 * coordinates не хранятся в памяти (см. StreamingTriangulation)
+		 */
+		static void appendElement(
+				OutputBuffer& output,
+				int id,
+				int vertex1,
+				int vertex2,
+				int vertex3);
 
 	};
 }
@@ -0,0 +1,25 @@
+#include "file_writer_interface.h"
+
+#include <fstream>
+
+
+namespace triangulation
+{
+	bool IFileWriter::writeFile(
+			const std::string& outputFileName,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		std::fstream file;
+		file.open(outputFileName, isBinary()
+				? std::ios::out | std::ios::binary | std::ios::trunc
+				: std::ios::out);
+		if (!file.is_open()) {
+			return false;
+		}
+		const bool ok = writeStream(file, coordinates, triangles, usedVertices);
+		file.close();
+		return ok && !file.fail();
+	}
+}
@@ -5,8 +5,9 @@
 
 #include <list>
 #include <memory>
+#include <ostream>
 #include <string>
-#include <set>
+#include <vector>
 
 
 namespace delaunay
@@ -16,6 +17,11 @@ namespace delaunay
 
 namespace triangulation
 {
+	/**
+	 * Запись сетки. Треугольники ссылаются на вершины по индексу в coordinates:
+	 * Vertex2D::id - плотный индекс, внешний номер вершины - coordinates[id].id.
+	 * usedVertices[i] - входит ли вершина coordinates[i] хотя бы в один треугольник.
+	 */
 	class IFileWriter
 	{
 	public:
@@ -25,11 +31,32 @@ namespace triangulation
 		IFileWriter& operator=(IFileWriter&&) = delete;
 		virtual ~IFileWriter() = default;
 
+		/**
+		 * Открывает файл (в режиме std::ios::binary для двоичных форматов) и
+		 * записывает в него сетку через writeStream()
+		 * @return false если файл не удалось открыть или записать
+		 */
 		virtual bool writeFile(
 				const std::string& outputFileName,
-				const std::list<Vertex3D>& coordinates,
+				const std::vector<Vertex3D>& coordinates,
 				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
-				const std::set<int>& usedVertexIds) = 0;
+				const std::vector<bool>& usedVertices);
+
+		/**
+		 * Записывает сетку в открытый поток, например в std::cout
+		 * @return false если сетку не удалось записать
+		 */
+		virtual bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) = 0;
+
+		/**
+		 * @return true если формат двоичный и поток не должен преобразовывать
+		 * переводы строк
+		 */
+		[[nodiscard]] virtual bool isBinary() const noexcept = 0;
 
 	protected:
 		IFileWriter() = default;
@@ -0,0 +1,29 @@
+#include "legacy_projection.h"
+
+#include <delaunay/vertex_2d.h>
+
+
+namespace triangulation
+{
+	bool LegacyProjection::needsFit() const noexcept
+	{
+		return false;
+	}
+
+	void LegacyProjection::fit(const Vertex3D*, size_t)
+	{}
+
+	void LegacyProjection::project(
+			const Vertex3D* vertices,
+			size_t count,
+			delaunay::Vertex2D* result) const noexcept
+	{
+		// без ветвлений и вызовов, чтобы компилятор векторизовал цикл
+		const Vertex3D* __restrict input = vertices;
+		delaunay::Vertex2D* __restrict output = result;
+		for (size_t i = 0; i < count; i++) {
+			output[i].x = input[i].x * input[i].z;
+			output[i].y = input[i].y * input[i].z;
+		}
+	}
+}
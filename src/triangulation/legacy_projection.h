@@ -0,0 +1,34 @@
+#ifndef TRIANGULATION_LEGACY_PROJECTION_H
+#define TRIANGULATION_LEGACY_PROJECTION_H
+
+#include "projection_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Исходная проекция (x * z, y * z). Параметров не имеет, поэтому вершины можно
+	 * проецировать по мере загрузки.
+	 */
+	class LegacyProjection : public IProjection
+	{
+	public:
+		LegacyProjection() = default;
+		LegacyProjection(const LegacyProjection&) = delete;
+		LegacyProjection(LegacyProjection&&) = delete;
+		LegacyProjection& operator=(const LegacyProjection&) = delete;
+		LegacyProjection& operator=(LegacyProjection&&) = delete;
+
+		[[nodiscard]] bool needsFit() const noexcept final;
+
+		void fit(const Vertex3D* vertices, size_t count) final;
+
+		void project(
+				const Vertex3D* vertices,
+				size_t count,
+				delaunay::Vertex2D* result) const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_LEGACY_PROJECTION_H
@@ -0,0 +1,137 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace triangulation
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& fileName)
+	{
+		close();
+		HANDLE file = CreateFileA(
+				fileName.c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+				nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		_file = file;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize)) {
+			close();
+			return false;
+		}
+		_size = static_cast<size_t>(fileSize.QuadPart);
+		if (_size == 0) {
+			return true;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			close();
+			return false;
+		}
+		_mapping = mapping;
+
+		_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!_data) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void MappedFile::close() noexcept
+	{
+		if (_data) {
+			UnmapViewOfFile(_data);
+			_data = nullptr;
+		}
+		if (_mapping) {
+			CloseHandle(_mapping);
+			_mapping = nullptr;
+		}
+		if (_file) {
+			CloseHandle(_file);
+			_file = nullptr;
+		}
+		_size = 0;
+	}
+#else
+	bool MappedFile::open(const std::string& fileName)
+	{
+		close();
+		_file = ::open(fileName.c_str(), O_RDONLY);
+		if (_file < 0) {
+			return false;
+		}
+
+		struct stat fileStat {};
+		if (fstat(_file, &fileStat) != 0) {
+			close();
+			return false;
+		}
+		_size = static_cast<size_t>(fileStat.st_size);
+		if (_size == 0) {
+			return true;
+		}
+
+		void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _file, 0);
+		if (data == MAP_FAILED) {
+			close();
+			return false;
+		}
+		// Файл читается один раз от начала до конца
+		madvise(data, _size, MADV_SEQUENTIAL);
+		_data = static_cast<const char*>(data);
+		return true;
+	}
+
+	void MappedFile::close() noexcept
+	{
+		if (_data) {
+			munmap(const_cast<char*>(_data), _size);
+			_data = nullptr;
+		}
+		if (_file >= 0) {
+			::close(_file);
+			_file = -1;
+		}
+		_size = 0;
+	}
+#endif
+
+	const char* MappedFile::data() const noexcept
+	{
+		return _data;
+	}
+
+	size_t MappedFile::size() const noexcept
+	{
+		return _size;
+	}
+}
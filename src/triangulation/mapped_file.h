@@ -0,0 +1,50 @@
+#ifndef TRIANGULATION_MAPPED_FILE_H
+#define TRIANGULATION_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+
+namespace triangulation
+{
+	/**
+	 * Файл, отображённый в память только для чтения.
+	 * Содержимое доступно через data() / size() до вызова close() или разрушения
+	 * объекта.
+	 */
+	class MappedFile
+	{
+	private:
+		const char* _data = nullptr;
+		size_t _size = 0;
+#ifdef _WIN32
+		void* _file = nullptr;
+		void* _mapping = nullptr;
+#else
+		int _file = -1;
+#endif
+
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		MappedFile & operator=(const MappedFile&) = delete;
+		MappedFile & operator=(MappedFile&&) = delete;
+
+		/**
+		 * Открывает и отображает файл в память. Пустой файл открывается успешно,
+		 * при этом data() возвращает nullptr.
+		 * @param fileName
+		 * @return false если файл не удалось открыть или отобразить
+		 */
+		bool open(const std::string& fileName);
+		void close() noexcept;
+
+		[[nodiscard]] const char* data() const noexcept;
+		[[nodiscard]] size_t size() const noexcept;
+
+	};
+}
+
+#endif //TRIANGULATION_MAPPED_FILE_H
@@ -0,0 +1,58 @@
+#include "obj_writer.h"
+
+#include "output_buffer.h"
+#include "vertex_index.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+
+namespace triangulation
+{
+	ObjWriter::ObjWriter() : IFileWriter()
+	{}
+
+	bool ObjWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		const VertexIndex vertexIndex(usedVertices);
+		// при ошибке файл не должен обрываться на середине граней
+		if (!vertexIndex.indexesAll(triangles)) {
+			return false;
+		}
+
+		OutputBuffer output(stream);
+		for (size_t position : vertexIndex.positions()) {
+			const Vertex3D& vertex = coordinates[position];
+			output.append("v ", 2);
+			output.appendFloat(vertex.x, 0);
+			output.append(' ');
+			output.appendFloat(vertex.y, 0);
+			output.append(' ');
+			output.appendFloat(vertex.z, 0);
+			output.append('\n');
+		}
+
+		for (const auto& triangle : triangles) {
+			const int32_t index1 = vertexIndex.index(triangle->vertex1->id);
+			const int32_t index2 = vertexIndex.index(triangle->vertex2->id);
+			const int32_t index3 = vertexIndex.index(triangle->vertex3->id);
+			// индексы вершин в OBJ начинаются с 1
+			output.append("f ", 2);
+			output.appendInt(index1 + 1, 0);
+			output.append(' ');
+			output.appendInt(index3 + 1, 0);
+			output.append(' ');
+			output.appendInt(index2 + 1, 0);
+			output.append('\n');
+		}
+		return output.flush();
+	}
+
+	bool ObjWriter::isBinary() const noexcept
+	{
+		return false;
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef TRIANGULATION_OBJ_WRITER_H
+#define TRIANGULATION_OBJ_WRITER_H
+
+#include "file_writer_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Записывает сетку в текстовом формате Wavefront OBJ: строки "v x y z" для
+	 * использованных вершин и "f a b c" с индексами вершин, начиная с 1.
+	 * Грани ориентированы против часовой стрелки в плоскости проекции (вершины
+	 * треугольника в порядке 1, 3, 2), как принято в сторонних программах; в
+	 * собственных форматах сохраняется порядок обхода по часовой стрелке.
+	 */
+	class ObjWriter : public IFileWriter
+	{
+	public:
+		ObjWriter();
+		ObjWriter(const ObjWriter&) = delete;
+		ObjWriter(ObjWriter&&) = delete;
+		ObjWriter& operator=(const ObjWriter&) = delete;
+		ObjWriter& operator=(ObjWriter&&) = delete;
+
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_OBJ_WRITER_H
@@ -0,0 +1,266 @@
+#include "outlier_filter.h"
+
+#include "thread_pool.h"
+#include "voxel_thinning.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+
+namespace triangulation
+{
+	namespace
+	{
+		// бит на номер ячейки по каждой оси в ключе
+		const int KEY_BITS = 21;
+		const int64_t MAX_CELL = (int64_t(1) << KEY_BITS) - 1;
+
+		/**
+		 * Вершины, упорядоченные по ячейкам сетки, и диапазоны вершин каждой
+		 * занятой ячейки
+		 */
+		class NeighbourGrid
+		{
+		private:
+			double _minimum[3] = {0.0, 0.0, 0.0};
+			double _cellSize = 1.0;
+			std::vector<std::array<double, 3> > _points;
+			std::vector<size_t> _order;
+			std::unordered_map<uint64_t, std::pair<size_t, size_t> > _cells;
+
+		public:
+			NeighbourGrid(const std::vector<Vertex3D>& coordinates, double cellSize)
+			{
+				double maximum[3] = {0.0, 0.0, 0.0};
+				for (size_t i = 0; i < coordinates.size(); i++) {
+					const double values[3] = {coordinates[i].x, coordinates[i].y, coordinates[i].z};
+					for (int axis = 0; axis < 3; axis++) {
+						if (i == 0 || values[axis] < _minimum[axis]) {
+							_minimum[axis] = values[axis];
+						}
+						if (i == 0 || values[axis] > maximum[axis]) {
+							maximum[axis] = values[axis];
+						}
+					}
+				}
+				const double extent = std::max({maximum[0] - _minimum[0], maximum[1] - _minimum[1], maximum[2] - _minimum[2]});
+				_cellSize = std::max(cellSize, extent / static_cast<double>(MAX_CELL));
+				if (!(_cellSize > 0.0)) {
+					_cellSize = 1.0;
+				}
+
+				std::vector<uint64_t> keys(coordinates.size());
+				for (size_t i = 0; i < coordinates.size(); i++) {
+					int64_t cell[3];
+					this->cell(coordinates[i], cell);
+					keys[i] = key(cell);
+				}
+				_order.resize(coordinates.size());
+				std::iota(_order.begin(), _order.end(), 0);
+				std::sort(_order.begin(), _order.end(), [&keys](size_t left, size_t right) {
+					return keys[left] < keys[right] || (keys[left] == keys[right] && left < right);
+				});
+				_points.resize(coordinates.size());
+				for (size_t i = 0; i < _order.size(); i++) {
+					const Vertex3D& vertex = coordinates[_order[i]];
+					_points[i] = {vertex.x, vertex.y, vertex.z};
+					const uint64_t cellKey = keys[_order[i]];
+					if (i == 0 || keys[_order[i - 1]] != cellKey) {
+						_cells.emplace(cellKey, std::make_pair(i, i + 1));
+					}
+					else {
+						_cells[cellKey].second = i + 1;
+					}
+				}
+			}
+
+			[[nodiscard]] size_t size() const noexcept
+			{
+				return _points.size();
+			}
+
+			// индекс в coordinates вершины с номером position в порядке ячеек
+			[[nodiscard]] size_t index(size_t position) const noexcept
+			{
+				return _order[position];
+			}
+
+			/**
+			 * Среднее расстояние от вершины с номером position до k ближайших соседей
+			 * @param heap - буфер для квадратов расстояний
+			 */
+			double meanDistance(size_t position, size_t k, std::vector<double>& heap) const
+			{
+				const std::array<double, 3>& point = _points[position];
+				int64_t center[3];
+				for (int axis = 0; axis < 3; axis++) {
+					center[axis] = cellOf(point[axis], axis);
+				}
+				heap.clear();
+				for (int64_t ring = 0; ring <= OutlierFilter::MAX_RINGS; ring++) {
+					// только ячейки на поверхности куба со стороной 2 * ring + 1
+					for (int64_t dz = -ring; dz <= ring; dz++) {
+						for (int64_t dy = -ring; dy <= ring; dy++) {
+							const bool face = dz == -ring || dz == ring || dy == -ring || dy == ring;
+							const int64_t step = face ? 1 : std::max<int64_t>(2 * ring, 1);
+							for (int64_t dx = -ring; dx <= ring; dx += step) {
+								const int64_t cell[3] = {center[0] + dx, center[1] + dy, center[2] + dz};
+								visitCell(cell, position, k, heap);
+							}
+						}
+					}
+					// вершины в следующих слоях не ближе ring ячеек
+					const double reach = static_cast<double>(ring) * _cellSize;
+					if (heap.size() == k && reach * reach >= heap.front()) {
+						break;
+					}
+				}
+				double sum = 0.0;
+				for (double distance : heap) {
+					sum += std::sqrt(distance);
+				}
+				sum += static_cast<double>(k - heap.size()) * OutlierFilter::MAX_RINGS * _cellSize;
+				return sum / static_cast<double>(k);
+			}
+
+		private:
+			[[nodiscard]] int64_t cellOf(double value, int axis) const noexcept
+			{
+				return std::min(static_cast<int64_t>((value - _minimum[axis]) / _cellSize), MAX_CELL);
+			}
+
+			void cell(const Vertex3D& vertex, int64_t result[3]) const noexcept
+			{
+				result[0] = cellOf(vertex.x, 0);
+				result[1] = cellOf(vertex.y, 1);
+				result[2] = cellOf(vertex.z, 2);
+			}
+
+			static uint64_t key(const int64_t cell[3]) noexcept
+			{
+				return static_cast<uint64_t>(cell[0])
+						| static_cast<uint64_t>(cell[1]) << KEY_BITS
+						| static_cast<uint64_t>(cell[2]) << (2 * KEY_BITS);
+			}
+
+			// добавляет вершины ячейки в кучу k ближайших (наибольший квадрат расстояния - первый)
+			void visitCell(const int64_t cell[3], size_t position, size_t k, std::vector<double>& heap) const
+			{
+				for (int axis = 0; axis < 3; axis++) {
+					if (cell[axis] < 0 || cell[axis] > MAX_CELL) {
+						return;
+					}
+				}
+				const auto found = _cells.find(key(cell));
+				if (found == _cells.end()) {
+					return;
+				}
+				const std::array<double, 3>& point = _points[position];
+				for (size_t i = found->second.first; i < found->second.second; i++) {
+					if (i == position) {
+						continue;
+					}
+					const double dx = _points[i][0] - point[0];
+					const double dy = _points[i][1] - point[1];
+					const double dz = _points[i][2] - point[2];
+					const double distance = dx * dx + dy * dy + dz * dz;
+					if (heap.size() < k) {
+						heap.push_back(distance);
+						std::push_heap(heap.begin(), heap.end());
+					}
+					else if (distance < heap.front()) {
+						std::pop_heap(heap.begin(), heap.end());
+						heap.back() = distance;
+						std::push_heap(heap.begin(), heap.end());
+					}
+				}
+			}
+		};
+	}
+
+	OutlierFilter::OutlierFilter(size_t neighbourCount, double sigma, size_t threadCount) :
+			_neighbourCount(neighbourCount),
+			_sigma(sigma),
+			_threadCount(threadCount)
+	{}
+
+	std::vector<Vertex3D> OutlierFilter::filter(const std::vector<Vertex3D>& coordinates, std::vector<int>& removedIds)
+	{
+		removedIds.clear();
+		const std::vector<double> distances = meanDistances(coordinates);
+		if (distances.empty()) {
+			return coordinates;
+		}
+		double mean = 0.0;
+		for (double distance : distances) {
+			mean += distance;
+		}
+		mean /= static_cast<double>(distances.size());
+		double variance = 0.0;
+		for (double distance : distances) {
+			variance += (distance - mean) * (distance - mean);
+		}
+		variance /= static_cast<double>(distances.size());
+		const double threshold = mean + _sigma * std::sqrt(variance);
+
+		std::vector<Vertex3D> result;
+		result.reserve(coordinates.size());
+		for (size_t i = 0; i < coordinates.size(); i++) {
+			if (distances[i] > threshold) {
+				removedIds.push_back(coordinates[i].id);
+			}
+			else {
+				result.push_back(coordinates[i]);
+			}
+		}
+		return result;
+	}
+
+	std::vector<double> OutlierFilter::meanDistances(const std::vector<Vertex3D>& coordinates)
+	{
+		const size_t k = std::min(_neighbourCount, coordinates.size() > 0 ? coordinates.size() - 1 : 0);
+		if (k == 0) {
+			return std::vector<double>(coordinates.size(), 0.0);
+		}
+		// сторона ячейки, при которой в занятой ячейке в среднем около k вершин
+		VoxelThinning thinning(_threadCount);
+		const double cellSize = thinning.spacingForBudget(
+				coordinates, std::max<size_t>(coordinates.size() / (k + 1), 1));
+		const NeighbourGrid grid(coordinates, cellSize);
+
+		std::vector<double> result(coordinates.size(), 0.0);
+		const auto task = [&grid, &result, k](size_t begin, size_t end) {
+			std::vector<double> heap;
+			heap.reserve(k);
+			for (size_t position = begin; position < end; position++) {
+				result[grid.index(position)] = grid.meanDistance(position, k, heap);
+			}
+		};
+		if (_threadCount == 1 || coordinates.size() < PARALLEL_THRESHOLD) {
+			task(0, grid.size());
+			return result;
+		}
+		ThreadPool pool(_threadCount);
+		// частей больше, чем потоков: время поиска у вершин в плотных и
+		// разреженных областях разное
+		const size_t parts = pool.size() * 8;
+		std::vector<std::future<void> > results;
+		results.reserve(parts);
+		for (size_t part = 0; part < parts; part++) {
+			const size_t begin = grid.size() * part / parts;
+			const size_t end = grid.size() * (part + 1) / parts;
+			results.push_back(pool.submit([&task, begin, end]() { task(begin, end); }));
+		}
+		for (auto& partResult : results) {
+			partResult.get();
+		}
+		return result;
+	}
+}
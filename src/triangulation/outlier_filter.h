@@ -0,0 +1,65 @@
+#ifndef TRIANGULATION_OUTLIER_FILTER_H
+#define TRIANGULATION_OUTLIER_FILTER_H
+
+#include "vertex_3d.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace triangulation
+{
+	/**
+	 * Статистическое удаление выбросов: для каждой вершины считается среднее
+	 * расстояние до k ближайших соседей, и удаляются вершины, у которых оно больше
+	 * среднего по облаку на sigma стандартных отклонений. Далёкие одиночные
+	 * вершины иначе раздувают габаритный прямоугольник триангуляции, и почти все
+	 * вершины попадают в несколько ячеек сетки TriangulationCache.
+	 *
+	 * Соседи ищутся в равномерной сетке (хеш-таблица занятых ячеек, в ячейке в
+	 * среднем около k вершин) по расширяющимся слоям ячеек. Для больших облаков
+	 * поиск выполняется в пуле потоков; результат от количества потоков не зависит.
+	 */
+	class OutlierFilter
+	{
+	public:
+		// Минимальное количество вершин, для которого используется пул потоков
+		static constexpr size_t PARALLEL_THRESHOLD = 1 << 14;
+		// Наибольшее количество слоёв ячеек вокруг вершины при поиске соседей;
+		// ненайденные соседи считаются лежащими на расстоянии MAX_RINGS ячеек
+		static constexpr int MAX_RINGS = 16;
+
+	private:
+		size_t _neighbourCount;
+		double _sigma;
+		size_t _threadCount;
+
+	public:
+		/**
+		 * @param neighbourCount - количество ближайших соседей k
+		 * @param sigma - порог в стандартных отклонениях среднего расстояния
+		 * @param threadCount - количество потоков, 0 - по количеству ядер, 1 - без
+		 * пула потоков
+		 */
+		OutlierFilter(size_t neighbourCount, double sigma, size_t threadCount = 1);
+		~OutlierFilter() = default;
+		OutlierFilter(const OutlierFilter&) = delete;
+		OutlierFilter(OutlierFilter&&) = delete;
+		OutlierFilter & operator=(const OutlierFilter&) = delete;
+		OutlierFilter & operator=(OutlierFilter&&) = delete;
+
+		/**
+		 * @param removedIds - id удалённых вершин в порядке coordinates
+		 * @return Оставшиеся вершины в исходном порядке
+		 */
+		std::vector<Vertex3D> filter(const std::vector<Vertex3D>& coordinates, std::vector<int>& removedIds);
+
+		/**
+		 * @return Среднее расстояние от каждой вершины до её k ближайших соседей
+		 */
+		std::vector<double> meanDistances(const std::vector<Vertex3D>& coordinates);
+
+	};
+}
+
+#endif //TRIANGULATION_OUTLIER_FILTER_H
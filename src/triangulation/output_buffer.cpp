@@ -0,0 +1,101 @@
+#include "output_buffer.h"
+
+#include "utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace triangulation
+{
+	OutputBuffer::OutputBuffer(std::ostream& stream, size_t capacity) :
+			_stream(&stream),
+			_buffer(std::max(capacity, 2 * Utils::MAX_NUMBER_LENGTH))
+	{}
+
+	OutputBuffer::OutputBuffer(size_t capacity) :
+			_buffer(std::max(capacity, 2 * Utils::MAX_NUMBER_LENGTH))
+	{}
+
+	OutputBuffer::~OutputBuffer()
+	{
+		flush();
+	}
+
+	void OutputBuffer::append(char c)
+	{
+		*reserve(1) = c;
+		_size++;
+	}
+
+	void OutputBuffer::append(const std::string& text)
+	{
+		append(text.data(), text.size());
+	}
+
+	void OutputBuffer::append(const char* data, size_t size)
+	{
+		if (_stream && size > _buffer.size()) {
+			flush();
+			_stream->write(data, static_cast<std::streamsize>(size));
+			return;
+		}
+		std::memcpy(reserve(size), data, size);
+		_size += size;
+	}
+
+	void OutputBuffer::appendInt(int i, size_t minLength)
+	{
+		_size += Utils::formatInt(
+				reserve(std::max(Utils::MAX_NUMBER_LENGTH, minLength + 1)), i, minLength);
+	}
+
+	void OutputBuffer::appendFloat(float f, size_t minLength)
+	{
+		_size += Utils::formatFloat(
+				reserve(std::max(Utils::MAX_NUMBER_LENGTH, minLength + 1)), f, minLength);
+	}
+
+	bool OutputBuffer::flush()
+	{
+		if (!_stream) {
+			return true;
+		}
+		if (_size > 0) {
+			_stream->write(_buffer.data(), static_cast<std::streamsize>(_size));
+			_size = 0;
+		}
+		return _stream->good();
+	}
+
+	const char* OutputBuffer::data() const noexcept
+	{
+		return _buffer.data();
+	}
+
+	size_t OutputBuffer::size() const noexcept
+	{
+		return _size;
+	}
+
+	void OutputBuffer::clear() noexcept
+	{
+		_size = 0;
+	}
+
+	char* OutputBuffer::reserve(size_t size)
+	{
+		if (_size + size > _buffer.size()) {
+			if (_stream) {
+				flush();
+				if (size > _buffer.size()) {
+					_buffer.resize(size);
+				}
+			}
+			else {
+				_buffer.resize(std::max(_buffer.size() * 2, _size + size));
+			}
+		}
+		return _buffer.data() + _size;
+	}
+}
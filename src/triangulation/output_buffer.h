@@ -0,0 +1,76 @@
+#ifndef TRIANGULATION_OUTPUT_BUFFER_H
+#define TRIANGULATION_OUTPUT_BUFFER_H
+
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace triangulation
+{
+	/**
+	 * Буфер для записи текста большими блоками. Числа форматируются прямо в буфер
+	 * (см. Utils::formatInt / Utils::formatFloat).
+	 *
+	 * Если буфер связан с потоком, то поток получает данные только при заполнении
+	 * буфера или вызове flush(). Буфер без потока просто накапливает текст в памяти,
+	 * который доступен через data() / size().
+	 */
+	class OutputBuffer
+	{
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+	private:
+		std::ostream* _stream = nullptr;
+		std::vector<char> _buffer;
+		size_t _size = 0;
+
+	public:
+		explicit OutputBuffer(std::ostream& stream, size_t capacity = DEFAULT_CAPACITY);
+		explicit OutputBuffer(size_t capacity = DEFAULT_CAPACITY);
+		~OutputBuffer();
+		OutputBuffer(const OutputBuffer&) = delete;
+		OutputBuffer(OutputBuffer&&) = delete;
+		OutputBuffer & operator=(const OutputBuffer&) = delete;
+		OutputBuffer & operator=(OutputBuffer&&) = delete;
+
+		void append(char c);
+		void append(const std::string& text);
+		void append(const char* data, size_t size);
+		void appendInt(int i, size_t minLength);
+		void appendFloat(float f, size_t minLength);
+
+		/**
+		 * Добавляет значение в двоичном виде в порядке байт машины
+		 * (для бинарных форматов вызывающий проверяет Utils::isLittleEndian)
+		 */
+		template<typename T>
+		void appendValue(const T& value)
+		{
+			std::memcpy(reserve(sizeof(T)), &value, sizeof(T));
+			_size += sizeof(T);
+		}
+
+		/**
+		 * Передаёт накопленные данные в поток. Для буфера без потока ничего не делает.
+		 * @return состояние потока после записи
+		 */
+		bool flush();
+
+		[[nodiscard]] const char* data() const noexcept;
+		[[nodiscard]] size_t size() const noexcept;
+		void clear() noexcept;
+
+	private:
+		/**
+		 * Освобождает место для size байт: записывает буфер в поток, а при отсутствии
+		 * потока увеличивает буфер
+		 */
+		char* reserve(size_t size);
+
+	};
+}
+
+#endif //TRIANGULATION_OUTPUT_BUFFER_H
@@ -0,0 +1,104 @@
+#include "parallel_writer.h"
+
+#include "default_writer.h"
+#include "output_buffer.h"
+#include "thread_pool.h"
+#include <delaunay/triangle.h>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+
+
+namespace triangulation
+{
+	ParallelWriter::ParallelWriter(size_t threadCount) :
+			IFileWriter(),
+			_threadCount(threadCount)
+	{}
+
+	ParallelWriter::~ParallelWriter() = default;
+
+	bool ParallelWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		// Каждая часть файла описывается функцией, которая форматирует её в буфер
+		using Chunk = std::function<void(OutputBuffer&)>;
+		std::vector<Chunk> chunks;
+		chunks.reserve(3 + coordinates.size() / LINES_PER_CHUNK
+				+ triangles.size() / LINES_PER_CHUNK);
+		chunks.emplace_back([](OutputBuffer& output) {
+			output.append(DefaultWriter::NODES_HEADER);
+		});
+		for (size_t begin = 0; begin < coordinates.size(); begin += LINES_PER_CHUNK) {
+			const size_t end = std::min(begin + LINES_PER_CHUNK, coordinates.size());
+			chunks.emplace_back([&coordinates, &usedVertices, begin, end](OutputBuffer& output) {
+				for (size_t i = begin; i < end; i++) {
+					if (usedVertices[i]) {
+						DefaultWriter::appendNode(output, coordinates[i]);
+					}
+				}
+			});
+		}
+		chunks.emplace_back([](OutputBuffer& output) {
+			output.append(DefaultWriter::ELEMENTS_HEADER);
+		});
+		// Список треугольников проходится один раз, чтобы найти границы частей
+		using TriangleIterator = std::list<std::shared_ptr<delaunay::Triangle> >::const_iterator;
+		TriangleIterator begin = triangles.begin();
+		while (begin != triangles.end()) {
+			TriangleIterator end = begin;
+			for (size_t i = 0; i < LINES_PER_CHUNK && end != triangles.end(); i++) {
+				++end;
+			}
+			chunks.emplace_back([&coordinates, begin, end](OutputBuffer& output) {
+				for (TriangleIterator i = begin; i != end; ++i) {
+					DefaultWriter::appendElement(output, **i, coordinates);
+				}
+			});
+			begin = end;
+		}
+
+		// Части форматируются в пуле, а текущий поток записывает их по порядку.
+		// Буфер части i переиспользуется для части i + window.
+		std::vector<std::unique_ptr<OutputBuffer> > buffers;
+		std::vector<std::future<void> > results(chunks.size());
+		if (!_pool) {
+			_pool = std::make_unique<ThreadPool>(_threadCount);
+		}
+		ThreadPool& pool = *_pool;
+		const size_t window = std::min(chunks.size(), 2 * pool.size());
+		buffers.reserve(window);
+		for (size_t i = 0; i < window; i++) {
+			buffers.push_back(std::make_unique<OutputBuffer>());
+		}
+		auto submit = [&chunks, &buffers, &results, &pool, window](size_t i) {
+			OutputBuffer* buffer = buffers[i % window].get();
+			const Chunk* chunk = &chunks[i];
+			results[i] = pool.submit([buffer, chunk]() {
+				buffer->clear();
+				(*chunk)(*buffer);
+			});
+		};
+		for (size_t i = 0; i < window; i++) {
+			submit(i);
+		}
+		for (size_t i = 0; i < chunks.size(); i++) {
+			results[i].get();
+			const OutputBuffer& buffer = *buffers[i % window];
+			stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			if (i + window < chunks.size()) {
+				submit(i + window);
+			}
+		}
+		return !stream.fail();
+	}
+
+	bool ParallelWriter::isBinary() const noexcept
+	{
+		return false;
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef TRIANGULATION_PARALLEL_WRITER_H
+#define TRIANGULATION_PARALLEL_WRITER_H
+
+#include "file_writer_interface.h"
+
+#include <memory>
+
+
+namespace triangulation
+{
+	class ThreadPool;
+
+	/**
+	 * Записывает файл в том же формате, что и DefaultWriter, но разделы узлов и
+	 * элементов форматируются частями параллельно в пуле потоков. Готовые части
+	 * записываются строго по порядку, поэтому результат совпадает побайтно с
+	 * DefaultWriter. В памяти одновременно находится не больше двух частей на поток.
+	 * Пул создаётся при первой записи и используется для всех последующих, поэтому
+	 * один объект не предназначен для записи из нескольких потоков одновременно.
+	 */
+	class ParallelWriter : public IFileWriter
+	{
+	public:
+		// количество строк в одной части
+		static constexpr size_t LINES_PER_CHUNK = 1 << 16;
+
+	private:
+		size_t _threadCount = 0;
+		std::unique_ptr<ThreadPool> _pool;
+
+	public:
+		ParallelWriter(const ParallelWriter&) = delete;
+		ParallelWriter(ParallelWriter&&) = delete;
+		ParallelWriter& operator=(const ParallelWriter&) = delete;
+		ParallelWriter& operator=(ParallelWriter&&) = delete;
+		/**
+		 * @param threadCount - количество потоков форматирования, 0 - по количеству ядер
+		 */
+		explicit ParallelWriter(size_t threadCount = 0);
+		~ParallelWriter() override;
+
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_PARALLEL_WRITER_H
@@ -0,0 +1,43 @@
+#include "plane_projection.h"
+
+#include "surface_fit.h"
+#include <delaunay/vertex_2d.h>
+
+
+namespace triangulation
+{
+	bool PlaneProjection::needsFit() const noexcept
+	{
+		return true;
+	}
+
+	void PlaneProjection::fit(const Vertex3D* vertices, size_t count)
+	{
+		const PrincipalAxes axes = SurfaceFit::principalAxes(vertices, count);
+		for (int k = 0; k < 3; k++) {
+			_axisX[k] = static_cast<float>(axes.axes[0][k]);
+			_axisY[k] = static_cast<float>(axes.axes[1][k]);
+		}
+		// начало координат в центре масс, чтобы не терять точность float
+		_offsetX = static_cast<float>(-SurfaceFit::dot(axes.center, axes.axes[0]));
+		_offsetY = static_cast<float>(-SurfaceFit::dot(axes.center, axes.axes[1]));
+	}
+
+	void PlaneProjection::project(
+			const Vertex3D* vertices,
+			size_t count,
+			delaunay::Vertex2D* result) const noexcept
+	{
+		const float xx = _axisX[0], xy = _axisX[1], xz = _axisX[2];
+		const float yx = _axisY[0], yy = _axisY[1], yz = _axisY[2];
+		const float offsetX = _offsetX;
+		const float offsetY = _offsetY;
+		// без ветвлений и вызовов, чтобы компилятор векторизовал цикл
+		const Vertex3D* __restrict input = vertices;
+		delaunay::Vertex2D* __restrict output = result;
+		for (size_t i = 0; i < count; i++) {
+			output[i].x = input[i].x * xx + input[i].y * xy + input[i].z * xz + offsetX;
+			output[i].y = input[i].x * yx + input[i].y * yy + input[i].z * yz + offsetY;
+		}
+	}
+}
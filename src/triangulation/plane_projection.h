@@ -0,0 +1,42 @@
+#ifndef TRIANGULATION_PLANE_PROJECTION_H
+#define TRIANGULATION_PLANE_PROJECTION_H
+
+#include "projection_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Проекция на плоскость, наилучшим образом приближающую вершины (метод главных
+	 * компонент): координаты - проекции на две главные оси с наибольшим разбросом.
+	 * Подходит для поверхностей, однозначно проецируемых на какую-то плоскость.
+	 */
+	class PlaneProjection : public IProjection
+	{
+	private:
+		// x = dot(vertex, _axisX) + _offsetX, y = dot(vertex, _axisY) + _offsetY
+		float _axisX[3] = {1.0f, 0.0f, 0.0f};
+		float _axisY[3] = {0.0f, 1.0f, 0.0f};
+		float _offsetX = 0.0f;
+		float _offsetY = 0.0f;
+
+	public:
+		PlaneProjection() = default;
+		PlaneProjection(const PlaneProjection&) = delete;
+		PlaneProjection(PlaneProjection&&) = delete;
+		PlaneProjection& operator=(const PlaneProjection&) = delete;
+		PlaneProjection& operator=(PlaneProjection&&) = delete;
+
+		[[nodiscard]] bool needsFit() const noexcept final;
+
+		void fit(const Vertex3D* vertices, size_t count) final;
+
+		void project(
+				const Vertex3D* vertices,
+				size_t count,
+				delaunay::Vertex2D* result) const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_PLANE_PROJECTION_H
@@ -0,0 +1,71 @@
+#include "ply_writer.h"
+
+#include "output_buffer.h"
+#include "utils.h"
+#include "vertex_index.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+
+namespace triangulation
+{
+	PlyWriter::PlyWriter() : IFileWriter()
+	{}
+
+	bool PlyWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		if (!Utils::isLittleEndian()) {
+			return false;
+		}
+		const VertexIndex vertexIndex(usedVertices);
+		// число граней записывается в заголовок, поэтому индексы проверяются заранее
+		if (!vertexIndex.indexesAll(triangles)) {
+			return false;
+		}
+
+		OutputBuffer output(stream);
+		output.append(
+				"ply\n"
+				"format binary_little_endian 1.0\n"
+				"element vertex ");
+		output.appendInt(static_cast<int>(vertexIndex.size()), 0);
+		output.append(
+				"\n"
+				"property float x\n"
+				"property float y\n"
+				"property float z\n"
+				"element face ");
+		output.appendInt(static_cast<int>(triangles.size()), 0);
+		output.append(
+				"\n"
+				"property list uchar int vertex_indices\n"
+				"end_header\n");
+
+		for (size_t position : vertexIndex.positions()) {
+			const Vertex3D& vertex = coordinates[position];
+			output.appendValue(vertex.x);
+			output.appendValue(vertex.y);
+			output.appendValue(vertex.z);
+		}
+
+		for (const auto& triangle : triangles) {
+			const int32_t index1 = vertexIndex.index(triangle->vertex1->id);
+			const int32_t index2 = vertexIndex.index(triangle->vertex2->id);
+			const int32_t index3 = vertexIndex.index(triangle->vertex3->id);
+			output.appendValue(static_cast<uint8_t>(3));
+			output.appendValue(index1);
+			output.appendValue(index3);
+			output.appendValue(index2);
+		}
+		return output.flush();
+	}
+
+	bool PlyWriter::isBinary() const noexcept
+	{
+		return true;
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef TRIANGULATION_PLY_WRITER_H
+#define TRIANGULATION_PLY_WRITER_H
+
+#include "file_writer_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Записывает сетку в формате PLY (binary_little_endian 1.0): вершины с
+	 * координатами x, y, z и грани со списком из трёх индексов вершин.
+	 * Грани ориентированы против часовой стрелки в плоскости проекции (вершины
+	 * треугольника в порядке 1, 3, 2), как принято в сторонних программах; в
+	 * собственных форматах сохраняется порядок обхода по часовой стрелке.
+	 */
+	class PlyWriter : public IFileWriter
+	{
+	public:
+		PlyWriter();
+		PlyWriter(const PlyWriter&) = delete;
+		PlyWriter(PlyWriter&&) = delete;
+		PlyWriter& operator=(const PlyWriter&) = delete;
+		PlyWriter& operator=(PlyWriter&&) = delete;
+
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_PLY_WRITER_H
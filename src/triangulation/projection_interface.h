@@ -0,0 +1,59 @@
+#ifndef TRIANGULATION_PROJECTION_INTERFACE_H
+#define TRIANGULATION_PROJECTION_INTERFACE_H
+
+#include "vertex_3d.h"
+
+#include <cstddef>
+
+
+namespace delaunay
+{
+	struct Vertex2D;
+}
+
+namespace triangulation
+{
+	/**
+	 * Проекция вершин 3D на плоскость триангуляции. Проекция выполняется пакетно
+	 * над непрерывным массивом вершин в заранее выделенный массив результата.
+	 */
+	class IProjection
+	{
+	public:
+		IProjection(const IProjection&) = delete;
+		IProjection(IProjection&&) = delete;
+		IProjection& operator=(const IProjection&) = delete;
+		IProjection& operator=(IProjection&&) = delete;
+		virtual ~IProjection() = default;
+
+		/**
+		 * @return true если параметры проекции вычисляются по всем вершинам и fit()
+		 * нужно вызвать до project()
+		 */
+		[[nodiscard]] virtual bool needsFit() const noexcept = 0;
+
+		/**
+		 * Вычисляет параметры проекции (плоскость, ось, центр) по всем вершинам
+		 * @param vertices
+		 * @param count
+		 */
+		virtual void fit(const Vertex3D* vertices, size_t count) = 0;
+
+		/**
+		 * Записывает x, y проекций вершин в result[0 .. count - 1], id не изменяются
+		 * @param vertices
+		 * @param count
+		 * @param result - не меньше count элементов, не пересекается с vertices
+		 */
+		virtual void project(
+				const Vertex3D* vertices,
+				size_t count,
+				delaunay::Vertex2D* result) const noexcept = 0;
+
+	protected:
+		IProjection() = default;
+
+	};
+}
+
+#endif //TRIANGULATION_PROJECTION_INTERFACE_H
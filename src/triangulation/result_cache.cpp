@@ -0,0 +1,270 @@
+#include "result_cache.h"
+
+#include "mapped_file.h"
+#include "utils.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <system_error>
+#include <vector>
+
+
+namespace triangulation
+{
+	const char ResultCache::MAGIC[8] = {'D', 'T', 'R', 'E', 'S', 'C', 'C', 'H'};
+	const char* const ResultCache::FILE_SUFFIX = ".result";
+
+	namespace
+	{
+		// начальные значения хэшей ключа
+		const uint64_t HASH_SEED = 0x44656c61756e6179ull;
+		const uint64_t CHECK_SEED = 0x547269616e676c65ull;
+
+		struct HashedVertex
+		{
+			int32_t id;
+			float x;
+			float y;
+		};
+
+		int32_t index(
+				const std::unordered_map<const delaunay::Triangle*, int32_t>& indices,
+				const std::shared_ptr<delaunay::Triangle>& triangle)
+		{
+			if (!triangle) {
+				return ResultCache::NO_NEIGHBOUR;
+			}
+			auto i = indices.find(triangle.get());
+			return i != indices.end() ? i->second : ResultCache::NO_NEIGHBOUR;
+		}
+	}
+
+	ResultCache::ResultCache(std::string directory, uint64_t maxSize) :
+			_directory(std::move(directory)),
+			_maxSize(maxSize)
+	{}
+
+	ResultCache::Key ResultCache::key(
+			const std::list<std::shared_ptr<delaunay::Vertex2D> >& vertices,
+			const std::string& engineParameters)
+	{
+		std::vector<HashedVertex> hashed;
+		hashed.reserve(vertices.size());
+		for (const auto& vertex : vertices) {
+			hashed.push_back({vertex->id, vertex->x, vertex->y});
+		}
+		const size_t size = hashed.size() * sizeof(HashedVertex);
+		Key result;
+		result.hash = Utils::hash(hashed.data(), size,
+				Utils::hash(engineParameters.data(), engineParameters.size(), HASH_SEED));
+		result.check = Utils::hash(hashed.data(), size,
+				Utils::hash(engineParameters.data(), engineParameters.size(), CHECK_SEED));
+		result.vertexCount = vertices.size();
+		return result;
+	}
+
+	bool ResultCache::load(
+			const Key& key,
+			const std::list<std::shared_ptr<delaunay::Vertex2D> >& vertices,
+			std::list<std::shared_ptr<delaunay::Triangle> >& triangles)
+	{
+		const std::string name = fileName(key);
+		MappedFile file;
+		bool hit = Utils::isLittleEndian()
+				&& file.open(name)
+				&& file.size() >= sizeof(ResultCacheHeader);
+		const auto* header = hit ? reinterpret_cast<const ResultCacheHeader*>(file.data()) : nullptr;
+		hit = hit
+				&& std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+				&& header->version == VERSION
+				&& header->key == key.hash
+				&& header->check == key.check
+				&& header->vertexCount == key.vertexCount
+				&& header->vertexCount == vertices.size()
+				&& header->triangleCount
+						== (file.size() - sizeof(ResultCacheHeader)) / sizeof(CachedTriangle);
+
+		// вершины по id
+		std::vector<std::shared_ptr<delaunay::Vertex2D> > byId;
+		if (hit) {
+			byId.resize(vertices.size());
+			for (const auto& vertex : vertices) {
+				if (vertex->id < 0 || static_cast<size_t>(vertex->id) >= byId.size()) {
+					hit = false;
+					break;
+				}
+				byId[static_cast<size_t>(vertex->id)] = vertex;
+			}
+		}
+		if (hit) {
+			const size_t triangleCount = static_cast<size_t>(header->triangleCount);
+			std::vector<CachedTriangle> records(triangleCount);
+			std::memcpy(records.data(), file.data() + sizeof(ResultCacheHeader),
+					triangleCount * sizeof(CachedTriangle));
+			std::vector<std::shared_ptr<delaunay::Triangle> > restored(triangleCount);
+			for (auto& triangle : restored) {
+				triangle = std::make_shared<delaunay::Triangle>();
+			}
+			auto vertex = [&byId](int32_t id) -> std::shared_ptr<delaunay::Vertex2D> {
+				return id >= 0 && static_cast<size_t>(id) < byId.size() ? byId[id] : nullptr;
+			};
+			auto neighbour = [&restored](int32_t i) -> std::shared_ptr<delaunay::Triangle> {
+				return i >= 0 && static_cast<size_t>(i) < restored.size() ? restored[i] : nullptr;
+			};
+			for (size_t i = 0; i < triangleCount && hit; i++) {
+				const CachedTriangle& record = records[i];
+				delaunay::Triangle& triangle = *restored[i];
+				triangle.id = record.id;
+				triangle.vertex1 = vertex(record.vertices[0]);
+				triangle.vertex2 = vertex(record.vertices[1]);
+				triangle.vertex3 = vertex(record.vertices[2]);
+				triangle.triangle1 = neighbour(record.neighbours[0]);
+				triangle.triangle2 = neighbour(record.neighbours[1]);
+				triangle.triangle3 = neighbour(record.neighbours[2]);
+				hit = triangle.vertex1 && triangle.vertex2 && triangle.vertex3;
+			}
+			if (hit) {
+				triangles.assign(restored.begin(), restored.end());
+			}
+		}
+		file.close();
+
+		if (!hit) {
+			_misses++;
+			return false;
+		}
+		_hits++;
+		// время модификации - время последнего использования для LRU
+		std::error_code error;
+		std::filesystem::last_write_time(
+				name, std::filesystem::file_time_type::clock::now(), error);
+		return true;
+	}
+
+	bool ResultCache::store(
+			const Key& key,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles)
+	{
+		if (!Utils::isLittleEndian()) {
+			return false;
+		}
+		ResultCacheHeader header {};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.key = key.hash;
+		header.check = key.check;
+		header.vertexCount = key.vertexCount;
+		header.triangleCount = triangles.size();
+
+		std::unordered_map<const delaunay::Triangle*, int32_t> indices;
+		indices.reserve(triangles.size());
+		for (const auto& triangle : triangles) {
+			indices.emplace(triangle.get(), static_cast<int32_t>(indices.size()));
+		}
+		std::vector<CachedTriangle> records;
+		records.reserve(triangles.size());
+		for (const auto& triangle : triangles) {
+			records.push_back({
+					triangle->id,
+					{triangle->vertex1->id, triangle->vertex2->id, triangle->vertex3->id},
+					{
+							index(indices, triangle->triangle1),
+							index(indices, triangle->triangle2),
+							index(indices, triangle->triangle3)}});
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::error_code error;
+		std::filesystem::create_directories(_directory, error);
+		const std::string name = fileName(key);
+		const std::string temporaryName = name + ".tmp";
+		{
+			std::ofstream file(temporaryName, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(
+					reinterpret_cast<const char*>(records.data()),
+					static_cast<std::streamsize>(records.size() * sizeof(CachedTriangle)));
+			file.close();
+			if (file.fail()) {
+				std::remove(temporaryName.c_str());
+				return false;
+			}
+		}
+		std::filesystem::rename(temporaryName, name, error);
+		if (error) {
+			std::remove(temporaryName.c_str());
+			return false;
+		}
+		evict();
+		return true;
+	}
+
+	uint64_t ResultCache::hits() const noexcept
+	{
+		return _hits;
+	}
+
+	uint64_t ResultCache::misses() const noexcept
+	{
+		return _misses;
+	}
+
+	std::string ResultCache::fileName(const Key& key) const
+	{
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key.hash));
+		return (std::filesystem::path(_directory) / (name + std::string(FILE_SUFFIX))).string();
+	}
+
+	void ResultCache::evict()
+	{
+		struct Entry
+		{
+			std::filesystem::path path;
+			std::filesystem::file_time_type time;
+			uint64_t size;
+		};
+		std::vector<Entry> entries;
+		uint64_t totalSize = 0;
+		std::error_code error;
+		// range-for использует бросающий operator++, поэтому обход через increment(error):
+		// файлы могут удаляться другими процессами во время обхода
+		std::filesystem::directory_iterator item(_directory, error);
+		for (const std::filesystem::directory_iterator end; !error && item != end; item.increment(error)) {
+			if (item->path().extension() != FILE_SUFFIX) {
+				continue;
+			}
+			std::error_code itemError;
+			Entry entry {item->path(), item->last_write_time(itemError), item->file_size(itemError)};
+			if (itemError) {
+				continue;
+			}
+			totalSize += entry.size;
+			entries.push_back(std::move(entry));
+		}
+		if (totalSize <= _maxSize) {
+			return;
+		}
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+			return a.time < b.time;
+		});
+		for (const auto& entry : entries) {
+			if (totalSize <= _maxSize) {
+				break;
+			}
+			std::error_code removeError;
+			if (std::filesystem::remove(entry.path, removeError)) {
+				totalSize -= entry.size;
+			}
+		}
+	}
+}
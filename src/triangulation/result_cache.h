@@ -0,0 +1,130 @@
+#ifndef TRIANGULATION_RESULT_CACHE_H
+#define TRIANGULATION_RESULT_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+namespace delaunay
+{
+	struct Triangle;
+	struct Vertex2D;
+}
+
+namespace triangulation
+{
+	/**
+	 * Заголовок файла результата в кэше. Все значения little-endian. За заголовком
+	 * следуют CachedTriangle[triangleCount].
+	 */
+	struct ResultCacheHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+		uint64_t key;
+		uint64_t check;
+		uint64_t vertexCount;
+		uint64_t triangleCount;
+		uint8_t reserved[16];
+	};
+	static_assert(sizeof(ResultCacheHeader) == 64, "Unexpected result cache header size");
+
+	struct CachedTriangle
+	{
+		int32_t id;
+		int32_t vertices[3];	// id вершин (плотные индексы)
+		int32_t neighbours[3];	// индексы соседних треугольников в файле или -1
+	};
+	static_assert(sizeof(CachedTriangle) == 28, "Unexpected cached triangle size");
+
+	/**
+	 * Локальный кэш результатов триангуляции на диске. Ключ - хэш проекций вершин
+	 * (id, x, y в порядке обработки) и параметров алгоритма, поэтому одинаковые
+	 * наборы точек триангулируются один раз.
+	 *
+	 * Каждый результат хранится в отдельном файле <ключ>.result. Время модификации
+	 * файла обновляется при каждом попадании, и при превышении maxSize удаляются
+	 * давно не использованные результаты (LRU).
+	 *
+	 * Методы можно вызывать из нескольких потоков.
+	 */
+	class ResultCache
+	{
+	public:
+		static const char MAGIC[8];
+		static constexpr uint32_t VERSION = 1;
+		static const char* const FILE_SUFFIX;
+		static constexpr int32_t NO_NEIGHBOUR = -1;
+
+		struct Key
+		{
+			uint64_t hash = 0;
+			// второй хэш с другим начальным значением для проверки совпадения
+			uint64_t check = 0;
+			uint64_t vertexCount = 0;
+		};
+
+	private:
+		std::string _directory;
+		uint64_t _maxSize = 0;
+		std::mutex _mutex;
+		std::atomic<uint64_t> _hits {0};
+		std::atomic<uint64_t> _misses {0};
+
+	public:
+		/**
+		 * @param directory - каталог кэша, создаётся при первой записи
+		 * @param maxSize - максимальный суммарный размер файлов кэша в байтах
+		 */
+		ResultCache(std::string directory, uint64_t maxSize);
+		~ResultCache() = default;
+		ResultCache(const ResultCache&) = delete;
+		ResultCache(ResultCache&&) = delete;
+		ResultCache & operator=(const ResultCache&) = delete;
+		ResultCache & operator=(ResultCache&&) = delete;
+
+		/**
+		 * @param vertices - проекции вершин в порядке обработки
+		 * @param engineParameters - описание алгоритма и его параметров
+		 * @return
+		 */
+		[[nodiscard]] static Key key(
+				const std::list<std::shared_ptr<delaunay::Vertex2D> >& vertices,
+				const std::string& engineParameters);
+
+		/**
+		 * Восстанавливает треугольники с соседями из кэша. Вершины треугольников
+		 * берутся из vertices, id которых должны быть плотными индексами.
+		 * @param key
+		 * @param vertices
+		 * @param triangles - заполняется при попадании
+		 * @return true при попадании в кэш
+		 */
+		bool load(
+				const Key& key,
+				const std::list<std::shared_ptr<delaunay::Vertex2D> >& vertices,
+				std::list<std::shared_ptr<delaunay::Triangle> >& triangles);
+
+		/**
+		 * Сохраняет результат и удаляет давно не использованные результаты, если
+		 * размер кэша превышает maxSize
+		 * @return false если результат не удалось записать
+		 */
+		bool store(const Key& key, const std::list<std::shared_ptr<delaunay::Triangle> >& triangles);
+
+		[[nodiscard]] uint64_t hits() const noexcept;
+		[[nodiscard]] uint64_t misses() const noexcept;
+
+	private:
+		[[nodiscard]] std::string fileName(const Key& key) const;
+		void evict();
+
+	};
+}
+
+#endif //TRIANGULATION_RESULT_CACHE_H
@@ -0,0 +1,65 @@
+#include "spherical_projection.h"
+
+#include "surface_fit.h"
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace triangulation
+{
+	bool SphericalProjection::needsFit() const noexcept
+	{
+		return true;
+	}
+
+	void SphericalProjection::fit(const Vertex3D* vertices, size_t count)
+	{
+		const PrincipalAxes axes = SurfaceFit::principalAxes(vertices, count);
+		double radius;
+		if (!SurfaceFit::fitSphere(vertices, count, _center, radius)) {
+			std::copy(axes.center, axes.center + 3, _center);
+			radius = std::sqrt(axes.variances[0] + axes.variances[1] + axes.variances[2]);
+		}
+		_radius = radius > 0.0 ? radius : 1.0;
+
+		for (int k = 0; k < 3; k++) {
+			_front[k] = axes.center[k] - _center[k];
+		}
+		if (!SurfaceFit::normalize(_front)) {
+			std::copy(axes.axes[2], axes.axes[2] + 3, _front);
+		}
+		// восток - главная ось с наибольшим разбросом, перпендикулярная _front
+		for (const double* axis : {axes.axes[0], axes.axes[1], axes.axes[2]}) {
+			const double projection = SurfaceFit::dot(axis, _front);
+			for (int k = 0; k < 3; k++) {
+				_east[k] = axis[k] - projection * _front[k];
+			}
+			if (SurfaceFit::normalize(_east)) {
+				break;
+			}
+		}
+		SurfaceFit::cross(_front, _east, _north);
+	}
+
+	void SphericalProjection::project(
+			const Vertex3D* vertices,
+			size_t count,
+			delaunay::Vertex2D* result) const noexcept
+	{
+		for (size_t i = 0; i < count; i++) {
+			const double d[3] = {
+					vertices[i].x - _center[0],
+					vertices[i].y - _center[1],
+					vertices[i].z - _center[2]};
+			const double front = SurfaceFit::dot(d, _front);
+			const double east = SurfaceFit::dot(d, _east);
+			const double north = SurfaceFit::dot(d, _north);
+			const double length = std::sqrt(front * front + east * east + north * north);
+			const double latitude = length > 0.0 ? std::asin(std::clamp(north / length, -1.0, 1.0)) : 0.0;
+			result[i].x = static_cast<float>(_radius * std::atan2(east, front));
+			result[i].y = static_cast<float>(_radius * latitude);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef TRIANGULATION_SPHERICAL_PROJECTION_H
+#define TRIANGULATION_SPHERICAL_PROJECTION_H
+
+#include "projection_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Развёртка сферы. Сфера подбирается методом наименьших квадратов, направление
+	 * из центра на середину облака вершин отображается в начало координат, поэтому
+	 * особые точки развёртки (полюса и шов) находятся вдали от вершин сегмента сферы.
+	 * Координаты - долгота и широта, умноженные на радиус.
+	 */
+	class SphericalProjection : public IProjection
+	{
+	private:
+		double _center[3] = {0.0, 0.0, 0.0};
+		// направление на середину облака вершин (нулевые долгота и широта), на
+		// восток и на север
+		double _front[3] = {1.0, 0.0, 0.0};
+		double _east[3] = {0.0, 1.0, 0.0};
+		double _north[3] = {0.0, 0.0, 1.0};
+		double _radius = 1.0;
+
+	public:
+		SphericalProjection() = default;
+		SphericalProjection(const SphericalProjection&) = delete;
+		SphericalProjection(SphericalProjection&&) = delete;
+		SphericalProjection& operator=(const SphericalProjection&) = delete;
+		SphericalProjection& operator=(SphericalProjection&&) = delete;
+
+		[[nodiscard]] bool needsFit() const noexcept final;
+
+		void fit(const Vertex3D* vertices, size_t count) final;
+
+		void project(
+				const Vertex3D* vertices,
+				size_t count,
+				delaunay::Vertex2D* result) const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_SPHERICAL_PROJECTION_H
@@ -0,0 +1,98 @@
+#include "stl_writer.h"
+
+#include "output_buffer.h"
+#include "utils.h"
+#include "vertex_index.h"
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <cmath>
+#include <cstring>
+
+
+namespace triangulation
+{
+	// размер заголовка бинарного STL
+	static const size_t STL_HEADER_SIZE = 80;
+
+	namespace
+	{
+		void appendVertex(OutputBuffer& output, const Vertex3D& vertex)
+		{
+			output.appendValue(vertex.x);
+			output.appendValue(vertex.y);
+			output.appendValue(vertex.z);
+		}
+
+		/**
+		 * Добавляет единичную нормаль треугольника a, b, c (нулевую для вырожденного)
+		 */
+		void appendNormal(OutputBuffer& output, const Vertex3D& a, const Vertex3D& b, const Vertex3D& c)
+		{
+			const float ux = b.x - a.x;
+			const float uy = b.y - a.y;
+			const float uz = b.z - a.z;
+			const float vx = c.x - a.x;
+			const float vy = c.y - a.y;
+			const float vz = c.z - a.z;
+			float nx = uy * vz - uz * vy;
+			float ny = uz * vx - ux * vz;
+			float nz = ux * vy - uy * vx;
+			const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+			if (length > 0.0f) {
+				nx /= length;
+				ny /= length;
+				nz /= length;
+			}
+			output.appendValue(nx);
+			output.appendValue(ny);
+			output.appendValue(nz);
+		}
+	}
+
+	StlWriter::StlWriter() : IFileWriter()
+	{}
+
+	bool StlWriter::writeStream(
+			std::ostream& stream,
+			const std::vector<Vertex3D>& coordinates,
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+			const std::vector<bool>& usedVertices)
+	{
+		if (!Utils::isLittleEndian()) {
+			return false;
+		}
+		const VertexIndex vertexIndex(usedVertices);
+		const std::vector<size_t>& positions = vertexIndex.positions();
+		// число треугольников записывается в заголовок, поэтому индексы проверяются заранее
+		if (!vertexIndex.indexesAll(triangles)) {
+			return false;
+		}
+
+		OutputBuffer output(stream);
+		char header[STL_HEADER_SIZE] = {};
+		std::strncpy(header, "DelaunayTriangulation", STL_HEADER_SIZE);
+		output.append(header, STL_HEADER_SIZE);
+		output.appendValue(static_cast<uint32_t>(triangles.size()));
+
+		for (const auto& triangle : triangles) {
+			const int32_t index1 = vertexIndex.index(triangle->vertex1->id);
+			const int32_t index2 = vertexIndex.index(triangle->vertex2->id);
+			const int32_t index3 = vertexIndex.index(triangle->vertex3->id);
+			const Vertex3D& a = coordinates[positions[index1]];
+			const Vertex3D& b = coordinates[positions[index3]];
+			const Vertex3D& c = coordinates[positions[index2]];
+			appendNormal(output, a, b, c);
+			appendVertex(output, a);
+			appendVertex(output, b);
+			appendVertex(output, c);
+			output.appendValue(static_cast<uint16_t>(0));
+		}
+		return output.flush();
+	}
+
+	bool StlWriter::isBinary() const noexcept
+	{
+		return true;
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef TRIANGULATION_STL_WRITER_H
+#define TRIANGULATION_STL_WRITER_H
+
+#include "file_writer_interface.h"
+
+
+namespace triangulation
+{
+	/**
+	 * Записывает сетку в бинарном формате STL: заголовок 80 байт, количество
+	 * треугольников и по 50 байт на треугольник (нормаль, три вершины, атрибут).
+	 * Треугольники ориентированы против часовой стрелки в плоскости проекции (вершины
+	 * треугольника в порядке 1, 3, 2), как принято в сторонних программах; в
+	 * собственных форматах сохраняется порядок обхода по часовой стрелке.
+	 */
+	class StlWriter : public IFileWriter
+	{
+	public:
+		StlWriter();
+		StlWriter(const StlWriter&) = delete;
+		StlWriter(StlWriter&&) = delete;
+		StlWriter& operator=(const StlWriter&) = delete;
+		StlWriter& operator=(StlWriter&&) = delete;
+
+		bool writeStream(
+				std::ostream& stream,
+				const std::vector<Vertex3D>& coordinates,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles,
+				const std::vector<bool>& usedVertices) final;
+
+		[[nodiscard]] bool isBinary() const noexcept final;
+
+	};
+}
+
+#endif //TRIANGULATION_STL_WRITER_H
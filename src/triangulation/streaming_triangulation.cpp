@@ -0,0 +1,212 @@
+#include "streaming_triangulation.h"
+
+#include "coordinates_file_parser.h"
+#include "default_writer.h"
+#include "output_buffer.h"
+#include "projection_interface.h"
+#include "vertex_3d.h"
+#include <delaunay/streaming_service.h>
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <sstream>
+
+
+namespace triangulation
+{
+	const char* const StreamingTriangulation::GRID_TAG = "*Grid";
+	const char* const StreamingTriangulation::FINALIZE_TAG = "*Finalize";
+	const char* const StreamingTriangulation::ELEMENTS_FILE_SUFFIX = ".elements";
+
+	// Окончательные треугольники ищутся перебором фронта, поэтому перебор
+	// запускается, когда фронт вырос вдвое с прошлого раза, но не меньше, чем
+	// до MIN_RELEASE_COUNT треугольников
+	static const size_t MIN_RELEASE_COUNT = 1 << 12;
+
+	namespace
+	{
+		/**
+		 * Проверяет, что строка начинается с тега, и возвращает остаток строки
+		 */
+		bool parseTag(const std::string& line, const char* tag, std::istringstream& arguments)
+		{
+			const size_t length = std::strlen(tag);
+			if (line.compare(0, length, tag) != 0
+					|| (line.size() > length && line[length] != ' ' && line[length] != '\t')) {
+				return false;
+			}
+			arguments.str(line.substr(length));
+			return true;
+		}
+
+		void writeTriangles(
+				OutputBuffer& output,
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles)
+		{
+			for (const auto& triangle : triangles) {
+				DefaultWriter::appendElement(
+						output,
+						triangle->id,
+						triangle->vertex1->id,
+						triangle->vertex2->id,
+						triangle->vertex3->id);
+			}
+		}
+	}
+
+	StreamingTriangulation::StreamingTriangulation(const IProjection& projection)
+		: _projection(projection)
+	{}
+
+	bool StreamingTriangulation::process(std::istream& input, const std::string& outputFileName)
+	{
+		std::ofstream output(outputFileName, std::ios::out | std::ios::trunc);
+		if (!output.is_open()) {
+			return false;
+		}
+		const std::string elementsFileName = outputFileName + ELEMENTS_FILE_SUFFIX;
+		bool ok;
+		{
+			std::ofstream elements(elementsFileName, std::ios::out | std::ios::trunc);
+			ok = elements.is_open() && process(input, output, elements);
+			ok = elements.flush() && ok;
+		}
+		if (ok) {
+			output << DefaultWriter::ELEMENTS_HEADER;
+			std::ifstream elements(elementsFileName, std::ios::in);
+			// пустой поток при выводе rdbuf() выставляет failbit
+			if (elements.peek() != std::ifstream::traits_type::eof()) {
+				output << elements.rdbuf();
+			}
+		}
+		std::remove(elementsFileName.c_str());
+		return ok && output.flush();
+	}
+
+	size_t StreamingTriangulation::vertexCount() const noexcept
+	{
+		return _vertexCount;
+	}
+
+	size_t StreamingTriangulation::triangleCount() const noexcept
+	{
+		return _triangleCount;
+	}
+
+	size_t StreamingTriangulation::maxActiveTriangleCount() const noexcept
+	{
+		return _maxActiveTriangleCount;
+	}
+
+	size_t StreamingTriangulation::invalidLineCount() const noexcept
+	{
+		return _invalidLineCount;
+	}
+
+	bool StreamingTriangulation::process(std::istream& input, std::ostream& nodes, std::ostream& elements)
+	{
+		_vertexCount = 0;
+		_triangleCount = 0;
+		_maxActiveTriangleCount = 0;
+		_invalidLineCount = 0;
+
+		OutputBuffer nodeOutput(nodes);
+		OutputBuffer elementOutput(elements);
+		nodeOutput.append(DefaultWriter::NODES_HEADER);
+
+		std::unique_ptr<delaunay::StreamingService> service;
+		std::list<std::shared_ptr<delaunay::Vertex2D> > batch;
+		size_t releaseCount = MIN_RELEASE_COUNT;
+		auto insertBatch = [&]() {
+			const bool ok = service->insertVertices(batch);
+			batch.clear();
+			// у вершин потока id - внешние номера
+			writeSkippedVertices(std::cout, service->skippedVertices());
+			_maxActiveTriangleCount = std::max(_maxActiveTriangleCount, service->activeTriangleCount());
+			return ok;
+		};
+
+		std::string line;
+		size_t lineNumber = 0;
+		while (std::getline(input, line)) {
+			lineNumber++;
+			Vertex3D vertex;
+			std::istringstream arguments;
+			if (CoordinatesFileParser::parseVertex(line.data(), line.data() + line.size(), vertex)) {
+				if (!service) {
+					std::cout << "There is no " << GRID_TAG << " tag before the first vertex (line "
+							<< lineNumber << ")." << std::endl;
+					return false;
+				}
+				auto projected = std::make_shared<delaunay::Vertex2D>();
+				_projection.project(&vertex, 1, projected.get());
+				projected->id = vertex.id;
+				// пропущенные вершины не попадают в раздел узлов
+				if (service->accepts(*projected)) {
+					DefaultWriter::appendNode(nodeOutput, vertex);
+				}
+				batch.push_back(projected);
+				_vertexCount++;
+			}
+			else if (parseTag(line, GRID_TAG, arguments)) {
+				float minX, minY, maxX, maxY;
+				int columns, rows;
+				if (service || !(arguments >> minX >> minY >> maxX >> maxY >> columns >> rows)) {
+					std::cout << "Invalid " << GRID_TAG << " tag (line " << lineNumber << ")." << std::endl;
+					return false;
+				}
+				service = std::make_unique<delaunay::StreamingService>(minX, minY, maxX, maxY, columns, rows);
+				if (!service->isValid()) {
+					std::cout << "Invalid " << GRID_TAG << " tag (line " << lineNumber << ")." << std::endl;
+					return false;
+				}
+			}
+			else if (parseTag(line, FINALIZE_TAG, arguments)) {
+				int column, row;
+				if (!service || !(arguments >> column >> row)) {
+					std::cout << "Invalid " << FINALIZE_TAG << " tag (line " << lineNumber << ")." << std::endl;
+					return false;
+				}
+				if (!insertBatch()) {
+					return false;
+				}
+				if (!service->finalizeCell(column, row)) {
+					std::cout << "Invalid " << FINALIZE_TAG << " tag (line " << lineNumber << ")." << std::endl;
+					return false;
+				}
+				if (service->activeTriangleCount() >= releaseCount) {
+					const std::list<std::shared_ptr<delaunay::Triangle> > released = service->releaseFinalizedTriangles();
+					writeTriangles(elementOutput, released);
+					_triangleCount += released.size();
+					releaseCount = std::max(MIN_RELEASE_COUNT, 2 * service->activeTriangleCount());
+				}
+			}
+			else {
+				const size_t begin = line.find_first_not_of(" \t\r");
+				if (begin != std::string::npos && line[begin] != '*') {
+					_invalidLineCount++;
+				}
+			}
+		}
+		if (input.bad()) {
+			return false;
+		}
+		if (service) {
+			if (!insertBatch()) {
+				return false;
+			}
+			const std::list<std::shared_ptr<delaunay::Triangle> > released = service->releaseAllTriangles();
+			writeTriangles(elementOutput, released);
+			_triangleCount += released.size();
+		}
+		const bool ok = nodeOutput.flush();
+		return elementOutput.flush() && ok;
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef TRIANGULATION_STREAMING_TRIANGULATION_H
+#define TRIANGULATION_STREAMING_TRIANGULATION_H
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+
+
+namespace triangulation
+{
+	class IProjection;
+
+	/**
+	 * Потоковая триангуляция файла, который не помещается в память (см.
+	 * delaunay::StreamingService). Вход - строки "N, X, Y, Z", упорядоченные по
+	 * ячейкам сетки, и теги в строках комментариев:
+	 * - "*Grid minX minY maxX maxY columns rows" - область и сетка в плоскости
+	 *   проекции, до первой вершины;
+	 * - "*Finalize column row" - после последней вершины ячейки.
+	 * Для обычного разбора теги остаются комментариями, поэтому тот же файл можно
+	 * триангулировать и целиком.
+	 *
+	 * Результат записывается в формате DefaultWriter: узлы по мере чтения, элементы
+	 * по мере освобождения окончательных треугольников во временный файл, который
+	 * в конце дописывается к выходному. В памяти хранится только фронт триангуляции.
+	 */
+	class StreamingTriangulation
+	{
+	public:
+		static const char* const GRID_TAG;
+		static const char* const FINALIZE_TAG;
+		static const char* const ELEMENTS_FILE_SUFFIX;
+
+	private:
+		const IProjection& _projection;
+		size_t _vertexCount = 0;
+		size_t _triangleCount = 0;
+		size_t _maxActiveTriangleCount = 0;
+		size_t _invalidLineCount = 0;
+
+	public:
+		/**
+		 * @param projection - проекция, для которой не нужен fit()
+		 */
+		explicit StreamingTriangulation(const IProjection& projection);
+		~StreamingTriangulation() = default;
+		StreamingTriangulation(const StreamingTriangulation&) = delete;
+		StreamingTriangulation(StreamingTriangulation&&) = delete;
+		StreamingTriangulation & operator=(const StreamingTriangulation&) = delete;
+		StreamingTriangulation & operator=(StreamingTriangulation&&) = delete;
+
+		/**
+		 * Триангулирует вход и записывает результат в файл outputFileName. Рядом с
+		 * ним на время работы создаётся файл outputFileName + ELEMENTS_FILE_SUFFIX.
+		 * @param input
+		 * @param outputFileName
+		 * @return false при ошибке чтения тегов или записи
+		 */
+		bool process(std::istream& input, const std::string& outputFileName);
+
+		[[nodiscard]] size_t vertexCount() const noexcept;
+		[[nodiscard]] size_t triangleCount() const noexcept;
+		/**
+		 * Наибольшее количество треугольников, одновременно хранившихся в памяти
+		 */
+		[[nodiscard]] size_t maxActiveTriangleCount() const noexcept;
+		[[nodiscard]] size_t invalidLineCount() const noexcept;
+
+	private:
+		bool process(std::istream& input, std::ostream& nodes, std::ostream& elements);
+
+	};
+}
+
+#endif //TRIANGULATION_STREAMING_TRIANGULATION_H
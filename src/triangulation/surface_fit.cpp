@@ -0,0 +1,251 @@
+#include "surface_fit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+namespace triangulation
+{
+	namespace
+	{
+		// относительная точность, ниже которой система или вектор считаются вырожденными
+		const double DEGENERATE_EPSILON = 1e-12;
+		const int MAX_JACOBI_SWEEPS = 50;
+	}
+
+	PrincipalAxes SurfaceFit::principalAxes(const Vertex3D* vertices, size_t count)
+	{
+		PrincipalAxes result;
+		if (count == 0) {
+			return result;
+		}
+		for (size_t i = 0; i < count; i++) {
+			result.center[0] += vertices[i].x;
+			result.center[1] += vertices[i].y;
+			result.center[2] += vertices[i].z;
+		}
+		for (double& value : result.center) {
+			value /= static_cast<double>(count);
+		}
+
+		double covariance[3][3] = {};
+		for (size_t i = 0; i < count; i++) {
+			const double d[3] = {
+					vertices[i].x - result.center[0],
+					vertices[i].y - result.center[1],
+					vertices[i].z - result.center[2]};
+			for (int p = 0; p < 3; p++) {
+				for (int q = p; q < 3; q++) {
+					covariance[p][q] += d[p] * d[q];
+				}
+			}
+		}
+		for (int p = 0; p < 3; p++) {
+			for (int q = p; q < 3; q++) {
+				covariance[p][q] /= static_cast<double>(count);
+				covariance[q][p] = covariance[p][q];
+			}
+		}
+
+		// собственные векторы симметричной матрицы 3x3 методом вращений Якоби
+		double vectors[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+		const double scale = std::abs(covariance[0][0]) + std::abs(covariance[1][1]) + std::abs(covariance[2][2]);
+		for (int sweep = 0; sweep < MAX_JACOBI_SWEEPS; sweep++) {
+			const double offDiagonal = std::abs(covariance[0][1])
+					+ std::abs(covariance[0][2])
+					+ std::abs(covariance[1][2]);
+			if (offDiagonal <= DEGENERATE_EPSILON * scale) {
+				break;
+			}
+			for (int p = 0; p < 2; p++) {
+				for (int q = p + 1; q < 3; q++) {
+					if (covariance[p][q] == 0.0) {
+						continue;
+					}
+					const double theta = (covariance[q][q] - covariance[p][p]) / (2.0 * covariance[p][q]);
+					const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+					const double c = 1.0 / std::sqrt(t * t + 1.0);
+					const double s = t * c;
+					for (int k = 0; k < 3; k++) {
+						const double kp = covariance[k][p];
+						const double kq = covariance[k][q];
+						covariance[k][p] = c * kp - s * kq;
+						covariance[k][q] = s * kp + c * kq;
+					}
+					for (int k = 0; k < 3; k++) {
+						const double pk = covariance[p][k];
+						const double qk = covariance[q][k];
+						covariance[p][k] = c * pk - s * qk;
+						covariance[q][k] = s * pk + c * qk;
+					}
+					for (auto& vector : vectors) {
+						const double kp = vector[p];
+						const double kq = vector[q];
+						vector[p] = c * kp - s * kq;
+						vector[q] = s * kp + c * kq;
+					}
+				}
+			}
+		}
+
+		int order[3] = {0, 1, 2};
+		std::sort(order, order + 3, [&covariance](int a, int b) {
+			return covariance[a][a] > covariance[b][b];
+		});
+		for (int i = 0; i < 3; i++) {
+			result.variances[i] = std::max(covariance[order[i]][order[i]], 0.0);
+			for (int k = 0; k < 3; k++) {
+				result.axes[i][k] = vectors[k][order[i]];
+			}
+		}
+		// правая тройка осей
+		cross(result.axes[0], result.axes[1], result.axes[2]);
+		return result;
+	}
+
+	bool SurfaceFit::fitCircle(
+			const Vertex3D* vertices,
+			size_t count,
+			const double origin[3],
+			const double axisX[3],
+			const double axisY[3],
+			double& centerX,
+			double& centerY,
+			double& radius)
+	{
+		// s^2 + t^2 = 2 * a * s + 2 * b * t + c, где c = r^2 - a^2 - b^2
+		double matrix[3][3] = {};
+		double vector[3] = {};
+		for (size_t i = 0; i < count; i++) {
+			const double d[3] = {
+					vertices[i].x - origin[0],
+					vertices[i].y - origin[1],
+					vertices[i].z - origin[2]};
+			const double row[3] = {2.0 * dot(d, axisX), 2.0 * dot(d, axisY), 1.0};
+			const double value = row[0] * row[0] / 4.0 + row[1] * row[1] / 4.0;
+			for (int p = 0; p < 3; p++) {
+				for (int q = 0; q < 3; q++) {
+					matrix[p][q] += row[p] * row[q];
+				}
+				vector[p] += row[p] * value;
+			}
+		}
+		if (count < 3 || !solve(&matrix[0][0], vector, 3)) {
+			return false;
+		}
+		const double squaredRadius = vector[2] + vector[0] * vector[0] + vector[1] * vector[1];
+		if (squaredRadius <= 0.0) {
+			return false;
+		}
+		centerX = vector[0];
+		centerY = vector[1];
+		radius = std::sqrt(squaredRadius);
+		return true;
+	}
+
+	bool SurfaceFit::fitSphere(
+			const Vertex3D* vertices,
+			size_t count,
+			double center[3],
+			double& radius)
+	{
+		const PrincipalAxes axes = principalAxes(vertices, count);
+		// |d|^2 = 2 * a . d + c относительно центра масс, c = r^2 - |a|^2
+		double matrix[4][4] = {};
+		double vector[4] = {};
+		for (size_t i = 0; i < count; i++) {
+			const double d[3] = {
+					vertices[i].x - axes.center[0],
+					vertices[i].y - axes.center[1],
+					vertices[i].z - axes.center[2]};
+			const double row[4] = {2.0 * d[0], 2.0 * d[1], 2.0 * d[2], 1.0};
+			const double value = dot(d, d);
+			for (int p = 0; p < 4; p++) {
+				for (int q = 0; q < 4; q++) {
+					matrix[p][q] += row[p] * row[q];
+				}
+				vector[p] += row[p] * value;
+			}
+		}
+		if (count < 4 || !solve(&matrix[0][0], vector, 4)) {
+			return false;
+		}
+		const double squaredRadius = vector[3] + dot(vector, vector);
+		if (squaredRadius <= 0.0) {
+			return false;
+		}
+		for (int k = 0; k < 3; k++) {
+			center[k] = axes.center[k] + vector[k];
+		}
+		radius = std::sqrt(squaredRadius);
+		return true;
+	}
+
+	double SurfaceFit::dot(const double a[3], const double b[3]) noexcept
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	void SurfaceFit::cross(const double a[3], const double b[3], double result[3]) noexcept
+	{
+		const double x = a[1] * b[2] - a[2] * b[1];
+		const double y = a[2] * b[0] - a[0] * b[2];
+		const double z = a[0] * b[1] - a[1] * b[0];
+		result[0] = x;
+		result[1] = y;
+		result[2] = z;
+	}
+
+	bool SurfaceFit::normalize(double vector[3]) noexcept
+	{
+		const double length = std::sqrt(dot(vector, vector));
+		if (length <= DEGENERATE_EPSILON) {
+			return false;
+		}
+		for (int k = 0; k < 3; k++) {
+			vector[k] /= length;
+		}
+		return true;
+	}
+
+	bool SurfaceFit::solve(double* matrix, double* vector, int n) noexcept
+	{
+		double scale = 0.0;
+		for (int i = 0; i < n * n; i++) {
+			scale = std::max(scale, std::abs(matrix[i]));
+		}
+		for (int column = 0; column < n; column++) {
+			int pivot = column;
+			for (int row = column + 1; row < n; row++) {
+				if (std::abs(matrix[row * n + column]) > std::abs(matrix[pivot * n + column])) {
+					pivot = row;
+				}
+			}
+			if (std::abs(matrix[pivot * n + column]) <= DEGENERATE_EPSILON * scale) {
+				return false;
+			}
+			if (pivot != column) {
+				for (int k = 0; k < n; k++) {
+					std::swap(matrix[pivot * n + k], matrix[column * n + k]);
+				}
+				std::swap(vector[pivot], vector[column]);
+			}
+			for (int row = column + 1; row < n; row++) {
+				const double factor = matrix[row * n + column] / matrix[column * n + column];
+				for (int k = column; k < n; k++) {
+					matrix[row * n + k] -= factor * matrix[column * n + k];
+				}
+				vector[row] -= factor * vector[column];
+			}
+		}
+		for (int row = n - 1; row >= 0; row--) {
+			double value = vector[row];
+			for (int k = row + 1; k < n; k++) {
+				value -= matrix[row * n + k] * vector[k];
+			}
+			vector[row] = value / matrix[row * n + row];
+		}
+		return true;
+	}
+}
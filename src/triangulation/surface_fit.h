@@ -0,0 +1,81 @@
+#ifndef TRIANGULATION_SURFACE_FIT_H
+#define TRIANGULATION_SURFACE_FIT_H
+
+#include "vertex_3d.h"
+
+#include <cstddef>
+
+
+namespace triangulation
+{
+	/**
+	 * Главные оси облака вершин: центр масс и собственные векторы матрицы ковариации,
+	 * упорядоченные по убыванию разброса (дисперсии) вдоль них
+	 */
+	struct PrincipalAxes
+	{
+		double center[3] = {0.0, 0.0, 0.0};
+		double axes[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+		double variances[3] = {0.0, 0.0, 0.0};
+	};
+
+	/**
+	 * Подбор простых поверхностей по облаку вершин для проекций IProjection
+	 */
+	class SurfaceFit
+	{
+	public:
+		SurfaceFit() = delete;
+		~SurfaceFit() = delete;
+		SurfaceFit(const SurfaceFit&) = delete;
+		SurfaceFit(SurfaceFit&&) = delete;
+		SurfaceFit & operator=(const SurfaceFit&) = delete;
+		SurfaceFit & operator=(SurfaceFit&&) = delete;
+
+		static PrincipalAxes principalAxes(const Vertex3D* vertices, size_t count);
+
+		/**
+		 * Окружность, наилучшим образом (по методу наименьших квадратов)
+		 * приближающая проекции вершин на плоскость origin + s * axisX + t * axisY
+		 * @param centerX, centerY - центр окружности в координатах s, t
+		 * @return false если вершины вырождены (например, лежат на одной прямой)
+		 */
+		static bool fitCircle(
+				const Vertex3D* vertices,
+				size_t count,
+				const double origin[3],
+				const double axisX[3],
+				const double axisY[3],
+				double& centerX,
+				double& centerY,
+				double& radius);
+
+		/**
+		 * Сфера, наилучшим образом (по методу наименьших квадратов) приближающая
+		 * вершины
+		 * @return false если вершины вырождены (например, лежат в одной плоскости)
+		 */
+		static bool fitSphere(
+				const Vertex3D* vertices,
+				size_t count,
+				double center[3],
+				double& radius);
+
+		static double dot(const double a[3], const double b[3]) noexcept;
+		static void cross(const double a[3], const double b[3], double result[3]) noexcept;
+		/**
+		 * @return false если длина вектора близка к нулю, vector при этом не меняется
+		 */
+		static bool normalize(double vector[3]) noexcept;
+
+	private:
+		/**
+		 * Решает систему matrix * x = vector (n x n) методом Гаусса, результат
+		 * записывается в vector
+		 */
+		static bool solve(double* matrix, double* vector, int n) noexcept;
+
+	};
+}
+
+#endif //TRIANGULATION_SURFACE_FIT_H
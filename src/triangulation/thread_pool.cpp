@@ -0,0 +1,66 @@
+#include "thread_pool.h"
+
+
+namespace triangulation
+{
+	ThreadPool::ThreadPool(size_t threadCount)
+	{
+		if (threadCount == 0) {
+			threadCount = defaultThreadCount();
+		}
+		_threads.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; i++) {
+			_threads.emplace_back(&ThreadPool::run, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopped = true;
+		}
+		_condition.notify_all();
+		for (auto& thread : _threads) {
+			thread.join();
+		}
+	}
+
+	size_t ThreadPool::size() const noexcept
+	{
+		return _threads.size();
+	}
+
+	size_t ThreadPool::defaultThreadCount() noexcept
+	{
+		const unsigned int count = std::thread::hardware_concurrency();
+		return count > 0 ? count : 1;
+	}
+
+	void ThreadPool::enqueue(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_tasks.push(std::move(task));
+		}
+		_condition.notify_one();
+	}
+
+	void ThreadPool::run()
+	{
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_condition.wait(lock, [this]() { return _stopped || !_tasks.empty(); });
+				// Перед остановкой выполняются все уже добавленные задачи
+				if (_tasks.empty()) {
+					return;
+				}
+				task = std::move(_tasks.front());
+				_tasks.pop();
+			}
+			task();
+		}
+	}
+}
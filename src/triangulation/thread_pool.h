@@ -0,0 +1,65 @@
+#ifndef TRIANGULATION_THREAD_POOL_H
+#define TRIANGULATION_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+
+namespace triangulation
+{
+	/**
+	 * Пул потоков с общей очередью задач. Задачи выполняются в порядке добавления,
+	 * результат каждой задачи доступен через std::future.
+	 */
+	class ThreadPool
+	{
+	private:
+		std::vector<std::thread> _threads;
+		std::queue<std::function<void()> > _tasks;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		bool _stopped = false;
+
+	public:
+		/**
+		 * @param threadCount - количество потоков, 0 - по количеству ядер
+		 */
+		explicit ThreadPool(size_t threadCount = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool & operator=(const ThreadPool&) = delete;
+		ThreadPool & operator=(ThreadPool&&) = delete;
+
+		[[nodiscard]] size_t size() const noexcept;
+
+		template<typename Task>
+		auto submit(Task&& task) -> std::future<decltype(task())>
+		{
+			using Result = decltype(task());
+			auto packagedTask = std::make_shared<std::packaged_task<Result()> >(
+					std::forward<Task>(task));
+			std::future<Result> result = packagedTask->get_future();
+			enqueue([packagedTask]() { (*packagedTask)(); });
+			return result;
+		}
+
+		/**
+		 * Количество потоков по умолчанию - по количеству ядер, но не меньше одного
+		 */
+		static size_t defaultThreadCount() noexcept;
+
+	private:
+		void enqueue(std::function<void()> task);
+		void run();
+
+	};
+}
+
+#endif //TRIANGULATION_THREAD_POOL_H
@@ -0,0 +1,352 @@
+#include "tiled_triangulation.h"
+
+#include "coordinates_file_parser.h"
+#include "default_writer.h"
+#include "output_buffer.h"
+#include "projection_interface.h"
+#include "thread_pool.h"
+#include "vertex_3d.h"
+#include <delaunay/skipped_vertex.h>
+#include <delaunay/tiling_service.h>
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+namespace triangulation
+{
+	const char* const TiledTriangulation::POINTS_FILE_SUFFIX = ".points";
+	const char* const TiledTriangulation::REGION_FILE_SUFFIX = ".region";
+	const char* const TiledTriangulation::ELEMENTS_FILE_SUFFIX = ".elements";
+
+	// поле тайла по умолчанию в средних расстояниях между вершинами
+	static const double DEFAULT_MARGIN_SPACINGS = 8.0;
+
+	namespace
+	{
+		/**
+		 * Вершина во временных файлах
+		 */
+		struct PointRecord
+		{
+			int32_t id;
+			float x;
+			float y;
+		};
+
+		/**
+		 * Треугольник во временных файлах
+		 */
+		struct ElementRecord
+		{
+			int32_t vertices[3];
+		};
+
+		struct RegionResult
+		{
+			bool ok = false;
+			size_t triangleCount = 0;
+			size_t vertexCount = 0;
+			std::vector<int> skippedVertexIds;
+		};
+
+		std::string regionFileName(const std::string& outputFileName, const char* suffix, int region)
+		{
+			return outputFileName + suffix + std::to_string(region);
+		}
+
+		RegionResult triangulateRegion(
+				const delaunay::TilingService& tiling,
+				int region,
+				const std::string& pointsFileName,
+				const std::string& elementsFileName)
+		{
+			RegionResult result;
+			std::list<std::shared_ptr<delaunay::Vertex2D> > vertices;
+			{
+				std::ifstream points(pointsFileName, std::ios::in | std::ios::binary);
+				PointRecord record;
+				while (points.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+					auto vertex = std::make_shared<delaunay::Vertex2D>();
+					vertex->id = record.id;
+					vertex->x = record.x;
+					vertex->y = record.y;
+					vertices.push_back(vertex);
+				}
+				if (points.bad()) {
+					return result;
+				}
+			}
+			std::remove(pointsFileName.c_str());
+
+			delaunay::RegionTriangulation triangulation;
+			if (!tiling.triangulateRegion(region, vertices, triangulation)) {
+				return result;
+			}
+			std::ofstream elements(elementsFileName, std::ios::out | std::ios::trunc | std::ios::binary);
+			OutputBuffer output(elements);
+			for (const auto& triangle : triangulation.triangles) {
+				ElementRecord record = {{triangle->vertex1->id, triangle->vertex2->id, triangle->vertex3->id}};
+				output.appendValue(record);
+			}
+			result.ok = output.flush();
+			result.triangleCount = triangulation.triangleCount;
+			result.vertexCount = triangulation.vertexCount;
+			result.skippedVertexIds = std::move(triangulation.skippedVertexIds);
+			return result;
+		}
+	}
+
+	TiledTriangulation::TiledTriangulation(
+			const IProjection& projection,
+			int columns,
+			int rows,
+			double margin,
+			size_t threadCount)
+		: _projection(projection)
+		, _columns(columns)
+		, _rows(rows)
+		, _margin(margin)
+		, _threadCount(threadCount)
+	{}
+
+	bool TiledTriangulation::process(std::istream& input, const std::string& outputFileName)
+	{
+		_usedMargin = 0.0;
+		_attemptCount = 0;
+		_vertexCount = 0;
+		_triangleCount = 0;
+		_invalidLineCount = 0;
+
+		std::ofstream output(outputFileName, std::ios::out | std::ios::trunc);
+		if (!output.is_open()) {
+			return false;
+		}
+		const std::string pointsFileName = outputFileName + POINTS_FILE_SUFFIX;
+		float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+		{
+			// узлы сразу пишутся в выходной файл, проекции вершин - во временный
+			std::ofstream points(pointsFileName, std::ios::out | std::ios::trunc | std::ios::binary);
+			OutputBuffer nodeOutput(output);
+			OutputBuffer pointOutput(points);
+			nodeOutput.append(DefaultWriter::NODES_HEADER);
+			std::string line;
+			while (std::getline(input, line)) {
+				Vertex3D vertex;
+				if (!CoordinatesFileParser::parseVertex(line.data(), line.data() + line.size(), vertex)) {
+					const size_t begin = line.find_first_not_of(" \t\r");
+					if (begin != std::string::npos && line[begin] != '*') {
+						_invalidLineCount++;
+					}
+					continue;
+				}
+				delaunay::Vertex2D projected;
+				_projection.project(&vertex, 1, &projected);
+				DefaultWriter::appendNode(nodeOutput, vertex);
+				pointOutput.appendValue(PointRecord{vertex.id, projected.x, projected.y});
+				if (_vertexCount == 0) {
+					minX = maxX = projected.x;
+					minY = maxY = projected.y;
+				}
+				minX = std::min(minX, projected.x);
+				minY = std::min(minY, projected.y);
+				maxX = std::max(maxX, projected.x);
+				maxY = std::max(maxY, projected.y);
+				_vertexCount++;
+			}
+			const bool ok = nodeOutput.flush();
+			if (input.bad() || !pointOutput.flush() || !ok) {
+				std::remove(pointsFileName.c_str());
+				return false;
+			}
+		}
+
+		int columns = _columns;
+		int rows = _rows;
+		double margin = _margin;
+		if (margin <= 0.0 && _vertexCount > 0) {
+			margin = DEFAULT_MARGIN_SPACINGS * std::sqrt(
+					(static_cast<double>(maxX) - minX) * (static_cast<double>(maxY) - minY) / _vertexCount);
+		}
+		ThreadPool pool(_threadCount);
+		// вершины, которые пропустила хотя бы одна область
+		std::unordered_set<int> skippedVertexIds;
+		bool ok = false;
+		bool complete = false;
+		int regionCount = 0;
+		while (!complete) {
+			delaunay::TilingService tiling(minX, minY, maxX, maxY, columns, rows, margin);
+			if (!tiling.isValid()) {
+				std::cout << "Cannot split the input into tiles." << std::endl;
+				ok = false;
+				break;
+			}
+			_attemptCount++;
+			_usedMargin = margin;
+			regionCount = tiling.regionCount();
+
+			// раскладка вершин по областям в порядке входа
+			{
+				std::vector<std::unique_ptr<std::ofstream> > regionFiles;
+				std::vector<std::unique_ptr<OutputBuffer> > regionOutputs;
+				for (int region = 0; region < regionCount; region++) {
+					regionFiles.push_back(std::make_unique<std::ofstream>(
+							regionFileName(outputFileName, REGION_FILE_SUFFIX, region),
+							std::ios::out | std::ios::trunc | std::ios::binary));
+					regionOutputs.push_back(std::make_unique<OutputBuffer>(*regionFiles.back(), 1 << 16));
+				}
+				std::ifstream points(pointsFileName, std::ios::in | std::ios::binary);
+				PointRecord record;
+				std::vector<int> regions;
+				while (points.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+					if (!skippedVertexIds.empty() && skippedVertexIds.count(record.id) > 0) {
+						continue;
+					}
+					delaunay::Vertex2D vertex;
+					vertex.x = record.x;
+					vertex.y = record.y;
+					regions.clear();
+					tiling.regionsOf(vertex, regions);
+					for (int region : regions) {
+						regionOutputs[region]->appendValue(record);
+					}
+				}
+				ok = !points.bad();
+				for (auto& regionOutput : regionOutputs) {
+					ok = regionOutput->flush() && ok;
+				}
+			}
+			if (!ok) {
+				break;
+			}
+
+			std::vector<std::future<RegionResult> > results;
+			for (int region = 0; region < regionCount; region++) {
+				results.push_back(pool.submit([&tiling, region, &outputFileName]() {
+					return triangulateRegion(
+							tiling,
+							region,
+							regionFileName(outputFileName, REGION_FILE_SUFFIX, region),
+							regionFileName(outputFileName, ELEMENTS_FILE_SUFFIX, region));
+				}));
+			}
+			size_t triangleCount = 0;
+			size_t vertexCount = 0;
+			const size_t previousSkippedCount = skippedVertexIds.size();
+			for (auto& result : results) {
+				const RegionResult regionResult = result.get();
+				ok = regionResult.ok && ok;
+				triangleCount += regionResult.triangleCount;
+				vertexCount += regionResult.vertexCount;
+				skippedVertexIds.insert(regionResult.skippedVertexIds.begin(), regionResult.skippedVertexIds.end());
+			}
+			if (!ok) {
+				break;
+			}
+			// Пропуск вершины зависит от соседних вершин, и области с разными
+			// наборами вершин могут пропускать разные вершины. Тогда разбиение
+			// повторяется без вершин, пропущенных хоть где-то. Одна область
+			// согласована сама с собой.
+			const size_t newSkippedCount = regionCount > 1 ? skippedVertexIds.size() - previousSkippedCount : 0;
+			complete = newSkippedCount == 0
+					&& triangleCount == delaunay::TilingService::expectedTriangleCount(vertexCount);
+			if (!complete) {
+				for (int region = 0; region < regionCount; region++) {
+					std::remove(regionFileName(outputFileName, ELEMENTS_FILE_SUFFIX, region).c_str());
+				}
+				if (newSkippedCount > 0) {
+					std::cout << "Tiles skipped " << newSkippedCount << " vertices, retrying without them." << std::endl;
+					continue;
+				}
+				if (columns == 1 && rows == 1) {
+					std::cout << "Cannot stitch the tiles." << std::endl;
+					ok = false;
+					break;
+				}
+				margin *= 2.0;
+				const double tileSize = std::max(
+						(static_cast<double>(maxX) - minX) / columns,
+						(static_cast<double>(maxY) - minY) / rows);
+				if (margin >= tileSize) {
+					columns = 1;
+					rows = 1;
+				}
+				std::cout << "Tile margins are too small, retrying with margin " << margin
+						<< " and " << columns << "x" << rows << " tiles." << std::endl;
+			}
+		}
+		std::remove(pointsFileName.c_str());
+
+		if (ok && complete && !skippedVertexIds.empty()) {
+			// id в PointRecord - внешние номера вершин
+			std::vector<int> ids(skippedVertexIds.cbegin(), skippedVertexIds.cend());
+			std::sort(ids.begin(), ids.end());
+			std::vector<delaunay::SkippedVertex> skippedVertices;
+			for (int id : ids) {
+				skippedVertices.push_back({id, delaunay::SkipReason::ValidationProblem});
+			}
+			writeSkippedVertices(std::cout, skippedVertices);
+		}
+
+		if (ok && complete) {
+			output << DefaultWriter::ELEMENTS_HEADER;
+			OutputBuffer elementOutput(output);
+			int id = 0;
+			for (int region = 0; region < regionCount; region++) {
+				std::ifstream elements(
+						regionFileName(outputFileName, ELEMENTS_FILE_SUFFIX, region),
+						std::ios::in | std::ios::binary);
+				ElementRecord record;
+				while (elements.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+					DefaultWriter::appendElement(
+							elementOutput, ++id, record.vertices[0], record.vertices[1], record.vertices[2]);
+				}
+				ok = !elements.bad() && ok;
+			}
+			ok = elementOutput.flush() && ok;
+			_triangleCount = static_cast<size_t>(id);
+		}
+		for (int region = 0; region < regionCount; region++) {
+			std::remove(regionFileName(outputFileName, REGION_FILE_SUFFIX, region).c_str());
+			std::remove(regionFileName(outputFileName, ELEMENTS_FILE_SUFFIX, region).c_str());
+		}
+		return ok && complete && output.flush();
+	}
+
+	size_t TiledTriangulation::vertexCount() const noexcept
+	{
+		return _vertexCount;
+	}
+
+	size_t TiledTriangulation::triangleCount() const noexcept
+	{
+		return _triangleCount;
+	}
+
+	size_t TiledTriangulation::invalidLineCount() const noexcept
+	{
+		return _invalidLineCount;
+	}
+
+	double TiledTriangulation::usedMargin() const noexcept
+	{
+		return _usedMargin;
+	}
+
+	int TiledTriangulation::attemptCount() const noexcept
+	{
+		return _attemptCount;
+	}
+}
@@ -0,0 +1,87 @@
+#ifndef TRIANGULATION_TILED_TRIANGULATION_H
+#define TRIANGULATION_TILED_TRIANGULATION_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+
+namespace triangulation
+{
+	class IProjection;
+
+	/**
+	 * Триангуляция большого файла по тайлам (см. delaunay::TilingService). Вершины
+	 * раскладываются по временным файлам областей, области триангулируются
+	 * параллельно, и в памяти одновременно находятся вершины и треугольники не
+	 * больше threadCount областей. Треугольники областей пишутся во временные файлы и
+	 * в конце дописываются к выходному с нумерацией подряд.
+	 *
+	 * Если полей тайлов не хватило (треугольников меньше, чем у полной
+	 * триангуляции), разбиение повторяется с вдвое большими полями, а когда поля
+	 * сравниваются с тайлом - одним тайлом.
+	 */
+	class TiledTriangulation
+	{
+	public:
+		static const char* const POINTS_FILE_SUFFIX;
+		static const char* const REGION_FILE_SUFFIX;
+		static const char* const ELEMENTS_FILE_SUFFIX;
+
+	private:
+		const IProjection& _projection;
+		int _columns;
+		int _rows;
+		double _margin;
+		size_t _threadCount;
+		double _usedMargin = 0.0;
+		int _attemptCount = 0;
+		size_t _vertexCount = 0;
+		size_t _triangleCount = 0;
+		size_t _invalidLineCount = 0;
+
+	public:
+		/**
+		 * @param projection - проекция, для которой не нужен fit()
+		 * @param columns, rows - количество тайлов
+		 * @param margin - поле тайла; 0 - подобрать по средней плотности вершин
+		 * @param threadCount - 0 для количества ядер
+		 */
+		TiledTriangulation(
+				const IProjection& projection,
+				int columns,
+				int rows,
+				double margin = 0.0,
+				size_t threadCount = 0);
+		~TiledTriangulation() = default;
+		TiledTriangulation(const TiledTriangulation&) = delete;
+		TiledTriangulation(TiledTriangulation&&) = delete;
+		TiledTriangulation & operator=(const TiledTriangulation&) = delete;
+		TiledTriangulation & operator=(TiledTriangulation&&) = delete;
+
+		/**
+		 * Триангулирует вход и записывает результат в формате DefaultWriter в файл
+		 * outputFileName. Рядом с ним на время работы создаются временные файлы с
+		 * суффиксами POINTS_FILE_SUFFIX, REGION_FILE_SUFFIX и ELEMENTS_FILE_SUFFIX.
+		 * @param input
+		 * @param outputFileName
+		 * @return false при ошибке записи или если вершины нельзя разбить на тайлы
+		 */
+		bool process(std::istream& input, const std::string& outputFileName);
+
+		[[nodiscard]] size_t vertexCount() const noexcept;
+		[[nodiscard]] size_t triangleCount() const noexcept;
+		[[nodiscard]] size_t invalidLineCount() const noexcept;
+		/**
+		 * Поле тайла последнего разбиения
+		 */
+		[[nodiscard]] double usedMargin() const noexcept;
+		/**
+		 * Количество разбиений, включая повторные
+		 */
+		[[nodiscard]] int attemptCount() const noexcept;
+
+	};
+}
+
+#endif //TRIANGULATION_TILED_TRIANGULATION_H
@@ -1,31 +1,100 @@
 #include "utils.h"
 
-#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 
 
 namespace triangulation
 {
-	std::string Utils::intToString(int i, size_t minLength)
+	// точность std::ostream по умолчанию
+	static const int DEFAULT_FLOAT_PRECISION = 6;
+
+	namespace
 	{
-		std::string result = std::to_string(i);
-		if (result.size() < minLength) {
-			for(size_t j = result.size(); j <= minLength; j++) {
-				result = ' ' + result;
+		/**
+		 * Сдвигает запись числа длиной length вправо, заполняя освободившееся место
+		 * пробелами
+		 */
+		size_t padLeft(char* buffer, size_t length, size_t minLength) noexcept
+		{
+			if (length >= minLength) {
+				return length;
 			}
+			const size_t padding = minLength + 1 - length;
+			std::memmove(buffer + padding, buffer, length);
+			std::memset(buffer, ' ', padding);
+			return minLength + 1;
 		}
+	}
+
+	std::string Utils::intToString(int i, size_t minLength)
+	{
+		std::string result(std::max(MAX_NUMBER_LENGTH, minLength + 1), ' ');
+		result.resize(formatInt(result.data(), i, minLength));
 		return result;
 	}
 
 	std::string Utils::floatToString(float f, size_t minLength)
 	{
-		std::ostringstream ss;
-		ss << f;
-		std::string result(ss.str());
-		if (result.size() < minLength) {
-			for(size_t j = result.size(); j <= minLength; j++) {
-				result = ' ' + result;
-			}
+		std::string result(std::max(MAX_NUMBER_LENGTH, minLength + 1), ' ');
+		result.resize(formatFloat(result.data(), f, minLength));
+		return result;
+	}
+
+	size_t Utils::formatInt(char* buffer, int i, size_t minLength) noexcept
+	{
+		const std::to_chars_result result = std::to_chars(buffer, buffer + MAX_NUMBER_LENGTH, i);
+		return padLeft(buffer, static_cast<size_t>(result.ptr - buffer), minLength);
+	}
+
+	bool Utils::isLittleEndian() noexcept
+	{
+		const uint32_t value = 1;
+		uint8_t firstByte;
+		std::memcpy(&firstByte, &value, 1);
+		return firstByte == 1;
+	}
+
+	uint64_t Utils::hash(const void* data, size_t size, uint64_t seed) noexcept
+	{
+		static const uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ull;
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		uint64_t result = seed ^ (size * MULTIPLIER);
+		auto mix = [&result](uint64_t word) {
+			result ^= word;
+			result *= MULTIPLIER;
+			result ^= result >> 32;
+		};
+		size_t i = 0;
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+			uint64_t word;
+			std::memcpy(&word, bytes + i, sizeof(word));
+			mix(word);
+		}
+		if (i < size) {
+			uint64_t word = 0;
+			std::memcpy(&word, bytes + i, size - i);
+			mix(word);
 		}
+		// финальное перемешивание splitmix64
+		result ^= result >> 30;
+		result *= 0xbf58476d1ce4e5b9ull;
+		result ^= result >> 27;
+		result *= 0x94d049bb133111ebull;
+		result ^= result >> 31;
 		return result;
 	}
+
+	size_t Utils::formatFloat(char* buffer, float f, size_t minLength) noexcept
+	{
+		const std::to_chars_result result = std::to_chars(
+				buffer,
+				buffer + MAX_NUMBER_LENGTH,
+				f,
+				std::chars_format::general,
+				DEFAULT_FLOAT_PRECISION);
+		return padLeft(buffer, static_cast<size_t>(result.ptr - buffer), minLength);
+	}
 }
@@ -1,6 +1,7 @@
 #ifndef TRIANGULATION_UTILS_H
 #define TRIANGULATION_UTILS_H
 
+#include <cstdint>
 #include <string>
 
 
@@ -9,6 +10,9 @@ namespace triangulation
 	class Utils
 	{
 	public:
+		// Максимальная длина записи числа formatInt / formatFloat без учёта выравнивания
+		static constexpr size_t MAX_NUMBER_LENGTH = 32;
+
 		Utils() = delete;
 		~Utils() = delete;
 		Utils(const Utils&) = delete;
@@ -20,6 +24,42 @@ namespace triangulation
 
 		static std::string floatToString(float f, size_t minLength);
 
+		/**
+		 * Записывает целое число в buffer, выравнивая его пробелами слева так же,
+		 * как intToString: если число короче minLength, то результат имеет длину
+		 * minLength + 1.
+		 * @param buffer - не меньше max(MAX_NUMBER_LENGTH, minLength + 1) байт
+		 * @param i
+		 * @param minLength
+		 * @return количество записанных байт
+		 */
+		static size_t formatInt(char* buffer, int i, size_t minLength) noexcept;
+
+		/**
+		 * Записывает число в buffer в формате std::ostream по умолчанию (%g, 6 значащих
+		 * цифр), выравнивая его пробелами слева так же, как floatToString.
+		 * @param buffer - не меньше max(MAX_NUMBER_LENGTH, minLength + 1) байт
+		 * @param f
+		 * @param minLength
+		 * @return количество записанных байт
+		 */
+		static size_t formatFloat(char* buffer, float f, size_t minLength) noexcept;
+
+		/**
+		 * Бинарные форматы записываются в little-endian, поэтому поддерживаются только
+		 * на платформах с таким порядком байт
+		 */
+		static bool isLittleEndian() noexcept;
+
+		/**
+		 * Быстрый некриптографический 64-битный хэш данных
+		 * @param data
+		 * @param size
+		 * @param seed
+		 * @return
+		 */
+		static uint64_t hash(const void* data, size_t size, uint64_t seed = 0) noexcept;
+
 	};
 }
 
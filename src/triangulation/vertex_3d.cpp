@@ -1,21 +1,91 @@
 #include "vertex_3d.h"
 
+#include "legacy_projection.h"
+#include <delaunay/skipped_vertex.h>
 #include <delaunay/vertex_2d.h>
 
+#include <ostream>
+#include <vector>
+
 
 namespace triangulation
 {
+	namespace
+	{
+		const char* skipReasonText(delaunay::SkipReason reason) noexcept
+		{
+			switch (reason) {
+				case delaunay::SkipReason::ValidationProblem:
+					return "validation problem";
+				case delaunay::SkipReason::OutOfTriangulationArea:
+					return "out of triangulation area";
+				case delaunay::SkipReason::FinalizedArea:
+					return "finalized area";
+			}
+			return "";
+		}
+
+		void writeSkippedVertex(std::ostream& output, int id, delaunay::SkipReason reason)
+		{
+			output << "Skipped vertex: " << id << " (" << skipReasonText(reason) << ")." << std::endl;
+		}
+	}
+
 	std::list<std::shared_ptr<delaunay::Vertex2D> > projectVertex3D(
-			const std::list<Vertex3D>& vertices)
+			const std::vector<Vertex3D>& vertices)
 	{
 		std::list<std::shared_ptr<delaunay::Vertex2D> > result;
-		for (const auto& vertex : vertices) {
-			std::shared_ptr<delaunay::Vertex2D> vertex2D = std::make_shared<delaunay::Vertex2D>();
-			vertex2D->id = vertex.id;
-			vertex2D->x = vertex.x * vertex.z;
-			vertex2D->y = vertex.y * vertex.z;
-			result.push_back(vertex2D);
-		}
+		projectVertex3D(vertices.data(), vertices.size(), result);
 		return result;
 	}
+
+	void projectVertex3D(
+			const Vertex3D* vertices,
+			size_t count,
+			std::list<std::shared_ptr<delaunay::Vertex2D> >& result)
+	{
+		LegacyProjection projection;
+		projectVertex3D(projection, vertices, count, result);
+	}
+
+	void projectVertex3D(
+			const IProjection& projection,
+			const Vertex3D* vertices,
+			size_t count,
+			std::list<std::shared_ptr<delaunay::Vertex2D> >& result)
+	{
+		if (count == 0) {
+			return;
+		}
+		auto block = std::make_shared<std::vector<delaunay::Vertex2D> >(count);
+		projection.project(vertices, count, block->data());
+		for (size_t i = 0; i < count; i++) {
+			delaunay::Vertex2D& vertex2D = (*block)[i];
+			vertex2D.id = static_cast<int>(result.size());
+			// указатель на элемент блока, владеющий всем блоком
+			result.emplace_back(block, &vertex2D);
+		}
+	}
+
+	void writeSkippedVertices(
+			std::ostream& output,
+			const std::vector<delaunay::SkippedVertex>& skippedVertices)
+	{
+		for (const auto& skippedVertex : skippedVertices) {
+			writeSkippedVertex(output, skippedVertex.id, skippedVertex.reason);
+		}
+	}
+
+	void writeSkippedVertices(
+			std::ostream& output,
+			const std::vector<delaunay::SkippedVertex>& skippedVertices,
+			const std::vector<Vertex3D>& coordinates)
+	{
+		for (const auto& skippedVertex : skippedVertices) {
+			const int id = skippedVertex.id >= 0 && static_cast<size_t>(skippedVertex.id) < coordinates.size()
+					? coordinates[skippedVertex.id].id
+					: skippedVertex.id;
+			writeSkippedVertex(output, id, skippedVertex.reason);
+		}
+	}
 }
@@ -1,17 +1,22 @@
 #ifndef TRIANGULATION_VERTEX_3D_H
 #define TRIANGULATION_VERTEX_3D_H
 
+#include <iosfwd>
 #include <memory>
 #include <list>
+#include <vector>
 
 
 namespace delaunay
 {
 	struct Vertex2D;
+	struct SkippedVertex;
 }
 
 namespace triangulation
 {
+	class IProjection;
+
 	// Данные вершины 3D
 	struct Vertex3D
 	{
@@ -22,8 +27,50 @@ namespace triangulation
 		float z = 0.0;
 	};
 
+	/**
+	 * Проецирует вершины на плоскость. id вершины 2D - плотный индекс вершины в
+	 * vertices, внешний номер остаётся в Vertex3D::id.
+	 */
 	std::list<std::shared_ptr<delaunay::Vertex2D> > projectVertex3D(
-			const std::list<Vertex3D>& vertices);
+			const std::vector<Vertex3D>& vertices);
+
+	/**
+	 * Добавляет в конец result проекции count вершин, начиная с vertices. id
+	 * вершины 2D - её порядковый номер в result.
+	 */
+	void projectVertex3D(
+			const Vertex3D* vertices,
+			size_t count,
+			std::list<std::shared_ptr<delaunay::Vertex2D> >& result);
+
+	/**
+	 * То же с заданной проекцией (для проекций с IProjection::needsFit() fit() уже
+	 * должен быть вызван). Вершины 2D размещаются одним блоком, элементы result
+	 * ссылаются на него.
+	 */
+	void projectVertex3D(
+			const IProjection& projection,
+			const Vertex3D* vertices,
+			size_t count,
+			std::list<std::shared_ptr<delaunay::Vertex2D> >& result);
+
+	/**
+	 * Выводит по строке "Skipped vertex: <номер> (<причина>)." на каждую вершину
+	 * @param output
+	 * @param skippedVertices - id вершин - внешние номера
+	 */
+	void writeSkippedVertices(
+			std::ostream& output,
+			const std::vector<delaunay::SkippedVertex>& skippedVertices);
+
+	/**
+	 * То же для вершин projectVertex3D: id - плотный индекс, выводится внешний
+	 * номер coordinates[id].id
+	 */
+	void writeSkippedVertices(
+			std::ostream& output,
+			const std::vector<delaunay::SkippedVertex>& skippedVertices,
+			const std::vector<Vertex3D>& coordinates);
 }
 
 #endif //TRIANGULATION_VERTEX_3D_H
@@ -0,0 +1,50 @@
+#include "vertex_index.h"
+
+#include <delaunay/triangle.h>
+#include <delaunay/vertex_2d.h>
+
+
+namespace triangulation
+{
+	VertexIndex::VertexIndex(const std::vector<bool>& usedVertices) :
+			_indices(usedVertices.size(), NO_INDEX)
+	{
+		for (size_t i = 0; i < usedVertices.size(); i++) {
+			if (usedVertices[i]) {
+				_indices[i] = static_cast<int32_t>(_positions.size());
+				_positions.push_back(i);
+			}
+		}
+	}
+
+	size_t VertexIndex::size() const noexcept
+	{
+		return _positions.size();
+	}
+
+	int32_t VertexIndex::index(int id) const noexcept
+	{
+		if (id < 0 || static_cast<size_t>(id) >= _indices.size()) {
+			return NO_INDEX;
+		}
+		return _indices[static_cast<size_t>(id)];
+	}
+
+	bool VertexIndex::indexesAll(
+			const std::list<std::shared_ptr<delaunay::Triangle> >& triangles) const noexcept
+	{
+		for (const auto& triangle : triangles) {
+			if (index(triangle->vertex1->id) == NO_INDEX
+					|| index(triangle->vertex2->id) == NO_INDEX
+					|| index(triangle->vertex3->id) == NO_INDEX) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const std::vector<size_t>& VertexIndex::positions() const noexcept
+	{
+		return _positions;
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef TRIANGULATION_VERTEX_INDEX_H
+#define TRIANGULATION_VERTEX_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+
+namespace delaunay
+{
+	struct Triangle;
+}
+
+namespace triangulation
+{
+	/**
+	 * Нумерация использованных вершин для форматов, в которых треугольники ссылаются
+	 * на вершины по индексу. Использованные вершины нумеруются с 0 в порядке
+	 * следования в coordinates.
+	 */
+	class VertexIndex
+	{
+	public:
+		static constexpr int32_t NO_INDEX = -1;
+
+	private:
+		// индексы по позиции вершины в coordinates
+		std::vector<int32_t> _indices;
+		// позиции в coordinates для вершин в порядке их индексов
+		std::vector<size_t> _positions;
+
+	public:
+		explicit VertexIndex(const std::vector<bool>& usedVertices);
+		~VertexIndex() = default;
+		VertexIndex(const VertexIndex&) = delete;
+		VertexIndex(VertexIndex&&) = delete;
+		VertexIndex & operator=(const VertexIndex&) = delete;
+		VertexIndex & operator=(VertexIndex&&) = delete;
+
+		[[nodiscard]] size_t size() const noexcept;
+
+		/**
+		 * @param id - позиция вершины в coordinates (Vertex2D::id)
+		 * @return индекс вершины или NO_INDEX если вершина не использована
+		 */
+		[[nodiscard]] int32_t index(int id) const noexcept;
+
+		/**
+		 * Есть ли индекс у всех вершин треугольников. Проверяется до записи, чтобы
+		 * при ошибке не оставлять обрезанный файл.
+		 */
+		[[nodiscard]] bool indexesAll(
+				const std::list<std::shared_ptr<delaunay::Triangle> >& triangles) const noexcept;
+
+		[[nodiscard]] const std::vector<size_t>& positions() const noexcept;
+
+	};
+}
+
+#endif //TRIANGULATION_VERTEX_INDEX_H
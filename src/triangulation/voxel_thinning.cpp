@@ -0,0 +1,230 @@
+#include "voxel_thinning.h"
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <unordered_map>
+
+
+namespace triangulation
+{
+	namespace
+	{
+		// бит на номер куба по каждой оси в ключе
+		const int KEY_BITS = 21;
+		const uint64_t MAX_CELL = (uint64_t(1) << KEY_BITS) - 1;
+		// допустимая нехватка вершин до budget при подборе стороны куба
+		const double BUDGET_TOLERANCE = 0.95;
+		const int MAX_BUDGET_ITERATIONS = 16;
+
+		/**
+		 * Сетка кубов от минимального угла габаритного прямоугольника вершин. Сторона
+		 * куба не меньше, чем нужно, чтобы номер куба по каждой оси уместился в KEY_BITS.
+		 */
+		struct Grid
+		{
+			double minimum[3] = {0.0, 0.0, 0.0};
+			double spacing = 0.0;
+
+			Grid(const std::vector<Vertex3D>& coordinates, double requestedSpacing)
+			{
+				double maximum[3] = {0.0, 0.0, 0.0};
+				for (size_t i = 0; i < coordinates.size(); i++) {
+					const double values[3] = {coordinates[i].x, coordinates[i].y, coordinates[i].z};
+					for (int axis = 0; axis < 3; axis++) {
+						if (i == 0 || values[axis] < minimum[axis]) {
+							minimum[axis] = values[axis];
+						}
+						if (i == 0 || values[axis] > maximum[axis]) {
+							maximum[axis] = values[axis];
+						}
+					}
+				}
+				const double extent = std::max({maximum[0] - minimum[0], maximum[1] - minimum[1], maximum[2] - minimum[2]});
+				spacing = std::max(requestedSpacing, extent / static_cast<double>(MAX_CELL));
+			}
+
+			[[nodiscard]] uint64_t key(const Vertex3D& vertex, double& distance) const noexcept
+			{
+				const double values[3] = {vertex.x, vertex.y, vertex.z};
+				uint64_t result = 0;
+				distance = 0.0;
+				for (int axis = 0; axis < 3; axis++) {
+					const double position = (values[axis] - minimum[axis]) / spacing;
+					const uint64_t cell = std::min(static_cast<uint64_t>(position), MAX_CELL);
+					const double offset = position - static_cast<double>(cell) - 0.5;
+					distance += offset * offset;
+					result |= cell << (axis * KEY_BITS);
+				}
+				return result;
+			}
+		};
+
+		/**
+		 * Выполняет task(begin, end) для частей диапазона [0, count) - по одной на
+		 * поток пула или целиком, если пула нет
+		 */
+		void parallelFor(ThreadPool* pool, size_t count, const std::function<void(size_t, size_t)>& task)
+		{
+			if (!pool || count < 2) {
+				task(0, count);
+				return;
+			}
+			const size_t parts = std::min(pool->size(), count);
+			std::vector<std::future<void> > results;
+			results.reserve(parts);
+			for (size_t part = 0; part < parts; part++) {
+				const size_t begin = count * part / parts;
+				const size_t end = count * (part + 1) / parts;
+				results.push_back(pool->submit([&task, begin, end]() { task(begin, end); }));
+			}
+			for (auto& result : results) {
+				result.get();
+			}
+		}
+
+		void computeKeys(
+				ThreadPool* pool,
+				const std::vector<Vertex3D>& coordinates,
+				const Grid& grid,
+				std::vector<uint64_t>& keys,
+				std::vector<double>* distances)
+		{
+			keys.resize(coordinates.size());
+			if (distances) {
+				distances->resize(coordinates.size());
+			}
+			parallelFor(pool, coordinates.size(), [&](size_t begin, size_t end) {
+				double distance;
+				for (size_t i = begin; i < end; i++) {
+					keys[i] = grid.key(coordinates[i], distance);
+					if (distances) {
+						(*distances)[i] = distance;
+					}
+				}
+			});
+		}
+
+		// перемешивание бит ключа, чтобы соседние кубы попадали в разные части
+		uint64_t mixKey(uint64_t key) noexcept
+		{
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			return key;
+		}
+	}
+
+	VoxelThinning::VoxelThinning(size_t threadCount) :
+			_threadCount(threadCount)
+	{}
+
+	std::vector<Vertex3D> VoxelThinning::thin(const std::vector<Vertex3D>& coordinates, double spacing)
+	{
+		if (coordinates.empty() || !(spacing > 0.0)) {
+			return coordinates;
+		}
+		std::unique_ptr<ThreadPool> pool;
+		if (_threadCount != 1 && coordinates.size() >= PARALLEL_THRESHOLD) {
+			pool = std::make_unique<ThreadPool>(_threadCount);
+		}
+		const Grid grid(coordinates, spacing);
+		std::vector<uint64_t> keys;
+		std::vector<double> distances;
+		computeKeys(pool.get(), coordinates, grid, keys, &distances);
+
+		// каждая часть кубов (по перемешанному ключу) обрабатывается своим потоком;
+		// при равном расстоянии до центра остаётся вершина с меньшим индексом
+		const size_t shards = pool ? pool->size() : 1;
+		std::vector<char> kept(coordinates.size(), 0);
+		parallelFor(pool.get(), shards, [&](size_t begin, size_t end) {
+			for (size_t shard = begin; shard < end; shard++) {
+				std::unordered_map<uint64_t, size_t> nearest;
+				for (size_t i = 0; i < keys.size(); i++) {
+					if (mixKey(keys[i]) % shards != shard) {
+						continue;
+					}
+					const auto inserted = nearest.emplace(keys[i], i);
+					if (!inserted.second && distances[i] < distances[inserted.first->second]) {
+						inserted.first->second = i;
+					}
+				}
+				for (const auto& cell : nearest) {
+					kept[cell.second] = 1;
+				}
+			}
+		});
+
+		std::vector<Vertex3D> result;
+		result.reserve(static_cast<size_t>(std::count(kept.begin(), kept.end(), 1)));
+		for (size_t i = 0; i < coordinates.size(); i++) {
+			if (kept[i]) {
+				result.push_back(coordinates[i]);
+			}
+		}
+		return result;
+	}
+
+	double VoxelThinning::spacingForBudget(const std::vector<Vertex3D>& coordinates, size_t budget)
+	{
+		if (budget == 0 || coordinates.size() <= budget) {
+			return 0.0;
+		}
+		std::unique_ptr<ThreadPool> pool;
+		if (_threadCount != 1 && coordinates.size() >= PARALLEL_THRESHOLD) {
+			pool = std::make_unique<ThreadPool>(_threadCount);
+		}
+		const Grid bounds(coordinates, 0.0);
+		// наибольшая сторона сетки по осям - MAX_CELL кубов
+		const double extent = bounds.spacing * static_cast<double>(MAX_CELL);
+		if (!(extent > 0.0)) {
+			// все вершины совпадают и в любом случае останется одна
+			return 1.0;
+		}
+		std::vector<uint64_t> keys;
+		const auto countCells = [&](double spacing) {
+			computeKeys(pool.get(), coordinates, Grid(coordinates, spacing), keys, nullptr);
+			std::sort(keys.begin(), keys.end());
+			return static_cast<size_t>(std::unique(keys.begin(), keys.end()) - keys.begin());
+		};
+
+		// количество занятых кубов примерно пропорционально spacing^-d, где d -
+		// размерность облака (2 для поверхности); d уточняется по двум последним
+		// шагам, а spacing остаётся между найденными границами
+		double tooSmall = 0.0;
+		double enough = extent * 2.0;
+		double spacing = extent / std::cbrt(static_cast<double>(budget));
+		double previousSpacing = 0.0;
+		size_t previousCount = 0;
+		double dimension = 2.0;
+		for (int iteration = 0; iteration < MAX_BUDGET_ITERATIONS; iteration++) {
+			const size_t count = countCells(spacing);
+			if (count <= budget) {
+				enough = std::min(enough, spacing);
+				if (static_cast<double>(count) >= BUDGET_TOLERANCE * static_cast<double>(budget)) {
+					break;
+				}
+			}
+			else {
+				tooSmall = std::max(tooSmall, spacing);
+			}
+			if (previousCount > 0 && count != previousCount && spacing != previousSpacing) {
+				dimension = -std::log(static_cast<double>(count) / static_cast<double>(previousCount))
+						/ std::log(spacing / previousSpacing);
+				dimension = std::min(std::max(dimension, 1.0), 3.0);
+			}
+			previousSpacing = spacing;
+			previousCount = count;
+			spacing *= std::pow(static_cast<double>(count) / static_cast<double>(budget), 1.0 / dimension);
+			if (!(spacing > tooSmall && spacing < enough)) {
+				spacing = tooSmall > 0.0 ? std::sqrt(tooSmall * enough) : enough / 2.0;
+			}
+		}
+		return enough;
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef TRIANGULATION_VOXEL_THINNING_H
+#define TRIANGULATION_VOXEL_THINNING_H
+
+#include "vertex_3d.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace triangulation
+{
+	/**
+	 * Прореживание облака вершин по сетке кубов (вокселей): из каждого куба
+	 * остаётся одна вершина - ближайшая к его центру. Кубы ищутся по ключу в
+	 * хеш-таблице, поэтому время линейно от количества вершин. Оставленные
+	 * вершины не изменяются и идут в исходном порядке, т.е. сохраняют свои id.
+	 *
+	 * Для больших облаков ключи считаются в пуле потоков, а кубы делятся между
+	 * потоками по ключу; результат от количества потоков не зависит.
+	 */
+	class VoxelThinning
+	{
+	public:
+		// Минимальное количество вершин, для которого используется пул потоков
+		static constexpr size_t PARALLEL_THRESHOLD = 1 << 16;
+
+	private:
+		size_t _threadCount;
+
+	public:
+		/**
+		 * @param threadCount - количество потоков, 0 - по количеству ядер, 1 - без
+		 * пула потоков
+		 */
+		explicit VoxelThinning(size_t threadCount = 1);
+		~VoxelThinning() = default;
+		VoxelThinning(const VoxelThinning&) = delete;
+		VoxelThinning(VoxelThinning&&) = delete;
+		VoxelThinning & operator=(const VoxelThinning&) = delete;
+		VoxelThinning & operator=(VoxelThinning&&) = delete;
+
+		/**
+		 * @param spacing - сторона куба; вершины ближе spacing друг к другу в общем
+		 * кубе сливаются. Если spacing <= 0, вершины возвращаются без изменений.
+		 * @return Оставленные вершины
+		 */
+		std::vector<Vertex3D> thin(const std::vector<Vertex3D>& coordinates, double spacing);
+
+		/**
+		 * Подбирает сторону куба, при которой после thin() остаётся не больше budget
+		 * вершин и не намного меньше (в пределах 5% или после нескольких итераций
+		 * подбора - наибольшее найденное количество, не превышающее budget)
+		 * @return 0 если вершин не больше budget и прореживать не нужно
+		 */
+		double spacingForBudget(const std::vector<Vertex3D>& coordinates, size_t budget);
+
+	};
+}
+
+#endif //TRIANGULATION_VOXEL_THINNING_H